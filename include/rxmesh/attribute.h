@@ -11,6 +11,7 @@
 #include "rxmesh/rxmesh.h"
 #include "rxmesh/types.h"
 #include "rxmesh/util/cuda_query.h"
+#include "rxmesh/util/host_memory.h"
 #include "rxmesh/util/log.h"
 #include "rxmesh/util/util.h"
 
@@ -195,6 +196,25 @@ class Attribute : public AttributeBase
         std::shared_ptr<DenseMatrix<T>> mat =
             std::make_shared<DenseMatrix<T>>(*m_rxmesh, rows(), cols());
 
+        if (m_rxmesh->template is_row_ordered<HandleT>()) {
+            // the owned elements of a patch are a block of rows
+            for_each_row_block([&](uint32_t p, uint32_t row, uint16_t n) {
+                for (uint32_t j = 0; j < cols(); ++j) {
+                    if (m_layout == SoA || cols() == 1) {
+                        std::memcpy(mat->col_data(j, HOST) + row,
+                                    m_h_attr[p] + index(p, 0, j),
+                                    n * sizeof(T));
+                    } else {
+                        for (uint16_t l = 0; l < n; ++l) {
+                            (*mat)(row + l, j) = m_h_attr[p][index(p, l, j)];
+                        }
+                    }
+                }
+            });
+            mat->move(HOST, DEVICE);
+            return mat;
+        }
+
         if constexpr (std::is_same_v<HandleT, VertexHandle>) {
             m_rxmesh->for_each_vertex(HOST, [&](const VertexHandle vh) {                
 
@@ -238,6 +258,32 @@ class Attribute : public AttributeBase
         assert(mat->rows() == rows());
         assert(mat->cols() == cols());
 
+        if (is_host_allocated() && mat->is_view(HOST) &&
+            mat->data(HOST) == m_h_attr[0]) {
+            // mat aliases this attribute (see to_matrix_view())
+            return;
+        }
+
+        // the rows of a reordered matrix (see SparseMatrix::reorder()) are
+        // not blocks of patches and are mapped through the handles below
+        if (m_rxmesh->template is_row_ordered<HandleT>() &&
+            !mat->is_reordered()) {
+            for_each_row_block([&](uint32_t p, uint32_t row, uint16_t n) {
+                for (uint32_t j = 0; j < cols(); ++j) {
+                    if (m_layout == SoA || cols() == 1) {
+                        std::memcpy(m_h_attr[p] + index(p, 0, j),
+                                    mat->col_data(j, HOST) + row,
+                                    n * sizeof(T));
+                    } else {
+                        for (uint16_t l = 0; l < n; ++l) {
+                            m_h_attr[p][index(p, l, j)] = (*mat)(row + l, j);
+                        }
+                    }
+                }
+            });
+            return;
+        }
+
 
         if constexpr (std::is_same_v<HandleT, VertexHandle>) {
             m_rxmesh->for_each_vertex(HOST, [&](const VertexHandle vh) {
@@ -264,6 +310,42 @@ class Attribute : public AttributeBase
         }
     }
 
+    /**
+     * @brief a dense matrix that aliases the storage of this attribute (on
+     * the host and device) without copying. This is possible when the mesh
+     * has a single patch whose local order is the row order (see
+     * RXMeshStatic::is_row_ordered()) and the values of every attribute are
+     * contiguous (a single attribute or SoA layout without padding). Otherwise,
+     * this is the same as to_matrix(). Call from_matrix() after writing to the
+     * matrix; it does nothing if the matrix aliases this attribute
+     */
+    std::shared_ptr<DenseMatrix<T>> to_matrix_view() const
+    {
+        if (!is_matrix_aliasable()) {
+            return to_matrix();
+        }
+        return std::make_shared<DenseMatrix<T>>(
+            *m_rxmesh,
+            rows(),
+            cols(),
+            is_host_allocated() ? m_h_attr[0] : nullptr,
+            is_device_allocated() ? m_h_ptr_on_device[0] : nullptr);
+    }
+
+    /**
+     * @brief check if to_matrix_view() aliases the storage of this attribute
+     */
+    bool is_matrix_aliasable() const
+    {
+        if (m_rxmesh->get_num_patches() != 1) {
+            return false;
+        }
+        if (cols() > 1 && (m_layout != SoA || capacity(0) != rows())) {
+            return false;
+        }
+        return m_rxmesh->template is_row_ordered<HandleT>();
+    }
+
 
     /**
      * @brief get the number of elements in a patch. The element type
@@ -317,6 +399,75 @@ class Attribute : public AttributeBase
         return (m_layout == AoS) ? 1 : capacity(p);
     }
 
+    /**
+     * @brief index of an attribute value in the patch storage
+     * @param p the patch id
+     * @param local_id the local id in the patch
+     * @param attr the attribute id
+     */
+    __host__ __device__ __forceinline__ uint32_t
+    index(const uint32_t p, const uint16_t local_id, const uint32_t attr) const
+    {
+        if (m_layout == AoSoA) {
+            return (local_id / AOSOA_TILE_WIDTH) *
+                       (AOSOA_TILE_WIDTH * m_num_attributes) +
+                   attr * AOSOA_TILE_WIDTH + local_id % AOSOA_TILE_WIDTH;
+        }
+        return local_id * pitch_x() + attr * pitch_y(p);
+    }
+
+    /**
+     * @brief number of AoSoA tiles in a patch i.e., the patch capacity
+     * divided by AOSOA_TILE_WIDTH rounded up
+     * @param p the patch id
+     */
+    __host__ __device__ __forceinline__ uint32_t
+    num_tiles(const uint32_t p) const
+    {
+        return DIVIDE_UP(capacity(p), AOSOA_TILE_WIDTH);
+    }
+
+    /**
+     * @brief number of T stored for a patch. With AoSoA layout, the patch
+     * capacity is padded to a multiple of AOSOA_TILE_WIDTH
+     * @param p the patch id
+     */
+    __host__ __device__ __forceinline__ uint32_t
+    patch_storage_size(const uint32_t p) const
+    {
+        if (m_layout == AoSoA) {
+            return num_tiles(p) * AOSOA_TILE_WIDTH * m_num_attributes;
+        }
+        return capacity(p) * m_num_attributes;
+    }
+
+    /**
+     * @brief pointer to AOSOA_TILE_WIDTH contiguous values of one attribute
+     * of the elements in a tile i.e., elements with local id in
+     * [tile * AOSOA_TILE_WIDTH, (tile + 1) * AOSOA_TILE_WIDTH). Used to write
+     * SIMD loops over a patch. Only valid with AoSoA layout. Lanes past
+     * size(p) hold no element and should be ignored. On the host, the pointer
+     * is aligned to min(AOSOA_TILE_WIDTH * sizeof(T),
+     * ATTRIBUTE_HOST_ALIGNMENT) bytes for power-of-two sizeof(T)
+     * @param p the patch id
+     * @param t the tile id in the patch
+     * @param attr the attribute id
+     */
+    __host__ __device__ __forceinline__ T* tile(const uint32_t p,
+                                                const uint32_t t,
+                                                const uint32_t attr) const
+    {
+        assert(m_layout == AoSoA);
+        assert(p < m_max_num_patches);
+        assert(attr < m_num_attributes);
+        assert(t < num_tiles(p));
+#ifdef __CUDA_ARCH__
+        return m_d_attr[p] + index(p, t * AOSOA_TILE_WIDTH, attr);
+#else
+        return m_h_attr[p] + index(p, t * AOSOA_TILE_WIDTH, attr);
+#endif
+    }
+
     Attribute(const Attribute& rhs) = default;
 
     virtual ~Attribute() = default;
@@ -399,14 +550,12 @@ class Attribute : public AttributeBase
 
 
         if (((location & HOST) == HOST) && is_host_allocated()) {
-
-#pragma omp parallel for
-            for (int p = 0; p < static_cast<int>(m_rxmesh->get_num_patches());
-                 ++p) {
-                for (uint32_t e = 0; e < capacity(p); ++e) {
-                    m_h_attr[p][e] = value;
-                }
-            }
+            m_rxmesh->get_host_schedule().run(
+                m_rxmesh->get_num_patches(), [&](uint32_t p) {
+                    for (uint32_t e = 0; e < patch_storage_size(p); ++e) {
+                        m_h_attr[p][e] = value;
+                    }
+                });
         }
     }
 
@@ -421,7 +570,9 @@ class Attribute : public AttributeBase
      * the host API from CUDA since all these small memcpy will be enqueued in
      * the same stream and so serialized
      */
-    void move(locationT source, locationT target, cudaStream_t stream = NULL)
+    virtual void move(locationT    source,
+                      locationT    target,
+                      cudaStream_t stream = NULL)
     {
         if (source == target) {
             RXMESH_WARN(
@@ -457,7 +608,7 @@ class Attribute : public AttributeBase
                 CUDA_ERROR(
                     cudaMemcpyAsync(m_h_ptr_on_device[p],
                                     m_h_attr[p],
-                                    sizeof(T) * capacity(p) * m_num_attributes,
+                                    sizeof(T) * patch_storage_size(p),
                                     cudaMemcpyHostToDevice,
                                     stream));
             }
@@ -466,7 +617,7 @@ class Attribute : public AttributeBase
                 CUDA_ERROR(
                     cudaMemcpyAsync(m_h_attr[p],
                                     m_h_ptr_on_device[p],
-                                    sizeof(T) * capacity(p) * m_num_attributes,
+                                    sizeof(T) * patch_storage_size(p),
                                     cudaMemcpyDeviceToHost,
                                     stream));
             }
@@ -481,9 +632,9 @@ class Attribute : public AttributeBase
     {
         if (((location & HOST) == HOST) && is_host_allocated()) {
             for (uint32_t p = 0; p < m_rxmesh->get_max_num_patches(); ++p) {
-                free(m_h_attr[p]);
+                host_free(m_h_attr[p]);
             }
-            free(m_h_attr);
+            host_free(m_h_attr);
             m_h_attr    = nullptr;
             m_allocated = m_allocated & (~HOST);
         }
@@ -492,6 +643,8 @@ class Attribute : public AttributeBase
             for (uint32_t p = 0; p < m_rxmesh->get_max_num_patches(); ++p) {
                 GPU_FREE(m_h_ptr_on_device[p]);
             }
+            host_free(m_h_ptr_on_device);
+            m_h_ptr_on_device = nullptr;
             GPU_FREE(m_d_attr);
             m_allocated = m_allocated & (~DEVICE);
         }
@@ -558,7 +711,7 @@ class Attribute : public AttributeBase
             for (uint32_t p = 0; p < m_rxmesh->get_num_patches(); ++p) {
                 std::memcpy(m_h_attr[p],
                             source.m_h_attr[p],
-                            sizeof(T) * capacity(p) * m_num_attributes);
+                            sizeof(T) * patch_storage_size(p));
             }
         }
 
@@ -582,7 +735,7 @@ class Attribute : public AttributeBase
                 CUDA_ERROR(
                     cudaMemcpyAsync(m_h_ptr_on_device[p],
                                     source.m_h_ptr_on_device[p],
-                                    sizeof(T) * capacity(p) * m_num_attributes,
+                                    sizeof(T) * patch_storage_size(p),
                                     cudaMemcpyDeviceToDevice,
                                     stream));
             }
@@ -609,7 +762,7 @@ class Attribute : public AttributeBase
                 CUDA_ERROR(
                     cudaMemcpyAsync(m_h_attr[p],
                                     source.m_h_ptr_on_device[p],
-                                    sizeof(T) * capacity(p) * m_num_attributes,
+                                    sizeof(T) * patch_storage_size(p),
                                     cudaMemcpyDeviceToHost,
                                     stream));
             }
@@ -636,7 +789,7 @@ class Attribute : public AttributeBase
                 CUDA_ERROR(
                     cudaMemcpyAsync(m_h_ptr_on_device[p],
                                     source.m_h_attr[p],
-                                    sizeof(T) * capacity(p) * m_num_attributes,
+                                    sizeof(T) * patch_storage_size(p),
                                     cudaMemcpyHostToDevice,
                                     stream));
             }
@@ -724,10 +877,10 @@ class Attribute : public AttributeBase
 
 #ifdef __CUDA_ARCH__
         assert(local_id < capacity(p_id));
-        return m_d_attr[p_id][local_id * pitch_x() + attr * pitch_y(p_id)];
+        return m_d_attr[p_id][index(p_id, local_id, attr)];
 #else
         assert(local_id < size(p_id));
-        return m_h_attr[p_id][local_id * pitch_x() + attr * pitch_y(p_id)];
+        return m_h_attr[p_id][index(p_id, local_id, attr)];
 #endif
     }
 
@@ -748,10 +901,10 @@ class Attribute : public AttributeBase
 
 #ifdef __CUDA_ARCH__
         assert(local_id < capacity(p_id));
-        return m_d_attr[p_id][local_id * pitch_x() + attr * pitch_y(p_id)];
+        return m_d_attr[p_id][index(p_id, local_id, attr)];
 #else
         assert(local_id < size(p_id));
-        return m_h_attr[p_id][local_id * pitch_x() + attr * pitch_y(p_id)];
+        return m_h_attr[p_id][index(p_id, local_id, attr)];
 #endif
     }
 
@@ -765,6 +918,35 @@ class Attribute : public AttributeBase
 
 
    protected:
+    /**
+     * @brief run func(p, row, n) in parallel over patches where row is the
+     * first row of patch p in a DenseMatrix and n is the number of elements
+     * owned by p. Used when the local order is the row order
+     */
+    template <typename FuncT>
+    void for_each_row_block(FuncT func) const
+    {
+        const Context& ctx = m_rxmesh->get_context();
+
+        const uint32_t* prefix = nullptr;
+        if constexpr (std::is_same_v<HandleT, VertexHandle>) {
+            prefix = ctx.vertex_prefix();
+        }
+        if constexpr (std::is_same_v<HandleT, EdgeHandle>) {
+            prefix = ctx.edge_prefix();
+        }
+        if constexpr (std::is_same_v<HandleT, FaceHandle>) {
+            prefix = ctx.face_prefix();
+        }
+
+        m_rxmesh->get_host_schedule().run(
+            m_rxmesh->get_num_patches(), [&](uint32_t p) {
+                func(p,
+                     prefix[p],
+                     m_h_patches_info[p].template get_num_owned<HandleT>());
+            });
+    }
+
     /**
      * @brief allocate internal memory
      */
@@ -776,11 +958,29 @@ class Attribute : public AttributeBase
                 release(HOST);
 
                 m_h_attr =
-                    static_cast<T**>(malloc(sizeof(T*) * m_max_num_patches));
-
-                for (uint32_t p = 0; p < m_max_num_patches; ++p) {
-                    m_h_attr[p] = static_cast<T*>(
-                        malloc(sizeof(T) * capacity(p) * m_num_attributes));
+                    host_malloc<T*>(m_max_num_patches, HostMemTag::Attribute);
+
+                const HostPatchSchedule& schedule =
+                    m_rxmesh->get_host_schedule();
+
+                if (schedule.is_numa_aware() &&
+                    schedule.get_policy().first_touch) {
+                    // allocate and touch every patch from the thread that
+                    // processes it in host loops
+                    schedule.run(m_max_num_patches, [&](uint32_t p) {
+                        const size_t count = patch_storage_size(p);
+                        m_h_attr[p] = host_malloc<T>(count,
+                                                     HostMemTag::Attribute,
+                                                     ATTRIBUTE_HOST_ALIGNMENT);
+                        std::memset(m_h_attr[p], 0, count * sizeof(T));
+                    });
+                } else {
+                    for (uint32_t p = 0; p < m_max_num_patches; ++p) {
+                        m_h_attr[p] =
+                            host_malloc<T>(patch_storage_size(p),
+                                           HostMemTag::Attribute,
+                                           ATTRIBUTE_HOST_ALIGNMENT);
+                    }
                 }
 
                 m_allocated = m_allocated | HOST;
@@ -796,15 +996,15 @@ class Attribute : public AttributeBase
                     BYTES_TO_MEGABYTES(sizeof(T*) * m_max_num_patches);
 
                 m_h_ptr_on_device =
-                    static_cast<T**>(malloc(sizeof(T*) * m_max_num_patches));
+                    host_malloc<T*>(m_max_num_patches, HostMemTag::Attribute);
 
                 for (uint32_t p = 0; p < m_max_num_patches; ++p) {
                     CUDA_ERROR(
                         cudaMalloc((void**)&(m_h_ptr_on_device[p]),
-                                   sizeof(T) * capacity(p) * m_num_attributes));
+                                   sizeof(T) * patch_storage_size(p)));
 
                     m_memory_mega_bytes += BYTES_TO_MEGABYTES(
-                        sizeof(T) * capacity(p) * m_num_attributes);
+                        sizeof(T) * patch_storage_size(p));
                 }
                 CUDA_ERROR(cudaMemcpy(m_d_attr,
                                       m_h_ptr_on_device,
@@ -0,0 +1,529 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "rxmesh/rxmesh_static.h"
+#include "rxmesh/util/log.h"
+#include "rxmesh/util/timer.h"
+#include "rxmesh/util/util.h"
+
+namespace rxmesh {
+
+/**
+ * @brief the RXMeshStatic build parameters selected by auto_tune()
+ */
+struct BuildConfig
+{
+    uint32_t patch_size               = 512;
+    float    capacity_factor          = 1.0;
+    float    patch_alloc_factor       = 1.0;
+    float    lp_hashtable_load_factor = 0.8;
+
+    bool operator==(const BuildConfig& other) const
+    {
+        return patch_size == other.patch_size &&
+               capacity_factor == other.capacity_factor &&
+               patch_alloc_factor == other.patch_alloc_factor &&
+               lp_hashtable_load_factor == other.lp_hashtable_load_factor;
+    }
+};
+
+/**
+ * @brief the configurations tried by auto_tune() unless the caller gives its
+ * own list
+ */
+inline std::vector<BuildConfig> default_tune_candidates()
+{
+    std::vector<BuildConfig> ret;
+    for (const uint32_t patch_size : {128u, 256u, 512u}) {
+        for (const float load_factor : {0.5f, 0.8f}) {
+            BuildConfig c;
+            c.patch_size               = patch_size;
+            c.lp_hashtable_load_factor = load_factor;
+            ret.push_back(c);
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief FNV-1a hash of the mesh connectivity used to identify a mesh across
+ * runs
+ */
+inline uint64_t mesh_fingerprint(const std::vector<std::vector<uint32_t>>& fv)
+{
+    const uint64_t num_faces = fv.size();
+    uint64_t       h         = detail::fnv1a(&num_faces, sizeof(num_faces));
+    for (const auto& f : fv) {
+        const uint32_t size = static_cast<uint32_t>(f.size());
+        h                   = detail::fnv1a(&size, sizeof(size), h);
+        h = detail::fnv1a(f.data(), size * sizeof(uint32_t), h);
+    }
+    return h;
+}
+
+/**
+ * @brief process-wide cache of the configurations selected by auto_tune()
+ * keyed by the mesh fingerprint, the workload name, and a hash of the tuning
+ * options (see tune_options_hash()). The cache is always
+ * kept in memory. If a folder is set, configurations are also written to and
+ * read from that folder so later runs on the same mesh skip the tuning
+ */
+class TuneCache
+{
+   public:
+    static TuneCache& instance()
+    {
+        static TuneCache s_instance;
+        return s_instance;
+    }
+
+    /**
+     * @brief set the folder where the configurations are persisted. An empty
+     * string (the default) keeps the cache in memory only
+     */
+    void set_folder(const std::string& folder)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_folder = folder;
+        if (!m_folder.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(m_folder, ec);
+            if (ec) {
+                RXMESH_WARN(
+                    "TuneCache::set_folder() can not create folder {}. The "
+                    "cache will be in memory only",
+                    m_folder);
+                m_folder.clear();
+            }
+        }
+    }
+
+    std::string get_folder() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_folder;
+    }
+
+    /**
+     * @brief look up the configuration tuned for a mesh and a workload with
+     * the tuning options identified by options_hash
+     */
+    bool find(const uint64_t     fingerprint,
+              const std::string& workload,
+              const uint64_t     options_hash,
+              BuildConfig&       config)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const KeyT key(fingerprint, workload, options_hash);
+
+        auto it = m_configs.find(key);
+        if (it != m_configs.end()) {
+            config = it->second;
+            m_num_hits++;
+            return true;
+        }
+
+        if (!m_folder.empty() && read(key, config)) {
+            m_configs[key] = config;
+            m_num_hits++;
+            m_num_disk_hits++;
+            return true;
+        }
+
+        m_num_misses++;
+        return false;
+    }
+
+    /**
+     * @brief store the configuration of a mesh and a workload tuned with the
+     * options identified by options_hash in memory and, if a folder is set, on
+     * disk
+     */
+    void insert(const uint64_t     fingerprint,
+                const std::string& workload,
+                const uint64_t     options_hash,
+                const BuildConfig& config)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        const KeyT key(fingerprint, workload, options_hash);
+        m_configs[key] = config;
+
+        if (!m_folder.empty()) {
+            write(key, config);
+        }
+    }
+
+    /**
+     * @brief remove all configurations from memory. The files on disk are kept
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_configs.clear();
+    }
+
+    void reset_stats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_num_hits      = 0;
+        m_num_misses    = 0;
+        m_num_disk_hits = 0;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_configs.size();
+    }
+
+    uint32_t get_num_hits() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_num_hits;
+    }
+
+    uint32_t get_num_misses() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_num_misses;
+    }
+
+    /**
+     * @brief the hits that were loaded from disk
+     */
+    uint32_t get_num_disk_hits() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_num_disk_hits;
+    }
+
+   private:
+    // mesh fingerprint, workload name, tuning options hash
+    using KeyT = std::tuple<uint64_t, std::string, uint64_t>;
+
+    // file header to detect truncated or foreign files
+    static constexpr uint32_t s_magic = 0x52584D54;  // "RXMT"
+
+    TuneCache() : m_num_hits(0), m_num_misses(0), m_num_disk_hits(0)
+    {
+    }
+
+    std::string file_name(const KeyT& key) const
+    {
+        // the workload name is hashed to keep the file name portable
+        const std::string& workload = std::get<1>(key);
+        const uint64_t     h = detail::fnv1a(workload.data(), workload.size());
+        char name[64];
+        std::snprintf(name,
+                      sizeof(name),
+                      "tune_%016llx_%016llx_%016llx.bin",
+                      static_cast<unsigned long long>(std::get<0>(key)),
+                      static_cast<unsigned long long>(h),
+                      static_cast<unsigned long long>(std::get<2>(key)));
+        return (std::filesystem::path(m_folder) / name).string();
+    }
+
+    bool read(const KeyT& key, BuildConfig& config)
+    {
+        std::ifstream file(file_name(key), std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        uint32_t    magic = 0;
+        BuildConfig c;
+        file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        file.read(reinterpret_cast<char*>(&c.patch_size), sizeof(uint32_t));
+        file.read(reinterpret_cast<char*>(&c.capacity_factor), sizeof(float));
+        file.read(reinterpret_cast<char*>(&c.patch_alloc_factor),
+                  sizeof(float));
+        file.read(reinterpret_cast<char*>(&c.lp_hashtable_load_factor),
+                  sizeof(float));
+        if (!file || magic != s_magic || c.patch_size == 0) {
+            RXMESH_WARN("TuneCache::read() invalid configuration in {}",
+                        file_name(key));
+            return false;
+        }
+        config = c;
+        return true;
+    }
+
+    void write(const KeyT& key, const BuildConfig& c)
+    {
+        std::ofstream file(file_name(key), std::ios::binary);
+        if (!file.is_open()) {
+            RXMESH_WARN("TuneCache::write() can not open {}", file_name(key));
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(&s_magic), sizeof(s_magic));
+        file.write(reinterpret_cast<const char*>(&c.patch_size),
+                   sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(&c.capacity_factor),
+                   sizeof(float));
+        file.write(reinterpret_cast<const char*>(&c.patch_alloc_factor),
+                   sizeof(float));
+        file.write(reinterpret_cast<const char*>(&c.lp_hashtable_load_factor),
+                   sizeof(float));
+    }
+
+    std::string                 m_folder;
+    mutable std::mutex          m_mutex;
+    std::map<KeyT, BuildConfig> m_configs;
+    uint32_t                    m_num_hits;
+    uint32_t                    m_num_misses;
+    uint32_t                    m_num_disk_hits;
+};
+
+/**
+ * @brief options of auto_tune()
+ */
+struct TuneOptions
+{
+    // the configurations to try
+    std::vector<BuildConfig> candidates = default_tune_candidates();
+
+    // number of timed runs of the workload for every candidate. The workload
+    // is run once more before the timed runs to warm up
+    uint32_t num_runs = 3;
+
+    // tune on a sample of the input grown from the first face (see
+    // detail::subsample_mesh()) with at most this many faces so large meshes
+    // are tuned quickly. Zero tunes on the whole input
+    uint32_t max_sample_faces = 200000;
+};
+
+/**
+ * @brief FNV-1a hash of the candidates and the options that affect which
+ * candidate auto_tune() selects, so a configuration tuned with one set of
+ * options is not returned for another
+ */
+inline uint64_t tune_options_hash(const TuneOptions& options)
+{
+    const uint64_t num_candidates = options.candidates.size();
+    uint64_t h = detail::fnv1a(&num_candidates, sizeof(num_candidates));
+    for (const BuildConfig& c : options.candidates) {
+        h = detail::fnv1a(&c.patch_size, sizeof(c.patch_size), h);
+        h = detail::fnv1a(&c.capacity_factor, sizeof(c.capacity_factor), h);
+        h = detail::fnv1a(
+            &c.patch_alloc_factor, sizeof(c.patch_alloc_factor), h);
+        h = detail::fnv1a(&c.lp_hashtable_load_factor,
+                          sizeof(c.lp_hashtable_load_factor),
+                          h);
+    }
+    h = detail::fnv1a(&options.num_runs, sizeof(options.num_runs), h);
+    h = detail::fnv1a(
+        &options.max_sample_faces, sizeof(options.max_sample_faces), h);
+    return h;
+}
+
+namespace detail {
+/**
+ * @brief grow a region of at most max_faces faces from the first face through
+ * faces that share a vertex and re-index its vertices. If the component of
+ * the first face has fewer than max_faces faces, growing continues from the
+ * next unvisited face, so the sample is connected only if max_faces fits in
+ * that component
+ */
+inline void subsample_mesh(const std::vector<std::vector<uint32_t>>& fv,
+                           const std::vector<std::vector<float>>&    vertices,
+                           const uint32_t                            max_faces,
+                           std::vector<std::vector<uint32_t>>&       sub_fv,
+                           std::vector<std::vector<float>>& sub_vertices)
+{
+    const uint32_t num_faces    = static_cast<uint32_t>(fv.size());
+    const uint32_t num_vertices = static_cast<uint32_t>(vertices.size());
+
+    // vertex incident faces in CSR
+    std::vector<uint32_t> vf_offset(num_vertices + 1, 0);
+    for (const auto& f : fv) {
+        for (const uint32_t v : f) {
+            vf_offset[v + 1]++;
+        }
+    }
+    std::partial_sum(vf_offset.begin(), vf_offset.end(), vf_offset.begin());
+    std::vector<uint32_t> vf_values(vf_offset.back());
+    std::vector<uint32_t> fill(vf_offset.begin(), vf_offset.end() - 1);
+    for (uint32_t f = 0; f < num_faces; ++f) {
+        for (const uint32_t v : fv[f]) {
+            vf_values[fill[v]++] = f;
+        }
+    }
+
+    std::vector<uint32_t> vertex_map(num_vertices, INVALID32);
+    std::vector<bool>     visited(num_faces, false);
+    std::queue<uint32_t>  queue;
+
+    sub_fv.clear();
+    sub_vertices.clear();
+
+    // restart from the next unvisited face if a component runs out
+    for (uint32_t seed = 0; seed < num_faces && sub_fv.size() < max_faces;
+         ++seed) {
+        if (visited[seed]) {
+            continue;
+        }
+        visited[seed] = true;
+        queue.push(seed);
+
+        while (!queue.empty() && sub_fv.size() < max_faces) {
+            const uint32_t f = queue.front();
+            queue.pop();
+
+            std::vector<uint32_t> face(fv[f].size());
+            for (size_t i = 0; i < fv[f].size(); ++i) {
+                const uint32_t v = fv[f][i];
+                if (vertex_map[v] == INVALID32) {
+                    vertex_map[v] = static_cast<uint32_t>(sub_vertices.size());
+                    sub_vertices.push_back(vertices[v]);
+                }
+                face[i] = vertex_map[v];
+
+                for (uint32_t j = vf_offset[v]; j < vf_offset[v + 1]; ++j) {
+                    const uint32_t n = vf_values[j];
+                    if (!visited[n]) {
+                        visited[n] = true;
+                        queue.push(n);
+                    }
+                }
+            }
+            sub_fv.push_back(std::move(face));
+        }
+
+        queue = std::queue<uint32_t>();
+    }
+}
+}  // namespace detail
+
+/**
+ * @brief select the RXMeshStatic build parameters that run a workload the
+ * fastest on the input mesh. Every candidate configuration builds an
+ * RXMeshStatic (on a sample of the input if it is large) and the
+ * workload is timed on it. The fastest configuration is stored in TuneCache
+ * under the mesh fingerprint, the workload name, and the options hash, so
+ * later calls (and later runs if a TuneCache folder is set) return it without
+ * tuning. Example:
+ *
+ *  BuildConfig c = auto_tune("smoothing", fv, vertices, [](RXMeshStatic& rx) {
+ *      ...
+ *  });
+ *  RXMeshStatic rx(fv, vertices, "", c.patch_size, c.capacity_factor,
+ *                  c.patch_alloc_factor, c.lp_hashtable_load_factor);
+ *
+ * @param workload_name identifies the workload in the cache
+ * @param fv face incident vertices of the input
+ * @param vertices vertex coordinates of the input
+ * @param workload callable taking RXMeshStatic& that runs a representative
+ * workload (host or device). It may allocate attributes on every call
+ * @param options candidates, number of runs, and sample size
+ */
+template <typename WorkloadT>
+BuildConfig auto_tune(const std::string&                        workload_name,
+                      const std::vector<std::vector<uint32_t>>& fv,
+                      const std::vector<std::vector<float>>&    vertices,
+                      WorkloadT                                 workload,
+                      const TuneOptions& options = TuneOptions())
+{
+    const uint64_t fingerprint  = mesh_fingerprint(fv);
+    const uint64_t options_hash = tune_options_hash(options);
+
+    BuildConfig best;
+    if (TuneCache::instance().find(
+            fingerprint, workload_name, options_hash, best)) {
+        RXMESH_INFO(
+            "auto_tune() using the cached configuration for {}: patch_size= "
+            "{}, capacity_factor= {}, patch_alloc_factor= {}, "
+            "lp_hashtable_load_factor= {}",
+            workload_name,
+            best.patch_size,
+            best.capacity_factor,
+            best.patch_alloc_factor,
+            best.lp_hashtable_load_factor);
+        return best;
+    }
+
+    if (options.candidates.empty()) {
+        RXMESH_WARN("auto_tune() no candidates. Using the default");
+        return best;
+    }
+
+    std::vector<std::vector<uint32_t>> sample_fv;
+    std::vector<std::vector<float>>    sample_vertices;
+    if (options.max_sample_faces > 0 && fv.size() > options.max_sample_faces) {
+        detail::subsample_mesh(
+            fv, vertices, options.max_sample_faces, sample_fv, sample_vertices);
+    } else {
+        sample_fv       = fv;
+        sample_vertices = vertices;
+    }
+
+    float best_time = std::numeric_limits<float>::max();
+
+    for (const BuildConfig& c : options.candidates) {
+        RXMeshStatic rx(sample_fv,
+                        sample_vertices,
+                        "",
+                        c.patch_size,
+                        c.capacity_factor,
+                        c.patch_alloc_factor,
+                        c.lp_hashtable_load_factor);
+
+        // warm up
+        workload(rx);
+        CUDA_ERROR(cudaDeviceSynchronize());
+
+        std::vector<float> times;
+        for (uint32_t r = 0; r < std::max(1u, options.num_runs); ++r) {
+            CPUTimer timer;
+            timer.start();
+            workload(rx);
+            CUDA_ERROR(cudaDeviceSynchronize());
+            timer.stop();
+            times.push_back(timer.elapsed_millis());
+        }
+        std::sort(times.begin(), times.end());
+        const float median = times[times.size() / 2];
+
+        RXMESH_INFO(
+            "auto_tune() {}: patch_size= {}, capacity_factor= {}, "
+            "patch_alloc_factor= {}, lp_hashtable_load_factor= {}, time= {} "
+            "(ms)",
+            workload_name,
+            c.patch_size,
+            c.capacity_factor,
+            c.patch_alloc_factor,
+            c.lp_hashtable_load_factor,
+            median);
+
+        if (median < best_time) {
+            best_time = median;
+            best      = c;
+        }
+    }
+
+    RXMESH_INFO("auto_tune() {}: selected patch_size= {} ({} ms)",
+                workload_name,
+                best.patch_size,
+                best_time);
+
+    TuneCache::instance().insert(
+        fingerprint, workload_name, options_hash, best);
+
+    return best;
+}
+
+}  // namespace rxmesh
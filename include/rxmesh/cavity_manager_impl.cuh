@@ -517,6 +517,17 @@ __device__ __inline__ uint32_t CavityManager<blockThreads, cop>::create(
         return id;
     } else {
         ::atomicAdd(m_s_num_cavities, -1);
+#ifdef RXMESH_PATCH_STATS
+        // too many cavities in this patch
+        detail::patch_stats_add(m_context.get_patch_stats(),
+                                m_context.m_max_num_patches,
+                                PatchCounter::CavityAttempted,
+                                patch_id());
+        detail::patch_stats_add(m_context.get_patch_stats(),
+                                m_context.m_max_num_patches,
+                                PatchCounter::CavityFailed,
+                                patch_id());
+#endif
         return INVALID32;
     }
 }
@@ -4340,6 +4351,39 @@ __device__ __inline__ void CavityManager<blockThreads, cop>::epilogue(
 {
     // make sure all writes are done
     block.sync();
+
+#ifdef RXMESH_PATCH_STATS
+    if (patch_id() != INVALID32 && get_num_cavities() > 0) {
+        uint32_t* stats = m_context.get_patch_stats();
+        if (threadIdx.x == 0) {
+            detail::patch_stats_add(stats,
+                                    m_context.m_max_num_patches,
+                                    PatchCounter::CavityAttempted,
+                                    patch_id(),
+                                    get_num_cavities());
+            if (!m_write_to_gmem) {
+                // the whole patch backed off
+                detail::patch_stats_add(stats,
+                                        m_context.m_max_num_patches,
+                                        PatchCounter::CavityFailed,
+                                        patch_id(),
+                                        get_num_cavities());
+            }
+        }
+        if (m_write_to_gmem) {
+            // cavities deactivated because of conflicts
+            for (int c = threadIdx.x; c < get_num_cavities();
+                 c += blockThreads) {
+                if (!m_s_active_cavity_bitmask(c)) {
+                    detail::patch_stats_add(stats,
+                                            m_context.m_max_num_patches,
+                                            PatchCounter::CavityFailed,
+                                            patch_id());
+                }
+            }
+        }
+    }
+#endif
     if (m_write_to_gmem) {
 
         // update number of elements again since add_vertex/edge/face could have
@@ -3,6 +3,7 @@
 #include <stdint.h>
 #include "rxmesh/patch_info.h"
 #include "rxmesh/patch_scheduler.cuh"
+#include "rxmesh/patch_stats.h"
 #include "rxmesh/util/macros.h"
 
 namespace rxmesh {
@@ -40,7 +41,9 @@ class Context
           m_max_lp_capacity_f(0),
           m_patches_info(nullptr),
           m_capacity_factor(0.0f),
-          m_max_num_patches(0)
+          m_max_num_patches(0),
+          m_d_patch_stats(nullptr),
+          m_h_patch_stats(nullptr)
     {
     }
 
@@ -122,6 +125,20 @@ class Context
 #endif
     }
 
+    /**
+     * @brief pointer to the per-patch work counters (see PatchStats) on the
+     * host or the device depending on where it is called from. nullptr if the
+     * patch stats is not enabled
+     */
+    __device__ __host__ __inline__ uint32_t* get_patch_stats() const
+    {
+#ifdef __CUDA_ARCH__
+        return m_d_patch_stats;
+#else
+        return m_h_patch_stats;
+#endif
+    }
+
     /**
      * @brief get the owner handle of a given mesh element handle
      * @param handle the mesh element handle
@@ -152,6 +169,12 @@ class Context
         if (pi[owner].is_owned(LocalT(lid))) {
             return handle;
         } else {
+#ifdef RXMESH_PATCH_STATS
+            detail::patch_stats_add(get_patch_stats(),
+                                    m_max_num_patches,
+                                    PatchCounter::NotOwnedLookup,
+                                    owner);
+#endif
 
             LPPair lp = pi[owner].get_lp<HandleT>().find(lid, table, stash);
 
@@ -327,5 +350,7 @@ class Context
     float      m_capacity_factor;
     uint32_t   m_max_num_patches;
     PatchScheduler m_patch_scheduler;
+    // per-patch work counters. Only allocated if patch stats is enabled
+    uint32_t *m_d_patch_stats, *m_h_patch_stats;
 };
 }  // namespace rxmesh
\ No newline at end of file
@@ -0,0 +1,423 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <omp.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "rxmesh/util/log.h"
+
+namespace rxmesh {
+
+/**
+ * @brief how host loops over patches are executed
+ */
+struct HostExecutionPolicy
+{
+    // assign contiguous patch ranges to threads grouped by NUMA domain and use
+    // the same patch-to-thread mapping in all host loops. If false, host loops
+    // use a plain OpenMP parallel for
+    bool numa_aware = false;
+
+    // number of host threads. Zero means omp_get_max_threads()
+    int num_threads = 0;
+
+    // pin every worker thread to the CPUs of its NUMA domain. The calling
+    // (master) thread is never pinned so it keeps its affinity after the loop
+    bool pin_threads = false;
+
+    // move the host patch topology to the NUMA domain of the thread that
+    // processes the patch and allocate host attributes on that domain
+    bool first_touch = true;
+
+    // if non-zero, host loops walk the patches ordered by super-patches of
+    // this many patches (see SuperPatches) so a thread, and a NUMA domain,
+    // gets runs of neighbor patches. This holds with or without numa_aware.
+    // Zero keeps the patch id order
+    uint32_t super_patch_size = 0;
+};
+
+/**
+ * @brief the NUMA domains of the machine as lists of CPUs. Read from
+ * /sys/devices/system/node on Linux. Falls back to a single domain with all
+ * CPUs
+ */
+struct NumaTopology
+{
+    std::vector<std::vector<int>> node_cpus;
+
+    uint32_t num_nodes() const
+    {
+        return static_cast<uint32_t>(node_cpus.size());
+    }
+
+    static const NumaTopology& instance()
+    {
+        static NumaTopology s_topology = detect();
+        return s_topology;
+    }
+
+   private:
+    // parse cpulist format, e.g., "0-15,32-47"
+    static std::vector<int> parse_cpu_list(const std::string& str)
+    {
+        std::vector<int>  cpus;
+        std::stringstream ss(str);
+        std::string       range;
+        while (std::getline(ss, range, ',')) {
+            if (range.empty() || range == "\n") {
+                continue;
+            }
+            const size_t dash = range.find('-');
+            if (dash == std::string::npos) {
+                cpus.push_back(std::stoi(range));
+            } else {
+                const int first = std::stoi(range.substr(0, dash));
+                const int last  = std::stoi(range.substr(dash + 1));
+                for (int c = first; c <= last; ++c) {
+                    cpus.push_back(c);
+                }
+            }
+        }
+        return cpus;
+    }
+
+    static NumaTopology detect()
+    {
+        NumaTopology ret;
+#ifdef __linux__
+        for (int n = 0;; ++n) {
+            std::ifstream file("/sys/devices/system/node/node" +
+                               std::to_string(n) + "/cpulist");
+            if (!file.is_open()) {
+                break;
+            }
+            std::string line;
+            std::getline(file, line);
+            std::vector<int> cpus = parse_cpu_list(line);
+            // memory-only nodes have no cpus
+            if (!cpus.empty()) {
+                ret.node_cpus.push_back(cpus);
+            }
+        }
+#endif
+        if (ret.node_cpus.empty()) {
+            const int        num_cpus = std::max(
+                1, static_cast<int>(std::thread::hardware_concurrency()));
+            std::vector<int> cpus(num_cpus);
+            for (int c = 0; c < num_cpus; ++c) {
+                cpus[c] = c;
+            }
+            ret.node_cpus.push_back(cpus);
+        }
+        return ret;
+    }
+};
+
+/**
+ * @brief a static mapping of patches to host threads. Every thread gets a
+ * contiguous range of patches (in patch id order or in a given patch order,
+ * e.g., by super-patches) balanced by the patch weights (e.g., number of owned
+ * elements). Threads are grouped by NUMA domain (thread 0..k-1 on domain 0,
+ * k..2k-1 on domain 1, ...) so contiguous patch ranges, which are spatially
+ * coherent, stay on one domain. Since every host loop uses the same
+ * mapping, the pages first-touched by a thread are reused by that thread in
+ * the following loops
+ */
+class HostPatchSchedule
+{
+   public:
+    HostPatchSchedule() : m_epoch(0)
+    {
+    }
+
+    /**
+     * @brief build the schedule
+     * @param policy the execution policy
+     * @param weights the per-patch work used to balance the ranges. The
+     * schedule covers weights.size() patches
+     * @param order optional permutation of the patches the ranges are taken
+     * from. Empty means the patch id order
+     */
+    void build(const HostExecutionPolicy&   policy,
+               const std::vector<uint32_t>& weights,
+               const std::vector<uint32_t>& order = std::vector<uint32_t>())
+    {
+        m_policy = policy;
+        m_epoch  = next_epoch();
+
+        const uint32_t num_patches = static_cast<uint32_t>(weights.size());
+
+        if (!order.empty() && order.size() != num_patches) {
+            RXMESH_ERROR(
+                "HostPatchSchedule::build() the order size ({}) does not match "
+                "the number of patches ({}). Using the patch id order",
+                order.size(),
+                num_patches);
+        }
+        m_patch_order.clear();
+        if (order.size() == num_patches) {
+            m_patch_order = order;
+        }
+        const int      num_threads = std::max(
+            1,
+            std::min<int>(
+                policy.num_threads > 0 ? policy.num_threads :
+                                         omp_get_max_threads(),
+                std::max<int>(1, num_patches)));
+
+        // threads to NUMA domains proportional to the number of cpus
+        const NumaTopology& topo = NumaTopology::instance();
+        size_t              total_cpus = 0;
+        for (const auto& c : topo.node_cpus) {
+            total_cpus += c.size();
+        }
+        m_thread_node.resize(num_threads);
+        size_t acc = 0;
+        for (uint32_t n = 0, t = 0; n < topo.num_nodes(); ++n) {
+            acc += topo.node_cpus[n].size();
+            const uint32_t t_end =
+                (n + 1 == topo.num_nodes()) ?
+                    num_threads :
+                    static_cast<uint32_t>((acc * num_threads) / total_cpus);
+            for (; t < t_end; ++t) {
+                m_thread_node[t] = n;
+            }
+        }
+
+        // contiguous ranges balanced by weight. Empty patches still cost a
+        // little so they are spread too
+        std::vector<uint64_t> prefix(num_patches + 1, 0);
+        for (uint32_t i = 0; i < num_patches; ++i) {
+            prefix[i + 1] =
+                prefix[i] + std::max<uint32_t>(1, weights[patch_at(i)]);
+        }
+        m_thread_offset.resize(num_threads + 1);
+        m_thread_offset[0] = 0;
+        for (int t = 1; t < num_threads; ++t) {
+            // the patch boundary closest to the ideal split
+            const uint64_t target = (prefix.back() * t) / num_threads;
+            uint32_t       b      = static_cast<uint32_t>(
+                std::lower_bound(prefix.begin(), prefix.end(), target) -
+                prefix.begin());
+            if (b > 0 && target - prefix[b - 1] < prefix[b] - target) {
+                b--;
+            }
+            m_thread_offset[t] = std::max(b, m_thread_offset[t - 1]);
+        }
+        m_thread_offset[num_threads] = num_patches;
+
+        m_patch_thread.resize(num_patches);
+        for (int t = 0; t < num_threads; ++t) {
+            for (uint32_t i = m_thread_offset[t]; i < m_thread_offset[t + 1];
+                 ++i) {
+                m_patch_thread[patch_at(i)] = t;
+            }
+        }
+    }
+
+    /**
+     * @brief true if built with a NUMA-aware policy
+     */
+    bool is_numa_aware() const
+    {
+        return m_policy.numa_aware && !m_thread_offset.empty();
+    }
+
+    const HostExecutionPolicy& get_policy() const
+    {
+        return m_policy;
+    }
+
+    int get_num_threads() const
+    {
+        return static_cast<int>(m_thread_node.size());
+    }
+
+    uint32_t get_num_patches() const
+    {
+        return static_cast<uint32_t>(m_patch_thread.size());
+    }
+
+    /**
+     * @brief the patch at position i of the schedule order. The identity if
+     * the schedule was built without an order
+     */
+    uint32_t patch_at(const uint32_t i) const
+    {
+        return m_patch_order.empty() ? i : m_patch_order[i];
+    }
+
+    /**
+     * @brief the position (see patch_at()) of the first patch processed by a
+     * thread
+     */
+    uint32_t thread_begin(const int t) const
+    {
+        return m_thread_offset[t];
+    }
+
+    /**
+     * @brief one past the position of the last patch processed by a thread
+     */
+    uint32_t thread_end(const int t) const
+    {
+        return m_thread_offset[t + 1];
+    }
+
+    /**
+     * @brief the thread that processes a patch
+     */
+    int patch_thread(const uint32_t p) const
+    {
+        return m_patch_thread[p];
+    }
+
+    /**
+     * @brief the NUMA domain of a thread
+     */
+    uint32_t thread_node(const int t) const
+    {
+        return m_thread_node[t];
+    }
+
+    /**
+     * @brief run func(p) for the first num_patches patches. If the schedule
+     * is NUMA-aware, each thread processes its own patch range. Otherwise,
+     * this is a plain OpenMP parallel for (with a static schedule) over the
+     * schedule order (see patch_at()) so threads still get runs of neighbor
+     * patches when the schedule was built with an order. If the team has
+     * fewer threads than the schedule (e.g., a nested region or a thread
+     * limit), every team thread processes the ranges of the threads it
+     * stands for. Patches beyond the schedule (e.g., added after it was
+     * built) are processed by a plain parallel for
+     */
+    template <typename FuncT>
+    void run(const uint32_t num_patches, FuncT func) const
+    {
+        const uint32_t num_scheduled = std::min(num_patches, get_num_patches());
+
+        if (!is_numa_aware()) {
+            const int num_ordered = static_cast<int>(
+                m_patch_order.empty() ? num_scheduled : get_num_patches());
+#pragma omp parallel
+            {
+#pragma omp for schedule(static) nowait
+                for (int i = 0; i < num_ordered; ++i) {
+                    const uint32_t p = patch_at(static_cast<uint32_t>(i));
+                    if (p < num_patches) {
+                        func(p);
+                    }
+                }
+
+#pragma omp for schedule(static)
+                for (int p = static_cast<int>(num_scheduled);
+                     p < static_cast<int>(num_patches);
+                     ++p) {
+                    func(static_cast<uint32_t>(p));
+                }
+            }
+            return;
+        }
+
+        if (num_patches > get_num_patches()) {
+            RXMESH_WARN(
+                "HostPatchSchedule::run() number of patches ({}) is bigger "
+                "than the scheduled patches ({}). The extra patches are not "
+                "NUMA-aware. Rebuild the schedule",
+                num_patches,
+                get_num_patches());
+        }
+
+        const int num_threads = get_num_threads();
+
+#pragma omp parallel num_threads(num_threads)
+        {
+            const int team_size = omp_get_num_threads();
+            for (int t = omp_get_thread_num(); t < num_threads;
+                 t += team_size) {
+                if (team_size == num_threads) {
+                    pin(t);
+                }
+                if (m_patch_order.empty()) {
+                    const uint32_t end = std::min(thread_end(t), num_scheduled);
+                    for (uint32_t p = thread_begin(t); p < end; ++p) {
+                        func(p);
+                    }
+                } else {
+                    for (uint32_t i = thread_begin(t); i < thread_end(t);
+                         ++i) {
+                        const uint32_t p = m_patch_order[i];
+                        if (p < num_patches) {
+                            func(p);
+                        }
+                    }
+                }
+            }
+
+#pragma omp for
+            for (int p = static_cast<int>(num_scheduled);
+                 p < static_cast<int>(num_patches);
+                 ++p) {
+                func(static_cast<uint32_t>(p));
+            }
+        }
+    }
+
+   private:
+    static uint64_t next_epoch()
+    {
+        static std::atomic<uint64_t> s_epoch(0);
+        return ++s_epoch;
+    }
+
+    // pin the calling thread to the CPUs of its NUMA domain. Done once per
+    // thread per schedule. The master thread of the team is the user's thread
+    // and is left as is
+    void pin(const int t) const
+    {
+#ifdef __linux__
+        if (!m_policy.pin_threads || omp_get_thread_num() == 0) {
+            return;
+        }
+        thread_local uint64_t t_pinned_epoch = 0;
+        if (t_pinned_epoch == m_epoch) {
+            return;
+        }
+        t_pinned_epoch = m_epoch;
+
+        const std::vector<int>& cpus =
+            NumaTopology::instance().node_cpus[m_thread_node[t]];
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int c : cpus) {
+            CPU_SET(c, &set);
+        }
+        if (sched_setaffinity(0, sizeof(cpu_set_t), &set) != 0) {
+            RXMESH_WARN(
+                "HostPatchSchedule::pin() can not pin thread {} to NUMA node "
+                "{}",
+                t,
+                m_thread_node[t]);
+        }
+#endif
+    }
+
+    HostExecutionPolicy   m_policy;
+    uint64_t              m_epoch;
+    std::vector<uint32_t> m_thread_offset;
+    std::vector<uint32_t> m_thread_node;
+    std::vector<int>      m_patch_thread;
+    std::vector<uint32_t> m_patch_order;
+};
+}  // namespace rxmesh
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+#include "rxmesh/context.h"
+#include "rxmesh/handle.h"
+#include "rxmesh/host_schedule.h"
+#include "rxmesh/patch_info.h"
+#include "rxmesh/util/log.h"
+#include "rxmesh/util/macros.h"
+
+namespace rxmesh {
+
+/**
+ * @brief host tables that map the mesh elements of type HandleT between
+ * their handle, their linear id (see RXMeshStatic::linear_id()), and their
+ * global id (see RXMeshStatic::map_to_global()) with a single load. Handles
+ * of not-owned elements map to the linear id of their owner. The accessors do
+ * not validate their input and are meant for hot host loops (export, import,
+ * matrix assembly). The tables are built once in parallel over patches
+ */
+template <typename HandleT>
+class IndexMap
+{
+   public:
+    using LocalT = typename HandleT::LocalT;
+
+    IndexMap() : m_built(false), m_row_ordered(false)
+    {
+    }
+
+    /**
+     * @brief build the tables
+     * @param num_patches number of patches
+     * @param patches_info the host patches
+     * @param prefix the prefix sum of the number of owned elements per patch
+     * @param ltog the per-patch local to global map. Elements of patches not
+     * covered by ltog get INVALID32 global id
+     * @param context the mesh context used to find the owner of not-owned
+     * elements
+     * @param schedule the host patch schedule
+     */
+    void build(const uint32_t                            num_patches,
+               const PatchInfo*                          patches_info,
+               const uint32_t*                           prefix,
+               const std::vector<std::vector<uint32_t>>& ltog,
+               const Context&                            context,
+               const HostPatchSchedule&                  schedule)
+    {
+        const uint32_t num_elements = prefix[num_patches];
+
+        m_patch_offset.resize(num_patches + 1);
+        m_patch_offset[0] = 0;
+        for (uint32_t p = 0; p < num_patches; ++p) {
+            m_patch_offset[p + 1] =
+                m_patch_offset[p] +
+                patches_info[p].get_num_elements<HandleT>()[0];
+        }
+
+        m_local_to_linear.assign(m_patch_offset.back(), INVALID32);
+        m_linear_to_handle.resize(num_elements);
+        m_linear_to_global.assign(num_elements, INVALID32);
+        m_global_to_linear.assign(num_elements, INVALID32);
+
+        // owned elements are ranked in local order
+        m_row_ordered.store(true, std::memory_order_relaxed);
+        schedule.run(num_patches, [&](uint32_t p) {
+            const PatchInfo& pi = patches_info[p];
+
+            const uint16_t  size        = pi.get_num_elements<HandleT>()[0];
+            const uint32_t* owned_mask  = pi.get_owned_mask<HandleT>();
+            const uint32_t* active_mask = pi.get_active_mask<HandleT>();
+            const bool      has_ltog    = p < ltog.size();
+
+            uint32_t linear   = prefix[p];
+            bool     in_owned = true;
+            for (uint16_t l = 0; l < size; ++l) {
+                const bool owned = detail::is_owned(l, owned_mask) &&
+                                   !detail::is_deleted(l, active_mask);
+                if (owned && !in_owned) {
+                    m_row_ordered.store(false, std::memory_order_relaxed);
+                }
+                in_owned = owned;
+                if (!owned) {
+                    continue;
+                }
+                m_local_to_linear[m_patch_offset[p] + l] = linear;
+                m_linear_to_handle[linear] = HandleT(p, LocalT(l));
+
+                if (has_ltog && l < ltog[p].size()) {
+                    const uint32_t global = ltog[p][l];
+                    m_linear_to_global[linear] = global;
+                    if (global < num_elements) {
+                        m_global_to_linear[global] = linear;
+                    }
+                }
+                linear++;
+            }
+        });
+
+        // not-owned elements take the linear id of their owner
+        schedule.run(num_patches, [&](uint32_t p) {
+            const PatchInfo& pi = patches_info[p];
+
+            const uint16_t  size        = pi.get_num_elements<HandleT>()[0];
+            const uint32_t* owned_mask  = pi.get_owned_mask<HandleT>();
+            const uint32_t* active_mask = pi.get_active_mask<HandleT>();
+
+            for (uint16_t l = 0; l < size; ++l) {
+                if (detail::is_owned(l, owned_mask) ||
+                    detail::is_deleted(l, active_mask)) {
+                    continue;
+                }
+                const HandleT owner = context.get_owner_handle(
+                    HandleT(p, LocalT(l)), patches_info);
+                m_local_to_linear[m_patch_offset[p] + l] =
+                    m_local_to_linear[m_patch_offset[owner.patch_id()] +
+                                      owner.local_id()];
+            }
+        });
+
+        m_built.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief release the tables. They are rebuilt on the next request
+     */
+    void clear()
+    {
+        m_patch_offset.clear();
+        m_local_to_linear.clear();
+        m_linear_to_handle.clear();
+        m_linear_to_global.clear();
+        m_global_to_linear.clear();
+        m_row_ordered.store(false, std::memory_order_relaxed);
+        m_built.store(false, std::memory_order_release);
+    }
+
+    bool is_built() const
+    {
+        return m_built.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief true if in every patch the owned elements are numbered first and
+     * none of them is deleted, i.e., the linear id of an element is its patch
+     * prefix plus its local id (see RXMeshStatic::is_row_ordered())
+     */
+    bool is_row_ordered() const
+    {
+        return m_row_ordered.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief number of (owned) elements
+     */
+    uint32_t size() const
+    {
+        return static_cast<uint32_t>(m_linear_to_handle.size());
+    }
+
+    /**
+     * @brief the linear id of a handle (owned or not)
+     */
+    uint32_t linear_id(const HandleT handle) const
+    {
+        return m_local_to_linear[m_patch_offset[handle.patch_id()] +
+                                 handle.local_id()];
+    }
+
+    /**
+     * @brief the owned handle with a linear id
+     */
+    HandleT handle(const uint32_t linear) const
+    {
+        return m_linear_to_handle[linear];
+    }
+
+    /**
+     * @brief the global id of the element with a linear id
+     */
+    uint32_t global_id(const uint32_t linear) const
+    {
+        return m_linear_to_global[linear];
+    }
+
+    /**
+     * @brief the linear id of the element with a global id
+     */
+    uint32_t linear_from_global(const uint32_t global) const
+    {
+        return m_global_to_linear[global];
+    }
+
+    /**
+     * @brief the offset of every patch in local_to_linear() (#patches + 1)
+     */
+    const std::vector<uint32_t>& patch_offset() const
+    {
+        return m_patch_offset;
+    }
+
+    /**
+     * @brief the linear id of every local element of every patch, indexed by
+     * patch_offset()[p] + local id
+     */
+    const std::vector<uint32_t>& local_to_linear() const
+    {
+        return m_local_to_linear;
+    }
+
+    /**
+     * @brief the memory used by the tables
+     */
+    size_t bytes() const
+    {
+        return sizeof(uint32_t) *
+                   (m_patch_offset.size() + m_local_to_linear.size() +
+                    m_linear_to_global.size() + m_global_to_linear.size()) +
+               sizeof(HandleT) * m_linear_to_handle.size();
+    }
+
+   private:
+    std::atomic<bool>     m_built;
+    std::atomic<bool>     m_row_ordered;
+    std::vector<uint32_t> m_patch_offset;
+    std::vector<uint32_t> m_local_to_linear;
+    std::vector<HandleT>  m_linear_to_handle;
+    std::vector<uint32_t> m_linear_to_global;
+    std::vector<uint32_t> m_global_to_linear;
+};
+
+}  // namespace rxmesh
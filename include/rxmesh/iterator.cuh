@@ -1,5 +1,6 @@
 #pragma once
 #include <stdint.h>
+#include <type_traits>
 #include "rxmesh/context.h"
 #include "rxmesh/handle.h"
 #include "rxmesh/patch_stash.cuh"
@@ -70,6 +71,38 @@ struct Iterator
         set(local_id, offset_size, patch_offset);
     }
 
+    /**
+     * @brief iterator over the output of a fixed-arity query (see
+     * op_fixed_size()) where the number of outputs per source element is a
+     * compile-time constant and no offset array is read
+     */
+    template <uint16_t fixedSize>
+    __device__ Iterator(const Context&     context,
+                        const uint16_t     local_id,
+                        const LocalT*      patch_output,
+                        std::integral_constant<uint16_t, fixedSize>,
+                        const uint32_t     patch_id,
+                        const uint32_t*    output_owned_bitmask,
+                        const LPHashTable& output_lp_hashtable,
+                        const LPPair*      s_table,
+                        const PatchStash   patch_stash,
+                        int                shift = 0)
+        : m_context(context),
+          m_local_id(local_id),
+          m_patch_output(patch_output),
+          m_patch_id(patch_id),
+          m_output_owned_bitmask(output_owned_bitmask),
+          m_output_lp_hashtable(output_lp_hashtable),
+          m_s_table(s_table),
+          m_patch_stash(patch_stash),
+          m_begin(local_id * fixedSize),
+          m_end(local_id * fixedSize + fixedSize),
+          m_current(0),
+          m_shift(shift)
+    {
+        static_assert(fixedSize > 0, "fixedSize should be positive");
+    }
+
     Iterator(const Iterator& orig) = default;
 
 
@@ -155,4 +188,48 @@ using EdgeIterator   = Iterator<EdgeHandle>;
 using DEdgeIterator  = Iterator<DEdgeHandle>;
 using FaceIterator   = Iterator<FaceHandle>;
 
+/**
+ * @brief iterator over the output of a fixed-arity query (see op_fixed_size())
+ * whose size is part of the type. Declaring the iterator of a query lambda
+ * with this type (e.g., FVIterator for Op::FV) lets loops over the output use
+ * the compile-time extent, e.g., to unroll or to fill fixed-size arrays. The
+ * extent is checked against the query op when the iterator is built
+ */
+template <typename HandleT, uint16_t N>
+struct FixedIterator : public Iterator<HandleT>
+{
+    static_assert(N > 0, "FixedIterator extent should be positive");
+
+    static constexpr uint16_t extent = N;
+
+    using Iterator<HandleT>::Iterator;
+
+    __device__ __host__ static constexpr uint16_t size()
+    {
+        return N;
+    }
+};
+
+using EVIterator        = FixedIterator<VertexHandle, 2>;
+using FVIterator        = FixedIterator<VertexHandle, 3>;
+using FEIterator        = FixedIterator<EdgeHandle, 3>;
+using EVDiamondIterator = FixedIterator<VertexHandle, 4>;
+
+namespace detail {
+/**
+ * @brief the compile-time extent of an iterator type or 0 if its size is only
+ * known at runtime
+ */
+template <typename IteratorT, typename = void>
+struct iterator_extent : std::integral_constant<uint16_t, 0>
+{
+};
+
+template <typename IteratorT>
+struct iterator_extent<IteratorT, std::void_t<decltype(IteratorT::extent)>>
+    : std::integral_constant<uint16_t, IteratorT::extent>
+{
+};
+}  // namespace detail
+
 }  // namespace rxmesh
\ No newline at end of file
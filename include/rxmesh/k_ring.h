@@ -0,0 +1,457 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <omp.h>
+
+#include "rxmesh/handle.h"
+#include "rxmesh/matrix/sparse_pattern.h"
+#include "rxmesh/patch_info.h"
+#include "rxmesh/types.h"
+#include "rxmesh/util/bitmask_util.h"
+#include "rxmesh/util/host_memory.h"
+#include "rxmesh/util/instrument.h"
+#include "rxmesh/util/log.h"
+#include "rxmesh/util/macros.h"
+
+namespace rxmesh {
+
+/**
+ * @brief the k-ring neighborhood of every mesh element of type HandleT stored
+ * as CSR, i.e., the elements reachable by at most k steps of Op::VV (vertices),
+ * Op::EE (edges), or Op::FF (faces), excluding the element itself. The
+ * neighbors of an element are listed in breadth-first order so the first
+ * entries are its 1-ring, followed by the 2-ring, and so on. Memory is
+ * proportional to the sum of the actual ring sizes.
+ *
+ * The rings are built on the host in parallel over patches. The 1-ring of the
+ * owned elements is complete within their patch thanks to the ribbon, so the
+ * search crosses patch boundaries by following the owner of every ribbon
+ * element. Visited elements are tracked with a per-thread bitmask that is
+ * cleared by walking the ring, so the cost is linear in the ring size.
+ * KRing is a lightweight object that can be captured by value in host and
+ * device lambdas. The device copy is uploaded with move(HOST, DEVICE).
+ * Memory is freed explicitly with release()
+ * @tparam HandleT VertexHandle, EdgeHandle, or FaceHandle
+ */
+template <typename HandleT>
+class KRing
+{
+    static_assert(std::is_same_v<HandleT, VertexHandle> ||
+                      std::is_same_v<HandleT, EdgeHandle> ||
+                      std::is_same_v<HandleT, FaceHandle>,
+                  "KRing: HandleT should be VertexHandle, EdgeHandle, or "
+                  "FaceHandle");
+
+   public:
+    using HandleType = HandleT;
+    using LocalT     = typename HandleT::LocalT;
+
+    /**
+     * @brief the query op that defines the 1-ring
+     */
+    static constexpr Op ring_op()
+    {
+        if constexpr (std::is_same_v<HandleT, VertexHandle>) {
+            return Op::VV;
+        }
+        if constexpr (std::is_same_v<HandleT, EdgeHandle>) {
+            return Op::EE;
+        }
+        return Op::FF;
+    }
+
+    /**
+     * @brief Default constructor which initializes all pointers to nullptr
+     */
+    KRing()
+        : m_rings(0),
+          m_num_patches(0),
+          m_num_rows(0),
+          m_num_locals(0),
+          m_nnz(0),
+          m_max_size(0),
+          m_allocated(LOCATION_NONE),
+          m_h_patch_offset(nullptr),
+          m_h_local_to_row(nullptr),
+          m_h_offset(nullptr),
+          m_h_value(nullptr),
+          m_d_patch_offset(nullptr),
+          m_d_local_to_row(nullptr),
+          m_d_offset(nullptr),
+          m_d_value(nullptr)
+    {
+    }
+
+    /**
+     * @brief build the k-ring of every element on the host and optionally
+     * upload it to the device
+     * @param rx the input mesh (RXMeshStatic or RXMeshDynamic after
+     * update_host())
+     * @param rings the number of rings (k). Should be at least 1
+     * @param location where the result should be available
+     */
+    template <typename MeshT>
+    KRing(const MeshT& rx, const uint32_t rings, locationT location)
+        : KRing()
+    {
+        RXMESH_ZONE("KRing::build");
+
+        if (rings == 0) {
+            RXMESH_ERROR("KRing::KRing() rings should be at least 1");
+            return;
+        }
+
+        m_rings       = rings;
+        m_num_patches = rx.get_num_patches();
+
+        build(rx);
+
+        if ((location & DEVICE) == DEVICE) {
+            move(HOST, DEVICE);
+        }
+    }
+
+    KRing(const KRing& rhs) = default;
+
+    /**
+     * @brief the number of rings (k)
+     */
+    __host__ __device__ __forceinline__ uint32_t get_rings() const
+    {
+        return m_rings;
+    }
+
+    /**
+     * @brief the number of (owned) elements i.e., number of CSR rows
+     */
+    __host__ __device__ __forceinline__ uint32_t get_num_rows() const
+    {
+        return m_num_rows;
+    }
+
+    /**
+     * @brief total number of stored neighbors
+     */
+    __host__ __device__ __forceinline__ uint32_t get_nnz() const
+    {
+        return m_nnz;
+    }
+
+    /**
+     * @brief the size of the largest k-ring
+     */
+    __host__ __device__ __forceinline__ uint32_t get_max_size() const
+    {
+        return m_max_size;
+    }
+
+    /**
+     * @brief the CSR row of an element, i.e., its linear id. Works for owned
+     * and not-owned handles
+     */
+    __host__ __device__ __forceinline__ uint32_t row(const HandleT handle) const
+    {
+        const uint32_t p = handle.patch_id();
+        const uint16_t l = handle.local_id();
+        assert(p < m_num_patches);
+#ifdef __CUDA_ARCH__
+        return m_d_local_to_row[m_d_patch_offset[p] + l];
+#else
+        return m_h_local_to_row[m_h_patch_offset[p] + l];
+#endif
+    }
+
+    /**
+     * @brief the number of elements in the k-ring of an element
+     */
+    __host__ __device__ __forceinline__ uint32_t
+    size(const HandleT handle) const
+    {
+        const uint32_t r = row(handle);
+#ifdef __CUDA_ARCH__
+        return m_d_offset[r + 1] - m_d_offset[r];
+#else
+        return m_h_offset[r + 1] - m_h_offset[r];
+#endif
+    }
+
+    /**
+     * @brief the i-th element in the k-ring of an element. The returned
+     * handle is the owned handle of the neighbor
+     * @param handle the input element
+     * @param i the neighbor index. Should be less than size(handle)
+     */
+    __host__ __device__ __forceinline__ HandleT
+    operator()(const HandleT handle, const uint32_t i) const
+    {
+        assert(i < size(handle));
+        const uint32_t r = row(handle);
+#ifdef __CUDA_ARCH__
+        return m_d_value[m_d_offset[r] + i];
+#else
+        return m_h_value[m_h_offset[r] + i];
+#endif
+    }
+
+    /**
+     * @brief check if the k-ring is allocated on host
+     */
+    bool is_host_allocated() const
+    {
+        return (m_allocated & HOST) == HOST;
+    }
+
+    /**
+     * @brief check if the k-ring is allocated on device
+     */
+    bool is_device_allocated() const
+    {
+        return (m_allocated & DEVICE) == DEVICE;
+    }
+
+    /**
+     * @brief the memory used on one location (host or device)
+     */
+    size_t bytes() const
+    {
+        return sizeof(uint32_t) *
+                   (size_t(m_num_patches + 1) + m_num_locals + m_num_rows + 1) +
+               sizeof(HandleT) * size_t(m_nnz);
+    }
+
+    /**
+     * @brief copy the k-ring from the host to the device. Only HOST to DEVICE
+     * is supported since the k-ring is not modified on the device
+     * @param source the source location
+     * @param target the destination location
+     */
+    void move(locationT source, locationT target)
+    {
+        if (source != HOST || target != DEVICE) {
+            RXMESH_ERROR(
+                "KRing::move() only HOST to DEVICE is supported. Got {} to {}",
+                location_to_string(source),
+                location_to_string(target));
+            return;
+        }
+        if (!is_host_allocated()) {
+            RXMESH_ERROR("KRing::move() the k-ring is not allocated on host");
+            return;
+        }
+
+        if (!is_device_allocated()) {
+            CUDA_ERROR(cudaMalloc((void**)&m_d_patch_offset,
+                                  (m_num_patches + 1) * sizeof(uint32_t)));
+            CUDA_ERROR(cudaMalloc((void**)&m_d_local_to_row,
+                                  m_num_locals * sizeof(uint32_t)));
+            CUDA_ERROR(cudaMalloc((void**)&m_d_offset,
+                                  (m_num_rows + 1) * sizeof(uint32_t)));
+            CUDA_ERROR(
+                cudaMalloc((void**)&m_d_value, m_nnz * sizeof(HandleT)));
+            m_allocated = m_allocated | DEVICE;
+        }
+
+        CUDA_ERROR(cudaMemcpy(m_d_patch_offset,
+                              m_h_patch_offset,
+                              (m_num_patches + 1) * sizeof(uint32_t),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_local_to_row,
+                              m_h_local_to_row,
+                              m_num_locals * sizeof(uint32_t),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_offset,
+                              m_h_offset,
+                              (m_num_rows + 1) * sizeof(uint32_t),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_value,
+                              m_h_value,
+                              m_nnz * sizeof(HandleT),
+                              cudaMemcpyHostToDevice));
+    }
+
+    /**
+     * @brief Release allocated memory in certain location
+     * @param location where memory will be released
+     */
+    void release(locationT location = LOCATION_ALL)
+    {
+        if (((location & HOST) == HOST) && is_host_allocated()) {
+            host_free(m_h_patch_offset);
+            host_free(m_h_local_to_row);
+            host_free(m_h_offset);
+            host_free(m_h_value);
+            m_h_patch_offset = nullptr;
+            m_h_local_to_row = nullptr;
+            m_h_offset       = nullptr;
+            m_h_value        = nullptr;
+            m_allocated      = m_allocated & (~HOST);
+        }
+
+        if (((location & DEVICE) == DEVICE) && is_device_allocated()) {
+            GPU_FREE(m_d_patch_offset);
+            GPU_FREE(m_d_local_to_row);
+            GPU_FREE(m_d_offset);
+            GPU_FREE(m_d_value);
+            m_allocated = m_allocated & (~DEVICE);
+        }
+    }
+
+   private:
+    /**
+     * @brief breadth-first search from row r over the 1-ring CSR. The visited
+     * rows are appended to queue (without r) and their bits are cleared
+     * before returning. The bitmask is indexed by linear id which does not
+     * fit in the 16-bit local id taken by detail::bitmask_set_bit()
+     */
+    void search(const SparsePattern&   one_ring,
+                const uint32_t         r,
+                std::vector<uint32_t>& queue,
+                std::vector<uint32_t>& visited) const
+    {
+        using IndexT = SparsePattern::IndexT;
+
+        auto flip = [&](const uint32_t c) {
+            visited[c / 32] ^= (uint32_t(1) << (c % 32));
+        };
+
+        auto expand = [&](const uint32_t u) {
+            for (IndexT i = one_ring.row_ptr[u]; i < one_ring.row_ptr[u + 1];
+                 ++i) {
+                const uint32_t c = uint32_t(one_ring.col_idx[i]);
+                if (!detail::is_set_bit(c, visited.data())) {
+                    flip(c);
+                    queue.push_back(c);
+                }
+            }
+        };
+
+        queue.clear();
+        flip(r);
+        expand(r);
+
+        // the frontier of every ring is the range added by the previous one
+        size_t begin = 0;
+        for (uint32_t ring = 1; ring < m_rings && begin < queue.size();
+             ++ring) {
+            const size_t end = queue.size();
+            for (size_t f = begin; f < end; ++f) {
+                expand(queue[f]);
+            }
+            begin = end;
+        }
+
+        flip(r);
+        for (const uint32_t c : queue) {
+            flip(c);
+        }
+    }
+
+    template <typename MeshT>
+    void build(const MeshT& rx)
+    {
+        const auto& map = rx.template get_index_map<HandleT>();
+
+        SparsePatternDesc desc;
+        desc.op        = ring_op();
+        desc.rings     = 1;
+        desc.diagonal  = false;
+        desc.replicate = 1;
+        std::shared_ptr<const SparsePattern> one_ring =
+            rx.get_sparse_pattern(desc);
+
+        m_num_rows   = uint32_t(one_ring->num_rows);
+        m_num_locals = map.patch_offset().back();
+
+        // the row of every local element is its linear id
+        m_h_patch_offset =
+            host_malloc<uint32_t>(m_num_patches + 1, HostMemTag::Query);
+        m_h_local_to_row =
+            host_malloc<uint32_t>(m_num_locals, HostMemTag::Query);
+        m_h_offset = host_malloc<uint32_t>(m_num_rows + 1, HostMemTag::Query);
+        std::memcpy(m_h_patch_offset,
+                    map.patch_offset().data(),
+                    (m_num_patches + 1) * sizeof(uint32_t));
+        std::memcpy(m_h_local_to_row,
+                    map.local_to_linear().data(),
+                    m_num_locals * sizeof(uint32_t));
+        m_h_offset[0] = 0;
+
+        const uint32_t num_words = DIVIDE_UP(m_num_rows, 32);
+        const int      num_threads =
+            std::max(omp_get_max_threads(),
+                     rx.get_host_schedule().get_num_threads());
+        std::vector<std::vector<uint32_t>> visited(num_threads);
+        std::vector<std::vector<uint32_t>> queue(num_threads);
+
+        // rows of a patch are contiguous in linear order so every thread
+        // walks a contiguous range of the output
+        auto run_pass = [&](const int pass) {
+            rx.get_host_schedule().run(m_num_patches, [&](const uint32_t p) {
+                const int t = omp_get_thread_num();
+                if (visited[t].size() != num_words) {
+                    visited[t].assign(num_words, 0);
+                }
+                const PatchInfo& pi    = rx.get_patch(p);
+                const uint32_t   begin = m_h_patch_offset[p];
+                const uint32_t   end   = m_h_patch_offset[p + 1];
+                for (uint32_t l = begin; l < end; ++l) {
+                    const LocalT local(l - begin);
+                    if (pi.is_deleted(local) || !pi.is_owned(local)) {
+                        continue;
+                    }
+                    const uint32_t r = m_h_local_to_row[l];
+                    search(*one_ring, r, queue[t], visited[t]);
+                    if (pass == 0) {
+                        m_h_offset[r + 1] = uint32_t(queue[t].size());
+                    } else {
+                        HandleT* out = m_h_value + m_h_offset[r];
+                        for (const uint32_t c : queue[t]) {
+                            *out++ = map.handle(c);
+                        }
+                    }
+                }
+            });
+        };
+
+        run_pass(0);
+        m_max_size = 0;
+        for (uint32_t r = 0; r < m_num_rows; ++r) {
+            m_max_size = std::max(m_max_size, m_h_offset[r + 1]);
+            m_h_offset[r + 1] += m_h_offset[r];
+        }
+        m_nnz     = m_h_offset[m_num_rows];
+        m_h_value =
+            host_malloc<HandleT>(std::max<size_t>(1, m_nnz), HostMemTag::Query);
+        run_pass(1);
+
+        m_allocated = m_allocated | HOST;
+    }
+
+    uint32_t  m_rings;
+    uint32_t  m_num_patches;
+    uint32_t  m_num_rows;
+    uint32_t  m_num_locals;
+    uint32_t  m_nnz;
+    uint32_t  m_max_size;
+    locationT m_allocated;
+    uint32_t* m_h_patch_offset;
+    uint32_t* m_h_local_to_row;
+    uint32_t* m_h_offset;
+    HandleT*  m_h_value;
+    uint32_t* m_d_patch_offset;
+    uint32_t* m_d_local_to_row;
+    uint32_t* m_d_offset;
+    HandleT*  m_d_value;
+};
+
+using VertexKRing = KRing<VertexHandle>;
+using EdgeKRing   = KRing<EdgeHandle>;
+using FaceKRing   = KRing<FaceHandle>;
+
+}  // namespace rxmesh
@@ -21,6 +21,57 @@ namespace rxmesh {
 
 namespace detail {
 
+/**
+ * @brief construct the iterator over the output of the query op for one
+ * source element. Fixed-arity queries (see op_fixed_size()) get their size at
+ * compile time and skip the offset array
+ */
+template <Op op, typename IteratorT>
+__device__ __forceinline__ IteratorT
+make_query_iterator(const Context&     context,
+                    const uint16_t     local_id,
+                    uint16_t*          s_output_value,
+                    const uint16_t*    s_output_offset,
+                    const uint32_t     patch_id,
+                    const uint32_t*    s_output_owned_bitmask,
+                    const LPHashTable& output_lp_hashtable,
+                    const LPPair*      s_table,
+                    const PatchStash   patch_stash)
+{
+    using LocalT = typename IteratorT::LocalT;
+
+    constexpr uint16_t fixed_size = op_fixed_size(op);
+
+    static_assert(iterator_extent<IteratorT>::value == 0 ||
+                      iterator_extent<IteratorT>::value == fixed_size,
+                  "make_query_iterator() the extent of the iterator does not "
+                  "match the output size of the query op");
+
+    if constexpr (fixed_size > 0) {
+        return IteratorT(context,
+                         local_id,
+                         reinterpret_cast<LocalT*>(s_output_value),
+                         std::integral_constant<uint16_t, fixed_size>{},
+                         patch_id,
+                         s_output_owned_bitmask,
+                         output_lp_hashtable,
+                         s_table,
+                         patch_stash,
+                         int(op == Op::FE));
+    } else {
+        return IteratorT(context,
+                         local_id,
+                         reinterpret_cast<LocalT*>(s_output_value),
+                         s_output_offset,
+                         0,
+                         patch_id,
+                         s_output_owned_bitmask,
+                         output_lp_hashtable,
+                         s_table,
+                         patch_stash);
+    }
+}
+
 /**
  * query_block_dispatcher()
  */
@@ -232,12 +283,6 @@ __device__ __inline__ void query_block_dispatcher(
 
     // Call compute on the output in shared memory by looping over all
     // source elements in this patch.
-    constexpr uint32_t fixed_offset =
-        ((op == Op::EV) ? 2 :
-                          ((op == Op::FV || op == Op::FE) ?
-                               3 :
-                               ((op == Op::EVDiamond) ? 4 : 0)));
-
     for (uint16_t local_id = threadIdx.x; local_id < num_src_in_patch;
          local_id += blockThreads) {
 
@@ -246,17 +291,16 @@ __device__ __inline__ void query_block_dispatcher(
         if (is_set_bit(local_id, s_participant_bitmask)) {
 
             ComputeHandleT   handle(patch_id, local_id);
-            ComputeIteratorT iter(context,
-                                  local_id,
-                                  reinterpret_cast<LocalT*>(s_output_value),
-                                  s_output_offset,
-                                  fixed_offset,
-                                  patch_id,
-                                  s_output_owned_bitmask,
-                                  output_lp_hashtable,
-                                  s_table,
-                                  context.m_patches_info[patch_id].patch_stash,
-                                  int(op == Op::FE));
+            ComputeIteratorT iter = make_query_iterator<op, ComputeIteratorT>(
+                context,
+                local_id,
+                s_output_value,
+                s_output_offset,
+                patch_id,
+                s_output_owned_bitmask,
+                output_lp_hashtable,
+                s_table,
+                context.m_patches_info[patch_id].patch_stash);
 
             compute_op(handle, iter);
         }
@@ -537,25 +581,17 @@ __device__ __inline__ void higher_query_block_dispatcher(
 
         if (pl.first == patch_id) {
 
-            constexpr uint32_t fixed_offset =
-                ((op == Op::EV) ? 2 :
-                                  ((op == Op::FV || op == Op::FE) ?
-                                       3 :
-                                       ((op == Op::EVDiamond) ? 4 : 0)));
-
-            ComputeIteratorT iter(
-                context,
-                pl.second,
-                reinterpret_cast<typename ComputeIteratorT::LocalT*>(
-                    s_output_value),
-                s_output_offset,
-                fixed_offset,
-                patch_id,
-                s_output_owned_bitmask,
-                output_lp_hashtable,
-                s_table,
-                context.m_patches_info[patch_id].patch_stash,
-                int(op == Op::FE));
+            ComputeIteratorT iter =
+                detail::make_query_iterator<op, ComputeIteratorT>(
+                    context,
+                    pl.second,
+                    s_output_value,
+                    s_output_offset,
+                    patch_id,
+                    s_output_owned_bitmask,
+                    output_lp_hashtable,
+                    s_table,
+                    context.m_patches_info[patch_id].patch_stash);
 
             compute_op(src_id, iter);
         }
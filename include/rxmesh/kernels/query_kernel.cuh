@@ -9,11 +9,16 @@
 
 namespace rxmesh {
 namespace detail {
-template <uint32_t blockThreads, Op op, typename LambdaT>
-__global__ static void query_kernel(const Context context,
-                                    const bool    oriented,
-                                    LambdaT       user_lambda)
+/**
+ * @brief kernel that runs a single query. Every (op, oriented) pair is its own
+ * specialization so the orientation branches are resolved at compile time
+ */
+template <uint32_t blockThreads, Op op, bool oriented, typename LambdaT>
+__global__ static void query_kernel(const Context context, LambdaT user_lambda)
 {
+    static_assert(!oriented || op_is_orientable(op),
+                  "query_kernel() op does not have an oriented variant");
+
     auto block = cooperative_groups::this_thread_block();
 
     Query<blockThreads> query(context);
@@ -23,6 +23,7 @@
 
 #include "rxmesh/hash_functions.cuh"
 #include "rxmesh/lp_pair.cuh"
+#include "rxmesh/util/host_memory.h"
 #include "rxmesh/util/macros.h"
 #include "rxmesh/util/prime_numbers.h"
 
@@ -88,8 +89,8 @@ struct LPHashTable
                                   stash_size * sizeof(LPPair),
                                   cudaMemcpyHostToDevice));
         } else {
-            m_table = (LPPair*)malloc(num_bytes());
-            m_stash = (LPPair*)malloc(stash_size * sizeof(LPPair));
+            m_table = host_malloc<LPPair>(m_capacity, HostMemTag::Topology);
+            m_stash = host_malloc<LPPair>(stash_size, HostMemTag::Topology);
             for (uint8_t i = 0; i < stash_size; ++i) {
                 m_stash[i] = LPPair::sentinel_pair();
             }
@@ -157,8 +158,8 @@ struct LPHashTable
             GPU_FREE(m_table);
             GPU_FREE(m_stash);
         } else {
-            ::free(m_table);
-            ::free(m_stash);
+            host_free(m_table);
+            host_free(m_stash);
         }
     }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <vector>
 #include "cublas_v2.h"
 #include "cusparse.h"
@@ -7,12 +8,26 @@
 #include "rxmesh/context.h"
 #include "rxmesh/rxmesh.h"
 #include "rxmesh/types.h"
+#include "rxmesh/util/host_memory.h"
 
 #include "rxmesh/util/meta.h"
 
 #include <Eigen/Dense>
 
 namespace rxmesh {
+
+namespace detail {
+/**
+ * @brief a new id for every row order computed by SparseMatrix::reorder() so
+ * dense matrices can tell which order they are in
+ */
+inline uint64_t next_row_order_id()
+{
+    static std::atomic<uint64_t> id{0};
+    return ++id;
+}
+}  // namespace detail
+
 /**
  * @brief dense matrix use for device and host, inside is a array.
  * The dense matrix is initialized as col major on device.
@@ -34,10 +49,14 @@ struct DenseMatrix
 
     DenseMatrix()
         : m_allocated(LOCATION_NONE),
+          m_view(LOCATION_NONE),
           m_num_rows(0),
           m_num_cols(0),
           m_d_val(nullptr),
-          m_h_val(nullptr)
+          m_h_val(nullptr),
+          m_h_row_order(nullptr),
+          m_d_row_order(nullptr),
+          m_row_order_id(0)
     {
     }
 
@@ -52,23 +71,65 @@ struct DenseMatrix
           m_dendescr(NULL),
           m_h_val(nullptr),
           m_d_val(nullptr),
-          m_cublas_handle(nullptr)
+          m_cublas_handle(nullptr),
+          m_allocated(LOCATION_NONE),
+          m_view(LOCATION_NONE),
+          m_h_row_order(nullptr),
+          m_d_row_order(nullptr),
+          m_row_order_id(0)
     {
 
 
         allocate(location);
 
-        CUSPARSE_ERROR(cusparseCreateDnMat(&m_dendescr,
-                                           m_num_rows,
-                                           m_num_cols,
-                                           m_num_rows,  // leading dim
-                                           m_d_val,
-                                           cuda_type<T>(),
-                                           CUSPARSE_ORDER_COL));
+        init_handles();
+    }
 
-        CUBLAS_ERROR(cublasCreate(&m_cublas_handle));
-        CUBLAS_ERROR(
-            cublasSetPointerMode(m_cublas_handle, CUBLAS_POINTER_MODE_HOST));
+    /**
+     * @brief a dense matrix that aliases existing memory (e.g., the storage of
+     * an attribute) instead of allocating its own. The aliased memory should
+     * outlive this matrix and is not freed by release()
+     * @param h_val the host memory with num_rows * num_cols entries in the
+     * matrix order or nullptr if the matrix is not on the host
+     * @param d_val the device memory with num_rows * num_cols entries in the
+     * matrix order or nullptr if the matrix is not on the device
+     */
+    DenseMatrix(const RXMesh& rx,
+                IndexT        num_rows,
+                IndexT        num_cols,
+                T*            h_val,
+                T*            d_val)
+        : m_context(rx.get_context()),
+          m_num_rows(num_rows),
+          m_num_cols(num_cols),
+          m_dendescr(NULL),
+          m_h_val(h_val),
+          m_d_val(d_val),
+          m_cublas_handle(nullptr),
+          m_allocated(LOCATION_NONE),
+          m_view(LOCATION_NONE),
+          m_h_row_order(nullptr),
+          m_d_row_order(nullptr),
+          m_row_order_id(0)
+    {
+        if (m_h_val != nullptr) {
+            m_allocated = m_allocated | HOST;
+        }
+        if (m_d_val != nullptr) {
+            m_allocated = m_allocated | DEVICE;
+        }
+        m_view = m_allocated;
+
+        init_handles();
+    }
+
+    /**
+     * @brief true if the memory on a location is aliased rather than owned by
+     * this matrix
+     */
+    __host__ bool is_view(locationT location = LOCATION_ALL) const
+    {
+        return (m_view & location) == location && location != LOCATION_NONE;
     }
 
     /**
@@ -638,9 +699,29 @@ struct DenseMatrix
             row = m_context.face_prefix()[id.first] + id.second;
         }
 
+#ifdef __CUDA_ARCH__
+        const IndexT* row_order = m_d_row_order;
+#else
+        const IndexT* row_order = m_h_row_order;
+#endif
+        if (row_order != nullptr) {
+            row = row_order[row];
+        }
+
         return row;
     }
 
+    /**
+     * @brief check if the rows are permuted by a reordered SparseMatrix (see
+     * SparseMatrix::reorder()). The handle accessors account for the
+     * permutation while the index accessors and the raw data use the new row
+     * order
+     */
+    __host__ __device__ bool is_reordered() const
+    {
+        return m_h_row_order != nullptr;
+    }
+
     /**
      * @brief return the raw pointer based on the specified location (host vs.
      * device)
@@ -800,6 +881,13 @@ struct DenseMatrix
                 location_to_string(target_flag));
             allocate(target_flag);
         }
+        // the rows are copied in the source order
+        if (source.is_reordered()) {
+            set_row_order(source.m_h_row_order, source.m_row_order_id);
+        } else {
+            release_row_order();
+        }
+
         // 1) copy from HOST to HOST
         if ((source_flag & HOST) == HOST && (target_flag & HOST) == HOST) {
             std::memcpy(m_h_val, source.m_h_val, bytes());
@@ -851,22 +939,86 @@ struct DenseMatrix
     __host__ void release(locationT location = LOCATION_ALL)
     {
         if (((location & HOST) == HOST) && ((m_allocated & HOST) == HOST)) {
-            free(m_h_val);
+            if ((m_view & HOST) != HOST) {
+                host_free(m_h_val);
+            }
             m_h_val     = nullptr;
             m_allocated = m_allocated & (~HOST);
+            m_view      = m_view & (~HOST);
         }
 
         if (((location & DEVICE) == DEVICE) &&
             ((m_allocated & DEVICE) == DEVICE)) {
-            GPU_FREE(m_d_val);
+            if ((m_view & DEVICE) != DEVICE) {
+                GPU_FREE(m_d_val);
+            }
+            m_d_val     = nullptr;
             m_allocated = m_allocated & (~DEVICE);
+            m_view      = m_view & (~DEVICE);
         }
         if ((location & LOCATION_ALL) == LOCATION_ALL) {
             CUSPARSE_ERROR(cusparseDestroyDnMat(m_dendescr));
+            release_row_order();
         }
     }
 
    private:
+    /**
+     * @brief keep a copy of the row order (see SparseMatrix::reorder()) so the
+     * matrix does not depend on the lifetime of the sparse matrix nor on its
+     * later reorderings
+     */
+    void set_row_order(const IndexT* h_order, const uint64_t id)
+    {
+        if (h_order == m_h_row_order) {
+            m_row_order_id = id;
+            return;
+        }
+        if (m_h_row_order == nullptr) {
+            m_h_row_order =
+                host_malloc<IndexT>(m_num_rows, HostMemTag::DenseMatrix);
+            CUDA_ERROR(cudaMalloc((void**)&m_d_row_order,
+                                  m_num_rows * sizeof(IndexT)));
+        }
+        std::copy(h_order, h_order + m_num_rows, m_h_row_order);
+        CUDA_ERROR(cudaMemcpy(m_d_row_order,
+                              m_h_row_order,
+                              m_num_rows * sizeof(IndexT),
+                              cudaMemcpyHostToDevice));
+        m_row_order_id = id;
+    }
+
+    /**
+     * @brief drop the row order, i.e., back to the linear id order
+     */
+    void release_row_order()
+    {
+        if (m_h_row_order != nullptr) {
+            host_free(m_h_row_order);
+            m_h_row_order = nullptr;
+        }
+        GPU_FREE(m_d_row_order);
+        m_row_order_id = 0;
+    }
+
+    /**
+     * @brief create the cuSparse dense matrix descriptor and cuBlas handle
+     */
+    void init_handles()
+    {
+        CUSPARSE_ERROR(cusparseCreateDnMat(&m_dendescr,
+                                           m_num_rows,
+                                           m_num_cols,
+                                           m_num_rows,  // leading dim
+                                           m_d_val,
+                                           cuda_type<T>(),
+                                           CUSPARSE_ORDER_COL));
+
+        CUBLAS_ERROR(cublasCreate(&m_cublas_handle));
+        CUBLAS_ERROR(
+            cublasSetPointerMode(m_cublas_handle, CUBLAS_POINTER_MODE_HOST));
+    }
+
     /**
      * @brief allocate the data on host or device
      */
@@ -875,7 +1027,7 @@ struct DenseMatrix
         if ((location & HOST) == HOST) {
             release(HOST);
 
-            m_h_val = static_cast<T*>(malloc(bytes()));
+            m_h_val = host_malloc<T>(rows() * cols(), HostMemTag::DenseMatrix);
 
             m_allocated = m_allocated | HOST;
         }
@@ -908,10 +1060,18 @@ struct DenseMatrix
     cusparseDnMatDescr_t m_dendescr;
     cublasHandle_t       m_cublas_handle;
     locationT            m_allocated;
+    locationT            m_view;
     IndexT               m_num_rows;
     IndexT               m_num_cols;
     T*                   m_d_val;
     T*                   m_h_val;
+
+    // the new row of every linear id (nullptr if not reordered). A copy of
+    // the order of the SparseMatrix that reordered this matrix, identified by
+    // m_row_order_id
+    IndexT*  m_h_row_order;
+    IndexT*  m_d_row_order;
+    uint64_t m_row_order_id;
 };
 
 }  // namespace rxmesh
@@ -0,0 +1,265 @@
+#pragma once
+
+#include <stdint.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rxmesh/matrix/permute_util.h"
+#include "rxmesh/util/log.h"
+
+namespace rxmesh {
+
+/**
+ * @brief process-wide cache of fill-reducing permutations keyed by the hash of
+ * the CSR pattern and the permutation method. Computing a nested dissection
+ * ordering of a large mesh takes seconds while solving with the same pattern
+ * (e.g., in every run of an app on the same mesh) only needs it once. The
+ * cache is always kept in memory. If a folder is set, permutations are also
+ * written to and read from that folder so they persist across runs
+ */
+class PermuteCache
+{
+   public:
+    using IndexT = int;
+
+    static PermuteCache& instance()
+    {
+        static PermuteCache s_instance;
+        return s_instance;
+    }
+
+    /**
+     * @brief enable or disable the cache. Enabled by default
+     */
+    void set_enabled(const bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_enabled = enabled;
+    }
+
+    bool is_enabled() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_enabled;
+    }
+
+    /**
+     * @brief set the folder where the permutations are persisted. An empty
+     * string (the default) keeps the cache in memory only
+     */
+    void set_folder(const std::string& folder)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_folder = folder;
+        if (!m_folder.empty()) {
+            std::error_code ec;
+            std::filesystem::create_directories(m_folder, ec);
+            if (ec) {
+                RXMESH_WARN(
+                    "PermuteCache::set_folder() can not create folder {}. The "
+                    "cache will be in memory only",
+                    m_folder);
+                m_folder.clear();
+            }
+        }
+    }
+
+    std::string get_folder() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_folder;
+    }
+
+    /**
+     * @brief look up the permutation of a pattern. On a hit, the permutation
+     * is copied to perm (of size num_rows) and true is returned
+     * @param pattern_hash the hash of the CSR pattern (see csr_pattern_hash())
+     * @param method the permutation method as an integer
+     * @param num_rows the number of rows of the matrix
+     * @param perm the output permutation
+     */
+    bool find(const uint64_t pattern_hash,
+              const int      method,
+              const IndexT   num_rows,
+              IndexT*        perm)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enabled) {
+            return false;
+        }
+
+        const KeyT key(pattern_hash, method);
+
+        auto it = m_perms.find(key);
+        if (it != m_perms.end() && IndexT(it->second.size()) == num_rows) {
+            std::copy(it->second.begin(), it->second.end(), perm);
+            m_num_hits++;
+            return true;
+        }
+
+        if (!m_folder.empty()) {
+            std::vector<IndexT> loaded;
+            if (read(key, num_rows, loaded)) {
+                std::copy(loaded.begin(), loaded.end(), perm);
+                m_perms[key] = std::move(loaded);
+                m_num_hits++;
+                m_num_disk_hits++;
+                return true;
+            }
+        }
+
+        m_num_misses++;
+        return false;
+    }
+
+    /**
+     * @brief store the permutation of a pattern in memory and, if a folder is
+     * set, on disk
+     */
+    void insert(const uint64_t pattern_hash,
+                const int      method,
+                const IndexT   num_rows,
+                const IndexT*  perm)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_enabled) {
+            return;
+        }
+
+        const KeyT key(pattern_hash, method);
+
+        std::vector<IndexT>& p = m_perms[key];
+        p.assign(perm, perm + num_rows);
+
+        if (!m_folder.empty()) {
+            write(key, p);
+        }
+    }
+
+    /**
+     * @brief remove all permutations from memory. The files on disk are kept
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_perms.clear();
+    }
+
+    void reset_stats()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_num_hits      = 0;
+        m_num_misses    = 0;
+        m_num_disk_hits = 0;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_perms.size();
+    }
+
+    uint32_t get_num_hits() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_num_hits;
+    }
+
+    uint32_t get_num_misses() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_num_misses;
+    }
+
+    /**
+     * @brief the hits that were loaded from disk
+     */
+    uint32_t get_num_disk_hits() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_num_disk_hits;
+    }
+
+    double hit_rate() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const uint32_t              total = m_num_hits + m_num_misses;
+        return total == 0 ? 0.0 : double(m_num_hits) / double(total);
+    }
+
+   private:
+    using KeyT = std::pair<uint64_t, int>;
+
+    // file header to detect truncated or foreign files
+    static constexpr uint32_t s_magic = 0x52584D50;  // "RXMP"
+
+    PermuteCache()
+        : m_enabled(true), m_num_hits(0), m_num_misses(0), m_num_disk_hits(0)
+    {
+    }
+
+    std::string file_name(const KeyT& key) const
+    {
+        char name[64];
+        std::snprintf(name,
+                      sizeof(name),
+                      "perm_%016llx_%d.bin",
+                      static_cast<unsigned long long>(key.first),
+                      key.second);
+        return (std::filesystem::path(m_folder) / name).string();
+    }
+
+    bool read(const KeyT& key, const IndexT num_rows, std::vector<IndexT>& perm)
+    {
+        std::ifstream file(file_name(key), std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        uint32_t magic = 0;
+        IndexT   n     = 0;
+        file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        file.read(reinterpret_cast<char*>(&n), sizeof(n));
+        if (!file || magic != s_magic || n != num_rows) {
+            return false;
+        }
+        perm.resize(n);
+        file.read(reinterpret_cast<char*>(perm.data()), n * sizeof(IndexT));
+        if (!file || !is_unique_permutation(uint32_t(n), perm.data())) {
+            RXMESH_WARN("PermuteCache::read() invalid permutation in {}",
+                        file_name(key));
+            return false;
+        }
+        return true;
+    }
+
+    void write(const KeyT& key, const std::vector<IndexT>& perm)
+    {
+        std::ofstream file(file_name(key), std::ios::binary);
+        if (!file.is_open()) {
+            RXMESH_WARN("PermuteCache::write() can not open {}",
+                        file_name(key));
+            return;
+        }
+        const IndexT n = IndexT(perm.size());
+        file.write(reinterpret_cast<const char*>(&s_magic), sizeof(s_magic));
+        file.write(reinterpret_cast<const char*>(&n), sizeof(n));
+        file.write(reinterpret_cast<const char*>(perm.data()),
+                   n * sizeof(IndexT));
+    }
+
+    bool                                m_enabled;
+    std::string                         m_folder;
+    mutable std::mutex                  m_mutex;
+    std::map<KeyT, std::vector<IndexT>> m_perms;
+    uint32_t                            m_num_hits;
+    uint32_t                            m_num_misses;
+    uint32_t                            m_num_disk_hits;
+};
+
+}  // namespace rxmesh
@@ -2,6 +2,9 @@
 
 #include <stdint.h>
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
 #include <vector>
 
 namespace rxmesh {
@@ -40,4 +43,86 @@ void inverse_permutation(uint32_t size, T* perm, T* helper)
         perm[i] = helper[i];
     }
 }
+
+/**
+ * @brief the distance of the non-zeros of a CSR matrix from the diagonal.
+ * max_bandwidth is the largest |row - col| and avg_bandwidth is the mean over
+ * all non-zeros. The smaller they are, the closer the entries of the input
+ * vector that an SpMV reads for consecutive rows
+ */
+struct CSRBandwidth
+{
+    int64_t max_bandwidth = 0;
+    double  avg_bandwidth = 0;
+};
+
+template <typename IndexT>
+CSRBandwidth csr_bandwidth(const IndexT  num_rows,
+                           const IndexT* row_ptr,
+                           const IndexT* col_idx)
+{
+    CSRBandwidth ret;
+    double       sum = 0;
+    for (IndexT r = 0; r < num_rows; ++r) {
+        for (IndexT i = row_ptr[r]; i < row_ptr[r + 1]; ++i) {
+            const int64_t d = std::abs(int64_t(col_idx[i]) - int64_t(r));
+            ret.max_bandwidth = std::max(ret.max_bandwidth, d);
+            sum += double(d);
+        }
+    }
+    const IndexT nnz = row_ptr[num_rows];
+    ret.avg_bandwidth = (nnz > 0) ? sum / double(nnz) : 0;
+    return ret;
+}
+
+/**
+ * @brief symmetrically permute the pattern of a square CSR matrix, i.e., row
+ * (and column) r moves to order[r]. The columns of every output row are
+ * sorted.
+ * @param num_rows number of rows (and columns)
+ * @param row_ptr the input row pointer
+ * @param col_idx the input column indices
+ * @param order the new index of every row/column
+ * @param out_row_ptr the output row pointer (num_rows + 1)
+ * @param out_col_idx the output column indices (nnz)
+ * @param val_map the input position of every output non-zero (nnz) that is
+ * used to gather the values
+ */
+template <typename IndexT>
+void permute_csr_pattern(const IndexT  num_rows,
+                         const IndexT* row_ptr,
+                         const IndexT* col_idx,
+                         const IndexT* order,
+                         IndexT*       out_row_ptr,
+                         IndexT*       out_col_idx,
+                         IndexT*       val_map)
+{
+    out_row_ptr[0] = 0;
+    for (IndexT r = 0; r < num_rows; ++r) {
+        out_row_ptr[order[r] + 1] = row_ptr[r + 1] - row_ptr[r];
+    }
+    for (IndexT r = 0; r < num_rows; ++r) {
+        out_row_ptr[r + 1] += out_row_ptr[r];
+    }
+
+#pragma omp parallel
+    {
+        std::vector<std::pair<IndexT, IndexT>> row;
+#pragma omp for
+        for (IndexT r = 0; r < num_rows; ++r) {
+            row.clear();
+            for (IndexT i = row_ptr[r]; i < row_ptr[r + 1]; ++i) {
+                row.push_back({order[col_idx[i]], i});
+            }
+            std::sort(row.begin(), row.end());
+
+            IndexT k = out_row_ptr[order[r]];
+            for (const auto& c : row) {
+                out_col_idx[k] = c.first;
+                val_map[k]     = c.second;
+                k++;
+            }
+        }
+    }
+}
 }  // namespace rxmesh
\ No newline at end of file
@@ -0,0 +1,525 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <omp.h>
+
+#include <Eigen/Sparse>
+
+#include "rxmesh/matrix/sparse_pattern.h"
+#include "rxmesh/util/instrument.h"
+#include "rxmesh/util/log.h"
+
+namespace rxmesh {
+
+/**
+ * @brief a CSR matrix on the host made of a (possibly shared) pattern and its
+ * values. Used for host sparse algebra (products, sums, transpose, scaling)
+ * to compose operators before moving them to a SparseMatrix. Sharing the
+ * pattern lets the numeric phase of an operation be repeated without
+ * recomputing the structure
+ */
+template <typename T>
+struct HostSparseMatrix
+{
+    using IndexT = SparsePattern::IndexT;
+
+    HostSparseMatrix() = default;
+
+    explicit HostSparseMatrix(std::shared_ptr<const SparsePattern> p)
+        : pattern(p), val(p->nnz(), T(0))
+    {
+    }
+
+    IndexT rows() const
+    {
+        return pattern ? pattern->num_rows : 0;
+    }
+
+    IndexT cols() const
+    {
+        return pattern ? pattern->num_cols : 0;
+    }
+
+    IndexT non_zeros() const
+    {
+        return pattern ? pattern->nnz() : 0;
+    }
+
+    const IndexT* row_ptr() const
+    {
+        return pattern->row_ptr.data();
+    }
+
+    const IndexT* col_idx() const
+    {
+        return pattern->col_idx.data();
+    }
+
+    /**
+     * @brief the value at (r, c) or zero if (r, c) is not in the pattern
+     */
+    T operator()(const IndexT r, const IndexT c) const
+    {
+        for (IndexT i = row_ptr()[r]; i < row_ptr()[r + 1]; ++i) {
+            if (col_idx()[i] == c) {
+                return val[i];
+            }
+        }
+        return T(0);
+    }
+
+    using EigenSparseMatrix =
+        Eigen::Map<const Eigen::SparseMatrix<T, Eigen::RowMajor, IndexT>>;
+
+    /**
+     * @brief map the matrix to Eigen sparse matrix. This is a zero-copy
+     * conversion so the Eigen matrix points to the pattern and val of this
+     * matrix and is valid as long as this matrix is
+     */
+    EigenSparseMatrix to_eigen() const
+    {
+        return EigenSparseMatrix(
+            rows(), cols(), non_zeros(), row_ptr(), col_idx(), val.data());
+    }
+
+    std::shared_ptr<const SparsePattern> pattern;
+    std::vector<T>                       val;
+};
+
+namespace detail {
+
+/**
+ * @brief row-parallel two-pass (count then fill) construction of a pattern.
+ * row_cols(r, marker, cols) appends the unique columns of row r to cols using
+ * marker (a per-thread dense array of num_cols entries initialized to -1) to
+ * detect duplicates. The columns of every row are sorted
+ */
+template <typename RowColsT>
+std::shared_ptr<SparsePattern> build_pattern_by_rows(
+    const SparsePattern::IndexT num_rows,
+    const SparsePattern::IndexT num_cols,
+    RowColsT                    row_cols)
+{
+    using IndexT = SparsePattern::IndexT;
+
+    auto ret      = std::make_shared<SparsePattern>();
+    ret->num_rows = num_rows;
+    ret->num_cols = num_cols;
+    ret->row_ptr.assign(num_rows + 1, 0);
+
+    auto run_pass = [&](const int pass) {
+#pragma omp parallel
+        {
+            std::vector<IndexT> marker(num_cols, -1);
+            std::vector<IndexT> cols;
+#pragma omp for schedule(dynamic, 512)
+            for (IndexT r = 0; r < num_rows; ++r) {
+                cols.clear();
+                row_cols(r, marker, cols);
+                for (const IndexT c : cols) {
+                    marker[c] = -1;
+                }
+                if (pass == 0) {
+                    ret->row_ptr[r + 1] = IndexT(cols.size());
+                } else {
+                    std::sort(cols.begin(), cols.end());
+                    std::copy(cols.begin(),
+                              cols.end(),
+                              ret->col_idx.begin() + ret->row_ptr[r]);
+                }
+            }
+        }
+    };
+
+    run_pass(0);
+    for (IndexT r = 0; r < num_rows; ++r) {
+        ret->row_ptr[r + 1] += ret->row_ptr[r];
+    }
+    ret->col_idx.resize(ret->row_ptr.back());
+    run_pass(1);
+
+    return ret;
+}
+}  // namespace detail
+
+/**
+ * @brief symbolic phase of C = A * B. Returns the pattern of C which can be
+ * reused by spgemm_numeric() as long as the patterns of A and B do not change
+ */
+inline std::shared_ptr<const SparsePattern> spgemm_symbolic(
+    const SparsePattern& a,
+    const SparsePattern& b)
+{
+    RXMESH_ZONE("spgemm_symbolic");
+    using IndexT = SparsePattern::IndexT;
+
+    if (a.num_cols != b.num_rows) {
+        RXMESH_ERROR(
+            "spgemm_symbolic() mismatch dimensions A is {}x{} and B is {}x{}",
+            a.num_rows,
+            a.num_cols,
+            b.num_rows,
+            b.num_cols);
+        return std::make_shared<SparsePattern>();
+    }
+
+    return detail::build_pattern_by_rows(
+        a.num_rows,
+        b.num_cols,
+        [&](IndexT r, std::vector<IndexT>& marker, std::vector<IndexT>& cols) {
+            for (IndexT i = a.row_ptr[r]; i < a.row_ptr[r + 1]; ++i) {
+                const IndexT k = a.col_idx[i];
+                for (IndexT j = b.row_ptr[k]; j < b.row_ptr[k + 1]; ++j) {
+                    const IndexT c = b.col_idx[j];
+                    if (marker[c] != r) {
+                        marker[c] = r;
+                        cols.push_back(c);
+                    }
+                }
+            }
+        });
+}
+
+/**
+ * @brief numeric phase of C = A * B where C has the pattern returned by
+ * spgemm_symbolic(). Every thread uses a dense accumulator that maps the
+ * columns of the current row to their position in C
+ */
+template <typename T>
+void spgemm_numeric(const HostSparseMatrix<T>& a,
+                    const HostSparseMatrix<T>& b,
+                    HostSparseMatrix<T>&       c)
+{
+    RXMESH_ZONE("spgemm_numeric");
+    using IndexT = SparsePattern::IndexT;
+
+    if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+        RXMESH_ERROR("spgemm_numeric() mismatch dimensions");
+        return;
+    }
+    c.val.assign(c.non_zeros(), T(0));
+
+    // set if an entry of A * B is missing from the pattern of C. Reported once
+    // after the loop
+    bool missing = false;
+
+#pragma omp parallel reduction(|| : missing)
+    {
+        std::vector<IndexT> pos(c.cols(), -1);
+#pragma omp for schedule(dynamic, 512)
+        for (IndexT r = 0; r < a.rows(); ++r) {
+            for (IndexT i = c.row_ptr()[r]; i < c.row_ptr()[r + 1]; ++i) {
+                pos[c.col_idx()[i]] = i;
+            }
+            for (IndexT i = a.row_ptr()[r]; i < a.row_ptr()[r + 1]; ++i) {
+                const IndexT k  = a.col_idx()[i];
+                const T      av = a.val[i];
+                for (IndexT j = b.row_ptr()[k]; j < b.row_ptr()[k + 1]; ++j) {
+                    const IndexT p = pos[b.col_idx()[j]];
+                    if (p < 0) {
+                        missing = true;
+                        continue;
+                    }
+                    c.val[p] += av * b.val[j];
+                }
+            }
+            for (IndexT i = c.row_ptr()[r]; i < c.row_ptr()[r + 1]; ++i) {
+                pos[c.col_idx()[i]] = -1;
+            }
+        }
+    }
+
+    if (missing) {
+        RXMESH_ERROR(
+            "spgemm_numeric() the pattern of C does not match A * B. Call "
+            "spgemm_symbolic() again");
+    }
+}
+
+/**
+ * @brief C = A * B (symbolic followed by numeric)
+ */
+template <typename T>
+HostSparseMatrix<T> spgemm(const HostSparseMatrix<T>& a,
+                           const HostSparseMatrix<T>& b)
+{
+    HostSparseMatrix<T> c(spgemm_symbolic(*a.pattern, *b.pattern));
+    spgemm_numeric(a, b, c);
+    return c;
+}
+
+/**
+ * @brief pattern of A + B
+ */
+inline std::shared_ptr<const SparsePattern> add_symbolic(
+    const SparsePattern& a,
+    const SparsePattern& b)
+{
+    RXMESH_ZONE("add_symbolic");
+    using IndexT = SparsePattern::IndexT;
+
+    if (a.num_rows != b.num_rows || a.num_cols != b.num_cols) {
+        RXMESH_ERROR(
+            "add_symbolic() mismatch dimensions A is {}x{} and B is {}x{}",
+            a.num_rows,
+            a.num_cols,
+            b.num_rows,
+            b.num_cols);
+        return std::make_shared<SparsePattern>();
+    }
+
+    return detail::build_pattern_by_rows(
+        a.num_rows,
+        a.num_cols,
+        [&](IndexT r, std::vector<IndexT>& marker, std::vector<IndexT>& cols) {
+            for (const SparsePattern* m : {&a, &b}) {
+                for (IndexT i = m->row_ptr[r]; i < m->row_ptr[r + 1]; ++i) {
+                    const IndexT c = m->col_idx[i];
+                    if (marker[c] != r) {
+                        marker[c] = r;
+                        cols.push_back(c);
+                    }
+                }
+            }
+        });
+}
+
+/**
+ * @brief C = alpha * A + beta * B where C has the pattern returned by
+ * add_symbolic()
+ */
+template <typename T>
+void add_numeric(const T                    alpha,
+                 const HostSparseMatrix<T>& a,
+                 const T                    beta,
+                 const HostSparseMatrix<T>& b,
+                 HostSparseMatrix<T>&       c)
+{
+    RXMESH_ZONE("add_numeric");
+    using IndexT = SparsePattern::IndexT;
+
+    if (a.rows() != b.rows() || a.cols() != b.cols() || c.rows() != a.rows() ||
+        c.cols() != a.cols()) {
+        RXMESH_ERROR("add_numeric() mismatch dimensions");
+        return;
+    }
+    c.val.assign(c.non_zeros(), T(0));
+
+    // set if an entry of A or B is missing from the pattern of C. Reported
+    // once after the loop
+    bool missing = false;
+
+#pragma omp parallel reduction(|| : missing)
+    {
+        std::vector<IndexT> pos(c.cols(), -1);
+#pragma omp for schedule(dynamic, 512)
+        for (IndexT r = 0; r < c.rows(); ++r) {
+            for (IndexT i = c.row_ptr()[r]; i < c.row_ptr()[r + 1]; ++i) {
+                pos[c.col_idx()[i]] = i;
+            }
+            for (IndexT i = a.row_ptr()[r]; i < a.row_ptr()[r + 1]; ++i) {
+                const IndexT p = pos[a.col_idx()[i]];
+                if (p < 0) {
+                    missing = true;
+                    continue;
+                }
+                c.val[p] += alpha * a.val[i];
+            }
+            for (IndexT i = b.row_ptr()[r]; i < b.row_ptr()[r + 1]; ++i) {
+                const IndexT p = pos[b.col_idx()[i]];
+                if (p < 0) {
+                    missing = true;
+                    continue;
+                }
+                c.val[p] += beta * b.val[i];
+            }
+            for (IndexT i = c.row_ptr()[r]; i < c.row_ptr()[r + 1]; ++i) {
+                pos[c.col_idx()[i]] = -1;
+            }
+        }
+    }
+
+    if (missing) {
+        RXMESH_ERROR(
+            "add_numeric() the pattern of C does not match A + B. Call "
+            "add_symbolic() again");
+    }
+}
+
+/**
+ * @brief C = alpha * A + beta * B
+ */
+template <typename T>
+HostSparseMatrix<T> add(const T                    alpha,
+                        const HostSparseMatrix<T>& a,
+                        const T                    beta,
+                        const HostSparseMatrix<T>& b)
+{
+    HostSparseMatrix<T> c(add_symbolic(*a.pattern, *b.pattern));
+    add_numeric(alpha, a, beta, b, c);
+    return c;
+}
+
+/**
+ * @brief the transpose of A. The columns of every row of the output are sorted
+ */
+template <typename T>
+HostSparseMatrix<T> transpose(const HostSparseMatrix<T>& a)
+{
+    RXMESH_ZONE("transpose");
+    using IndexT = SparsePattern::IndexT;
+
+    auto pt      = std::make_shared<SparsePattern>();
+    pt->num_rows = a.cols();
+    pt->num_cols = a.rows();
+    pt->row_ptr.assign(a.cols() + 1, 0);
+    pt->col_idx.resize(a.non_zeros());
+
+    for (IndexT i = 0; i < a.non_zeros(); ++i) {
+        pt->row_ptr[a.col_idx()[i] + 1]++;
+    }
+    for (IndexT r = 0; r < pt->num_rows; ++r) {
+        pt->row_ptr[r + 1] += pt->row_ptr[r];
+    }
+
+    std::vector<T>      val(a.non_zeros());
+    std::vector<IndexT> offset(pt->row_ptr.begin(), pt->row_ptr.end() - 1);
+    // visiting the rows of A in order gives sorted rows in the transpose
+    for (IndexT r = 0; r < a.rows(); ++r) {
+        for (IndexT i = a.row_ptr()[r]; i < a.row_ptr()[r + 1]; ++i) {
+            const IndexT p  = offset[a.col_idx()[i]]++;
+            pt->col_idx[p] = r;
+            val[p]         = a.val[i];
+        }
+    }
+
+    HostSparseMatrix<T> ret;
+    ret.pattern = pt;
+    ret.val     = std::move(val);
+    return ret;
+}
+
+/**
+ * @brief A = diag(d) * A, i.e., scale row r by d[r]
+ */
+template <typename T>
+void scale_rows(const std::vector<T>& d, HostSparseMatrix<T>& a)
+{
+    using IndexT = SparsePattern::IndexT;
+    assert(IndexT(d.size()) == a.rows());
+#pragma omp parallel for
+    for (IndexT r = 0; r < a.rows(); ++r) {
+        for (IndexT i = a.row_ptr()[r]; i < a.row_ptr()[r + 1]; ++i) {
+            a.val[i] *= d[r];
+        }
+    }
+}
+
+/**
+ * @brief A = A * diag(d), i.e., scale column c by d[c]
+ */
+template <typename T>
+void scale_cols(HostSparseMatrix<T>& a, const std::vector<T>& d)
+{
+    using IndexT = SparsePattern::IndexT;
+    assert(IndexT(d.size()) == a.cols());
+#pragma omp parallel for
+    for (IndexT i = 0; i < a.non_zeros(); ++i) {
+        a.val[i] *= d[a.col_idx()[i]];
+    }
+}
+
+/**
+ * @brief the Kronecker product of A with the k x k identity, e.g., to apply a
+ * scalar operator to every coordinate of a vector-valued unknown. Entry
+ * (r, c) of A becomes the entries (r*k + i, c*k + i) for i in [0, k)
+ */
+template <typename T>
+HostSparseMatrix<T> kron_identity(const HostSparseMatrix<T>& a,
+                                  const uint32_t             k)
+{
+    RXMESH_ZONE("kron_identity");
+    using IndexT = SparsePattern::IndexT;
+
+    auto pk      = std::make_shared<SparsePattern>();
+    pk->num_rows = a.rows() * k;
+    pk->num_cols = a.cols() * k;
+    pk->row_ptr.resize(pk->num_rows + 1);
+    pk->col_idx.resize(IndexT(a.non_zeros() * k));
+
+    std::vector<T> val(pk->col_idx.size());
+
+    pk->row_ptr[0] = 0;
+#pragma omp parallel for
+    for (IndexT r = 0; r < a.rows(); ++r) {
+        const IndexT start = a.row_ptr()[r];
+        const IndexT len   = a.row_ptr()[r + 1] - start;
+        for (uint32_t i = 0; i < k; ++i) {
+            const IndexT row     = r * k + i;
+            const IndexT offset  = start * k + i * len;
+            pk->row_ptr[row + 1] = offset + len;
+            for (IndexT j = 0; j < len; ++j) {
+                pk->col_idx[offset + j] = a.col_idx()[start + j] * k + i;
+                val[offset + j]         = a.val[start + j];
+            }
+        }
+    }
+
+    HostSparseMatrix<T> ret;
+    ret.pattern = pk;
+    ret.val     = std::move(val);
+    return ret;
+}
+
+/**
+ * @brief the piecewise-constant prolongation P of an aggregation, i.e., the
+ * n x num_aggregates matrix with P(i, aggregate[i]) = 1. transpose(P) is the
+ * matching restriction and transpose(P) * A * P is the Galerkin coarse
+ * operator. Used with RXMeshStatic::get_super_patch_aggregates() to build
+ * a coarse level from the super-patches
+ * @param aggregate the aggregate of every fine unknown
+ * @param num_aggregates the number of aggregates (coarse unknowns)
+ */
+template <typename T>
+HostSparseMatrix<T> aggregation_prolongation(
+    const std::vector<uint32_t>& aggregate,
+    const uint32_t               num_aggregates)
+{
+    using IndexT = SparsePattern::IndexT;
+
+    const IndexT n = IndexT(aggregate.size());
+
+    auto pp      = std::make_shared<SparsePattern>();
+    pp->num_rows = n;
+    pp->num_cols = IndexT(num_aggregates);
+    pp->row_ptr.resize(n + 1);
+    pp->col_idx.resize(n);
+
+    bool invalid = false;
+#pragma omp parallel for reduction(|| : invalid)
+    for (IndexT r = 0; r <= n; ++r) {
+        pp->row_ptr[r] = r;
+        if (r < n) {
+            invalid        = invalid || aggregate[r] >= num_aggregates;
+            pp->col_idx[r] = IndexT(aggregate[r]);
+        }
+    }
+    if (invalid) {
+        RXMESH_ERROR(
+            "aggregation_prolongation() an aggregate is out of the range "
+            "[0, {})",
+            num_aggregates);
+    }
+
+    HostSparseMatrix<T> ret;
+    ret.pattern = pp;
+    ret.val.assign(n, T(1));
+    return ret;
+}
+
+}  // namespace rxmesh
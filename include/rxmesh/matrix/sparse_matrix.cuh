@@ -6,6 +6,8 @@
 #include "rxmesh/context.h"
 
 #include "rxmesh/launch_box.h"
+#include "rxmesh/util/host_memory.h"
+#include "rxmesh/util/instrument.h"
 
 #include "thrust/device_ptr.h"
 #include "thrust/execution_policy.h"
@@ -14,8 +16,11 @@
 
 #include "cusolverSp_LOWLEVEL_PREVIEW.h"
 #include "rxmesh/matrix/dense_matrix.cuh"
+#include "rxmesh/matrix/permute_cache.h"
 #include "rxmesh/matrix/permute_util.h"
+#include "rxmesh/matrix/sparse_algebra.h"
 #include "rxmesh/matrix/sparse_matrix_kernels.cuh"
+#include "rxmesh/matrix/sparse_pattern.h"
 
 #include "rxmesh/matrix/mgnd_permute.cuh"
 #include "rxmesh/matrix/nd_permute.cuh"
@@ -138,6 +143,9 @@ struct SparseMatrix
           m_h_solver_col_idx(nullptr),
           m_h_permute_map(nullptr),
           m_d_permute_map(nullptr),
+          m_h_row_order(nullptr),
+          m_d_row_order(nullptr),
+          m_row_order_id(0),
           m_use_reorder(false),
           m_reorder_allocated(false),
           m_d_cusparse_spmm_buffer(nullptr),
@@ -152,6 +160,101 @@ struct SparseMatrix
 
     SparseMatrix(const RXMeshStatic& rx) : SparseMatrix(rx, 1) {};
 
+    /**
+     * @brief construct the matrix from a pattern built on the host (see
+     * SparsePatternDesc), e.g., a VF matrix, an EE matrix, or a 2-ring VV
+     * stencil. The pattern is taken from the mesh pattern cache so matrices
+     * with the same structure share the host construction
+     */
+    SparseMatrix(const RXMeshStatic& rx, const SparsePatternDesc& desc)
+        : SparseMatrix(rx, rx.get_sparse_pattern(desc))
+    {
+    }
+
+    /**
+     * @brief construct the matrix from the result of host sparse algebra
+     * (see sparse_algebra.h), e.g., a bilaplacian computed with spgemm(). The
+     * values are copied to both host and device
+     */
+    SparseMatrix(const RXMeshStatic& rx, const HostSparseMatrix<T>& mat)
+        : SparseMatrix(rx, mat.pattern)
+    {
+        std::copy(mat.val.begin(), mat.val.end(), m_h_val);
+        CUDA_ERROR(cudaMemcpy(
+            m_d_val, m_h_val, m_nnz * sizeof(T), cudaMemcpyHostToDevice));
+    }
+
+    /**
+     * @brief construct the matrix from a host CSR pattern. The values are
+     * initialized to zero
+     */
+    SparseMatrix(const RXMeshStatic&                  rx,
+                 std::shared_ptr<const SparsePattern> pattern)
+        : m_d_row_ptr(nullptr),
+          m_d_col_idx(nullptr),
+          m_d_val(nullptr),
+          m_h_row_ptr(nullptr),
+          m_h_col_idx(nullptr),
+          m_h_val(nullptr),
+          m_num_rows(0),
+          m_num_cols(0),
+          m_nnz(0),
+          m_context(rx.get_context()),
+          m_cusparse_handle(NULL),
+          m_descr(NULL),
+          m_replicate(pattern->block_size()),
+          m_spdescr(NULL),
+          m_spmm_buffer_size(0),
+          m_spmv_buffer_size(0),
+          m_h_permute(nullptr),
+          m_d_permute(nullptr),
+          m_d_solver_row_ptr(nullptr),
+          m_d_solver_col_idx(nullptr),
+          m_d_solver_val(nullptr),
+          m_h_solver_row_ptr(nullptr),
+          m_h_solver_col_idx(nullptr),
+          m_h_permute_map(nullptr),
+          m_d_permute_map(nullptr),
+          m_h_row_order(nullptr),
+          m_d_row_order(nullptr),
+          m_row_order_id(0),
+          m_use_reorder(false),
+          m_reorder_allocated(false),
+          m_d_cusparse_spmm_buffer(nullptr),
+          m_d_cusparse_spmv_buffer(nullptr),
+          m_solver_buffer(nullptr),
+          m_d_solver_b(nullptr),
+          m_d_solver_x(nullptr),
+          m_allocated(LOCATION_NONE),
+          m_current_solver(Solver::NONE)
+    {
+        RXMESH_ZONE("SparseMatrix::SparseMatrix(pattern)");
+
+        m_num_rows = pattern->num_rows;
+        m_num_cols = pattern->num_cols;
+        m_nnz      = pattern->nnz();
+
+        allocate(LOCATION_ALL);
+
+        std::copy(
+            pattern->row_ptr.begin(), pattern->row_ptr.end(), m_h_row_ptr);
+        std::copy(
+            pattern->col_idx.begin(), pattern->col_idx.end(), m_h_col_idx);
+        std::fill_n(m_h_val, m_nnz, T(0));
+
+        CUDA_ERROR(cudaMemcpy(m_d_row_ptr,
+                              m_h_row_ptr,
+                              (m_num_rows + 1) * sizeof(IndexT),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_col_idx,
+                              m_h_col_idx,
+                              m_nnz * sizeof(IndexT),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemset(m_d_val, 0, m_nnz * sizeof(T)));
+
+        create_cusparse_handles();
+    }
+
    protected:
     SparseMatrix(const RXMeshStatic& rx, IndexT replicate)
         : m_d_row_ptr(nullptr),
@@ -179,6 +282,9 @@ struct SparseMatrix
           m_h_solver_col_idx(nullptr),
           m_h_permute_map(nullptr),
           m_d_permute_map(nullptr),
+          m_h_row_order(nullptr),
+          m_d_row_order(nullptr),
+          m_row_order_id(0),
           m_use_reorder(false),
           m_reorder_allocated(false),
           m_d_cusparse_spmm_buffer(nullptr),
@@ -258,39 +364,11 @@ struct SparseMatrix
         CUDA_ERROR(cudaMemset(m_d_val, 0, m_nnz * sizeof(T)));
         m_allocated = m_allocated | DEVICE;
 
-        // create cusparse matrix
-        CUSPARSE_ERROR(cusparseCreateMatDescr(&m_descr));
-        CUSPARSE_ERROR(
-            cusparseSetMatType(m_descr, CUSPARSE_MATRIX_TYPE_GENERAL));
-        CUSPARSE_ERROR(
-            cusparseSetMatDiagType(m_descr, CUSPARSE_DIAG_TYPE_NON_UNIT));
-        CUSPARSE_ERROR(
-            cusparseSetMatIndexBase(m_descr, CUSPARSE_INDEX_BASE_ZERO));
-
-        CUSPARSE_ERROR(cusparseCreateCsr(&m_spdescr,
-                                         m_num_rows,
-                                         m_num_cols,
-                                         m_nnz,
-                                         m_d_row_ptr,
-                                         m_d_col_idx,
-                                         m_d_val,
-                                         CUSPARSE_INDEX_32I,
-                                         CUSPARSE_INDEX_32I,
-                                         CUSPARSE_INDEX_BASE_ZERO,
-                                         cuda_type<T>()));
-
-        CUSPARSE_ERROR(cusparseCreate(&m_cusparse_handle));
-        CUSOLVER_ERROR(cusolverSpCreate(&m_cusolver_sphandle));
-
-        CUSOLVER_ERROR(cusolverSpCreateCsrcholInfo(&m_chol_info));
-
-        CUSOLVER_ERROR(cusolverSpCreateCsrqrInfo(&m_qr_info));
-
         // allocate the host
-        m_h_val = static_cast<T*>(malloc(m_nnz * sizeof(T)));
+        m_h_val = host_malloc<T>(m_nnz, HostMemTag::SparseMatrix);
         m_h_row_ptr =
-            static_cast<IndexT*>(malloc((m_num_rows + 1) * sizeof(IndexT)));
-        m_h_col_idx = static_cast<IndexT*>(malloc(m_nnz * sizeof(IndexT)));
+            host_malloc<IndexT>(m_num_rows + 1, HostMemTag::SparseMatrix);
+        m_h_col_idx = host_malloc<IndexT>(m_nnz, HostMemTag::SparseMatrix);
 
         CUDA_ERROR(cudaMemcpy(
             m_h_val, m_d_val, m_nnz * sizeof(T), cudaMemcpyDeviceToHost));
@@ -305,8 +383,7 @@ struct SparseMatrix
 
         m_allocated = m_allocated | HOST;
 
-        CUSPARSE_ERROR(cusparseSetPointerMode(m_cusparse_handle,
-                                              CUSPARSE_POINTER_MODE_HOST));
+        create_cusparse_handles();
 
 #ifndef NDEBUG
         // sanity check: no repeated indices in the col_id for a specific row
@@ -378,6 +455,26 @@ struct SparseMatrix
     }
 
 
+    /**
+     * @brief copy the host CSR into a HostSparseMatrix to compose it with
+     * other operators using host sparse algebra (see sparse_algebra.h). The
+     * matrix should be up-to-date on the host, e.g., by calling
+     * move(DEVICE, HOST)
+     */
+    __host__ HostSparseMatrix<T> to_host_sparse() const
+    {
+        auto pattern      = std::make_shared<SparsePattern>();
+        pattern->num_rows = m_num_rows;
+        pattern->num_cols = m_num_cols;
+        pattern->row_ptr.assign(m_h_row_ptr, m_h_row_ptr + m_num_rows + 1);
+        pattern->col_idx.assign(m_h_col_idx, m_h_col_idx + m_nnz);
+
+        HostSparseMatrix<T> ret;
+        ret.pattern = pattern;
+        ret.val.assign(m_h_val, m_h_val + m_nnz);
+        return ret;
+    }
+
     /**
      * @brief return number of rows
      */
@@ -402,6 +499,15 @@ struct SparseMatrix
         return m_nnz;
     }
 
+    /**
+     * @brief return the size of the dense blocks the matrix is made of, e.g.,
+     * 3 for a matrix that couples the xyz coordinates of every vertex
+     */
+    __device__ __host__ IndexT replicate() const
+    {
+        return m_replicate;
+    }
+
     /**
      * @brief return the number of non-zero values on and below the diagonal
      */
@@ -454,6 +560,34 @@ struct SparseMatrix
         return this->operator()(get_row_id(row_v), get_row_id(col_v));
     }
 
+    /**
+     * @brief access the matrix using vertex/edge/face handles, e.g., for
+     * matrices built from a SparsePatternDesc with different row and column
+     * element types
+     */
+    template <typename RowHandleT,
+              typename ColHandleT,
+              typename RowHandleT::LocalT* = nullptr,
+              typename ColHandleT::LocalT* = nullptr>
+    __device__ __host__ T& operator()(const RowHandleT& row,
+                                      const ColHandleT& col)
+    {
+        return this->operator()(get_row_id(row), get_row_id(col));
+    }
+
+    /**
+     * @brief access the matrix using vertex/edge/face handles
+     */
+    template <typename RowHandleT,
+              typename ColHandleT,
+              typename RowHandleT::LocalT* = nullptr,
+              typename ColHandleT::LocalT* = nullptr>
+    __device__ __host__ const T& operator()(const RowHandleT& row,
+                                            const ColHandleT& col) const
+    {
+        return this->operator()(get_row_id(row), get_row_id(col));
+    }
+
     /**
      * @brief access the matrix using row and col index
      */
@@ -529,12 +663,34 @@ struct SparseMatrix
     }
 
     /**
-     * @brief return the row index corresponding to specific vertex handle
+     * @brief return the row index corresponding to specific vertex/edge/face
+     * handle
      */
-    __device__ __host__ uint32_t get_row_id(const VertexHandle& handle) const
+    template <typename HandleT>
+    __device__ __host__ uint32_t get_row_id(const HandleT& handle) const
     {
         auto id = handle.unpack();
-        return m_context.vertex_prefix()[id.first] + id.second;
+
+        uint32_t row = 0;
+        if constexpr (std::is_same_v<HandleT, VertexHandle>) {
+            row = m_context.vertex_prefix()[id.first] + id.second;
+        }
+        if constexpr (std::is_same_v<HandleT, EdgeHandle>) {
+            row = m_context.edge_prefix()[id.first] + id.second;
+        }
+        if constexpr (std::is_same_v<HandleT, FaceHandle>) {
+            row = m_context.face_prefix()[id.first] + id.second;
+        }
+
+#ifdef __CUDA_ARCH__
+        const IndexT* row_order = m_d_row_order;
+#else
+        const IndexT* row_order = m_h_row_order;
+#endif
+        if (row_order != nullptr) {
+            row = row_order[row];
+        }
+        return row;
     }
 
     /**
@@ -559,12 +715,21 @@ struct SparseMatrix
             GPU_FREE(m_d_solver_b);
             GPU_FREE(m_d_permute_map);
 
-            free(m_h_permute);
-            free(m_h_permute_map);
+            host_free(m_h_solver_row_ptr);
+            host_free(m_h_solver_col_idx);
+            host_free(m_h_permute);
+            host_free(m_h_permute_map);
         }
         GPU_FREE(m_solver_buffer);
         GPU_FREE(m_d_cusparse_spmm_buffer);
         GPU_FREE(m_d_cusparse_spmv_buffer);
+
+        if (m_h_row_order != nullptr) {
+            host_free(m_h_row_order);
+            m_h_row_order = nullptr;
+        }
+        GPU_FREE(m_d_row_order);
+        m_row_order_id = 0;
     }
 
     /**
@@ -668,6 +833,11 @@ struct SparseMatrix
         assert(rows() == C_mat.rows());
         assert(B_mat.cols() == C_mat.cols());
 
+        if (!is_in_row_order(B_mat, "multiply") ||
+            !is_in_row_order(C_mat, "multiply")) {
+            return;
+        }
+
         T alpha;
         T beta;
 
@@ -818,6 +988,11 @@ struct SparseMatrix
         assert(rows() == C_mat.rows());
         assert(B_mat.cols() == C_mat.cols());
 
+        if (!is_in_row_order(B_mat, "multiply_cw") ||
+            !is_in_row_order(C_mat, "multiply_cw")) {
+            return;
+        }
+
         for (int i = 0; i < B_mat.m_num_cols; ++i) {
             multiply(B_mat.col_data(i), C_mat.col_data(i), stream);
         }
@@ -870,6 +1045,12 @@ struct SparseMatrix
                         PermuteMethod         reorder,
                         cudaStream_t          stream = 0)
     {
+        RXMESH_ZONE_NAMED(solve_zone, "SparseMatrix::solve");
+        RXMESH_ZONE_COUNTER(solve_zone, "num_rhs", B_mat.cols());
+        if (!is_in_row_order(B_mat, "solve") ||
+            !is_in_row_order(X_mat, "solve")) {
+            return;
+        }
         for (int i = 0; i < B_mat.cols(); ++i) {
             cusparse_linear_solver_wrapper(
                 solver,
@@ -890,10 +1071,285 @@ struct SparseMatrix
                         PermuteMethod reorder,
                         cudaStream_t  stream = 0)
     {
+        RXMESH_ZONE("SparseMatrix::solve");
         cusparse_linear_solver_wrapper(
             solver, reorder, m_cusolver_sphandle, B_arr, X_arr, stream);
     }
 
+    /**
+     * @brief permute the rows and columns of the matrix (on the host and
+     * device) to reduce its bandwidth, e.g., with SYMRCM, so that an SpMV
+     * (on the host or device) reads nearby entries of the input vector for
+     * consecutive rows. Unlike permute(), which only permutes the copy used
+     * by the solver, this changes the matrix itself and the handle accessors
+     * (operator() and get_row_id()) follow the new order. Dense matrices that
+     * multiply this matrix should be permuted with reorder(DenseMatrix&) (see
+     * also to_matrix() and from_matrix()). Should be called before the
+     * solver low-level API and before reordering dense matrices. The
+     * bandwidth before and after can be queried with bandwidth()
+     * @param rx the mesh used to build the matrix
+     * @param method the permutation method. SYMRCM reduces the bandwidth,
+     * GPUMGND/GPUND keep the patches close to each other
+     */
+    __host__ void reorder(RXMeshStatic&       rx,
+                          const PermuteMethod method = PermuteMethod::SYMRCM)
+    {
+        RXMESH_ZONE_NAMED(reorder_zone, "SparseMatrix::reorder");
+        RXMESH_ZONE_COUNTER(reorder_zone, "num_rows", m_num_rows);
+        RXMESH_ZONE_COUNTER(reorder_zone, "nnz", m_nnz);
+
+        if (method == PermuteMethod::NONE) {
+            RXMESH_WARN(
+                "SparseMatrix::reorder() No reordering is specified. Continue "
+                "without reordering!");
+            return;
+        }
+
+        if (m_num_rows != m_num_cols) {
+            RXMESH_ERROR(
+                "SparseMatrix::reorder() only square matrices can be "
+                "reordered ({} x {})",
+                m_num_rows,
+                m_num_cols);
+            return;
+        }
+
+        if (m_use_reorder || m_current_solver != Solver::NONE) {
+            RXMESH_ERROR(
+                "SparseMatrix::reorder() should be called before the solver "
+                "low-level API (permute(), analyze_pattern())");
+            return;
+        }
+
+        if ((m_allocated & LOCATION_ALL) != LOCATION_ALL) {
+            RXMESH_ERROR(
+                "SparseMatrix::reorder() the matrix should be allocated on "
+                "the host and device");
+            return;
+        }
+
+        // perm[i] is the old index of the new row i
+        std::vector<IndexT> perm(m_num_rows);
+        find_or_compute_permute(
+            rx, method, m_h_row_ptr, m_h_col_idx, perm.data());
+        assert(is_unique_permutation(m_num_rows, perm.data()));
+
+        // order[r] is the new index of the old row r
+        std::vector<IndexT> order(m_num_rows);
+        for (IndexT i = 0; i < m_num_rows; ++i) {
+            order[perm[i]] = i;
+        }
+
+        std::vector<IndexT> row_ptr(m_num_rows + 1);
+        std::vector<IndexT> col_idx(m_nnz);
+        std::vector<IndexT> val_map(m_nnz);
+        permute_csr_pattern(m_num_rows,
+                            m_h_row_ptr,
+                            m_h_col_idx,
+                            order.data(),
+                            row_ptr.data(),
+                            col_idx.data(),
+                            val_map.data());
+
+        // host
+        std::vector<T> val(m_nnz);
+        for (IndexT i = 0; i < m_nnz; ++i) {
+            val[i] = m_h_val[val_map[i]];
+        }
+        std::copy(row_ptr.begin(), row_ptr.end(), m_h_row_ptr);
+        std::copy(col_idx.begin(), col_idx.end(), m_h_col_idx);
+        std::copy(val.begin(), val.end(), m_h_val);
+
+        // device. The values are gathered on the device since they may be
+        // updated only there
+        IndexT* d_val_map = nullptr;
+        T*      d_val     = nullptr;
+        CUDA_ERROR(cudaMalloc((void**)&d_val_map, m_nnz * sizeof(IndexT)));
+        CUDA_ERROR(cudaMalloc((void**)&d_val, m_nnz * sizeof(T)));
+        CUDA_ERROR(cudaMemcpy(d_val_map,
+                              val_map.data(),
+                              m_nnz * sizeof(IndexT),
+                              cudaMemcpyHostToDevice));
+        permute_gather(d_val_map, m_d_val, d_val, m_nnz);
+        CUDA_ERROR(cudaMemcpy(
+            m_d_val, d_val, m_nnz * sizeof(T), cudaMemcpyDeviceToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_row_ptr,
+                              m_h_row_ptr,
+                              (m_num_rows + 1) * sizeof(IndexT),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_col_idx,
+                              m_h_col_idx,
+                              m_nnz * sizeof(IndexT),
+                              cudaMemcpyHostToDevice));
+        GPU_FREE(d_val_map);
+        GPU_FREE(d_val);
+
+        // the cuSparse buffers are sized for the old pattern
+        GPU_FREE(m_d_cusparse_spmm_buffer);
+        GPU_FREE(m_d_cusparse_spmv_buffer);
+
+        // compose with a previous reordering so the order always maps the
+        // linear ids
+        if (m_h_row_order == nullptr) {
+            m_h_row_order =
+                host_malloc<IndexT>(m_num_rows, HostMemTag::SparseMatrix);
+            CUDA_ERROR(cudaMalloc((void**)&m_d_row_order,
+                                  m_num_rows * sizeof(IndexT)));
+            std::copy(order.begin(), order.end(), m_h_row_order);
+        } else {
+            for (IndexT r = 0; r < m_num_rows; ++r) {
+                m_h_row_order[r] = order[m_h_row_order[r]];
+            }
+        }
+        CUDA_ERROR(cudaMemcpy(m_d_row_order,
+                              m_h_row_order,
+                              m_num_rows * sizeof(IndexT),
+                              cudaMemcpyHostToDevice));
+
+        // dense matrices reordered before keep the previous order
+        m_row_order_id = detail::next_row_order_id();
+    }
+
+    /**
+     * @brief permute the rows of a dense matrix in the linear id order (e.g.,
+     * from Attribute::to_matrix()) to the order of this matrix after
+     * reorder() so it can be multiplied by (or solved with) this matrix. The
+     * handle accessors of the dense matrix follow the new order. The dense
+     * matrix keeps its own copy of the order, so it is not affected by
+     * releasing or reordering this matrix again
+     */
+    __host__ void reorder(DenseMatrix<T>& mat) const
+    {
+        if (m_h_row_order == nullptr) {
+            return;
+        }
+
+        if (mat.rows() != m_num_rows) {
+            RXMESH_ERROR(
+                "SparseMatrix::reorder() the dense matrix has {} rows while "
+                "the sparse matrix has {} rows",
+                mat.rows(),
+                m_num_rows);
+            return;
+        }
+
+        if (mat.is_reordered()) {
+            RXMESH_ERROR(
+                "SparseMatrix::reorder() the dense matrix is already "
+                "reordered");
+            return;
+        }
+
+        if (mat.is_view(HOST) || mat.is_view(DEVICE)) {
+            RXMESH_ERROR(
+                "SparseMatrix::reorder() can not reorder a dense matrix that "
+                "aliases an attribute (see Attribute::to_matrix_view())");
+            return;
+        }
+
+        if ((mat.m_allocated & HOST) == HOST) {
+            std::vector<T> col(m_num_rows);
+            for (IndexT j = 0; j < mat.cols(); ++j) {
+                T* data = mat.col_data(j, HOST);
+                for (IndexT r = 0; r < m_num_rows; ++r) {
+                    col[m_h_row_order[r]] = data[r];
+                }
+                std::copy(col.begin(), col.end(), data);
+            }
+        }
+
+        if ((mat.m_allocated & DEVICE) == DEVICE) {
+            T* d_col = nullptr;
+            CUDA_ERROR(cudaMalloc((void**)&d_col, m_num_rows * sizeof(T)));
+            for (IndexT j = 0; j < mat.cols(); ++j) {
+                T* data = mat.col_data(j, DEVICE);
+                // d_col[order[r]] = data[r]
+                thrust::scatter(thrust::device,
+                                thrust::device_ptr<T>(data),
+                                thrust::device_ptr<T>(data) + m_num_rows,
+                                thrust::device_ptr<IndexT>(m_d_row_order),
+                                thrust::device_ptr<T>(d_col));
+                CUDA_ERROR(cudaMemcpy(data,
+                                      d_col,
+                                      m_num_rows * sizeof(T),
+                                      cudaMemcpyDeviceToDevice));
+            }
+            GPU_FREE(d_col);
+        }
+
+        mat.set_row_order(m_h_row_order, m_row_order_id);
+    }
+
+    /**
+     * @brief convert an attribute into a dense matrix in the row order of
+     * this matrix (see reorder())
+     */
+    template <typename HandleT>
+    __host__ std::shared_ptr<DenseMatrix<T>> to_matrix(
+        const Attribute<T, HandleT>& attr) const
+    {
+        std::shared_ptr<DenseMatrix<T>> mat = attr.to_matrix();
+        reorder(*mat);
+        return mat;
+    }
+
+    /**
+     * @brief copy a dense matrix in the row order of this matrix (see
+     * reorder()) back to an attribute on the host
+     */
+    template <typename HandleT>
+    __host__ void from_matrix(DenseMatrix<T>&        mat,
+                              Attribute<T, HandleT>& attr) const
+    {
+        if (!is_in_row_order(mat, "from_matrix")) {
+            return;
+        }
+        attr.from_matrix(&mat);
+    }
+
+    /**
+     * @brief check that a dense matrix is in the row order of this matrix,
+     * i.e., it was reordered with reorder(DenseMatrix&) after the last
+     * reorder() of this matrix, or neither is reordered
+     */
+    __host__ bool is_in_row_order(const DenseMatrix<T>& mat,
+                                  const std::string&    caller) const
+    {
+        if (mat.m_row_order_id != m_row_order_id) {
+            RXMESH_ERROR(
+                "SparseMatrix::{}() the dense matrix is not in the row order "
+                "of this matrix (see reorder())",
+                caller);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief check if the matrix is reordered by reorder()
+     */
+    __host__ __device__ bool is_reordered() const
+    {
+        return m_h_row_order != nullptr;
+    }
+
+    /**
+     * @brief the new row of every linear id after reorder() or nullptr if
+     * the matrix is not reordered
+     */
+    __host__ const IndexT* get_h_row_order() const
+    {
+        return m_h_row_order;
+    }
+
+    /**
+     * @brief the bandwidth of the (host) matrix pattern (see csr_bandwidth())
+     */
+    __host__ CSRBandwidth bandwidth() const
+    {
+        return csr_bandwidth(m_num_rows, m_h_row_ptr, m_h_col_idx);
+    }
+
 
     /* --- LOW LEVEL API --- */
 
@@ -923,15 +1379,17 @@ struct SparseMatrix
                                   m_nnz * sizeof(IndexT)));
 
             m_h_solver_row_ptr =
-                (IndexT*)malloc((m_num_rows + 1) * sizeof(IndexT));
-            m_h_solver_col_idx = (IndexT*)malloc(m_nnz * sizeof(IndexT));
+                host_malloc<IndexT>(m_num_rows + 1, HostMemTag::SparseMatrix);
+            m_h_solver_col_idx =
+                host_malloc<IndexT>(m_nnz, HostMemTag::SparseMatrix);
 
-            m_h_permute = (IndexT*)malloc(m_num_rows * sizeof(IndexT));
+            m_h_permute =
+                host_malloc<IndexT>(m_num_rows, HostMemTag::SparseMatrix);
             CUDA_ERROR(
                 cudaMalloc((void**)&m_d_permute, m_num_rows * sizeof(IndexT)));
 
             m_h_permute_map =
-                static_cast<IndexT*>(malloc(m_nnz * sizeof(IndexT)));
+                host_malloc<IndexT>(m_nnz, HostMemTag::SparseMatrix);
 
             CUDA_ERROR(
                 cudaMalloc((void**)&m_d_permute_map, m_nnz * sizeof(IndexT)));
@@ -954,6 +1412,9 @@ struct SparseMatrix
      */
     __host__ void permute(RXMeshStatic& rx, PermuteMethod reorder)
     {
+        RXMESH_ZONE_NAMED(permute_zone, "SparseMatrix::permute");
+        RXMESH_ZONE_COUNTER(permute_zone, "num_rows", m_num_rows);
+        RXMESH_ZONE_COUNTER(permute_zone, "nnz", m_nnz);
         permute_alloc(reorder);
 
         if (reorder == PermuteMethod::NONE) {
@@ -966,41 +1427,9 @@ struct SparseMatrix
 
         m_use_reorder = true;
 
-
-        if (reorder == PermuteMethod::SYMRCM) {
-            CUSOLVER_ERROR(cusolverSpXcsrsymrcmHost(m_cusolver_sphandle,
-                                                    m_num_rows,
-                                                    m_nnz,
-                                                    m_descr,
-                                                    m_h_solver_row_ptr,
-                                                    m_h_solver_col_idx,
-                                                    m_h_permute));
-        } else if (reorder == PermuteMethod::SYMAMD) {
-            CUSOLVER_ERROR(cusolverSpXcsrsymamdHost(m_cusolver_sphandle,
-                                                    m_num_rows,
-                                                    m_nnz,
-                                                    m_descr,
-                                                    m_h_solver_row_ptr,
-                                                    m_h_solver_col_idx,
-                                                    m_h_permute));
-        } else if (reorder == PermuteMethod::NSTDIS) {
-            CUSOLVER_ERROR(cusolverSpXcsrmetisndHost(m_cusolver_sphandle,
-                                                     m_num_rows,
-                                                     m_nnz,
-                                                     m_descr,
-                                                     m_h_solver_row_ptr,
-                                                     m_h_solver_col_idx,
-                                                     NULL,
-                                                     m_h_permute));
-        } else if (reorder == PermuteMethod::GPUMGND) {
-            mgnd_permute(rx, m_h_permute);
-
-        } else if (reorder == PermuteMethod::GPUND) {
-            nd_permute(rx, m_h_permute);
-        } else {
-            RXMESH_ERROR("SparseMatrix::permute() incompatible reorder method");
-        }
-
+        const bool cached = find_or_compute_permute(
+            rx, reorder, m_h_solver_row_ptr, m_h_solver_col_idx, m_h_permute);
+        RXMESH_ZONE_COUNTER(permute_zone, "cache_hit", int(cached));
 
         assert(is_unique_permutation(m_num_rows, m_h_permute));
 
@@ -1034,7 +1463,8 @@ struct SparseMatrix
                                                          m_h_permute,
                                                          &size_perm));
 
-        perm_buffer_cpu = (void*)malloc(sizeof(char) * size_perm);
+        perm_buffer_cpu =
+            host_malloc<char>(size_perm, HostMemTag::SparseMatrix);
 
         // permute the matrix
         CUSOLVER_ERROR(cusolverSpXcsrpermHost(m_cusolver_sphandle,
@@ -1067,7 +1497,7 @@ struct SparseMatrix
         permute_gather(m_d_permute_map, m_d_val, m_d_solver_val, m_nnz);
 
 
-        free(perm_buffer_cpu);
+        host_free(perm_buffer_cpu);
     }
 
     /**
@@ -1076,6 +1506,7 @@ struct SparseMatrix
      */
     __host__ void analyze_pattern(Solver solver)
     {
+        RXMESH_ZONE("SparseMatrix::analyze_pattern");
         m_current_solver = solver;
 
         if (!m_use_reorder) {
@@ -1313,6 +1744,7 @@ struct SparseMatrix
      */
     __host__ void factorize(Solver solver)
     {
+        RXMESH_ZONE("SparseMatrix::factorize");
         if (solver != m_current_solver) {
             RXMESH_ERROR(
                 "SparseMatrix::post_analyze_alloc() input solver is different "
@@ -1481,6 +1913,7 @@ struct SparseMatrix
                             Solver        solver,
                             PermuteMethod reorder = PermuteMethod::NSTDIS)
     {
+        RXMESH_ZONE("SparseMatrix::pre_solve");
         if (solver != Solver::CHOL && solver != Solver::QR) {
             RXMESH_WARN(
                 "SparseMatrix::pre_solve() the low-level API only works for "
@@ -1508,6 +1941,12 @@ struct SparseMatrix
                         DenseMatrix<T>& X_mat,
                         cudaStream_t    stream = NULL)
     {
+        RXMESH_ZONE_NAMED(solve_zone, "SparseMatrix::solve");
+        RXMESH_ZONE_COUNTER(solve_zone, "num_rhs", B_mat.cols());
+        if (!is_in_row_order(B_mat, "solve") ||
+            !is_in_row_order(X_mat, "solve")) {
+            return;
+        }
         CUSOLVER_ERROR(cusolverSpSetStream(m_cusolver_sphandle, stream));
         for (int i = 0; i < B_mat.cols(); ++i) {
             solve(B_mat.col_data(i), X_mat.col_data(i));
@@ -1630,12 +2069,49 @@ struct SparseMatrix
 
 
    protected:
+    /**
+     * @brief create the cuSparse matrix descriptors and the cuSparse/cuSolver
+     * handles once the device CSR is allocated
+     */
+    __host__ void create_cusparse_handles()
+    {
+        CUSPARSE_ERROR(cusparseCreateMatDescr(&m_descr));
+        CUSPARSE_ERROR(
+            cusparseSetMatType(m_descr, CUSPARSE_MATRIX_TYPE_GENERAL));
+        CUSPARSE_ERROR(
+            cusparseSetMatDiagType(m_descr, CUSPARSE_DIAG_TYPE_NON_UNIT));
+        CUSPARSE_ERROR(
+            cusparseSetMatIndexBase(m_descr, CUSPARSE_INDEX_BASE_ZERO));
+
+        CUSPARSE_ERROR(cusparseCreateCsr(&m_spdescr,
+                                         m_num_rows,
+                                         m_num_cols,
+                                         m_nnz,
+                                         m_d_row_ptr,
+                                         m_d_col_idx,
+                                         m_d_val,
+                                         CUSPARSE_INDEX_32I,
+                                         CUSPARSE_INDEX_32I,
+                                         CUSPARSE_INDEX_BASE_ZERO,
+                                         cuda_type<T>()));
+
+        CUSPARSE_ERROR(cusparseCreate(&m_cusparse_handle));
+        CUSOLVER_ERROR(cusolverSpCreate(&m_cusolver_sphandle));
+
+        CUSOLVER_ERROR(cusolverSpCreateCsrcholInfo(&m_chol_info));
+
+        CUSOLVER_ERROR(cusolverSpCreateCsrqrInfo(&m_qr_info));
+
+        CUSPARSE_ERROR(cusparseSetPointerMode(m_cusparse_handle,
+                                              CUSPARSE_POINTER_MODE_HOST));
+    }
+
     __host__ void release(locationT location)
     {
         if (((location & HOST) == HOST) && ((m_allocated & HOST) == HOST)) {
-            free(m_h_val);
-            free(m_h_row_ptr);
-            free(m_h_col_idx);
+            host_free(m_h_val);
+            host_free(m_h_row_ptr);
+            host_free(m_h_col_idx);
             m_h_val     = nullptr;
             m_h_row_ptr = nullptr;
             m_h_col_idx = nullptr;
@@ -1656,10 +2132,10 @@ struct SparseMatrix
         if ((location & HOST) == HOST) {
             release(HOST);
 
-            m_h_val = static_cast<T*>(malloc(m_nnz * sizeof(T)));
+            m_h_val = host_malloc<T>(m_nnz, HostMemTag::SparseMatrix);
             m_h_row_ptr =
-                static_cast<IndexT*>(malloc((m_num_rows + 1) * sizeof(IndexT)));
-            m_h_col_idx = static_cast<IndexT*>(malloc(m_nnz * sizeof(IndexT)));
+                host_malloc<IndexT>(m_num_rows + 1, HostMemTag::SparseMatrix);
+            m_h_col_idx = host_malloc<IndexT>(m_nnz, HostMemTag::SparseMatrix);
 
             m_allocated = m_allocated | HOST;
         }
@@ -1895,6 +2371,83 @@ struct SparseMatrix
         }
     }
 
+    /**
+     * @brief find the fill-reducing (or bandwidth-reducing) permutation of a
+     * CSR pattern with the same size as this matrix in the PermuteCache or
+     * compute it. The output follows cuSolver convention, i.e., perm[i] is the
+     * old index of the new row i
+     * @return true if the permutation was found in the cache
+     */
+    __host__ bool find_or_compute_permute(RXMeshStatic&       rx,
+                                          const PermuteMethod reorder,
+                                          const IndexT*       row_ptr,
+                                          const IndexT*       col_idx,
+                                          IndexT*             perm)
+    {
+        // look up the permutation of this pattern. The GPU orderings are
+        // computed from the mesh patches so the patches are part of the key
+        uint64_t pattern_hash =
+            csr_pattern_hash(m_num_rows, m_num_cols, row_ptr, col_idx);
+        if (reorder == PermuteMethod::GPUMGND ||
+            reorder == PermuteMethod::GPUND) {
+            pattern_hash = pattern_hash * 31 + rx.get_num_patches();
+        }
+        const bool cached = PermuteCache::instance().find(
+            pattern_hash, static_cast<int>(reorder), m_num_rows, perm);
+
+        if (cached) {
+            // perm is already filled from the cache
+        } else if (reorder == PermuteMethod::SYMRCM) {
+            CUSOLVER_ERROR(cusolverSpXcsrsymrcmHost(m_cusolver_sphandle,
+                                                    m_num_rows,
+                                                    m_nnz,
+                                                    m_descr,
+                                                    row_ptr,
+                                                    col_idx,
+                                                    perm));
+        } else if (reorder == PermuteMethod::SYMAMD) {
+            CUSOLVER_ERROR(cusolverSpXcsrsymamdHost(m_cusolver_sphandle,
+                                                    m_num_rows,
+                                                    m_nnz,
+                                                    m_descr,
+                                                    row_ptr,
+                                                    col_idx,
+                                                    perm));
+        } else if (reorder == PermuteMethod::NSTDIS) {
+            CUSOLVER_ERROR(cusolverSpXcsrmetisndHost(m_cusolver_sphandle,
+                                                     m_num_rows,
+                                                     m_nnz,
+                                                     m_descr,
+                                                     row_ptr,
+                                                     col_idx,
+                                                     NULL,
+                                                     perm));
+        } else if (reorder == PermuteMethod::GPUMGND ||
+                   reorder == PermuteMethod::GPUND) {
+            if (reorder == PermuteMethod::GPUMGND) {
+                mgnd_permute(rx, perm);
+            } else {
+                nd_permute(rx, perm);
+            }
+            // the GPU orderings are computed in the linear id order
+            if (m_h_row_order != nullptr) {
+                for (IndexT i = 0; i < m_num_rows; ++i) {
+                    perm[i] = m_h_row_order[perm[i]];
+                }
+            }
+        } else {
+            RXMESH_ERROR(
+                "SparseMatrix::find_or_compute_permute() incompatible reorder "
+                "method");
+        }
+
+        if (!cached) {
+            PermuteCache::instance().insert(
+                pattern_hash, static_cast<int>(reorder), m_num_rows, perm);
+        }
+        return cached;
+    }
+
     int reorder_to_int(const PermuteMethod& reorder) const
     {
         switch (reorder) {
@@ -1988,6 +2541,15 @@ struct SparseMatrix
     IndexT* m_h_permute_map;
     IndexT* m_d_permute_map;
 
+    // the new row (and column) of every linear id after reorder() (nullptr
+    // if the matrix is in the linear id order)
+    IndexT* m_h_row_order;
+    IndexT* m_d_row_order;
+
+    // changes with every reorder() so dense matrices in an older order are
+    // detected (see from_matrix())
+    uint64_t m_row_order_id;
+
     T* m_d_solver_b;
     T* m_d_solver_x;
 
@@ -0,0 +1,697 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include <omp.h>
+
+#include "rxmesh/context.h"
+#include "rxmesh/handle.h"
+#include "rxmesh/patch_info.h"
+#include "rxmesh/types.h"
+#include "rxmesh/util/instrument.h"
+#include "rxmesh/util/log.h"
+#include "rxmesh/util/util.h"
+
+namespace rxmesh {
+
+/**
+ * @brief description of the non-zero pattern of a sparse matrix defined by the
+ * mesh connectivity. The rows are the source element of the query op and the
+ * columns are its output element, e.g., Op::VF gives a #V x #F matrix. Op::V,
+ * Op::E, and Op::F give a diagonal pattern (e.g., a mass matrix)
+ */
+struct SparsePatternDesc
+{
+    Op op = Op::VV;
+
+    // number of rings of the stencil, e.g., 2 for the 2-ring of a vertex.
+    // Only used with square ops (VV, EE, FF)
+    uint32_t rings = 1;
+
+    // add the diagonal entries (stored first in every row). Only used with
+    // square ops
+    bool diagonal = true;
+
+    // replicate every entry into a (replicate x replicate) block, e.g., for
+    // vector-valued unknowns
+    uint32_t replicate = 1;
+
+    bool operator==(const SparsePatternDesc& other) const
+    {
+        return op == other.op && rings == other.rings &&
+               diagonal == other.diagonal && replicate == other.replicate;
+    }
+
+    bool operator!=(const SparsePatternDesc& other) const
+    {
+        return !(*this == other);
+    }
+
+    /**
+     * @brief true if the rows and columns are the same mesh element type
+     */
+    bool is_square() const
+    {
+        return op == Op::VV || op == Op::EE || op == Op::FF || op == Op::V ||
+               op == Op::E || op == Op::F;
+    }
+
+    /**
+     * @brief the same description with the unused fields reset so that
+     * descriptions of the same pattern compare equal
+     */
+    SparsePatternDesc normalized() const
+    {
+        SparsePatternDesc ret = *this;
+        if (!is_square()) {
+            ret.rings    = 1;
+            ret.diagonal = false;
+        }
+        if (op == Op::V || op == Op::E || op == Op::F) {
+            ret.rings = 1;
+        }
+        return ret;
+    }
+};
+
+/**
+ * @brief FNV-1a hash of a CSR structure (size, row pointer, and column index)
+ */
+inline size_t csr_pattern_hash(const int  num_rows,
+                               const int  num_cols,
+                               const int* row_ptr,
+                               const int* col_idx)
+{
+    uint64_t h = detail::fnv1a(&num_rows, sizeof(int));
+    h          = detail::fnv1a(&num_cols, sizeof(int), h);
+    if (row_ptr != nullptr) {
+        h = detail::fnv1a(row_ptr, (num_rows + 1) * sizeof(int), h);
+        h = detail::fnv1a(col_idx, row_ptr[num_rows] * sizeof(int), h);
+    }
+    return size_t(h);
+}
+
+/**
+ * @brief CSR non-zero pattern (row pointer and column index) built on the host.
+ * Rows and columns use the linear index of the mesh elements (see
+ * RXMeshStatic::linear_id()). If the pattern has diagonal entries, the
+ * diagonal is the first entry of the row and the rest of the row is sorted
+ */
+struct SparsePattern
+{
+    using IndexT = int;
+
+    SparsePatternDesc   desc;
+    IndexT              num_rows = 0;
+    IndexT              num_cols = 0;
+    std::vector<IndexT> row_ptr;
+    std::vector<IndexT> col_idx;
+
+    IndexT nnz() const
+    {
+        return row_ptr.empty() ? 0 : row_ptr.back();
+    }
+
+    /**
+     * @brief hash of the structure (size, row pointer, and column index) that
+     * identifies patterns with the same structure regardless of how they were
+     * built
+     */
+    size_t hash() const
+    {
+        return csr_pattern_hash(
+            num_rows, num_cols, row_ptr.data(), col_idx.data());
+    }
+
+    /**
+     * @brief host memory used by the pattern in bytes
+     */
+    size_t bytes() const
+    {
+        return (row_ptr.size() + col_idx.size()) * sizeof(IndexT);
+    }
+
+    /**
+     * @brief true if the pattern is made of dense k x k blocks, i.e., every
+     * row in a block row touches all the k columns of the same block columns
+     */
+    bool is_blocked(const IndexT k) const
+    {
+        if (k <= 0 || num_rows % k != 0 || num_cols % k != 0) {
+            return false;
+        }
+        if (k == 1) {
+            return true;
+        }
+
+        // number of entries of the current block row in every block column
+        std::vector<IndexT> count(num_cols / k, 0);
+        std::vector<IndexT> row_count(num_cols / k, 0);
+
+        for (IndexT br = 0; br < num_rows / k; ++br) {
+            for (IndexT r = br * k; r < (br + 1) * k; ++r) {
+                for (IndexT i = row_ptr[r]; i < row_ptr[r + 1]; ++i) {
+                    row_count[col_idx[i] / k]++;
+                }
+                // a row touches none or all the columns of a block column
+                for (IndexT i = row_ptr[r]; i < row_ptr[r + 1]; ++i) {
+                    const IndexT bc = col_idx[i] / k;
+                    if (row_count[bc] != 0 && row_count[bc] != k) {
+                        return false;
+                    }
+                    count[bc] += row_count[bc];
+                    row_count[bc] = 0;
+                }
+            }
+            // and every row of the block row touches the same block columns
+            for (IndexT i = row_ptr[br * k]; i < row_ptr[(br + 1) * k]; ++i) {
+                const IndexT bc = col_idx[i] / k;
+                if (count[bc] != 0 && count[bc] != k * k) {
+                    return false;
+                }
+                count[bc] = 0;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief the size of the dense blocks the pattern is made of. This is
+     * desc.replicate for patterns built from a description, but patterns
+     * produced by sparse algebra (e.g., spgemm() of replicated matrices) only
+     * carry a default description, so the block size is read from the
+     * structure: the largest k (that divides the first row length) for which
+     * is_blocked(k) holds
+     */
+    IndexT block_size() const
+    {
+        if (desc.replicate > 1 && is_blocked(IndexT(desc.replicate))) {
+            return IndexT(desc.replicate);
+        }
+        if (num_rows == 0 || nnz() == 0) {
+            return 1;
+        }
+        const IndexT len = row_ptr[1] - row_ptr[0];
+        for (IndexT k = len; k > 1; --k) {
+            if (len % k == 0 && is_blocked(k)) {
+                return k;
+            }
+        }
+        return 1;
+    }
+};
+
+namespace detail {
+
+template <typename HandleT>
+uint16_t pattern_num_local(const PatchInfo& pi)
+{
+    return pi.get_num_elements<HandleT>()[0];
+}
+
+/**
+ * @brief the source and output element of the ops supported by the pattern
+ * builder. Calls func with a default-constructed source and output handle
+ */
+template <typename FuncT>
+bool pattern_dispatch(const Op op, FuncT func)
+{
+    switch (op) {
+        case Op::V:
+        case Op::VV:
+            func(VertexHandle(), VertexHandle());
+            return true;
+        case Op::VE:
+            func(VertexHandle(), EdgeHandle());
+            return true;
+        case Op::VF:
+            func(VertexHandle(), FaceHandle());
+            return true;
+        case Op::E:
+        case Op::EE:
+            func(EdgeHandle(), EdgeHandle());
+            return true;
+        case Op::EV:
+            func(EdgeHandle(), VertexHandle());
+            return true;
+        case Op::EF:
+            func(EdgeHandle(), FaceHandle());
+            return true;
+        case Op::F:
+        case Op::FF:
+            func(FaceHandle(), FaceHandle());
+            return true;
+        case Op::FV:
+            func(FaceHandle(), VertexHandle());
+            return true;
+        case Op::FE:
+            func(FaceHandle(), EdgeHandle());
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief the local (within a patch) adjacency of an op stored as CSR. Built
+ * from the patch EV and FE. The ribbon guarantees that the adjacency of the
+ * owned elements is complete
+ */
+struct LocalAdjacency
+{
+    std::vector<uint32_t> offset;
+    std::vector<uint16_t> value;
+
+    template <typename SrcHandleT>
+    void build(const Op op, const PatchInfo& pi)
+    {
+        const uint16_t num_src = pattern_num_local<SrcHandleT>(pi);
+        const uint16_t num_e   = pattern_num_local<EdgeHandle>(pi);
+        const uint16_t num_f   = pattern_num_local<FaceHandle>(pi);
+
+        std::vector<std::pair<uint16_t, uint16_t>> pairs;
+
+        auto face_edges = [&](const uint16_t f, uint16_t* e, flag_t* d) {
+            for (int i = 0; i < 3; ++i) {
+                Context::unpack_edge_dir(pi.fe[3 * f + i].id, e[i], d[i]);
+            }
+        };
+
+        if (op == Op::VV || op == Op::VE || op == Op::EV) {
+            for (uint16_t e = 0; e < num_e; ++e) {
+                if (pi.is_deleted(LocalEdgeT(e))) {
+                    continue;
+                }
+                const uint16_t v0 = pi.ev[2 * e + 0].id;
+                const uint16_t v1 = pi.ev[2 * e + 1].id;
+                if (op == Op::VV) {
+                    pairs.push_back({v0, v1});
+                    pairs.push_back({v1, v0});
+                } else if (op == Op::VE) {
+                    pairs.push_back({v0, e});
+                    pairs.push_back({v1, e});
+                } else {
+                    pairs.push_back({e, v0});
+                    pairs.push_back({e, v1});
+                }
+            }
+        } else if (op == Op::FF) {
+            // faces incident to every edge then pair them up
+            std::vector<std::vector<uint16_t>> ef(num_e);
+            for (uint16_t f = 0; f < num_f; ++f) {
+                if (pi.is_deleted(LocalFaceT(f))) {
+                    continue;
+                }
+                uint16_t e[3];
+                flag_t   d[3];
+                face_edges(f, e, d);
+                for (int i = 0; i < 3; ++i) {
+                    ef[e[i]].push_back(f);
+                }
+            }
+            for (const auto& fs : ef) {
+                for (size_t a = 0; a < fs.size(); ++a) {
+                    for (size_t b = 0; b < fs.size(); ++b) {
+                        if (a != b) {
+                            pairs.push_back({fs[a], fs[b]});
+                        }
+                    }
+                }
+            }
+        } else if (op != Op::V && op != Op::E && op != Op::F) {
+            for (uint16_t f = 0; f < num_f; ++f) {
+                if (pi.is_deleted(LocalFaceT(f))) {
+                    continue;
+                }
+                uint16_t e[3];
+                flag_t   d[3];
+                face_edges(f, e, d);
+                for (int i = 0; i < 3; ++i) {
+                    // the first vertex of the edge along the face orientation
+                    const uint16_t v = pi.ev[2 * e[i] + d[i]].id;
+                    switch (op) {
+                        case Op::FV:
+                            pairs.push_back({f, v});
+                            break;
+                        case Op::VF:
+                            pairs.push_back({v, f});
+                            break;
+                        case Op::FE:
+                            pairs.push_back({f, e[i]});
+                            break;
+                        case Op::EF:
+                            pairs.push_back({e[i], f});
+                            break;
+                        case Op::EE:
+                            pairs.push_back({e[i], e[(i + 1) % 3]});
+                            pairs.push_back({e[i], e[(i + 2) % 3]});
+                            break;
+                        default:
+                            break;
+                    }
+                }
+            }
+        }
+
+        // counting sort by source
+        offset.assign(num_src + 1, 0);
+        for (const auto& p : pairs) {
+            offset[p.first + 1]++;
+        }
+        for (uint32_t s = 0; s < num_src; ++s) {
+            offset[s + 1] += offset[s];
+        }
+        value.resize(pairs.size());
+        std::vector<uint32_t> pos(offset.begin(), offset.end() - 1);
+        for (const auto& p : pairs) {
+            value[pos[p.first]++] = p.second;
+        }
+    }
+};
+
+/**
+ * @brief linear index of every local element in a patch. INVALID32 for
+ * deleted elements
+ */
+template <typename HandleT, typename MeshT>
+void pattern_local_to_linear(const MeshT&           rx,
+                             const uint32_t         p,
+                             std::vector<uint32_t>& ltol)
+{
+    using LocalT         = typename HandleT::LocalT;
+    const PatchInfo& pi  = rx.get_patch(p);
+    const uint16_t   n   = pattern_num_local<HandleT>(pi);
+    const auto&      map = rx.template get_index_map<HandleT>();
+    ltol.resize(n);
+    for (uint16_t l = 0; l < n; ++l) {
+        ltol[l] = pi.is_deleted(LocalT(l)) ?
+                      INVALID32 :
+                      map.linear_id(HandleT(p, LocalT(l)));
+    }
+}
+
+/**
+ * @brief build the 1-ring pattern (no diagonal, no replication) in two passes
+ * over patches. First pass counts the unique neighbors of every owned element.
+ * Second pass fills the column index after the prefix sum. Both passes are
+ * run with the mesh host schedule
+ */
+template <typename SrcHandleT, typename DstHandleT, typename MeshT>
+void build_one_ring_pattern(const MeshT& rx, const Op op, SparsePattern& ret)
+{
+    using IndexT     = SparsePattern::IndexT;
+    using SrcLocalT  = typename SrcHandleT::LocalT;
+    const bool self  = std::is_same_v<SrcHandleT, DstHandleT>;
+    const bool empty = (op == Op::V || op == Op::E || op == Op::F);
+
+    ret.num_rows = rx.template get_num_elements<SrcHandleT>();
+    ret.num_cols = rx.template get_num_elements<DstHandleT>();
+    ret.row_ptr.assign(ret.num_rows + 1, 0);
+
+    const uint32_t num_patches = rx.get_num_patches();
+
+    // pass = 0 count, pass = 1 fill
+    auto run_pass = [&](const int pass) {
+        rx.get_host_schedule().run(num_patches, [&](const uint32_t p) {
+            const PatchInfo& pi = rx.get_patch(p);
+
+            LocalAdjacency adj;
+            if (!empty) {
+                adj.build<SrcHandleT>(op, pi);
+            }
+
+            std::vector<uint32_t> src_ltol, dst_ltol;
+            pattern_local_to_linear<SrcHandleT>(rx, p, src_ltol);
+            pattern_local_to_linear<DstHandleT>(rx, p, dst_ltol);
+
+            std::vector<IndexT> cols;
+            for (uint16_t s = 0; s < src_ltol.size(); ++s) {
+                if (src_ltol[s] == INVALID32 || !pi.is_owned(SrcLocalT(s))) {
+                    continue;
+                }
+                const IndexT row = src_ltol[s];
+                cols.clear();
+                if (!empty) {
+                    for (uint32_t i = adj.offset[s]; i < adj.offset[s + 1];
+                         ++i) {
+                        const uint32_t c = dst_ltol[adj.value[i]];
+                        if (c != INVALID32 && !(self && IndexT(c) == row)) {
+                            cols.push_back(c);
+                        }
+                    }
+                    std::sort(cols.begin(), cols.end());
+                    cols.erase(std::unique(cols.begin(), cols.end()),
+                               cols.end());
+                }
+                if (pass == 0) {
+                    ret.row_ptr[row + 1] = IndexT(cols.size());
+                } else {
+                    std::copy(cols.begin(),
+                              cols.end(),
+                              ret.col_idx.begin() + ret.row_ptr[row]);
+                }
+            }
+        });
+    };
+
+    run_pass(0);
+    for (IndexT r = 0; r < ret.num_rows; ++r) {
+        ret.row_ptr[r + 1] += ret.row_ptr[r];
+    }
+    ret.col_idx.resize(ret.row_ptr.back());
+    run_pass(1);
+}
+
+/**
+ * @brief expand a 1-ring pattern to k rings, add the diagonal, and replicate
+ * every entry into a block. Two passes over rows: count then fill
+ */
+inline void expand_pattern(const SparsePattern&     one_ring,
+                           const SparsePatternDesc& desc,
+                           SparsePattern&           ret)
+{
+    using IndexT = SparsePattern::IndexT;
+
+    const bool   square = desc.is_square();
+    const IndexT k      = std::max<uint32_t>(1, desc.replicate);
+    const IndexT n      = one_ring.num_rows;
+    const bool   diag   = square && desc.diagonal;
+    const bool   rings  = square && desc.rings > 1;
+
+    ret.num_rows = one_ring.num_rows * k;
+    ret.num_cols = one_ring.num_cols * k;
+    ret.row_ptr.assign(ret.num_rows + 1, 0);
+
+    // the sorted block columns of a row (excluding the diagonal)
+    auto block_cols = [&](const IndexT r,
+                          std::vector<IndexT>&  cols,
+                          std::vector<IndexT>&  frontier,
+                          std::vector<IndexT>&  next,
+                          std::vector<uint8_t>& visited) {
+        cols.clear();
+        if (!rings) {
+            cols.assign(one_ring.col_idx.begin() + one_ring.row_ptr[r],
+                        one_ring.col_idx.begin() + one_ring.row_ptr[r + 1]);
+            return;
+        }
+        // breadth-first search over the 1-ring
+        frontier.assign(1, r);
+        visited[r] = 1;
+        for (uint32_t ring = 0; ring < desc.rings && !frontier.empty();
+             ++ring) {
+            next.clear();
+            for (const IndexT u : frontier) {
+                for (IndexT i = one_ring.row_ptr[u];
+                     i < one_ring.row_ptr[u + 1];
+                     ++i) {
+                    const IndexT c = one_ring.col_idx[i];
+                    if (!visited[c]) {
+                        visited[c] = 1;
+                        next.push_back(c);
+                        cols.push_back(c);
+                    }
+                }
+            }
+            std::swap(frontier, next);
+        }
+        visited[r] = 0;
+        for (const IndexT c : cols) {
+            visited[c] = 0;
+        }
+        std::sort(cols.begin(), cols.end());
+    };
+
+    auto run_pass = [&](const int pass) {
+#pragma omp parallel
+        {
+            std::vector<IndexT>  cols, frontier, next;
+            std::vector<uint8_t> visited(rings ? n : 0, 0);
+#pragma omp for schedule(dynamic, 1024)
+            for (IndexT r = 0; r < n; ++r) {
+                block_cols(r, cols, frontier, next, visited);
+                const IndexT num_blocks = IndexT(cols.size()) + (diag ? 1 : 0);
+                for (IndexT i = 0; i < k; ++i) {
+                    const IndexT row = r * k + i;
+                    if (pass == 0) {
+                        ret.row_ptr[row + 1] = num_blocks * k;
+                        continue;
+                    }
+                    IndexT offset = ret.row_ptr[row];
+                    if (diag) {
+                        for (IndexT j = 0; j < k; ++j) {
+                            ret.col_idx[offset++] = r * k + j;
+                        }
+                    }
+                    for (const IndexT c : cols) {
+                        for (IndexT j = 0; j < k; ++j) {
+                            ret.col_idx[offset++] = c * k + j;
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    run_pass(0);
+    for (IndexT r = 0; r < ret.num_rows; ++r) {
+        ret.row_ptr[r + 1] += ret.row_ptr[r];
+    }
+    ret.col_idx.resize(ret.row_ptr.back());
+    run_pass(1);
+}
+}  // namespace detail
+
+/**
+ * @brief build the CSR pattern described by desc on the host
+ * @param rx the input mesh (RXMeshStatic or RXMeshDynamic after update_host())
+ * @param desc the pattern description
+ */
+template <typename MeshT>
+std::shared_ptr<SparsePattern> build_sparse_pattern(
+    const MeshT&             rx,
+    const SparsePatternDesc& desc)
+{
+    RXMESH_ZONE("build_sparse_pattern");
+
+    auto ret  = std::make_shared<SparsePattern>();
+    ret->desc = desc;
+
+    if (desc.replicate == 0) {
+        RXMESH_ERROR("build_sparse_pattern() replicate should be at least 1");
+        return ret;
+    }
+
+    SparsePattern one_ring;
+
+    const bool supported =
+        detail::pattern_dispatch(desc.op, [&](auto src, auto dst) {
+            using SrcHandleT = decltype(src);
+            using DstHandleT = decltype(dst);
+            detail::build_one_ring_pattern<SrcHandleT, DstHandleT>(
+                rx, desc.op, one_ring);
+        });
+
+    if (!supported) {
+        RXMESH_ERROR("build_sparse_pattern() unsupported op {}",
+                     op_to_string(desc.op));
+        return ret;
+    }
+
+    if (!desc.is_square() && desc.rings != 1) {
+        RXMESH_WARN("build_sparse_pattern() rings is ignored for op {}",
+                    op_to_string(desc.op));
+    }
+
+    const bool diag  = desc.is_square() && desc.diagonal;
+    const bool rings = desc.is_square() && desc.rings > 1;
+    if (desc.replicate == 1 && !diag && !rings) {
+        one_ring.desc = desc;
+        *ret          = std::move(one_ring);
+    } else {
+        detail::expand_pattern(one_ring, desc, *ret);
+    }
+    return ret;
+}
+
+/**
+ * @brief cache of the patterns built for one mesh so matrices with the same
+ * structure (e.g., the Laplacian and the mass matrix of the same stencil) do
+ * not rebuild it. Must be cleared when the mesh topology changes
+ */
+class SparsePatternCache
+{
+   public:
+    template <typename MeshT>
+    std::shared_ptr<const SparsePattern> get(const MeshT&             rx,
+                                             const SparsePatternDesc& input)
+    {
+        const SparsePatternDesc desc = input.normalized();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (auto p = find(desc)) {
+                m_num_hits++;
+                return p;
+            }
+        }
+
+        // build outside the lock since it runs in parallel
+        std::shared_ptr<SparsePattern> pattern = build_sparse_pattern(rx, desc);
+
+        // another thread may have inserted the same pattern in the meantime.
+        // Keep the first one so all the matrices share it
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_num_misses++;
+        if (auto p = find(desc)) {
+            return p;
+        }
+        m_patterns.push_back(pattern);
+        return pattern;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_patterns.clear();
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_patterns.size();
+    }
+
+    uint32_t get_num_hits() const
+    {
+        return m_num_hits;
+    }
+
+    uint32_t get_num_misses() const
+    {
+        return m_num_misses;
+    }
+
+   private:
+    // the cached pattern with this (normalized) description or nullptr.
+    // Should be called with the lock held
+    std::shared_ptr<SparsePattern> find(const SparsePatternDesc& desc) const
+    {
+        for (const auto& p : m_patterns) {
+            if (p->desc == desc) {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+
+    mutable std::mutex                          m_mutex;
+    std::vector<std::shared_ptr<SparsePattern>> m_patterns;
+    uint32_t                                    m_num_hits   = 0;
+    uint32_t                                    m_num_misses = 0;
+};
+}  // namespace rxmesh
@@ -0,0 +1,548 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include <cuda_bf16.h>
+#include <cuda_fp16.h>
+
+#include "rxmesh/attribute.h"
+
+namespace rxmesh {
+
+/**
+ * @brief 16-bit fixed-point storage. The value is decoded as
+ * offset + scale * q where scale and offset are stored per patch
+ */
+struct quant16_t
+{
+    uint16_t q;
+};
+
+namespace detail {
+
+/**
+ * @brief conversion between the storage type and the compute type of a
+ * MixedAttribute. The quantization parameters (x = scale, y = offset) are only
+ * used by quant16_t
+ */
+template <typename StorageT>
+struct StorageConverter
+{
+    static constexpr bool is_quantized = false;
+
+    template <typename ComputeT>
+    __host__ __device__ __forceinline__ static ComputeT to_compute(
+        const StorageT& s,
+        const float2&)
+    {
+        return static_cast<ComputeT>(s);
+    }
+
+    template <typename ComputeT>
+    __host__ __device__ __forceinline__ static StorageT to_storage(
+        const ComputeT& v,
+        const float2&)
+    {
+        return static_cast<StorageT>(v);
+    }
+};
+
+template <>
+struct StorageConverter<__half>
+{
+    static constexpr bool is_quantized = false;
+
+    template <typename ComputeT>
+    __host__ __device__ __forceinline__ static ComputeT to_compute(
+        const __half& s,
+        const float2&)
+    {
+        return static_cast<ComputeT>(__half2float(s));
+    }
+
+    template <typename ComputeT>
+    __host__ __device__ __forceinline__ static __half to_storage(
+        const ComputeT& v,
+        const float2&)
+    {
+        return __float2half(static_cast<float>(v));
+    }
+};
+
+template <>
+struct StorageConverter<__nv_bfloat16>
+{
+    static constexpr bool is_quantized = false;
+
+    template <typename ComputeT>
+    __host__ __device__ __forceinline__ static ComputeT to_compute(
+        const __nv_bfloat16& s,
+        const float2&)
+    {
+        return static_cast<ComputeT>(__bfloat162float(s));
+    }
+
+    template <typename ComputeT>
+    __host__ __device__ __forceinline__ static __nv_bfloat16 to_storage(
+        const ComputeT& v,
+        const float2&)
+    {
+        return __float2bfloat16(static_cast<float>(v));
+    }
+};
+
+template <>
+struct StorageConverter<quant16_t>
+{
+    static constexpr bool is_quantized = true;
+
+    template <typename ComputeT>
+    __host__ __device__ __forceinline__ static ComputeT to_compute(
+        const quant16_t& s,
+        const float2&    q)
+    {
+        return static_cast<ComputeT>(q.y + q.x * static_cast<float>(s.q));
+    }
+
+    template <typename ComputeT>
+    __host__ __device__ __forceinline__ static quant16_t to_storage(
+        const ComputeT& v,
+        const float2&   q)
+    {
+        float t = (static_cast<float>(v) - q.y) / q.x;
+        t       = fminf(fmaxf(t, 0.f), 65535.f);
+        return quant16_t{static_cast<uint16_t>(t + 0.5f)};
+    }
+};
+}  // namespace detail
+
+
+/**
+ * @brief An attribute that keeps its values in a compact storage type
+ * (__half, __nv_bfloat16, or quant16_t) and exposes them as ComputeT. Reading
+ * converts to ComputeT and writing converts back to StorageT so kernels compute
+ * in full precision while moving half the bytes. The storage, allocation,
+ * layout, and move() are those of Attribute<StorageT, HandleT>. move() and
+ * release() are virtual so the quantization parameters follow the values
+ * when called through Attribute<StorageT, HandleT>
+ * @tparam ComputeT the type used in computation, e.g., float
+ * @tparam StorageT the type stored in memory
+ * @tparam HandleT the handle type of the mesh element
+ */
+template <typename ComputeT, typename StorageT, typename HandleT>
+class MixedAttribute : public Attribute<StorageT, HandleT>
+{
+    using ConverterT = detail::StorageConverter<StorageT>;
+
+   public:
+    using ComputeType = ComputeT;
+    using StorageType = StorageT;
+    using BaseType    = Attribute<StorageT, HandleT>;
+
+    /**
+     * @brief proxy returned by operator() that converts on read and write
+     */
+    struct Reference
+    {
+        __host__ __device__ __forceinline__ Reference(StorageT*     ptr,
+                                                      const float2& q)
+            : m_ptr(ptr), m_q(q)
+        {
+        }
+
+        __host__ __device__ __forceinline__ operator ComputeT() const
+        {
+            return ConverterT::template to_compute<ComputeT>(*m_ptr, m_q);
+        }
+
+        __host__ __device__ __forceinline__ Reference& operator=(
+            const ComputeT& v)
+        {
+            *m_ptr = ConverterT::template to_storage<ComputeT>(v, m_q);
+            return *this;
+        }
+
+        __host__ __device__ __forceinline__ Reference& operator=(
+            const Reference& other)
+        {
+            return this->operator=(static_cast<ComputeT>(other));
+        }
+
+        __host__ __device__ __forceinline__ Reference& operator+=(
+            const ComputeT& v)
+        {
+            return this->operator=(static_cast<ComputeT>(*this) + v);
+        }
+
+        __host__ __device__ __forceinline__ Reference& operator-=(
+            const ComputeT& v)
+        {
+            return this->operator=(static_cast<ComputeT>(*this) - v);
+        }
+
+        __host__ __device__ __forceinline__ Reference& operator*=(
+            const ComputeT& v)
+        {
+            return this->operator=(static_cast<ComputeT>(*this) * v);
+        }
+
+        __host__ __device__ __forceinline__ Reference& operator/=(
+            const ComputeT& v)
+        {
+            return this->operator=(static_cast<ComputeT>(*this) / v);
+        }
+
+       private:
+        StorageT* m_ptr;
+        float2    m_q;
+    };
+
+    MixedAttribute()
+        : BaseType(), m_h_quant(nullptr), m_d_quant(nullptr)
+    {
+    }
+
+    explicit MixedAttribute(const char*   name,
+                            uint32_t      num_attributes,
+                            locationT     location,
+                            layoutT       layout,
+                            RXMeshStatic* rxmesh)
+        : BaseType(name, num_attributes, location, layout, rxmesh),
+          m_h_quant(nullptr),
+          m_d_quant(nullptr)
+    {
+        if constexpr (ConverterT::is_quantized) {
+            m_h_quant = host_malloc<float2>(this->m_max_num_patches,
+                                            HostMemTag::Attribute);
+            if ((location & DEVICE) == DEVICE) {
+                CUDA_ERROR(
+                    cudaMalloc((void**)&m_d_quant,
+                               sizeof(float2) * this->m_max_num_patches));
+            }
+            set_range(ComputeT(0), ComputeT(1));
+        }
+    }
+
+    MixedAttribute(const MixedAttribute& rhs) = default;
+
+    virtual ~MixedAttribute() = default;
+
+    /**
+     * @brief set the same quantization range [lower, upper] for all patches.
+     * Only meaningful for quant16_t storage. Values already stored are not
+     * re-encoded
+     */
+    void set_range(const ComputeT lower, const ComputeT upper)
+    {
+        if constexpr (ConverterT::is_quantized) {
+            for (uint32_t p = 0; p < this->m_max_num_patches; ++p) {
+                m_h_quant[p] = make_quant(float(lower), float(upper));
+            }
+            sync_quant();
+        }
+    }
+
+    /**
+     * @brief read a value converted to ComputeT
+     */
+    __host__ __device__ __forceinline__ ComputeT get(
+        const HandleT  handle,
+        const uint32_t attr = 0) const
+    {
+        auto pl = handle.unpack();
+        return ConverterT::template to_compute<ComputeT>(
+            BaseType::operator()(pl.first, pl.second, attr), quant(pl.first));
+    }
+
+    /**
+     * @brief write a ComputeT value converted to the storage type
+     */
+    __host__ __device__ __forceinline__ void set(const HandleT   handle,
+                                                 const uint32_t  attr,
+                                                 const ComputeT& v) const
+    {
+        auto pl = handle.unpack();
+        BaseType::operator()(pl.first, pl.second, attr) =
+            ConverterT::template to_storage<ComputeT>(v, quant(pl.first));
+    }
+
+    /**
+     * @brief Accessing an attribute using a handle to the mesh element
+     * @param handle input handle
+     * @param attr the attribute id
+     * @return a proxy that reads and writes ComputeT
+     */
+    __host__ __device__ __forceinline__ Reference
+    operator()(const HandleT handle, const uint32_t attr = 0) const
+    {
+        auto pl = handle.unpack();
+        return this->operator()(pl.first, pl.second, attr);
+    }
+
+    /**
+     * @brief Access the attribute value using patch and local index in the
+     * patch
+     */
+    __host__ __device__ __forceinline__ Reference
+    operator()(const uint32_t p_id,
+               const uint16_t local_id,
+               const uint32_t attr) const
+    {
+        return Reference(&BaseType::operator()(p_id, local_id, attr),
+                         quant(p_id));
+    }
+
+    /**
+     * @brief Accessing the attribute a glm vector of ComputeT. The return
+     * result is a copy.
+     */
+    template <int N>
+    __host__ __device__ __inline__ vec<ComputeT, N> to_glm(
+        const HandleT& handle) const
+    {
+        assert(N == this->get_num_attributes());
+
+        vec<ComputeT, N> ret;
+
+        for (int i = 0; i < N; ++i) {
+            ret[i] = get(handle, i);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief Accessing the attribute a Eigen matrix of ComputeT. The return
+     * result is a copy.
+     */
+    template <int N>
+    __host__ __device__ __inline__ Eigen::Matrix<ComputeT, N, 1> to_eigen(
+        const HandleT& handle) const
+    {
+        assert(N == this->get_num_attributes());
+
+        Eigen::Matrix<ComputeT, N, 1> ret;
+
+        for (Eigen::Index i = 0; i < N; ++i) {
+            ret[i] = get(handle, i);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief convert a full-precision attribute into this attribute on the
+     * host. Both attributes should have the same number of attributes. If
+     * this attribute is allocated on the device, the result is also moved to
+     * the device
+     * @param source the full-precision attribute allocated on the host
+     * @param fit_range for quant16_t storage, fit the quantization range of
+     * every patch to the patch values. Otherwise, the current range is used
+     */
+    void from_attribute(const Attribute<ComputeT, HandleT>& source,
+                        const bool                          fit_range = true)
+    {
+        if (!check_source(source, "from_attribute")) {
+            return;
+        }
+
+        const bool same_layout = source.get_layout() == this->m_layout;
+
+        this->m_rxmesh->get_host_schedule().run(
+            this->m_rxmesh->get_num_patches(), [&](uint32_t p) {
+                const uint32_t size = this->size(p);
+                const uint32_t na   = this->m_num_attributes;
+
+                if (ConverterT::is_quantized && fit_range) {
+                    float lower = 0, upper = 0;
+                    bool  first = true;
+                    for (uint16_t l = 0; l < size; ++l) {
+                        for (uint32_t a = 0; a < na; ++a) {
+                            const float v = float(source(p, l, a));
+                            lower = first ? v : std::min(lower, v);
+                            upper = first ? v : std::max(upper, v);
+                            first = false;
+                        }
+                    }
+                    m_h_quant[p] = make_quant(lower, upper);
+                }
+
+                const float2 q = m_h_quant ? m_h_quant[p] : float2();
+                if (size == 0) {
+                    return;
+                }
+
+                if (same_layout) {
+                    // both buffers are contiguous with the same pitch
+                    const ComputeT* src = &source(p, 0, 0);
+                    StorageT*       dst = this->m_h_attr[p];
+                    const uint32_t  n   = this->patch_storage_size(p);
+#pragma omp simd
+                    for (uint32_t i = 0; i < n; ++i) {
+                        dst[i] = ConverterT::template to_storage<ComputeT>(
+                            src[i], q);
+                    }
+                } else {
+                    for (uint16_t l = 0; l < size; ++l) {
+                        for (uint32_t a = 0; a < na; ++a) {
+                            BaseType::operator()(p, l, a) =
+                                ConverterT::template to_storage<ComputeT>(
+                                    source(p, l, a), q);
+                        }
+                    }
+                }
+            });
+
+        sync_quant();
+
+        if (this->is_device_allocated()) {
+            BaseType::move(HOST, DEVICE);
+        }
+    }
+
+    /**
+     * @brief convert this attribute to a full-precision attribute on the host
+     * @param dest the full-precision attribute allocated on the host with the
+     * same number of attributes
+     */
+    void to_attribute(Attribute<ComputeT, HandleT>& dest) const
+    {
+        if (!check_source(dest, "to_attribute")) {
+            return;
+        }
+
+        const bool same_layout = dest.get_layout() == this->m_layout;
+
+        this->m_rxmesh->get_host_schedule().run(
+            this->m_rxmesh->get_num_patches(), [&](uint32_t p) {
+                const uint32_t size = this->size(p);
+                const uint32_t na   = this->m_num_attributes;
+                const float2   q    = m_h_quant ? m_h_quant[p] : float2();
+                if (size == 0) {
+                    return;
+                }
+
+                if (same_layout) {
+                    const StorageT* src = this->m_h_attr[p];
+                    ComputeT*       dst = &dest(p, 0, 0);
+                    const uint32_t  n   = this->patch_storage_size(p);
+#pragma omp simd
+                    for (uint32_t i = 0; i < n; ++i) {
+                        dst[i] = ConverterT::template to_compute<ComputeT>(
+                            src[i], q);
+                    }
+                } else {
+                    for (uint16_t l = 0; l < size; ++l) {
+                        for (uint32_t a = 0; a < na; ++a) {
+                            dest(p, l, a) =
+                                ConverterT::template to_compute<ComputeT>(
+                                    BaseType::operator()(p, l, a), q);
+                        }
+                    }
+                }
+            });
+    }
+
+    /**
+     * @brief Copy memory from one location to another including the
+     * quantization parameters
+     */
+    void move(locationT    source,
+              locationT    target,
+              cudaStream_t stream = NULL) override
+    {
+        BaseType::move(source, target, stream);
+        if constexpr (ConverterT::is_quantized) {
+            if ((target & DEVICE) == DEVICE && m_d_quant == nullptr) {
+                CUDA_ERROR(
+                    cudaMalloc((void**)&m_d_quant,
+                               sizeof(float2) * this->m_max_num_patches));
+                sync_quant();
+            }
+        }
+    }
+
+    /**
+     * @brief Release allocated memory in certain location
+     */
+    void release(locationT location = LOCATION_ALL) override
+    {
+        BaseType::release(location);
+        if ((location & DEVICE) == DEVICE) {
+            GPU_FREE(m_d_quant);
+        }
+        if ((location & HOST) == HOST && m_h_quant != nullptr) {
+            host_free(m_h_quant);
+            m_h_quant = nullptr;
+        }
+    }
+
+   private:
+    __host__ __device__ __forceinline__ float2 quant(const uint32_t p) const
+    {
+        if constexpr (ConverterT::is_quantized) {
+#ifdef __CUDA_ARCH__
+            return m_d_quant[p];
+#else
+            return m_h_quant[p];
+#endif
+        } else {
+            return float2();
+        }
+    }
+
+    static float2 make_quant(const float lower, const float upper)
+    {
+        float2 q;
+        q.x = (upper > lower) ? (upper - lower) / 65535.f : 1.f;
+        q.y = lower;
+        return q;
+    }
+
+    void sync_quant()
+    {
+        if (m_d_quant != nullptr && m_h_quant != nullptr) {
+            CUDA_ERROR(cudaMemcpy(m_d_quant,
+                                  m_h_quant,
+                                  sizeof(float2) * this->m_max_num_patches,
+                                  cudaMemcpyHostToDevice));
+        }
+    }
+
+    bool check_source(const Attribute<ComputeT, HandleT>& other,
+                      const char*                         caller) const
+    {
+        if (!this->is_host_allocated() || !other.is_host_allocated()) {
+            RXMESH_ERROR(
+                "MixedAttribute::{}() both attributes should be allocated on "
+                "the host",
+                caller);
+            return false;
+        }
+        if (other.get_num_attributes() != this->m_num_attributes) {
+            RXMESH_ERROR(
+                "MixedAttribute::{}() mismatch number of attributes ({} vs. "
+                "{})",
+                caller,
+                other.get_num_attributes(),
+                this->m_num_attributes);
+            return false;
+        }
+        return true;
+    }
+
+    float2* m_h_quant;
+    float2* m_d_quant;
+};
+
+template <typename ComputeT, typename StorageT>
+using MixedVertexAttribute = MixedAttribute<ComputeT, StorageT, VertexHandle>;
+
+template <typename ComputeT, typename StorageT>
+using MixedEdgeAttribute = MixedAttribute<ComputeT, StorageT, EdgeHandle>;
+
+template <typename ComputeT, typename StorageT>
+using MixedFaceAttribute = MixedAttribute<ComputeT, StorageT, FaceHandle>;
+
+}  // namespace rxmesh
@@ -0,0 +1,611 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include <omp.h>
+
+#include "rxmesh/context.h"
+#include "rxmesh/handle.h"
+#include "rxmesh/patch_info.h"
+#include "rxmesh/types.h"
+#include "rxmesh/util/bitmask_util.h"
+#include "rxmesh/util/host_memory.h"
+#include "rxmesh/util/instrument.h"
+#include "rxmesh/util/log.h"
+#include "rxmesh/util/macros.h"
+
+namespace rxmesh {
+
+/**
+ * @brief a contiguous range of handles, e.g., the oriented one-ring of a
+ * vertex. It has the same accessors as Iterator so code written for query
+ * iterators works with it
+ */
+template <typename HandleT>
+struct OneRingIterator
+{
+    __host__ __device__ OneRingIterator() : m_begin(nullptr), m_size(0)
+    {
+    }
+
+    __host__ __device__ OneRingIterator(const HandleT* begin,
+                                        const uint32_t size)
+        : m_begin(begin), m_size(size)
+    {
+    }
+
+    __host__ __device__ __forceinline__ uint32_t size() const
+    {
+        return m_size;
+    }
+
+    __host__ __device__ __forceinline__ HandleT
+    operator[](const uint32_t i) const
+    {
+        assert(i < m_size);
+        return m_begin[i];
+    }
+
+    __host__ __device__ __forceinline__ HandleT front() const
+    {
+        return (*this)[0];
+    }
+
+    __host__ __device__ __forceinline__ HandleT back() const
+    {
+        return (*this)[m_size - 1];
+    }
+
+   private:
+    const HandleT* m_begin;
+    uint32_t       m_size;
+};
+
+/**
+ * @brief the oriented one-ring (Op::VV, Op::VE, and Op::VF) of every vertex
+ * stored as CSR. The neighbors are sorted counter-clockwise with respect to
+ * the face orientation. For a boundary vertex, the ring starts and ends at a
+ * boundary edge and VV/VE have one more entry than VF. The i-th face is
+ * between the i-th and (i+1)-th neighbor vertex (edge) in both cases.
+ * Non-manifold vertices get one ordered fan after another.
+ *
+ * The order is computed once on the host in parallel over patches using only
+ * the patch-local topology since the one-ring of an owned vertex is complete
+ * within its patch thanks to the ribbon. Iterating over the cached order
+ * costs the same as an unoriented query. OrientedOneRing is a lightweight
+ * object that can be captured by value in host and device lambdas. The device
+ * copy is uploaded with move(HOST, DEVICE). Memory is freed explicitly with
+ * release()
+ */
+class OrientedOneRing
+{
+   public:
+    /**
+     * @brief Default constructor which initializes all pointers to nullptr
+     */
+    OrientedOneRing()
+        : m_num_patches(0),
+          m_num_rows(0),
+          m_num_locals(0),
+          m_nnz_vv(0),
+          m_nnz_vf(0),
+          m_allocated(LOCATION_NONE),
+          m_h_patch_offset(nullptr),
+          m_h_local_to_row(nullptr),
+          m_h_vv_offset(nullptr),
+          m_h_vf_offset(nullptr),
+          m_h_vv(nullptr),
+          m_h_ve(nullptr),
+          m_h_vf(nullptr),
+          m_d_patch_offset(nullptr),
+          m_d_local_to_row(nullptr),
+          m_d_vv_offset(nullptr),
+          m_d_vf_offset(nullptr),
+          m_d_vv(nullptr),
+          m_d_ve(nullptr),
+          m_d_vf(nullptr)
+    {
+    }
+
+    /**
+     * @brief build the oriented one-ring of every vertex on the host and
+     * optionally upload it to the device
+     * @param rx the input mesh (RXMeshStatic or RXMeshDynamic after
+     * update_host())
+     * @param location where the result should be available
+     */
+    template <typename MeshT>
+    OrientedOneRing(const MeshT& rx, locationT location) : OrientedOneRing()
+    {
+        RXMESH_ZONE("OrientedOneRing::build");
+
+        m_num_patches = rx.get_num_patches();
+
+        build(rx);
+
+        if ((location & DEVICE) == DEVICE) {
+            move(HOST, DEVICE);
+        }
+    }
+
+    OrientedOneRing(const OrientedOneRing& rhs) = default;
+
+    /**
+     * @brief the number of (owned) vertices i.e., number of CSR rows
+     */
+    __host__ __device__ __forceinline__ uint32_t get_num_rows() const
+    {
+        return m_num_rows;
+    }
+
+    /**
+     * @brief the CSR row of a vertex, i.e., its linear id. Works for owned
+     * and not-owned handles
+     */
+    __host__ __device__ __forceinline__ uint32_t
+    row(const VertexHandle vh) const
+    {
+        const uint32_t p = vh.patch_id();
+        const uint16_t l = vh.local_id();
+        assert(p < m_num_patches);
+#ifdef __CUDA_ARCH__
+        return m_d_local_to_row[m_d_patch_offset[p] + l];
+#else
+        return m_h_local_to_row[m_h_patch_offset[p] + l];
+#endif
+    }
+
+    /**
+     * @brief the oriented output of the query op (Op::VV, Op::VE, or Op::VF)
+     * of a vertex. The returned handles are owned handles
+     */
+    template <Op op>
+    __host__ __device__ __forceinline__ auto get(const VertexHandle vh) const
+    {
+        static_assert(op == Op::VV || op == Op::VE || op == Op::VF,
+                      "OrientedOneRing::get() only supports Op::VV, Op::VE, "
+                      "and Op::VF");
+
+        const uint32_t r = row(vh);
+#ifdef __CUDA_ARCH__
+        const uint32_t*     vv_offset = m_d_vv_offset;
+        const uint32_t*     vf_offset = m_d_vf_offset;
+        const VertexHandle* vv        = m_d_vv;
+        const EdgeHandle*   ve        = m_d_ve;
+        const FaceHandle*   vf        = m_d_vf;
+#else
+        const uint32_t*     vv_offset = m_h_vv_offset;
+        const uint32_t*     vf_offset = m_h_vf_offset;
+        const VertexHandle* vv        = m_h_vv;
+        const EdgeHandle*   ve        = m_h_ve;
+        const FaceHandle*   vf        = m_h_vf;
+#endif
+        if constexpr (op == Op::VV) {
+            return OneRingIterator<VertexHandle>(
+                vv + vv_offset[r], vv_offset[r + 1] - vv_offset[r]);
+        } else if constexpr (op == Op::VE) {
+            return OneRingIterator<EdgeHandle>(
+                ve + vv_offset[r], vv_offset[r + 1] - vv_offset[r]);
+        } else {
+            return OneRingIterator<FaceHandle>(
+                vf + vf_offset[r], vf_offset[r + 1] - vf_offset[r]);
+        }
+    }
+
+    /**
+     * @brief if the one-ring of a vertex is open i.e., the vertex is on the
+     * boundary
+     */
+    __host__ __device__ __forceinline__ bool is_open(
+        const VertexHandle vh) const
+    {
+        return get<Op::VV>(vh).size() != get<Op::VF>(vh).size();
+    }
+
+    /**
+     * @brief check if the one-ring is allocated on host
+     */
+    bool is_host_allocated() const
+    {
+        return (m_allocated & HOST) == HOST;
+    }
+
+    /**
+     * @brief check if the one-ring is allocated on device
+     */
+    bool is_device_allocated() const
+    {
+        return (m_allocated & DEVICE) == DEVICE;
+    }
+
+    /**
+     * @brief the memory used on one location (host or device)
+     */
+    size_t bytes() const
+    {
+        return sizeof(uint32_t) * (size_t(m_num_patches + 1) + m_num_locals +
+                                   2 * (size_t(m_num_rows) + 1)) +
+               (sizeof(VertexHandle) + sizeof(EdgeHandle)) * size_t(m_nnz_vv) +
+               sizeof(FaceHandle) * size_t(m_nnz_vf);
+    }
+
+    /**
+     * @brief copy the one-ring from the host to the device. Only HOST to
+     * DEVICE is supported since the one-ring is not modified on the device
+     * @param source the source location
+     * @param target the destination location
+     */
+    void move(locationT source, locationT target)
+    {
+        if (source != HOST || target != DEVICE) {
+            RXMESH_ERROR(
+                "OrientedOneRing::move() only HOST to DEVICE is supported. Got "
+                "{} to {}",
+                location_to_string(source),
+                location_to_string(target));
+            return;
+        }
+        if (!is_host_allocated()) {
+            RXMESH_ERROR(
+                "OrientedOneRing::move() the one-ring is not allocated on "
+                "host");
+            return;
+        }
+
+        if (!is_device_allocated()) {
+            CUDA_ERROR(cudaMalloc((void**)&m_d_patch_offset,
+                                  (m_num_patches + 1) * sizeof(uint32_t)));
+            CUDA_ERROR(cudaMalloc((void**)&m_d_local_to_row,
+                                  m_num_locals * sizeof(uint32_t)));
+            CUDA_ERROR(cudaMalloc((void**)&m_d_vv_offset,
+                                  (m_num_rows + 1) * sizeof(uint32_t)));
+            CUDA_ERROR(cudaMalloc((void**)&m_d_vf_offset,
+                                  (m_num_rows + 1) * sizeof(uint32_t)));
+            CUDA_ERROR(
+                cudaMalloc((void**)&m_d_vv, m_nnz_vv * sizeof(VertexHandle)));
+            CUDA_ERROR(
+                cudaMalloc((void**)&m_d_ve, m_nnz_vv * sizeof(EdgeHandle)));
+            CUDA_ERROR(
+                cudaMalloc((void**)&m_d_vf, m_nnz_vf * sizeof(FaceHandle)));
+            m_allocated = m_allocated | DEVICE;
+        }
+
+        CUDA_ERROR(cudaMemcpy(m_d_patch_offset,
+                              m_h_patch_offset,
+                              (m_num_patches + 1) * sizeof(uint32_t),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_local_to_row,
+                              m_h_local_to_row,
+                              m_num_locals * sizeof(uint32_t),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_vv_offset,
+                              m_h_vv_offset,
+                              (m_num_rows + 1) * sizeof(uint32_t),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_vf_offset,
+                              m_h_vf_offset,
+                              (m_num_rows + 1) * sizeof(uint32_t),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_vv,
+                              m_h_vv,
+                              m_nnz_vv * sizeof(VertexHandle),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_ve,
+                              m_h_ve,
+                              m_nnz_vv * sizeof(EdgeHandle),
+                              cudaMemcpyHostToDevice));
+        CUDA_ERROR(cudaMemcpy(m_d_vf,
+                              m_h_vf,
+                              m_nnz_vf * sizeof(FaceHandle),
+                              cudaMemcpyHostToDevice));
+    }
+
+    /**
+     * @brief Release allocated memory in certain location
+     * @param location where memory will be released
+     */
+    void release(locationT location = LOCATION_ALL)
+    {
+        if (((location & HOST) == HOST) && is_host_allocated()) {
+            host_free(m_h_patch_offset);
+            host_free(m_h_local_to_row);
+            host_free(m_h_vv_offset);
+            host_free(m_h_vf_offset);
+            host_free(m_h_vv);
+            host_free(m_h_ve);
+            host_free(m_h_vf);
+            m_h_patch_offset = nullptr;
+            m_h_local_to_row = nullptr;
+            m_h_vv_offset    = nullptr;
+            m_h_vf_offset    = nullptr;
+            m_h_vv           = nullptr;
+            m_h_ve           = nullptr;
+            m_h_vf           = nullptr;
+            m_allocated      = m_allocated & (~HOST);
+        }
+
+        if (((location & DEVICE) == DEVICE) && is_device_allocated()) {
+            GPU_FREE(m_d_patch_offset);
+            GPU_FREE(m_d_local_to_row);
+            GPU_FREE(m_d_vv_offset);
+            GPU_FREE(m_d_vf_offset);
+            GPU_FREE(m_d_vv);
+            GPU_FREE(m_d_ve);
+            GPU_FREE(m_d_vf);
+            m_allocated = m_allocated & (~DEVICE);
+        }
+    }
+
+   private:
+    /**
+     * @brief the incident faces of the vertices of one patch as (face, corner)
+     * pairs packed as 3 * face + corner
+     */
+    struct PatchCorners
+    {
+        std::vector<uint16_t> corner;  // 3 * face + k -> vertex
+        std::vector<uint16_t> edge;    // 3 * face + k -> edge from corner k
+        std::vector<uint32_t> offset;  // vertex -> start in value
+        std::vector<uint32_t> value;   // 3 * face + k
+
+        void build(const PatchInfo& pi)
+        {
+            const uint16_t num_faces    = pi.num_faces[0];
+            const uint16_t num_vertices = pi.num_vertices[0];
+
+            corner.assign(3 * size_t(num_faces), INVALID16);
+            edge.assign(3 * size_t(num_faces), INVALID16);
+            offset.assign(size_t(num_vertices) + 1, 0);
+
+            for (uint16_t f = 0; f < num_faces; ++f) {
+                if (detail::is_deleted(f, pi.active_mask_f)) {
+                    continue;
+                }
+                for (uint32_t k = 0; k < 3; ++k) {
+                    uint16_t e;
+                    flag_t   dir(0);
+                    Context::unpack_edge_dir(pi.fe[3 * f + k].id, e, dir);
+                    const uint16_t v   = pi.ev[2 * e + dir].id;
+                    corner[3 * f + k] = v;
+                    edge[3 * f + k]   = e;
+                    offset[v + 1]++;
+                }
+            }
+            for (uint16_t v = 0; v < num_vertices; ++v) {
+                offset[v + 1] += offset[v];
+            }
+            value.resize(offset[num_vertices]);
+
+            std::vector<uint32_t> pos(offset.begin(), offset.end() - 1);
+            for (uint32_t c = 0; c < corner.size(); ++c) {
+                if (corner[c] != INVALID16) {
+                    value[pos[corner[c]]++] = c;
+                }
+            }
+        }
+
+        // the corner after c (the head of the edge leaving c)
+        uint32_t next(const uint32_t c) const
+        {
+            return 3 * (c / 3) + (c % 3 + 1) % 3;
+        }
+
+        // the corner before c (the tail of the edge entering c)
+        uint32_t prev(const uint32_t c) const
+        {
+            return 3 * (c / 3) + (c % 3 + 2) % 3;
+        }
+    };
+
+    /**
+     * @brief sort the corners of vertex v counter-clockwise. Every corner c
+     * contributes the edge leaving v (edge[c]) and the face c / 3. The face of
+     * corner c is followed by the face whose leaving edge is the edge entering
+     * v in c (edge[prev(c)]). Fans start at a corner with no predecessor, if
+     * any, so open fans start at a boundary edge
+     * @return the number of VV entries. The sorted corners are written in
+     * order, and open is set for every corner that ends an open fan
+     */
+    static uint32_t sort_corners(const PatchCorners&    pc,
+                                 const uint16_t         v,
+                                 std::vector<uint32_t>& left,
+                                 std::vector<uint32_t>& order,
+                                 std::vector<uint8_t>&  open)
+    {
+        left.assign(pc.value.begin() + pc.offset[v],
+                    pc.value.begin() + pc.offset[v + 1]);
+        order.clear();
+        open.clear();
+
+        auto find_leaving = [&](const uint16_t e) {
+            for (uint32_t i = 0; i < left.size(); ++i) {
+                if (pc.edge[left[i]] == e) {
+                    return i;
+                }
+            }
+            return uint32_t(INVALID32);
+        };
+
+        uint32_t num_vv = 0;
+        while (!left.empty()) {
+            // a corner whose leaving edge is not entering in any other corner
+            uint32_t start = 0;
+            for (uint32_t i = 0; i < left.size(); ++i) {
+                bool has_prev = false;
+                for (uint32_t j = 0; j < left.size() && !has_prev; ++j) {
+                    has_prev = pc.edge[pc.prev(left[j])] == pc.edge[left[i]];
+                }
+                if (!has_prev) {
+                    start = i;
+                    break;
+                }
+            }
+
+            const uint16_t first_edge = pc.edge[left[start]];
+
+            uint32_t cur = left[start];
+            left[start]  = left.back();
+            left.pop_back();
+            while (true) {
+                order.push_back(cur);
+                open.push_back(0);
+                num_vv++;
+
+                const uint16_t entering = pc.edge[pc.prev(cur)];
+                if (entering == first_edge) {
+                    break;
+                }
+                const uint32_t i = find_leaving(entering);
+                if (i == INVALID32) {
+                    // open fan: the entering edge is a boundary edge and its
+                    // tail is one more neighbor
+                    open.back() = 1;
+                    num_vv++;
+                    break;
+                }
+                cur     = left[i];
+                left[i] = left.back();
+                left.pop_back();
+            }
+        }
+        return num_vv;
+    }
+
+    template <typename MeshT>
+    void build(const MeshT& rx)
+    {
+        const auto& v_map = rx.template get_index_map<VertexHandle>();
+        const auto& e_map = rx.template get_index_map<EdgeHandle>();
+        const auto& f_map = rx.template get_index_map<FaceHandle>();
+
+        m_num_rows   = v_map.size();
+        m_num_locals = v_map.patch_offset().back();
+
+        // the row of every local vertex is its linear id
+        m_h_patch_offset =
+            host_malloc<uint32_t>(m_num_patches + 1, HostMemTag::Query);
+        m_h_local_to_row =
+            host_malloc<uint32_t>(m_num_locals, HostMemTag::Query);
+        m_h_vv_offset =
+            host_malloc<uint32_t>(m_num_rows + 1, HostMemTag::Query);
+        m_h_vf_offset =
+            host_malloc<uint32_t>(m_num_rows + 1, HostMemTag::Query);
+        std::memcpy(m_h_patch_offset,
+                    v_map.patch_offset().data(),
+                    (m_num_patches + 1) * sizeof(uint32_t));
+        std::memcpy(m_h_local_to_row,
+                    v_map.local_to_linear().data(),
+                    m_num_locals * sizeof(uint32_t));
+        m_h_vv_offset[0] = 0;
+        m_h_vf_offset[0] = 0;
+
+        const int num_threads = std::max(
+            omp_get_max_threads(), rx.get_host_schedule().get_num_threads());
+        std::vector<PatchCorners>          corners(num_threads);
+        std::vector<std::vector<uint32_t>> left(num_threads);
+        std::vector<std::vector<uint32_t>> order(num_threads);
+        std::vector<std::vector<uint8_t>>  open(num_threads);
+
+        auto run_pass = [&](const int pass) {
+            rx.get_host_schedule().run(m_num_patches, [&](const uint32_t p) {
+                const int        t  = omp_get_thread_num();
+                const PatchInfo& pi = rx.get_patch(p);
+                PatchCorners&    pc = corners[t];
+                pc.build(pi);
+
+                for (uint16_t v = 0; v < pi.num_vertices[0]; ++v) {
+                    const LocalVertexT local(v);
+                    if (pi.is_deleted(local) || !pi.is_owned(local)) {
+                        continue;
+                    }
+                    const uint32_t r = v_map.linear_id(VertexHandle(p, v));
+
+                    const uint32_t num_vv =
+                        sort_corners(pc, v, left[t], order[t], open[t]);
+
+                    if (pass == 0) {
+                        m_h_vv_offset[r + 1] = num_vv;
+                        m_h_vf_offset[r + 1] = uint32_t(order[t].size());
+                        continue;
+                    }
+
+                    auto owned_v = [&](const uint16_t l) {
+                        return v_map.handle(
+                            v_map.linear_id(VertexHandle(p, l)));
+                    };
+                    auto owned_e = [&](const uint16_t l) {
+                        return e_map.handle(e_map.linear_id(EdgeHandle(p, l)));
+                    };
+
+                    uint32_t vv = m_h_vv_offset[r];
+                    uint32_t vf = m_h_vf_offset[r];
+                    for (uint32_t i = 0; i < order[t].size(); ++i) {
+                        const uint32_t c = order[t][i];
+
+                        m_h_vv[vv] = owned_v(pc.corner[pc.next(c)]);
+                        m_h_ve[vv] = owned_e(pc.edge[c]);
+                        vv++;
+
+                        m_h_vf[vf++] = f_map.handle(
+                            f_map.linear_id(FaceHandle(p, uint16_t(c / 3))));
+
+                        if (open[t][i]) {
+                            const uint32_t pc_c = pc.prev(c);
+                            m_h_vv[vv] = owned_v(pc.corner[pc_c]);
+                            m_h_ve[vv] = owned_e(pc.edge[pc_c]);
+                            vv++;
+                        }
+                    }
+                    assert(vv == m_h_vv_offset[r + 1]);
+                    assert(vf == m_h_vf_offset[r + 1]);
+                }
+            });
+        };
+
+        run_pass(0);
+        for (uint32_t r = 0; r < m_num_rows; ++r) {
+            m_h_vv_offset[r + 1] += m_h_vv_offset[r];
+            m_h_vf_offset[r + 1] += m_h_vf_offset[r];
+        }
+        m_nnz_vv = m_h_vv_offset[m_num_rows];
+        m_nnz_vf = m_h_vf_offset[m_num_rows];
+
+        m_h_vv = host_malloc<VertexHandle>(std::max<size_t>(1, m_nnz_vv),
+                                           HostMemTag::Query);
+        m_h_ve = host_malloc<EdgeHandle>(std::max<size_t>(1, m_nnz_vv),
+                                         HostMemTag::Query);
+        m_h_vf = host_malloc<FaceHandle>(std::max<size_t>(1, m_nnz_vf),
+                                         HostMemTag::Query);
+        run_pass(1);
+
+        m_allocated = m_allocated | HOST;
+    }
+
+    uint32_t      m_num_patches;
+    uint32_t      m_num_rows;
+    uint32_t      m_num_locals;
+    uint32_t      m_nnz_vv;
+    uint32_t      m_nnz_vf;
+    locationT     m_allocated;
+    uint32_t*     m_h_patch_offset;
+    uint32_t*     m_h_local_to_row;
+    uint32_t*     m_h_vv_offset;
+    uint32_t*     m_h_vf_offset;
+    VertexHandle* m_h_vv;
+    EdgeHandle*   m_h_ve;
+    FaceHandle*   m_h_vf;
+    uint32_t*     m_d_patch_offset;
+    uint32_t*     m_d_local_to_row;
+    uint32_t*     m_d_vv_offset;
+    uint32_t*     m_d_vf_offset;
+    VertexHandle* m_d_vv;
+    EdgeHandle*   m_d_ve;
+    FaceHandle*   m_d_vf;
+};
+
+}  // namespace rxmesh
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace rxmesh {
+
+/**
+ * @brief Partition quality of an RXMesh instance. Per-patch values are indexed
+ * by the patch id. Computed from the host patches by
+ * RXMesh::compute_partition_diagnostics() and written by
+ * Report::partition_diagnostics() as distributions
+ */
+struct PartitionDiagnostics
+{
+    // number of owned mesh elements in every patch
+    std::vector<uint32_t> num_owned_vertices, num_owned_edges, num_owned_faces;
+
+    // number of not-owned (ribbon) mesh elements in every patch
+    std::vector<uint32_t> num_ribbon_vertices, num_ribbon_edges,
+        num_ribbon_faces;
+
+    // ribbon faces over owned faces
+    std::vector<float> ribbon_ratio;
+
+    // number of edges in the patch that are shared by an owned and a ribbon
+    // face, i.e., the edges on the patch boundary. Every cut edge is counted
+    // by the two patches it separates
+    std::vector<uint32_t> edge_cut;
+
+    // number of neighbor patches, i.e., the used slots of the patch stash
+    std::vector<uint32_t> num_neighbor_patches;
+
+    // load factor of the not-owned hashtable of every patch and its stash
+    std::vector<float> lp_load_factor_v, lp_load_factor_e, lp_load_factor_f;
+    std::vector<float> lp_stash_load_factor_v, lp_stash_load_factor_e,
+        lp_stash_load_factor_f;
+
+    // the build parameters the diagnostics were computed with
+    uint32_t patch_size               = 0;
+    float    capacity_factor          = 0;
+    float    lp_hashtable_load_factor = 0;
+
+    // number of edges that separate two patches
+    uint32_t total_edge_cut = 0;
+
+    // number of colors used by the patch graph coloring
+    uint32_t num_colors = 0;
+
+    // capacity of the patch stash
+    uint32_t patch_stash_size = 0;
+
+    // number of patches whose neighbors fill all the patch stash slots
+    uint32_t num_patches_at_stash_limit = 0;
+};
+
+}  // namespace rxmesh
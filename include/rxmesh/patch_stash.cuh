@@ -3,6 +3,7 @@
 
 #include "rxmesh/kernels/shmem_mutex.cuh"
 #include "rxmesh/lp_pair.cuh"
+#include "rxmesh/util/host_memory.h"
 
 namespace rxmesh {
 
@@ -21,7 +22,7 @@ struct PatchStash
             CUDA_ERROR(
                 cudaMemset(m_stash, INVALID8, stash_size * sizeof(uint32_t)));
         } else {
-            m_stash = (uint32_t*)malloc(stash_size * sizeof(uint32_t));
+            m_stash = host_malloc<uint32_t>(stash_size, HostMemTag::Topology);
             for (uint8_t i = 0; i < stash_size; ++i) {
                 m_stash[i] = INVALID32;
             }
@@ -155,7 +156,7 @@ struct PatchStash
             GPU_FREE(m_stash);
 
         } else {
-            ::free(m_stash);
+            host_free(m_stash);
         }
     }
 
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "rxmesh/util/macros.h"
+
+namespace rxmesh {
+
+/**
+ * @brief the per-patch work counters that could be collected by PatchStats
+ */
+enum class PatchCounter : uint32_t
+{
+    // number of mesh elements visited in the patch
+    Visited = 0,
+    // number of handles that are not owned by the patch and had to be resolved
+    // through the patch LPHashTable and PatchStash
+    NotOwnedLookup = 1,
+    // number of cavities created in the patch
+    CavityAttempted = 2,
+    // number of cavities in the patch that did not make it through (conflict
+    // with other cavities or failed to lock neighbor patches)
+    CavityFailed = 3,
+    NumCounters  = 4,
+};
+
+/**
+ * @brief convert PatchCounter to string
+ */
+static std::string patch_counter_to_string(const PatchCounter& counter)
+{
+    switch (counter) {
+        case PatchCounter::Visited:
+            return "visited";
+        case PatchCounter::NotOwnedLookup:
+            return "not_owned_lookup";
+        case PatchCounter::CavityAttempted:
+            return "cavity_attempted";
+        case PatchCounter::CavityFailed:
+            return "cavity_failed";
+        default: {
+            RXMESH_ERROR("patch_counter_to_string() unknown input counter");
+            return "";
+        }
+    }
+}
+
+/**
+ * @brief summary of a per-patch distribution, e.g., the number of elements
+ * visited in every patch
+ */
+struct DistributionSummary
+{
+    double min    = 0;
+    double max    = 0;
+    double mean   = 0;
+    double stddev = 0;
+    double median = 0;
+    double p90    = 0;
+    double total  = 0;
+    // max/mean, i.e., 1 means perfectly balanced
+    double imbalance = 0;
+
+    /**
+     * @brief compute the summary of a list of per-patch values
+     */
+    template <typename T>
+    static DistributionSummary summarize(const std::vector<T>& values)
+    {
+        DistributionSummary ret;
+        if (values.empty()) {
+            return ret;
+        }
+
+        std::vector<double> sorted(values.begin(), values.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        const double n = static_cast<double>(sorted.size());
+
+        ret.min   = sorted.front();
+        ret.max   = sorted.back();
+        ret.total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+        ret.mean  = ret.total / n;
+
+        double var = 0;
+        for (double v : sorted) {
+            var += (v - ret.mean) * (v - ret.mean);
+        }
+        ret.stddev = std::sqrt(var / n);
+
+        ret.median = sorted[sorted.size() / 2];
+        ret.p90    = sorted[std::min(
+            sorted.size() - 1,
+            static_cast<size_t>(std::ceil(0.9 * n)) - 1)];
+
+        ret.imbalance = (ret.mean > 0) ? ret.max / ret.mean : 0;
+        return ret;
+    }
+};
+
+namespace detail {
+/**
+ * @brief increment a per-patch counter. stats is the counters array (on host
+ * or device) laid out as [counter][patch]. Does nothing if stats is null
+ */
+__device__ __host__ __inline__ void patch_stats_add(
+    uint32_t*          stats,
+    const uint32_t     max_num_patches,
+    const PatchCounter counter,
+    const uint32_t     patch_id,
+    const uint32_t     val = 1)
+{
+    if (stats == nullptr || patch_id >= max_num_patches) {
+        return;
+    }
+    uint32_t* addr =
+        stats + static_cast<uint32_t>(counter) * max_num_patches + patch_id;
+#ifdef __CUDA_ARCH__
+    ::atomicAdd(addr, val);
+#else
+#pragma omp atomic
+    addr[0] += val;
+#endif
+}
+}  // namespace detail
+
+/**
+ * @brief optional per-patch work counters and host timing used to measure the
+ * load (im)balance across patches. Host counters are collected in host passes
+ * (e.g., for_each with HOST) and the device counters are collected in device
+ * kernels only if RXMesh is compiled with RXMESH_PATCH_STATS. Counters
+ * accumulate until reset() is called, so a "pass" is everything between two
+ * calls to reset()
+ */
+class PatchStats
+{
+   public:
+    PatchStats(uint32_t max_num_patches)
+        : m_max_num_patches(max_num_patches),
+          m_d_counters(nullptr),
+          m_h_counters(num_counters() * max_num_patches, 0),
+          m_h_device_counters(num_counters() * max_num_patches, 0),
+          m_h_time_ms(max_num_patches, 0)
+    {
+        CUDA_ERROR(cudaMalloc((void**)&m_d_counters,
+                              m_h_counters.size() * sizeof(uint32_t)));
+        CUDA_ERROR(cudaMemset(
+            m_d_counters, 0, m_h_counters.size() * sizeof(uint32_t)));
+    }
+
+    PatchStats(const PatchStats&)            = delete;
+    PatchStats& operator=(const PatchStats&) = delete;
+
+    ~PatchStats()
+    {
+        GPU_FREE(m_d_counters);
+    }
+
+    /**
+     * @brief zero out all host and device counters and host timing
+     */
+    void reset()
+    {
+        std::fill(m_h_counters.begin(), m_h_counters.end(), 0);
+        std::fill(m_h_device_counters.begin(), m_h_device_counters.end(), 0);
+        std::fill(m_h_time_ms.begin(), m_h_time_ms.end(), 0.f);
+        CUDA_ERROR(cudaMemset(
+            m_d_counters, 0, m_h_counters.size() * sizeof(uint32_t)));
+    }
+
+    /**
+     * @brief copy the device counters to the host. Should be called after the
+     * device kernels are done and before reading the counters
+     */
+    void sync_from_device()
+    {
+        CUDA_ERROR(cudaMemcpy(m_h_device_counters.data(),
+                              m_d_counters,
+                              m_h_device_counters.size() * sizeof(uint32_t),
+                              cudaMemcpyDeviceToHost));
+    }
+
+    /**
+     * @brief return a counter value of a patch (host + device)
+     */
+    uint64_t get(const PatchCounter counter, const uint32_t p) const
+    {
+        const uint32_t id = index(counter, p);
+        return uint64_t(m_h_counters[id]) + uint64_t(m_h_device_counters[id]);
+    }
+
+    /**
+     * @brief increment a counter of a patch from host code. Thread-safe
+     */
+    void add(const PatchCounter counter, const uint32_t p, const uint32_t val)
+    {
+        detail::patch_stats_add(
+            m_h_counters.data(), m_max_num_patches, counter, p, val);
+    }
+
+    /**
+     * @brief add time spent on a patch by a host pass. Each patch should be
+     * processed by one thread at a time
+     */
+    void add_host_time(const uint32_t p, const float time_ms)
+    {
+        m_h_time_ms[p] += time_ms;
+    }
+
+    /**
+     * @brief the accumulated time spent on a patch in host passes
+     */
+    float get_host_time(const uint32_t p) const
+    {
+        return m_h_time_ms[p];
+    }
+
+    /**
+     * @brief summary of a counter over the first num_patches patches
+     */
+    DistributionSummary summarize(const PatchCounter counter,
+                                  const uint32_t     num_patches) const
+    {
+        std::vector<uint64_t> values(num_patches);
+        for (uint32_t p = 0; p < num_patches; ++p) {
+            values[p] = get(counter, p);
+        }
+        return DistributionSummary::summarize(values);
+    }
+
+    /**
+     * @brief summary of the host time over the first num_patches patches
+     */
+    DistributionSummary summarize_host_time(const uint32_t num_patches) const
+    {
+        return DistributionSummary::summarize(std::vector<float>(
+            m_h_time_ms.begin(), m_h_time_ms.begin() + num_patches));
+    }
+
+    /**
+     * @brief pointer to the host counters to be used with
+     * detail::patch_stats_add
+     */
+    uint32_t* get_host_counters()
+    {
+        return m_h_counters.data();
+    }
+
+    /**
+     * @brief pointer to the device counters to be used with
+     * detail::patch_stats_add
+     */
+    uint32_t* get_device_counters()
+    {
+        return m_d_counters;
+    }
+
+    uint32_t get_max_num_patches() const
+    {
+        return m_max_num_patches;
+    }
+
+    static constexpr uint32_t num_counters()
+    {
+        return static_cast<uint32_t>(PatchCounter::NumCounters);
+    }
+
+   private:
+    uint32_t index(const PatchCounter counter, const uint32_t p) const
+    {
+        return static_cast<uint32_t>(counter) * m_max_num_patches + p;
+    }
+
+    uint32_t              m_max_num_patches;
+    uint32_t*             m_d_counters;
+    std::vector<uint32_t> m_h_counters;
+    std::vector<uint32_t> m_h_device_counters;
+    std::vector<float>    m_h_time_ms;
+};
+}  // namespace rxmesh
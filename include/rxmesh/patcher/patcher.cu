@@ -2,6 +2,8 @@
 #include <stdint.h>
 #include <functional>
 #include <iomanip>
+#include <numeric>
+#include <omp.h>
 #include <queue>
 #include <unordered_map>
 #include "cub/device/device_radix_sort.cuh"
@@ -10,6 +12,7 @@
 #include "rxmesh/kernels/util.cuh"
 #include "rxmesh/patcher/patcher.h"
 #include "rxmesh/patcher/patcher_kernel.cuh"
+#include "rxmesh/util/instrument.h"
 #include "rxmesh/util/log.h"
 #include "rxmesh/util/macros.h"
 #include "rxmesh/util/timer.h"
@@ -23,6 +26,10 @@ namespace rxmesh {
 namespace patcher {
 
 Patcher::Patcher(std::string filename)
+    : m_ribbon_vf_time_ms(0.0),
+      m_ribbon_extract_time_ms(0.0),
+      m_ribbon_compact_time_ms(0.0),
+      m_partition_method(PartitionMethod::METIS)
 {
     RXMESH_TRACE("Patcher: Reading {}", filename);
     std::ifstream                      is(filename, std::ios::binary);
@@ -50,9 +57,14 @@ Patcher::Patcher(uint32_t                                        patch_size,
       m_max_num_patches(0),
       m_num_components(0),
       m_num_lloyd_run(0),
-      m_patching_time_ms(0.0)
+      m_patching_time_ms(0.0),
+      m_ribbon_vf_time_ms(0.0),
+      m_ribbon_extract_time_ms(0.0),
+      m_ribbon_compact_time_ms(0.0),
+      m_partition_method(PartitionMethod::METIS)
 
 {
+    RXMESH_ZONE("Patcher::Patcher");
     // TODO for test use only, forcing use_metis to true
     use_metis = true;
 
@@ -200,9 +212,14 @@ Patcher::Patcher(uint32_t                                        patch_size,
       m_max_num_patches(0),
       m_num_components(0),
       m_num_lloyd_run(0),
-      m_patching_time_ms(0.0)
+      m_patching_time_ms(0.0),
+      m_ribbon_vf_time_ms(0.0),
+      m_ribbon_extract_time_ms(0.0),
+      m_ribbon_compact_time_ms(0.0),
+      m_partition_method(PartitionMethod::METIS)
 
 {
+    RXMESH_ZONE("Patcher::Patcher");
     RXMESH_INFO("========== Patcher: Using VV mode ==========");
 
     std::vector<uint32_t> vv_offset;
@@ -240,41 +257,24 @@ Patcher::Patcher(uint32_t                                        patch_size,
 
     // degenerate cases
     if (m_num_patches <= 1) {
-        RXMESH_ERROR(
-            "Patcher: Not implemented under VV mode. Current Implementation "
-            "not verified");
-
-        m_patches_offset[0] = m_num_vertices;
-        m_num_seeds         = 1;
-        m_num_components    = 1;
-        m_num_lloyd_run     = 0;
-        for (uint32_t i = 0; i < m_num_vertices; ++i) {
-            m_face_patch[i]  = 0;
-            m_patches_val[i] = i;
-        }
-        allocate_device_memory(seeds,
-                               ff_offset,
-                               ff_values,
-                               d_face_patch,
-                               d_queue,
-                               d_queue_ptr,
-                               d_ff_values,
-                               d_ff_offset,
-                               d_cub_temp_storage_scan,
-                               d_cub_temp_storage_max,
-                               cub_scan_bytes,
-                               cub_max_bytes,
-                               d_seeds,
-                               d_new_num_patches,
-                               d_max_patch_size,
-                               d_patches_offset,
-                               d_patches_size,
-                               d_patches_val);
+        // a single patch that is split below if the input has more than one
+        // component
+        m_num_patches    = 1;
+        m_num_seeds      = 1;
+        m_num_components = 1;
+        m_num_lloyd_run  = 0;
+        std::fill(m_face_patch.begin(), m_face_patch.end(), 0);
+        compute_inital_compressed_patches();
+        split_disconnected_patches(fv, ff_offset, ff_values, edges_map);
+        extract_ribbons(fv, ff_offset, ff_values);
         assign_patch(fv, edges_map);
     } else {
         // Only METIS is supported 
         metis_kway_vv(fv, ev, vv_offset, vv_values);
 
+        // METIS may put disconnected parts of the mesh in one patch
+        split_disconnected_patches(fv, ff_offset, ff_values, edges_map);
+
         // check ff adjacency: no face should be isolated from its own patch
         for (uint32_t f = 0; f < m_num_faces; ++f) {
             uint32_t f_patch = m_face_patch[f];
@@ -322,6 +322,85 @@ Patcher::Patcher(uint32_t                                        patch_size,
     GPU_FREE(d_patches_val);
 }
 
+Patcher::Patcher(uint32_t                                        patch_size,
+                 const std::vector<uint32_t>&                    ff_offset,
+                 const std::vector<uint32_t>&                    ff_values,
+                 const std::vector<std::vector<uint32_t>>&       fv,
+                 const std::vector<std::vector<float>>&          vertices,
+                 const std::unordered_map<std::pair<uint32_t, uint32_t>,
+                                          uint32_t,
+                                          detail::edge_key_hash> edges_map,
+                 const uint32_t                                  num_vertices,
+                 const uint32_t                                  num_edges,
+                 const PartitionPolicy&                          policy)
+    : m_patch_size(patch_size),
+      m_num_patches(0),
+      m_num_vertices(num_vertices),
+      m_num_edges(num_edges),
+      m_num_faces(fv.size()),
+      m_num_seeds(0),
+      m_max_num_patches(0),
+      m_num_components(0),
+      m_num_lloyd_run(0),
+      m_patching_time_ms(0.0),
+      m_ribbon_vf_time_ms(0.0),
+      m_ribbon_extract_time_ms(0.0),
+      m_ribbon_compact_time_ms(0.0),
+      m_partition_method(policy.method)
+{
+    RXMESH_ZONE("Patcher::Patcher");
+
+    if (m_partition_method != PartitionMethod::METIS &&
+        vertices.size() != m_num_vertices) {
+        RXMESH_WARN(
+            "Patcher::Patcher() {} partition needs the coordinates of all {} "
+            "vertices but {} were given. Falling back to METIS",
+            partition_method_to_string(m_partition_method),
+            m_num_vertices,
+            vertices.size());
+        m_partition_method = PartitionMethod::METIS;
+    }
+
+    m_num_patches = DIVIDE_UP(m_num_faces, m_patch_size);
+
+    m_max_num_patches = 5 * m_num_patches;
+
+    m_num_seeds = m_num_patches;
+    std::vector<uint32_t> seeds;
+
+    allocate_memory(seeds);
+
+    // degenerate cases
+    if (m_num_patches <= 1) {
+        m_patches_offset[0] = m_num_faces;
+        m_num_seeds         = 1;
+        m_num_components    = 1;
+        for (uint32_t i = 0; i < m_num_faces; ++i) {
+            m_face_patch[i]  = 0;
+            m_patches_val[i] = i;
+        }
+    } else {
+        if (m_partition_method == PartitionMethod::METIS) {
+            metis_kway(ff_offset, ff_values);
+        } else {
+            if (m_partition_method == PartitionMethod::Morton) {
+                morton_partition(fv, vertices);
+            } else {
+                inertial_partition(fv, vertices);
+            }
+            smooth_partition(ff_offset, ff_values, policy.smoothing_passes);
+            compute_inital_compressed_patches();
+        }
+    }
+    split_disconnected_patches(fv, ff_offset, ff_values, edges_map);
+    extract_ribbons(fv, ff_offset, ff_values);
+    assign_patch(fv, edges_map);
+
+    calc_edge_cut(fv, ff_offset, ff_values);
+
+    print_statistics();
+}
+
 void Patcher::grid(const std::vector<std::vector<uint32_t>>& fv)
 {
     // this only work if the input is a mesh coming from create_plane()
@@ -360,6 +439,438 @@ void Patcher::grid(const std::vector<std::vector<uint32_t>>& fv)
     compute_inital_compressed_patches();
 }
 
+namespace {
+
+/**
+ * @brief the centroids of the faces stored as x, y, z for every face
+ */
+std::vector<float> face_centroids(
+    const std::vector<std::vector<uint32_t>>& fv,
+    const std::vector<std::vector<float>>&    vertices)
+{
+    const int64_t      num_faces = fv.size();
+    std::vector<float> centroids(3 * num_faces, 0.f);
+
+#pragma omp parallel for
+    for (int64_t f = 0; f < num_faces; ++f) {
+        float c[3] = {0.f, 0.f, 0.f};
+        for (const uint32_t v : fv[f]) {
+            const size_t dim = std::min<size_t>(3, vertices[v].size());
+            for (size_t i = 0; i < dim; ++i) {
+                c[i] += vertices[v][i];
+            }
+        }
+        const float inv = 1.f / float(std::max<size_t>(1, fv[f].size()));
+        for (int i = 0; i < 3; ++i) {
+            centroids[3 * f + i] = c[i] * inv;
+        }
+    }
+    return centroids;
+}
+
+/**
+ * @brief spread the lower 21 bits of x such that there are two zero bits
+ * between consecutive bits
+ */
+uint64_t expand_bits_21(uint64_t x)
+{
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffff;
+    x = (x | x << 16) & 0x1f0000ff0000ff;
+    x = (x | x << 8) & 0x100f00f00f00f00f;
+    x = (x | x << 4) & 0x10c30c30c30c30c3;
+    x = (x | x << 2) & 0x1249249249249249;
+    return x;
+}
+
+/**
+ * @brief sort in parallel by sorting one chunk per thread and then merging
+ * the chunks pairwise
+ */
+template <typename T>
+void parallel_sort(std::vector<T>& v)
+{
+    const int64_t n = v.size();
+    const int64_t num_chunks = std::max<int64_t>(
+        1, std::min<int64_t>(omp_get_max_threads(), n / 4096));
+
+    std::vector<int64_t> bounds(num_chunks + 1);
+    for (int64_t c = 0; c <= num_chunks; ++c) {
+        bounds[c] = n * c / num_chunks;
+    }
+
+#pragma omp parallel for
+    for (int64_t c = 0; c < num_chunks; ++c) {
+        std::sort(v.begin() + bounds[c], v.begin() + bounds[c + 1]);
+    }
+
+    for (int64_t width = 1; width < num_chunks; width *= 2) {
+#pragma omp parallel for
+        for (int64_t c = 0; c < num_chunks; c += 2 * width) {
+            const int64_t mid = std::min(c + width, num_chunks);
+            const int64_t end = std::min(c + 2 * width, num_chunks);
+            std::inplace_merge(v.begin() + bounds[c],
+                               v.begin() + bounds[mid],
+                               v.begin() + bounds[end]);
+        }
+    }
+}
+
+/**
+ * @brief split faces[begin, end) into num_parts parts of (almost) equal size
+ * by cutting at the median of the projection of the centroids on their
+ * principal axis. The two halves are processed as OpenMP tasks
+ */
+void inertial_bisect(const float* centroids,
+                     uint32_t*    faces,
+                     uint32_t*    face_patch,
+                     uint32_t     begin,
+                     uint32_t     end,
+                     uint32_t     first_part,
+                     uint32_t     num_parts)
+{
+    if (num_parts <= 1) {
+        for (uint32_t i = begin; i < end; ++i) {
+            face_patch[faces[i]] = first_part;
+        }
+        return;
+    }
+
+    // mean and covariance of the centroids
+    double mean[3] = {0, 0, 0};
+    for (uint32_t i = begin; i < end; ++i) {
+        for (int k = 0; k < 3; ++k) {
+            mean[k] += centroids[3 * faces[i] + k];
+        }
+    }
+    for (int k = 0; k < 3; ++k) {
+        mean[k] /= double(end - begin);
+    }
+
+    double cov[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    for (uint32_t i = begin; i < end; ++i) {
+        double d[3];
+        for (int k = 0; k < 3; ++k) {
+            d[k] = centroids[3 * faces[i] + k] - mean[k];
+        }
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                cov[r][c] += d[r] * d[c];
+            }
+        }
+    }
+
+    // principal axis with power iterations starting from the coordinate axis
+    // with the largest variance
+    double axis[3] = {0, 0, 0};
+    int    start   = 0;
+    for (int k = 1; k < 3; ++k) {
+        if (cov[k][k] > cov[start][start]) {
+            start = k;
+        }
+    }
+    axis[start] = 1;
+    for (int it = 0; it < 16; ++it) {
+        double next[3] = {0, 0, 0};
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) {
+                next[r] += cov[r][c] * axis[c];
+            }
+        }
+        const double len = std::sqrt(next[0] * next[0] + next[1] * next[1] +
+                                     next[2] * next[2]);
+        if (len == 0) {
+            break;
+        }
+        for (int k = 0; k < 3; ++k) {
+            axis[k] = next[k] / len;
+        }
+    }
+
+    auto project = [&](const uint32_t f) {
+        return centroids[3 * f + 0] * axis[0] + centroids[3 * f + 1] * axis[1] +
+               centroids[3 * f + 2] * axis[2];
+    };
+
+    const uint32_t left_parts = num_parts / 2;
+    const uint32_t mid =
+        begin + uint32_t(uint64_t(end - begin) * left_parts / num_parts);
+
+    std::nth_element(faces + begin,
+                     faces + mid,
+                     faces + end,
+                     [&](const uint32_t a, const uint32_t b) {
+                         return project(a) < project(b);
+                     });
+
+#pragma omp task if (mid - begin > 4096)
+    inertial_bisect(
+        centroids, faces, face_patch, begin, mid, first_part, left_parts);
+
+    inertial_bisect(centroids,
+                    faces,
+                    face_patch,
+                    mid,
+                    end,
+                    first_part + left_parts,
+                    num_parts - left_parts);
+
+#pragma omp taskwait
+}
+}  // namespace
+
+void Patcher::morton_partition(const std::vector<std::vector<uint32_t>>& fv,
+                               const std::vector<std::vector<float>>& vertices)
+{
+    RXMESH_ZONE("Patcher::morton_partition");
+
+    CPUTimer timer;
+    timer.start();
+
+    const std::vector<float> centroids = face_centroids(fv, vertices);
+
+    // bounding box of the centroids
+    float lo[3], hi[3];
+    for (int k = 0; k < 3; ++k) {
+        lo[k] = std::numeric_limits<float>::max();
+        hi[k] = std::numeric_limits<float>::lowest();
+    }
+    for (uint32_t f = 0; f < m_num_faces; ++f) {
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = std::min(lo[k], centroids[3 * f + k]);
+            hi[k] = std::max(hi[k], centroids[3 * f + k]);
+        }
+    }
+
+    // quantize every centroid to 21 bits per axis using the same scale for all
+    // axes so the cells stay cubes
+    const float extent =
+        std::max(hi[0] - lo[0], std::max(hi[1] - lo[1], hi[2] - lo[2]));
+    const float scale = (extent > 0) ? float((1 << 21) - 1) / extent : 0.f;
+
+    std::vector<std::pair<uint64_t, uint32_t>> keys(m_num_faces);
+
+#pragma omp parallel for
+    for (int64_t f = 0; f < int64_t(m_num_faces); ++f) {
+        uint64_t code = 0;
+        for (int k = 0; k < 3; ++k) {
+            const uint64_t q = uint64_t((centroids[3 * f + k] - lo[k]) * scale);
+            code |= expand_bits_21(q) << (2 - k);
+        }
+        keys[f] = {code, uint32_t(f)};
+    }
+
+    parallel_sort(keys);
+
+    // cut the curve into m_num_patches chunks of (almost) equal size
+    m_num_patches = DIVIDE_UP(m_num_faces, m_patch_size);
+
+#pragma omp parallel for
+    for (int64_t r = 0; r < int64_t(m_num_faces); ++r) {
+        m_face_patch[keys[r].second] =
+            uint32_t(uint64_t(r) * m_num_patches / m_num_faces);
+    }
+
+    timer.stop();
+    m_patching_time_ms = timer.elapsed_millis();
+}
+
+void Patcher::inertial_partition(
+    const std::vector<std::vector<uint32_t>>& fv,
+    const std::vector<std::vector<float>>&    vertices)
+{
+    RXMESH_ZONE("Patcher::inertial_partition");
+
+    CPUTimer timer;
+    timer.start();
+
+    const std::vector<float> centroids = face_centroids(fv, vertices);
+
+    std::vector<uint32_t> faces(m_num_faces);
+    std::iota(faces.begin(), faces.end(), 0);
+
+    m_num_patches = DIVIDE_UP(m_num_faces, m_patch_size);
+
+#pragma omp parallel
+#pragma omp single
+    inertial_bisect(centroids.data(),
+                    faces.data(),
+                    m_face_patch.data(),
+                    0,
+                    m_num_faces,
+                    0,
+                    m_num_patches);
+
+    timer.stop();
+    m_patching_time_ms = timer.elapsed_millis();
+}
+
+void Patcher::smooth_partition(const std::vector<uint32_t>& ff_offset,
+                               const std::vector<uint32_t>& ff_values,
+                               const uint32_t               num_passes)
+{
+    RXMESH_ZONE("Patcher::smooth_partition");
+
+    CPUTimer timer;
+    timer.start();
+
+    const uint32_t max_patch_size = m_patch_size + m_patch_size / 10;
+
+    std::vector<uint32_t> patch_size(m_num_patches, 0);
+    for (uint32_t f = 0; f < m_num_faces; ++f) {
+        patch_size[m_face_patch[f]]++;
+    }
+
+    // the neighbor patch that shares the most edges with f if it shares more
+    // edges than f's own patch. Otherwise, f's own patch
+    auto best_patch = [&](const uint32_t f) {
+        const uint32_t own = m_face_patch[f];
+
+        uint32_t own_count(0), best(own), best_count(0);
+        for (uint32_t i = ff_offset[f]; i < ff_offset[f + 1]; ++i) {
+            const uint32_t p = m_face_patch[ff_values[i]];
+            if (p == own) {
+                own_count++;
+                continue;
+            }
+            uint32_t count = 0;
+            for (uint32_t j = ff_offset[f]; j < ff_offset[f + 1]; ++j) {
+                if (m_face_patch[ff_values[j]] == p) {
+                    count++;
+                }
+            }
+            if (count > best_count) {
+                best       = p;
+                best_count = count;
+            }
+        }
+        return (best_count > own_count) ? best : own;
+    };
+
+    std::vector<uint8_t> is_candidate(m_num_faces);
+
+    uint32_t num_moved = 0;
+    for (uint32_t pass = 0; pass < num_passes; ++pass) {
+
+        // finding the candidates is done in parallel while moving the faces
+        // is done serially so every move sees the up-to-date patch sizes
+#pragma omp parallel for
+        for (int64_t f = 0; f < int64_t(m_num_faces); ++f) {
+            is_candidate[f] = (best_patch(f) != m_face_patch[f]);
+        }
+
+        uint32_t pass_moved = 0;
+        for (uint32_t f = 0; f < m_num_faces; ++f) {
+            if (!is_candidate[f]) {
+                continue;
+            }
+            const uint32_t own = m_face_patch[f];
+            const uint32_t p   = best_patch(f);
+            if (p != own && patch_size[p] < max_patch_size &&
+                patch_size[own] > 1) {
+                m_face_patch[f] = p;
+                patch_size[p]++;
+                patch_size[own]--;
+                pass_moved++;
+            }
+        }
+
+        num_moved += pass_moved;
+        if (pass_moved == 0) {
+            break;
+        }
+    }
+
+    timer.stop();
+    m_patching_time_ms += timer.elapsed_millis();
+
+    RXMESH_TRACE("Patcher: boundary smoothing moved {} faces in {} (ms)",
+                 num_moved,
+                 timer.elapsed_millis());
+}
+
+void Patcher::split_disconnected_patches(
+    const std::vector<std::vector<uint32_t>>&                 fv,
+    const std::vector<uint32_t>&                              ff_offset,
+    const std::vector<uint32_t>&                              ff_values,
+    const std::unordered_map<std::pair<uint32_t, uint32_t>,
+                             uint32_t,
+                             ::rxmesh::detail::edge_key_hash>& edges_map)
+{
+    RXMESH_ZONE("Patcher::split_disconnected_patches");
+
+    // label the face-connected components of every patch with a BFS that only
+    // crosses faces of the same patch. The first component of a patch keeps
+    // the patch id and the other components become new patches
+    std::vector<uint32_t> new_patch(m_num_faces, INVALID32);
+    std::vector<uint8_t>  is_labeled(m_num_patches, 0);
+    std::vector<uint32_t> queue;
+
+    uint32_t num_patches = m_num_patches;
+    for (uint32_t f = 0; f < m_num_faces; ++f) {
+        if (new_patch[f] != INVALID32) {
+            continue;
+        }
+        const uint32_t p     = m_face_patch[f];
+        const uint32_t label = is_labeled[p] ? num_patches++ : p;
+        is_labeled[p]        = 1;
+
+        new_patch[f] = label;
+        queue.clear();
+        queue.push_back(f);
+        for (size_t q = 0; q < queue.size(); ++q) {
+            const uint32_t cur = queue[q];
+            for (uint32_t i = ff_offset[cur]; i < ff_offset[cur + 1]; ++i) {
+                const uint32_t n = ff_values[i];
+                if (new_patch[n] == INVALID32 && m_face_patch[n] == p) {
+                    new_patch[n] = label;
+                    queue.push_back(n);
+                }
+            }
+        }
+    }
+
+    if (num_patches == m_num_patches) {
+        return;
+    }
+
+    RXMESH_TRACE("Patcher: split disconnected patches from {} to {} patches",
+                 m_num_patches,
+                 num_patches);
+
+    // vertices and edges that are already assigned to a patch follow one of
+    // their faces in this patch
+    std::vector<uint8_t> v_done(m_num_vertices, 0);
+    std::vector<uint8_t> e_done(m_num_edges, 0);
+    for (uint32_t f = 0; f < m_num_faces; ++f) {
+        const uint32_t old_p = m_face_patch[f];
+        uint32_t       v1    = fv[f].back();
+        for (uint32_t v = 0; v < fv[f].size(); ++v) {
+            const uint32_t v0 = fv[f][v];
+            const uint32_t e =
+                edges_map.at(::rxmesh::detail::edge_key(v0, v1));
+            if (!v_done[v0] && m_vertex_patch[v0] == old_p) {
+                m_vertex_patch[v0] = new_patch[f];
+                v_done[v0]         = 1;
+            }
+            if (!e_done[e] && m_edge_patch[e] == old_p) {
+                m_edge_patch[e] = new_patch[f];
+                e_done[e]       = 1;
+            }
+            v1 = v0;
+        }
+    }
+
+    m_face_patch      = std::move(new_patch);
+    m_num_patches     = num_patches;
+    m_max_num_patches = std::max(m_max_num_patches, 5 * m_num_patches);
+    if (m_ribbon_ext_offset.size() < m_max_num_patches) {
+        m_ribbon_ext_offset.resize(m_max_num_patches, 0);
+    }
+
+    compute_inital_compressed_patches();
+}
+
 Patcher::~Patcher()
 {
 }
@@ -489,6 +1000,7 @@ void Patcher::calc_edge_cut(const std::vector<std::vector<uint32_t>>& fv,
                             const std::vector<uint32_t>&              ff_offset,
                             const std::vector<uint32_t>&              ff_values)
 {
+    RXMESH_ZONE("Patcher::calc_edge_cut");
     // given a graph where nodes represents faces in the mesh and two nodes
     // are connected in this graph if two faces share an edge, we calculate
     // the edge cut fo such a graph
@@ -564,6 +1076,16 @@ void Patcher::print_statistics()
     RXMESH_TRACE("Patcher: number external ribbon faces = {} ({:02.2f}%)",
                  get_num_ext_ribbon_faces(),
                  get_ribbon_overhead());
+
+    // ribbon extraction time
+    RXMESH_TRACE(
+        "Patcher: Ribbon extraction time = {} (ms): vertex-face incidence = {} "
+        "(ms), per-patch ribbons = {} (ms), compaction = {} (ms)",
+        m_ribbon_vf_time_ms + m_ribbon_extract_time_ms +
+            m_ribbon_compact_time_ms,
+        m_ribbon_vf_time_ms,
+        m_ribbon_extract_time_ms,
+        m_ribbon_compact_time_ms);
 }
 
 void Patcher::initialize_random_seeds(std::vector<uint32_t>&       seeds,
@@ -777,6 +1299,7 @@ void Patcher::extract_ribbons(const std::vector<std::vector<uint32_t>>& fv,
                               const std::vector<uint32_t>& ff_offset,
                               const std::vector<uint32_t>& ff_values)
 {
+    RXMESH_ZONE("Patcher::extract_ribbons");
     // Post process the patches by extracting the ribbons
     // For patch P, we start first by identifying boundary faces; faces that has
     // an edge on P's boundary. These faces are captured by querying the
@@ -784,127 +1307,171 @@ void Patcher::extract_ribbons(const std::vector<std::vector<uint32_t>>& fv,
     // in the same patch, then this face is a boundary face. From these boundary
     // faces we can extract boundary vertices. We also now know which patch is
     // neighbor to P. Then we can use the boundary vertices to find the faces
-    // that are incident to these vertices on the neighbor patches
-    std::vector<uint32_t> frontier;
-    frontier.reserve(m_num_faces);
-
-    std::vector<uint32_t> bd_vertices;
-    bd_vertices.reserve(m_patch_size);
-
-    // build vertex incident faces
-    std::vector<std::vector<uint32_t>> vertex_incident_faces(
-        m_num_vertices, std::vector<uint32_t>(10));
-    for (uint32_t i = 0; i < vertex_incident_faces.size(); ++i) {
-        vertex_incident_faces[i].clear();
-    }
-    for (uint32_t face = 0; face < m_num_faces; ++face) {
+    // that are incident to these vertices on the neighbor patches.
+    // Patches are processed in parallel, each writing its ribbon in its own
+    // list, and the lists are then compacted into m_ribbon_ext_val
+
+    CPUTimer timer;
+
+    // build vertex incident faces in CSR format where the faces of every
+    // vertex are sorted. The count and the fill use atomics, the scan is done
+    // per thread chunk and then offset by the chunk sums, and since the fill
+    // order is arbitrary the faces of every vertex are sorted at the end
+    timer.start();
+    std::vector<uint32_t> vf_offset(m_num_vertices + 1, 0);
+#pragma omp parallel for
+    for (int face = 0; face < int(m_num_faces); ++face) {
         for (uint32_t v = 0; v < fv[face].size(); ++v) {
-            vertex_incident_faces[fv[face][v]].push_back(face);
+#pragma omp atomic
+            vf_offset[fv[face][v] + 1]++;
         }
     }
+    {
+        std::vector<uint32_t> chunk_sum(omp_get_max_threads() + 1, 0);
+#pragma omp parallel
+        {
+            const int t  = omp_get_thread_num();
+            const int nt = omp_get_num_threads();
+
+            // this thread's chunk of vf_offset[1..m_num_vertices]
+            const uint32_t begin = uint64_t(m_num_vertices) * t / nt + 1;
+            const uint32_t end   = uint64_t(m_num_vertices) * (t + 1) / nt + 1;
+            for (uint32_t v = begin + 1; v < end; ++v) {
+                vf_offset[v] += vf_offset[v - 1];
+            }
+            chunk_sum[t + 1] = (end > begin) ? vf_offset[end - 1] : 0;
+#pragma omp barrier
+#pragma omp single
+            {
+                for (int i = 0; i < nt; ++i) {
+                    chunk_sum[i + 1] += chunk_sum[i];
+                }
+            }
+            for (uint32_t v = begin; v < end; ++v) {
+                vf_offset[v] += chunk_sum[t];
+            }
+        }
+    }
+    std::vector<uint32_t> vf_values(vf_offset.back());
+    {
+        std::vector<uint32_t> pos(vf_offset.begin(), vf_offset.end() - 1);
+#pragma omp parallel for
+        for (int face = 0; face < int(m_num_faces); ++face) {
+            for (uint32_t v = 0; v < fv[face].size(); ++v) {
+                uint32_t slot;
+#pragma omp atomic capture
+                slot = pos[fv[face][v]]++;
+                vf_values[slot] = face;
+            }
+        }
+    }
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int v = 0; v < int(m_num_vertices); ++v) {
+        std::sort(vf_values.begin() + vf_offset[v],
+                  vf_values.begin() + vf_offset[v + 1]);
+    }
+    timer.stop();
+    m_ribbon_vf_time_ms = timer.elapsed_millis();
 
-    for (uint32_t cur_p = 0; cur_p < m_num_patches; ++cur_p) {
-
-        uint32_t p_start = (cur_p == 0) ? 0 : m_patches_offset[cur_p - 1];
-        uint32_t p_end   = m_patches_offset[cur_p];
-
-        bd_vertices.clear();
-        frontier.clear();
+    // extract the ribbon of every patch
+    timer.start();
+    std::vector<std::vector<uint32_t>> patch_ribbon(m_num_patches);
 
+#pragma omp parallel
+    {
+        // per-thread buffers
+        std::vector<uint32_t> bd_vertices;
+        bd_vertices.reserve(m_patch_size);
+        std::vector<uint32_t> added;
 
-        //***** Pass One
-        // 1) build a frontier of the boundary faces by loop over all faces and
-        // add those that has an edge on the patch boundary
-        for (uint32_t fb = p_start; fb < p_end; ++fb) {
-            uint32_t face = m_patches_val[fb];
+#pragma omp for schedule(dynamic, 16)
+        for (int cur_p = 0; cur_p < int(m_num_patches); ++cur_p) {
 
-            bool     added = false;
-            uint32_t start = ff_offset[face];
-            uint32_t end   = ff_offset[face + 1];
+            uint32_t p_start = (cur_p == 0) ? 0 : m_patches_offset[cur_p - 1];
+            uint32_t p_end   = m_patches_offset[cur_p];
 
-            for (uint32_t g = start; g < end; ++g) {
-                uint32_t n       = ff_values[g];
-                uint32_t n_patch = get_face_patch_id(n);
+            bd_vertices.clear();
 
-                // n is boundary face if its patch is not the current patch we
-                // are processing
-                if (n_patch != cur_p) {
-                    if (!added) {
-                        frontier.push_back(face);
-                        added = true;
-                    }
+            //***** Pass One
+            // 1) find the boundary faces by looping over all faces in the
+            // patch and checking if they have an edge on the patch boundary.
+            // The shared vertices of a boundary face and its neighbor face in
+            // another patch are boundary vertices
+            for (uint32_t fb = p_start; fb < p_end; ++fb) {
+                uint32_t face = m_patches_val[fb];
 
-                    // find/add the boundary vertices; these are the vertices
-                    // that are shared between face and n
+                uint32_t start = ff_offset[face];
+                uint32_t end   = ff_offset[face + 1];
 
-                    // add the common vertices in fv[face] and fv[n]
-                    for (uint32_t i = 0; i < fv[face].size(); ++i) {
-                        auto it_vf =
-                            std::find(fv[n].begin(), fv[n].end(), fv[face][i]);
-                        if (it_vf != fv[n].end()) {
-                            bd_vertices.push_back(fv[face][i]);
+                for (uint32_t g = start; g < end; ++g) {
+                    uint32_t n = ff_values[g];
+
+                    if (get_face_patch_id(n) != uint32_t(cur_p)) {
+                        // add the common vertices in fv[face] and fv[n]
+                        for (uint32_t i = 0; i < fv[face].size(); ++i) {
+                            for (uint32_t j = 0; j < fv[n].size(); ++j) {
+                                if (fv[n][j] == fv[face][i]) {
+                                    bd_vertices.push_back(fv[face][i]);
+                                    break;
+                                }
+                            }
                         }
                     }
-
-                    // we don't break out of this loop because we want to get
-                    // all the boundary vertices
-                    // break;
                 }
             }
-        }
 
-        // Sort boundary vertices so we can use binary_search
-        std::sort(bd_vertices.begin(), bd_vertices.end());
-        // remove duplicated vertices
-        inplace_remove_duplicates_sorted(bd_vertices);
-
-
-        //***** Pass Two
-
-        // 3) for every vertex on the patch boundary, we add all the faces
-        // that are incident to it and not in the current patch
-
-        m_ribbon_ext_offset[cur_p] =
-            (cur_p == 0) ? 0 : m_ribbon_ext_offset[cur_p - 1];
-        uint32_t r_start = m_ribbon_ext_offset[cur_p];
-
-        for (uint32_t v = 0; v < bd_vertices.size(); ++v) {
-            uint32_t vert = bd_vertices[v];
-
-            for (uint32_t f = 0; f < vertex_incident_faces[vert].size(); ++f) {
-                uint32_t face = vertex_incident_faces[vert][f];
-                if (get_face_patch_id(face) != cur_p) {
-                    // make sure we have not added face before
-                    bool     added = false;
-                    uint32_t r_end = m_ribbon_ext_offset[cur_p];
-                    for (uint32_t r = r_start; r < r_end; ++r) {
-                        if (m_ribbon_ext_val[r] == face) {
-                            added = true;
-                            break;
-                        }
-                    }
-                    if (!added) {
-
-                        m_ribbon_ext_val[m_ribbon_ext_offset[cur_p]] = face;
-                        m_ribbon_ext_offset[cur_p]++;
-                        if (m_ribbon_ext_offset[cur_p] == m_num_faces) {
-                            // need to expand m_ribbon_ext_val. This occurs
-                            // mostly for small meshes with small patch size
-                            // such that the amount overlap between exterior
-                            // ribbon of different patches is larger than
-                            // m_num_faces
-                            uint32_t new_size = m_ribbon_ext_val.size() * 2;
-                            m_ribbon_ext_val.resize(new_size);
+            // Sort boundary vertices and remove duplicated vertices
+            std::sort(bd_vertices.begin(), bd_vertices.end());
+            inplace_remove_duplicates_sorted(bd_vertices);
+
+
+            //***** Pass Two
+            // 2) for every vertex on the patch boundary, we add all the faces
+            // that are incident to it and not in the current patch (in the
+            // order they are first seen)
+            std::vector<uint32_t>& ribbon = patch_ribbon[cur_p];
+            added.clear();
+
+            for (uint32_t v = 0; v < bd_vertices.size(); ++v) {
+                uint32_t vert = bd_vertices[v];
+
+                for (uint32_t f = vf_offset[vert]; f < vf_offset[vert + 1];
+                     ++f) {
+                    uint32_t face = vf_values[f];
+                    if (get_face_patch_id(face) != uint32_t(cur_p)) {
+                        // make sure we have not added face before
+                        auto it = std::lower_bound(
+                            added.begin(), added.end(), face);
+                        if (it == added.end() || *it != face) {
+                            added.insert(it, face);
+                            ribbon.push_back(face);
                         }
-                        assert(m_ribbon_ext_offset[cur_p] <=
-                               m_ribbon_ext_val.size());
                     }
                 }
             }
         }
     }
+    timer.stop();
+    m_ribbon_extract_time_ms = timer.elapsed_millis();
+
+    // compact the ribbons
+    timer.start();
+    for (uint32_t p = 0; p < m_num_patches; ++p) {
+        m_ribbon_ext_offset[p] = ((p == 0) ? 0 : m_ribbon_ext_offset[p - 1]) +
+                                 uint32_t(patch_ribbon[p].size());
+    }
 
     m_ribbon_ext_val.resize(m_ribbon_ext_offset[m_num_patches - 1]);
+
+#pragma omp parallel for schedule(dynamic, 64)
+    for (int p = 0; p < int(m_num_patches); ++p) {
+        std::copy(patch_ribbon[p].begin(),
+                  patch_ribbon[p].end(),
+                  m_ribbon_ext_val.begin() +
+                      ((p == 0) ? 0 : m_ribbon_ext_offset[p - 1]));
+    }
+    timer.stop();
+    m_ribbon_compact_time_ms = timer.elapsed_millis();
 }
 
 void Patcher::assign_patch(
@@ -913,6 +1480,7 @@ void Patcher::assign_patch(
                              uint32_t,
                              ::rxmesh::detail::edge_key_hash> edges_map)
 {
+    RXMESH_ZONE("Patcher::assign_patch");
     // For every patch p, for every face in the patch, find the three edges
     // that bound that face, and assign them to the patch. For boundary vertices
     // and edges assign them to one patch (TODO smallest face count). For now,
@@ -1033,6 +1601,7 @@ void Patcher::run_lloyd(uint32_t* d_face_patch,
                         uint32_t* d_patches_size,
                         uint32_t* d_patches_val)
 {
+    RXMESH_ZONE("Patcher::run_lloyd");
     std::vector<uint32_t> h_queue_ptr{0, m_num_patches, m_num_patches};
 
     // CUDA_ERROR(cudaProfilerStart());
@@ -1229,6 +1798,7 @@ uint32_t Patcher::construct_patches_compressed_format(
 void Patcher::metis_kway(const std::vector<uint32_t>& ff_offset,
                          const std::vector<uint32_t>& ff_values)
 {
+    RXMESH_ZONE("Patcher::metis_kway");
 
     std::vector<idx_t> xadj(ff_offset.size());
     std::vector<idx_t> adjncy(ff_values.size());
@@ -1308,6 +1878,7 @@ void Patcher::metis_kway_vv(const std::vector<std::vector<uint32_t>>& fv,
                             const std::vector<uint32_t>&              vv_offset,
                             const std::vector<uint32_t>&              vv_values)
 {
+    RXMESH_ZONE("Patcher::metis_kway_vv");
 
     std::vector<idx_t> xadj(vv_offset.size());
     std::vector<idx_t> adjncy(vv_values.size());
@@ -1489,6 +2060,7 @@ void Patcher::build_supporting_structures_vv(
     std::vector<uint32_t>&                    vv_offset,
     std::vector<uint32_t>&                    vv_values)
 {
+    RXMESH_ZONE("Patcher::build_supporting_structures_vv");
     /* ---------- populate vv stuff ---------- */
 
     std::vector<uint32_t> vv_size(
@@ -18,6 +18,55 @@ namespace rxmesh {
 
 class RXMeshDynamic;
 
+/**
+ * @brief How the input faces are partitioned into patches. METIS is the
+ * default. Morton and Inertial are geometric partitioners that use the face
+ * centroids and so need the vertex coordinates at construction time
+ */
+enum class PartitionMethod
+{
+    // METIS k-way partition of the mesh graph
+    METIS = 0,
+    // sort the face centroids along a Morton (Z-order) curve and cut the
+    // sorted list into chunks of at most patch_size faces
+    Morton = 1,
+    // recursively split the face centroids at the median of their principal
+    // axis until every part has at most patch_size faces
+    Inertial = 2,
+};
+
+/**
+ * @brief convert PartitionMethod to string
+ */
+static std::string partition_method_to_string(const PartitionMethod method)
+{
+    switch (method) {
+        case PartitionMethod::METIS:
+            return "METIS";
+        case PartitionMethod::Morton:
+            return "Morton";
+        case PartitionMethod::Inertial:
+            return "Inertial";
+        default: {
+            RXMESH_ERROR("partition_method_to_string() unknown method");
+            return "";
+        }
+    }
+}
+
+/**
+ * @brief Options for the initial partition of the input mesh into patches
+ */
+struct PartitionPolicy
+{
+    PartitionMethod method = PartitionMethod::METIS;
+
+    // number of boundary smoothing passes applied after a geometric partition.
+    // A pass moves every face that has more neighbor faces in another patch
+    // than in its own patch to that patch. Zero disables smoothing
+    uint32_t smoothing_passes = 2;
+};
+
 namespace patcher {
 
 /**
@@ -55,6 +104,23 @@ class Patcher
             const uint32_t num_vertices,
             const uint32_t num_edges);
 
+    /**
+     * @brief partition the faces using the face centroids rather than the mesh
+     * graph (see PartitionMethod). Falls back to METIS if the policy method is
+     * METIS
+     */
+    Patcher(uint32_t                                  patch_size,
+            const std::vector<uint32_t>&              ff_offset,
+            const std::vector<uint32_t>&              ff_values,
+            const std::vector<std::vector<uint32_t>>& fv,
+            const std::vector<std::vector<float>>&    vertices,
+            const std::unordered_map<std::pair<uint32_t, uint32_t>,
+                                     uint32_t,
+                                     ::rxmesh::detail::edge_key_hash> edges_map,
+            const uint32_t         num_vertices,
+            const uint32_t         num_edges,
+            const PartitionPolicy& policy);
+
     Patcher(std::string filename);
 
     ~Patcher();
@@ -71,6 +137,20 @@ class Patcher
         return m_patch_size;
     }
 
+    /**
+     * @brief host memory (in bytes) held by the patching output
+     */
+    size_t get_host_memory_bytes() const
+    {
+        auto bytes = [](const std::vector<uint32_t>& v) {
+            return v.capacity() * sizeof(uint32_t);
+        };
+        return bytes(m_face_patch) + bytes(m_vertex_patch) +
+               bytes(m_edge_patch) + bytes(m_patches_val) +
+               bytes(m_patches_offset) + bytes(m_ribbon_ext_val) +
+               bytes(m_ribbon_ext_offset);
+    }
+
     std::vector<uint32_t>& get_face_patch()
     {
         return m_face_patch;
@@ -163,6 +243,11 @@ class Patcher
         return m_num_lloyd_run;
     }
 
+    PartitionMethod get_partition_method() const
+    {
+        return m_partition_method;
+    }
+
     void save(std::string filename)
     {
         std::ofstream                       ss(filename, std::ios::binary);
@@ -257,6 +342,20 @@ class Patcher
                                              std::vector<uint32_t>& component,
                                              uint32_t               num_seeds);
 
+    /**
+     * @brief split every patch into its face-connected components so a patch
+     * never spans two components of the input (e.g., two meshes of an
+     * RXMeshBatch). The vertices and edges that are already assigned to a
+     * patch follow their faces
+     */
+    void split_disconnected_patches(
+        const std::vector<std::vector<uint32_t>>&                 fv,
+        const std::vector<uint32_t>&                              ff_offset,
+        const std::vector<uint32_t>&                              ff_values,
+        const std::unordered_map<std::pair<uint32_t, uint32_t>,
+                                 uint32_t,
+                                 ::rxmesh::detail::edge_key_hash>& edges_map);
+
     void extract_ribbons(const std::vector<std::vector<uint32_t>>& fv,
                          const std::vector<uint32_t>&              ff_offset,
                          const std::vector<uint32_t>&              ff_values);
@@ -293,6 +392,31 @@ class Patcher
     void metis_kway(const std::vector<uint32_t>& ff_offset,
                     const std::vector<uint32_t>& ff_values);
 
+    /**
+     * @brief partition the faces by sorting their centroids along a Morton
+     * curve and chunking the sorted faces
+     */
+    void morton_partition(const std::vector<std::vector<uint32_t>>& fv,
+                          const std::vector<std::vector<float>>&    vertices);
+
+    /**
+     * @brief partition the faces with recursive inertial bisection of their
+     * centroids
+     */
+    void inertial_partition(const std::vector<std::vector<uint32_t>>& fv,
+                            const std::vector<std::vector<float>>& vertices);
+
+    /**
+     * @brief move faces on the patch boundaries to the neighbor patch that
+     * shares most of their edges as long as the patch stays within 10% of the
+     * patch size. This shortens the boundaries but does not guarantee
+     * face-connected patches, e.g., a Morton chunk may span two separate
+     * regions. split_disconnected_patches() runs afterwards for that
+     */
+    void smooth_partition(const std::vector<uint32_t>& ff_offset,
+                          const std::vector<uint32_t>& ff_values,
+                          const uint32_t               num_passes);
+
     /* VV_Patcher - for testing initial partitioning with VV */
     void metis_kway_vv(const std::vector<std::vector<uint32_t>>& fv,
                        const std::vector<std::vector<uint32_t>>& ev, 
@@ -326,6 +450,13 @@ class Patcher
 
     // caching the time taken to construct the patches
     float m_patching_time_ms;
+
+    // the method used for the initial partition
+    PartitionMethod m_partition_method;
+
+    // caching the time taken by the steps of extract_ribbons()
+    float m_ribbon_vf_time_ms, m_ribbon_extract_time_ms,
+        m_ribbon_compact_time_ms;
 };
 
 }  // namespace patcher
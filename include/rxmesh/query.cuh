@@ -204,7 +204,7 @@ struct Query
         prologue<op>(
             block, shrd_alloc, compute_active_set, oriented, allow_not_owned);
 
-        run_compute(block, compute_op);
+        run_compute<op>(block, compute_op);
 
         epilogue(block, shrd_alloc);
     }
@@ -289,6 +289,64 @@ struct Query
     }
 
 
+    /**
+     * @brief same as run_compute() but with the query operation known at
+     * compile time (it should match the one passed to prologue()) so the
+     * iterators of fixed-arity queries have a compile-time size
+     */
+    template <Op op, typename computeT>
+    __device__ __inline__ void run_compute(
+        cooperative_groups::thread_block& block,
+        computeT                          compute_op)
+    {
+        using ComputeTraits    = detail::FunctionTraits<computeT>;
+        using ComputeHandleT   = typename ComputeTraits::template arg<0>::type;
+        using ComputeIteratorT = typename ComputeTraits::template arg<1>::type;
+
+        assert(m_op == op);
+
+        for (uint16_t local_id = threadIdx.x; local_id < m_num_src_in_patch;
+             local_id += blockThreads) {
+
+            if (detail::is_set_bit(local_id, m_s_participant_bitmask)) {
+
+                assert(m_s_output_value);
+
+                ComputeHandleT   handle(m_patch_info.patch_id, local_id);
+                ComputeIteratorT iter =
+                    get_iterator<ComputeIteratorT, op>(local_id);
+                compute_op(handle, iter);
+            }
+        }
+    }
+
+
+    /**
+     * @brief same as get_iterator() but with the query operation known at
+     * compile time (it should match the one passed to prologue())
+     */
+    template <typename IteratorT, Op op>
+    __device__ __inline__ IteratorT get_iterator(uint16_t local_id) const
+    {
+        assert(m_op == op);
+
+        if (detail::is_set_bit(local_id, m_s_participant_bitmask)) {
+            return detail::make_query_iterator<op, IteratorT>(
+                m_context,
+                local_id,
+                m_s_output_value,
+                m_s_output_offset,
+                m_patch_info.patch_id,
+                m_s_output_owned_bitmask,
+                m_output_lp_hashtable,
+                m_s_table,
+                m_patch_info.patch_stash);
+        } else {
+            return IteratorT(m_context, local_id, m_patch_info.patch_id);
+        }
+    }
+
+
     /**
      * @brief return an iterator over the queries elements give a local index of
      * a source element
@@ -296,11 +354,7 @@ struct Query
     template <typename IteratorT>
     __device__ __inline__ IteratorT get_iterator(uint16_t local_id) const
     {
-        const uint32_t fixed_offset =
-            ((m_op == Op::EV) ? 2 :
-                                ((m_op == Op::FV || m_op == Op::FE) ?
-                                     3 :
-                                     ((m_op == Op::EVDiamond) ? 4 : 0)));
+        const uint32_t fixed_offset = op_fixed_size(m_op);
 
         using LocalT = typename IteratorT::LocalT;
 
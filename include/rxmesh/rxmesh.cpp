@@ -12,9 +12,41 @@
 #include "rxmesh/patch_scheduler.cuh"
 #include "rxmesh/rxmesh.h"
 #include "rxmesh/util/bitmask_util.h"
+#include "rxmesh/util/host_memory.h"
+#include "rxmesh/util/instrument.h"
 #include "rxmesh/util/util.h"
 
 namespace rxmesh {
+
+namespace {
+/**
+ * @brief group the mesh elements by their owner patch as CSR (counting sort)
+ */
+void group_by_patch(const std::vector<uint32_t>& element_patch,
+                    const uint32_t               num_patches,
+                    std::vector<uint32_t>&       offset,
+                    std::vector<uint32_t>&       value)
+{
+    offset.assign(num_patches + 1, 0);
+    for (const uint32_t p : element_patch) {
+        if (p < num_patches) {
+            offset[p + 1]++;
+        }
+    }
+    for (uint32_t p = 0; p < num_patches; ++p) {
+        offset[p + 1] += offset[p];
+    }
+    value.resize(offset.back());
+    std::vector<uint32_t> pos(offset.begin(), offset.end() - 1);
+    for (uint32_t i = 0; i < element_patch.size(); ++i) {
+        const uint32_t p = element_patch[i];
+        if (p < num_patches) {
+            value[pos[p]++] = i;
+        }
+    }
+}
+}  // namespace
+
 RXMesh::RXMesh(uint32_t patch_size)
     : m_num_edges(0),
       m_num_faces(0),
@@ -48,6 +80,8 @@ RXMesh::RXMesh(uint32_t patch_size)
       m_lp_hashtable_load_factor(0.f),
       m_patch_alloc_factor(0.f),
       m_topo_memory_mega_bytes(0.0),
+      m_h_tracked_topology_bytes(0),
+      m_h_tracked_patcher_bytes(0),
       m_num_colors(0)
 {
 }
@@ -56,8 +90,11 @@ void RXMesh::init(const std::vector<std::vector<uint32_t>>& fv,
                   const std::string                         patcher_file,
                   const float                               capacity_factor,
                   const float                               patch_alloc_factor,
-                  const float lp_hashtable_load_factor)
+                  const float lp_hashtable_load_factor,
+                  const PartitionPolicy&                    partition_policy,
+                  const std::vector<std::vector<float>>*    vertices)
 {
+    RXMESH_ZONE_NAMED(init_zone, "RXMesh::init");
     m_topo_memory_mega_bytes   = 0;
     m_capacity_factor          = capacity_factor;
     m_lp_hashtable_load_factor = lp_hashtable_load_factor;
@@ -79,20 +116,33 @@ void RXMesh::init(const std::vector<std::vector<uint32_t>>& fv,
         RXMESH_ERROR(
             "RXMesh::init hashtable load factor should be less than 1");
     }
+    PartitionPolicy policy = partition_policy;
+    if (policy.method != PartitionMethod::METIS && vertices == nullptr) {
+        RXMESH_ERROR(
+            "RXMesh::init {} partition needs the vertex coordinates. Using "
+            "METIS instead",
+            partition_method_to_string(policy.method));
+        policy.method = PartitionMethod::METIS;
+    }
 
     m_timers.add("LPHashTable");
-    m_timers.add("ht.insert");
-    m_timers.add("lower_bound");
     m_timers.add("bitmask");
-    m_timers.add("buildHT");
     m_timers.add("cudaMalloc");
     m_timers.add("malloc");
 
     m_timers.add("build");
+    m_timers.add("build_ltog");
+    m_timers.add("build_topology");
+    m_timers.add("build_host_patches");
+    m_timers.add("publish_device");
     m_timers.start("build");
-    build(fv, patcher_file);
+    build(fv, patcher_file, policy, vertices);
     m_timers.stop("build");
     RXMESH_INFO("build time = {} (ms)", m_timers.elapsed_millis("build"));
+    RXMESH_INFO("build_ltog time = {} (ms)",
+                m_timers.elapsed_millis("build_ltog"));
+    RXMESH_INFO("build_topology time = {} (ms)",
+                m_timers.elapsed_millis("build_topology"));
 
     m_timers.add("populate_patch_stash");
     m_timers.start("populate_patch_stash");
@@ -116,6 +166,10 @@ void RXMesh::init(const std::vector<std::vector<uint32_t>>& fv,
     m_timers.stop("build_device");
     RXMESH_INFO("build_device time = {} (ms)",
                 m_timers.elapsed_millis("build_device"));
+    RXMESH_INFO("build_host_patches time = {} (ms)",
+                m_timers.elapsed_millis("build_host_patches"));
+    RXMESH_INFO("publish_device time = {} (ms)",
+                m_timers.elapsed_millis("publish_device"));
 
 
     m_timers.add("PatchScheduler");
@@ -188,29 +242,47 @@ void RXMesh::init(const std::vector<std::vector<uint32_t>>& fv,
 
     RXMESH_INFO("malloc time = {} (ms)", m_timers.elapsed_millis("malloc"));
 
-    RXMESH_INFO("buildHT time = {} (ms)", m_timers.elapsed_millis("buildHT"));
     RXMESH_INFO("bitmask time = {} (ms)", m_timers.elapsed_millis("bitmask"));
-    RXMESH_INFO("lower_bound time = {} (ms)",
-                m_timers.elapsed_millis("lower_bound"));
-    RXMESH_INFO("ht.insert time = {} (ms)",
-                m_timers.elapsed_millis("ht.insert"));
     RXMESH_INFO("LPHashTable time = {} (ms)",
                 m_timers.elapsed_millis("LPHashTable"));
+
+    build_host_schedule(HostExecutionPolicy());
+
+    track_host_containers();
+
+    m_build_stage_times.clear();
+    for (const char* stage : {"build_ltog",
+                              "build_topology",
+                              "populate_patch_stash",
+                              "coloring",
+                              "build_host_patches",
+                              "publish_device"}) {
+        m_build_stage_times.push_back({stage, m_timers.elapsed_millis(stage)});
+    }
+
+    RXMESH_ZONE_COUNTER(init_zone, "num_vertices", m_num_vertices);
+    RXMESH_ZONE_COUNTER(init_zone, "num_edges", m_num_edges);
+    RXMESH_ZONE_COUNTER(init_zone, "num_faces", m_num_faces);
+    RXMESH_ZONE_COUNTER(init_zone, "num_patches", get_num_patches());
+    RXMESH_ZONE_COUNTER(init_zone, "topo_memory_mb", m_topo_memory_mega_bytes);
 }
 
 RXMesh::~RXMesh()
 {
     m_rxmesh_context.m_patch_scheduler.free();
 
-    for (uint32_t p = 0; p < get_num_patches(); ++p) {
-        free(m_h_patches_info[p].active_mask_v);
-        free(m_h_patches_info[p].active_mask_e);
-        free(m_h_patches_info[p].active_mask_f);
-        free(m_h_patches_info[p].owned_mask_v);
-        free(m_h_patches_info[p].owned_mask_e);
-        free(m_h_patches_info[p].owned_mask_f);
-        free(m_h_patches_info[p].num_faces);
-        free(m_h_patches_info[p].dirty);
+    // the extra patches are allocated on the host as well
+    for (uint32_t p = 0; p < get_max_num_patches(); ++p) {
+        host_free(m_h_patches_info[p].active_mask_v);
+        host_free(m_h_patches_info[p].active_mask_e);
+        host_free(m_h_patches_info[p].active_mask_f);
+        host_free(m_h_patches_info[p].owned_mask_v);
+        host_free(m_h_patches_info[p].owned_mask_e);
+        host_free(m_h_patches_info[p].owned_mask_f);
+        host_free(m_h_patches_info[p].ev);
+        host_free(m_h_patches_info[p].fe);
+        host_free(m_h_patches_info[p].num_faces);
+        host_free(m_h_patches_info[p].dirty);
         m_h_patches_info[p].lp_v.free();
         m_h_patches_info[p].lp_e.free();
         m_h_patches_info[p].lp_f.free();
@@ -245,21 +317,205 @@ RXMesh::~RXMesh()
         m_h_patches_info[p].lock.free();
     }
     GPU_FREE(m_d_patches_info);
-    free(m_h_patches_info);
+    host_free(m_h_patches_info);
     m_rxmesh_context.release();
 
     GPU_FREE(m_d_vertex_prefix);
     GPU_FREE(m_d_edge_prefix);
     GPU_FREE(m_d_face_prefix);
 
-    free(m_h_vertex_prefix);
-    free(m_h_edge_prefix);
-    free(m_h_face_prefix);
+    host_free(m_h_vertex_prefix);
+    host_free(m_h_edge_prefix);
+    host_free(m_h_face_prefix);
+
+    HostMemory::instance().untrack(HostMemTag::Topology,
+                                   m_h_tracked_topology_bytes);
+    HostMemory::instance().untrack(HostMemTag::Patcher,
+                                   m_h_tracked_patcher_bytes);
+}
+
+void RXMesh::set_host_execution_policy(const HostExecutionPolicy& policy)
+{
+    RXMESH_ZONE("RXMesh::set_host_execution_policy");
+
+    build_host_schedule(policy);
+
+    if (policy.numa_aware && policy.first_touch) {
+        // re-allocate the host topology from the thread that will process
+        // the patch so the pages land on its NUMA domain
+        m_host_schedule.run(get_max_num_patches(), [&](uint32_t p) {
+            PatchInfo& pi    = m_h_patches_info[p];
+            pi.ev            = host_first_touch_copy(pi.ev);
+            pi.fe            = host_first_touch_copy(pi.fe);
+            pi.active_mask_v = host_first_touch_copy(pi.active_mask_v);
+            pi.active_mask_e = host_first_touch_copy(pi.active_mask_e);
+            pi.active_mask_f = host_first_touch_copy(pi.active_mask_f);
+            pi.owned_mask_v  = host_first_touch_copy(pi.owned_mask_v);
+            pi.owned_mask_e  = host_first_touch_copy(pi.owned_mask_e);
+            pi.owned_mask_f  = host_first_touch_copy(pi.owned_mask_f);
+        });
+    }
+}
+
+PartitionDiagnostics RXMesh::compute_partition_diagnostics() const
+{
+    RXMESH_ZONE("RXMesh::compute_partition_diagnostics");
+
+    const uint32_t num_patches = get_num_patches();
+
+    PartitionDiagnostics ret;
+    ret.num_owned_vertices.resize(num_patches);
+    ret.num_owned_edges.resize(num_patches);
+    ret.num_owned_faces.resize(num_patches);
+    ret.num_ribbon_vertices.resize(num_patches);
+    ret.num_ribbon_edges.resize(num_patches);
+    ret.num_ribbon_faces.resize(num_patches);
+    ret.ribbon_ratio.resize(num_patches);
+    ret.edge_cut.resize(num_patches);
+    ret.num_neighbor_patches.resize(num_patches);
+    ret.lp_load_factor_v.resize(num_patches);
+    ret.lp_load_factor_e.resize(num_patches);
+    ret.lp_load_factor_f.resize(num_patches);
+    ret.lp_stash_load_factor_v.resize(num_patches);
+    ret.lp_stash_load_factor_e.resize(num_patches);
+    ret.lp_stash_load_factor_f.resize(num_patches);
+
+    ret.patch_size               = m_patch_size;
+    ret.capacity_factor          = m_capacity_factor;
+    ret.lp_hashtable_load_factor = m_lp_hashtable_load_factor;
+    ret.num_colors               = m_num_colors;
+    ret.patch_stash_size         = PatchStash::stash_size;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t i = 0; i < int64_t(num_patches); ++i) {
+        const uint32_t   p  = static_cast<uint32_t>(i);
+        const PatchInfo& pi = m_h_patches_info[p];
+
+        ret.num_owned_vertices[p] = pi.get_num_owned<VertexHandle>();
+        ret.num_owned_edges[p]    = pi.get_num_owned<EdgeHandle>();
+        ret.num_owned_faces[p]    = pi.get_num_owned<FaceHandle>();
+
+        ret.num_ribbon_vertices[p] =
+            pi.num_vertices[0] - ret.num_owned_vertices[p];
+        ret.num_ribbon_edges[p] = pi.num_edges[0] - ret.num_owned_edges[p];
+        ret.num_ribbon_faces[p] = pi.num_faces[0] - ret.num_owned_faces[p];
+
+        ret.ribbon_ratio[p] =
+            (ret.num_owned_faces[p] == 0) ?
+                0.f :
+                float(ret.num_ribbon_faces[p]) / float(ret.num_owned_faces[p]);
+
+        // an edge is on the patch boundary if it is incident to an owned face
+        // (bit 1) and a ribbon face (bit 2)
+        std::vector<uint8_t> edge_side(pi.num_edges[0], 0);
+        for (uint16_t f = 0; f < pi.num_faces[0]; ++f) {
+            if (detail::is_deleted(f, pi.active_mask_f)) {
+                continue;
+            }
+            const uint8_t side = detail::is_owned(f, pi.owned_mask_f) ? 1 : 2;
+            for (uint32_t k = 0; k < 3; ++k) {
+                uint16_t e;
+                flag_t   dir(0);
+                Context::unpack_edge_dir(pi.fe[3 * f + k].id, e, dir);
+                edge_side[e] |= side;
+            }
+        }
+        ret.edge_cut[p] = static_cast<uint32_t>(
+            std::count(edge_side.begin(), edge_side.end(), uint8_t(3)));
+
+        uint32_t num_neighbors = 0;
+        for (uint8_t s = 0; s < PatchStash::stash_size; ++s) {
+            if (pi.patch_stash.get_patch(s) != INVALID32) {
+                num_neighbors++;
+            }
+        }
+        ret.num_neighbor_patches[p] = num_neighbors;
+
+        ret.lp_load_factor_v[p]       = pi.lp_v.compute_load_factor();
+        ret.lp_load_factor_e[p]       = pi.lp_e.compute_load_factor();
+        ret.lp_load_factor_f[p]       = pi.lp_f.compute_load_factor();
+        ret.lp_stash_load_factor_v[p] = pi.lp_v.compute_stash_load_factor();
+        ret.lp_stash_load_factor_e[p] = pi.lp_e.compute_stash_load_factor();
+        ret.lp_stash_load_factor_f[p] = pi.lp_f.compute_stash_load_factor();
+    }
+
+    uint32_t sum_edge_cut = 0;
+    for (uint32_t p = 0; p < num_patches; ++p) {
+        sum_edge_cut += ret.edge_cut[p];
+        if (ret.num_neighbor_patches[p] >= ret.patch_stash_size) {
+            ret.num_patches_at_stash_limit++;
+        }
+    }
+    ret.total_edge_cut = sum_edge_cut / 2;
+
+    return ret;
+}
+
+void RXMesh::build_host_schedule(const HostExecutionPolicy& policy)
+{
+    std::vector<uint32_t> weights(get_max_num_patches(), 0);
+    for (uint32_t p = 0; p < get_num_patches(); ++p) {
+        weights[p] = m_h_num_owned_v[p] + m_h_num_owned_e[p] +
+                     m_h_num_owned_f[p];
+    }
+
+    std::vector<uint32_t> order;
+    if (policy.super_patch_size > 0) {
+        // patches grouped by super-patch followed by the unused patches
+        order = get_super_patches(policy.super_patch_size).get_patch_order();
+        for (uint32_t p = get_num_patches(); p < get_max_num_patches(); ++p) {
+            order.push_back(p);
+        }
+    }
+    m_host_schedule.build(policy, weights, order);
+}
+
+void RXMesh::track_host_containers()
+{
+    size_t topo_bytes = 0;
+
+    auto add_vec = [&](const auto& v) {
+        using VecT = std::decay_t<decltype(v)>;
+        topo_bytes += v.capacity() * sizeof(typename VecT::value_type);
+    };
+
+    add_vec(m_h_num_owned_v);
+    add_vec(m_h_num_owned_e);
+    add_vec(m_h_num_owned_f);
+
+    for (const auto* ltog :
+         {&m_h_patches_ltog_v, &m_h_patches_ltog_e, &m_h_patches_ltog_f}) {
+        add_vec(*ltog);
+        for (const auto& l : *ltog) {
+            add_vec(l);
+        }
+    }
+
+    // approximate the hash map with one node (key, value, next pointer, and
+    // cached hash) per entry plus the bucket array
+    topo_bytes += m_edges_map.bucket_count() * sizeof(void*) +
+                  m_edges_map.size() * (sizeof(EdgeMapT::value_type) +
+                                        sizeof(void*) + sizeof(size_t));
+
+    const size_t patcher_bytes =
+        m_patcher ? m_patcher->get_host_memory_bytes() : 0;
+
+    HostMemory& hm = HostMemory::instance();
+    hm.untrack(HostMemTag::Topology, m_h_tracked_topology_bytes);
+    hm.untrack(HostMemTag::Patcher, m_h_tracked_patcher_bytes);
+    hm.track(HostMemTag::Topology, topo_bytes);
+    hm.track(HostMemTag::Patcher, patcher_bytes);
+
+    m_h_tracked_topology_bytes = topo_bytes;
+    m_h_tracked_patcher_bytes  = patcher_bytes;
 }
 
 void RXMesh::build(const std::vector<std::vector<uint32_t>>& fv,
-                   const std::string                         patcher_file)
+                   const std::string                         patcher_file,
+                   const PartitionPolicy&                    partition_policy,
+                   const std::vector<std::vector<float>>*    vertices)
 {
+    RXMESH_ZONE("RXMesh::build");
     std::vector<uint32_t>              ff_values;
     std::vector<uint32_t>              ff_offset;
     std::vector<std::vector<uint32_t>> ef;
@@ -271,16 +527,29 @@ void RXMesh::build(const std::vector<std::vector<uint32_t>>& fv,
 
     build_supporting_structures(fv, ev, ef, ff_offset, ff_values);
 
-    /* VV_Patcher - Use this constructor for testing initial partitioning with
-     * VV */
-    m_patcher = std::make_unique<patcher::Patcher>(m_patch_size,
-                                                    ff_offset,
-                                                    ff_values,
-                                                    fv,
-                                                    ev,
-                                                    m_edges_map,
-                                                    m_num_vertices,
-                                                    m_num_edges);
+    if (partition_policy.method != PartitionMethod::METIS) {
+        assert(vertices != nullptr);
+        m_patcher = std::make_unique<patcher::Patcher>(m_patch_size,
+                                                        ff_offset,
+                                                        ff_values,
+                                                        fv,
+                                                        *vertices,
+                                                        m_edges_map,
+                                                        m_num_vertices,
+                                                        m_num_edges,
+                                                        partition_policy);
+    } else {
+        /* VV_Patcher - Use this constructor for testing initial partitioning
+         * with VV */
+        m_patcher = std::make_unique<patcher::Patcher>(m_patch_size,
+                                                        ff_offset,
+                                                        ff_values,
+                                                        fv,
+                                                        ev,
+                                                        m_edges_map,
+                                                        m_num_vertices,
+                                                        m_num_edges);
+    }
 
     /* The original code for patcher construction */
     // // Patcher file loading
@@ -318,7 +587,7 @@ void RXMesh::build(const std::vector<std::vector<uint32_t>>& fv,
         std::ceil(m_patch_alloc_factor * static_cast<float>(m_num_patches)));
 
     m_h_patches_info =
-        (PatchInfo*)malloc(get_max_num_patches() * sizeof(PatchInfo));
+        host_malloc<PatchInfo>(get_max_num_patches(), HostMemTag::Topology);
     m_h_patches_ltog_f.resize(get_num_patches());
     m_h_patches_ltog_e.resize(get_num_patches());
     m_h_patches_ltog_v.resize(get_num_patches());
@@ -326,10 +595,25 @@ void RXMesh::build(const std::vector<std::vector<uint32_t>>& fv,
     m_h_num_owned_v.resize(get_max_num_patches(), 0);
     m_h_num_owned_e.resize(get_max_num_patches(), 0);
 
-#pragma omp parallel for
+    // the owned vertices and edges of every patch so a patch only visits its
+    // own elements
+    std::vector<uint32_t> owned_offset_v, owned_v, owned_offset_e, owned_e;
+    group_by_patch(m_patcher->get_vertex_patch(),
+                   get_num_patches(),
+                   owned_offset_v,
+                   owned_v);
+    group_by_patch(m_patcher->get_edge_patch(),
+                   get_num_patches(),
+                   owned_offset_e,
+                   owned_e);
+
+    m_timers.start("build_ltog");
+#pragma omp parallel for schedule(dynamic)
     for (int p = 0; p < static_cast<int>(get_num_patches()); ++p) {
-        build_single_patch_ltog(fv, ev, p);
+        build_single_patch_ltog(
+            fv, ev, owned_offset_v, owned_v, owned_offset_e, owned_e, p);
     }
+    m_timers.stop("build_ltog");
 
     // calc max elements for use in build_device (which populates
     // m_h_patches_info and thus we can not use calc_max_elements now)
@@ -357,17 +641,22 @@ void RXMesh::build(const std::vector<std::vector<uint32_t>>& fv,
     m_max_face_capacity = static_cast<uint16_t>(std::ceil(
         m_capacity_factor * static_cast<float>(m_max_faces_per_patch)));
 
-#pragma omp parallel for
+    m_timers.start("build_topology");
+#pragma omp parallel for schedule(dynamic)
     for (int p = 0; p < static_cast<int>(get_num_patches()); ++p) {
         build_single_patch_topology(fv, p);
     }
+    m_timers.stop("build_topology");
 
     const uint32_t patches_1_bytes =
         (get_max_num_patches() + 1) * sizeof(uint32_t);
 
-    m_h_vertex_prefix = (uint32_t*)malloc(patches_1_bytes);
-    m_h_edge_prefix   = (uint32_t*)malloc(patches_1_bytes);
-    m_h_face_prefix   = (uint32_t*)malloc(patches_1_bytes);
+    m_h_vertex_prefix =
+        host_malloc<uint32_t>(get_max_num_patches() + 1, HostMemTag::Topology);
+    m_h_edge_prefix =
+        host_malloc<uint32_t>(get_max_num_patches() + 1, HostMemTag::Topology);
+    m_h_face_prefix =
+        host_malloc<uint32_t>(get_max_num_patches() + 1, HostMemTag::Topology);
 
     memset(m_h_vertex_prefix, 0, patches_1_bytes);
     memset(m_h_edge_prefix, 0, patches_1_bytes);
@@ -412,6 +701,7 @@ void RXMesh::build_supporting_structures(
     std::vector<uint32_t>&                    ff_offset,
     std::vector<uint32_t>&                    ff_values)
 {
+    RXMESH_ZONE("RXMesh::build_supporting_structures");
     m_num_faces    = static_cast<uint32_t>(fv.size());
     m_num_vertices = 0;
     m_num_edges    = 0;
@@ -506,6 +796,7 @@ void RXMesh::build_supporting_structures(
 void RXMesh::calc_input_statistics(const std::vector<std::vector<uint32_t>>& fv,
                                    const std::vector<std::vector<uint32_t>>& ef)
 {
+    RXMESH_ZONE("RXMesh::calc_input_statistics");
     if (m_num_vertices == 0 || m_num_faces == 0 || m_num_edges == 0 ||
         fv.size() == 0 || ef.size() == 0) {
         RXMESH_ERROR(
@@ -577,8 +868,13 @@ void RXMesh::calc_max_elements()
 void RXMesh::build_single_patch_ltog(
     const std::vector<std::vector<uint32_t>>& fv,
     const std::vector<std::vector<uint32_t>>& ev,
+    const std::vector<uint32_t>&              owned_offset_v,
+    const std::vector<uint32_t>&              owned_v,
+    const std::vector<uint32_t>&              owned_offset_e,
+    const std::vector<uint32_t>&              owned_e,
     const uint32_t                            patch_id)
 {
+    RXMESH_ZONE("RXMesh::build_single_patch_ltog");
     // patch start and end
     const uint32_t p_start =
         (patch_id == 0) ? 0 : m_patcher->get_patches_offset()[patch_id - 1];
@@ -593,34 +889,28 @@ void RXMesh::build_single_patch_ltog(
 
     const uint32_t total_patch_num_faces =
         (p_end - p_start) + (r_end - r_start);
-    m_h_patches_ltog_f[patch_id].resize(total_patch_num_faces);
-    m_h_patches_ltog_v[patch_id].reserve(3 * total_patch_num_faces);
-    m_h_patches_ltog_e[patch_id].reserve(3 * total_patch_num_faces);
 
-    std::vector<bool> is_vertex_added(m_num_vertices, false);
-    std::vector<bool> is_edge_added(m_num_edges, false);
+    std::vector<uint32_t>& ltog_f = m_h_patches_ltog_f[patch_id];
+    std::vector<uint32_t>& ltog_e = m_h_patches_ltog_e[patch_id];
+    std::vector<uint32_t>& ltog_v = m_h_patches_ltog_v[patch_id];
+
+    ltog_f.resize(total_patch_num_faces);
+    ltog_v.clear();
+    ltog_e.clear();
+    ltog_v.reserve(3 * total_patch_num_faces);
+    ltog_e.reserve(3 * total_patch_num_faces);
 
-    // add faces owned by this patch
+    // collect the vertices and edges of the faces (with duplicates that are
+    // removed below) instead of marking them in arrays as large as the mesh
     auto add_new_face = [&](uint32_t global_face_id, uint16_t local_face_id) {
-        m_h_patches_ltog_f[patch_id][local_face_id] = global_face_id;
+        ltog_f[local_face_id] = global_face_id;
 
         for (uint32_t v = 0; v < 3; ++v) {
             uint32_t v0 = fv[global_face_id][v];
             uint32_t v1 = fv[global_face_id][(v + 1) % 3];
 
-            uint32_t edge_id = get_edge_id(v0, v1);
-
-            if (!is_vertex_added[v0]) {
-                is_vertex_added[v0] = true;
-
-                m_h_patches_ltog_v[patch_id].push_back(v0);
-            }
-
-            if (!is_edge_added[edge_id]) {
-                is_edge_added[edge_id] = true;
-
-                m_h_patches_ltog_e[patch_id].push_back(edge_id);
-            }
+            ltog_v.push_back(v0);
+            ltog_e.push_back(get_edge_id(v0, v1));
         }
     };
 
@@ -635,37 +925,28 @@ void RXMesh::build_single_patch_ltog(
         add_new_face(face_id, local_face_id++);
     }
 
-
-    // add edges owned by this patch
-    for (uint32_t e = 0; e < m_num_edges; ++e) {
-        // if the edge is owned by this patch but it was not added yet
-        if (m_patcher->get_edge_patch_id(e) == patch_id && !is_edge_added[e]) {
-            m_h_patches_ltog_e[patch_id].push_back(e);
-            for (uint32_t i = 0; i < 2; ++i) {
-                uint32_t v = ev[e][i];
-                if (!is_vertex_added[v]) {
-                    m_h_patches_ltog_v[patch_id].push_back(v);
-                }
-            }
-        }
+    // add edges owned by this patch (and their end vertices)
+    for (uint32_t i = owned_offset_e[patch_id];
+         i < owned_offset_e[patch_id + 1];
+         ++i) {
+        const uint32_t e = owned_e[i];
+        ltog_e.push_back(e);
+        ltog_v.push_back(ev[e][0]);
+        ltog_v.push_back(ev[e][1]);
     }
 
     // add vertices owned by this patch
-    for (uint32_t v = 0; v < m_num_vertices; ++v) {
-        // if the edge is owned by this patch but it was not added yet
-        if (m_patcher->get_vertex_patch_id(v) == patch_id &&
-            !is_vertex_added[v]) {
-            m_h_patches_ltog_v[patch_id].push_back(v);
-        }
+    for (uint32_t i = owned_offset_v[patch_id];
+         i < owned_offset_v[patch_id + 1];
+         ++i) {
+        ltog_v.push_back(owned_v[i]);
     }
 
     auto create_unique_mapping = [&](std::vector<uint32_t>&       ltog_map,
                                      const std::vector<uint32_t>& patch) {
         std::sort(ltog_map.begin(), ltog_map.end());
-#ifndef NDEBUG
-        auto unique_end = std::unique(ltog_map.begin(), ltog_map.end());
-        assert(unique_end == ltog_map.end());
-#endif
+        ltog_map.erase(std::unique(ltog_map.begin(), ltog_map.end()),
+                       ltog_map.end());
 
         // we use stable partition since we want ltog to be sorted so we can
         // use binary search on it when we populate the topology
@@ -676,20 +957,21 @@ void RXMesh::build_single_patch_ltog(
         return static_cast<uint16_t>(part_end - ltog_map.begin());
     };
 
-    m_h_num_owned_f[patch_id] = create_unique_mapping(
-        m_h_patches_ltog_f[patch_id], m_patcher->get_face_patch());
+    m_h_num_owned_f[patch_id] =
+        create_unique_mapping(ltog_f, m_patcher->get_face_patch());
 
-    m_h_num_owned_e[patch_id] = create_unique_mapping(
-        m_h_patches_ltog_e[patch_id], m_patcher->get_edge_patch());
+    m_h_num_owned_e[patch_id] =
+        create_unique_mapping(ltog_e, m_patcher->get_edge_patch());
 
-    m_h_num_owned_v[patch_id] = create_unique_mapping(
-        m_h_patches_ltog_v[patch_id], m_patcher->get_vertex_patch());
+    m_h_num_owned_v[patch_id] =
+        create_unique_mapping(ltog_v, m_patcher->get_vertex_patch());
 }
 
 void RXMesh::build_single_patch_topology(
     const std::vector<std::vector<uint32_t>>& fv,
     const uint32_t                            patch_id)
 {
+    RXMESH_ZONE("RXMesh::build_single_patch_topology");
     // patch start and end
     const uint32_t p_start =
         (patch_id == 0) ? 0 : m_patcher->get_patches_offset()[patch_id - 1];
@@ -708,9 +990,9 @@ void RXMesh::build_single_patch_topology(
     const uint32_t faces_cap = m_max_face_capacity;
 
     m_h_patches_info[patch_id].ev =
-        (LocalVertexT*)malloc(edges_cap * 2 * sizeof(LocalVertexT));
+        host_malloc<LocalVertexT>(edges_cap * 2, HostMemTag::Topology);
     m_h_patches_info[patch_id].fe =
-        (LocalEdgeT*)malloc(faces_cap * 3 * sizeof(LocalEdgeT));
+        host_malloc<LocalEdgeT>(faces_cap * 3, HostMemTag::Topology);
 
     std::vector<bool> is_added_edge(patch_num_edges, false);
 
@@ -815,55 +1097,32 @@ void RXMesh::build_single_patch_topology(
 
 const VertexHandle RXMesh::map_to_local_vertex(uint32_t i) const
 {
-    auto pl = map_to_local<VertexHandle>(i, m_h_vertex_prefix);
-    return {pl.first, pl.second};
+    if (i >= get_num_vertices()) {
+        RXMESH_ERROR(
+            "RXMeshStatic::map_to_local_vertex input ({}) is out of range!", i);
+        return VertexHandle();
+    }
+    return get_index_map<VertexHandle>().handle(i);
 }
 
 const EdgeHandle RXMesh::map_to_local_edge(uint32_t i) const
 {
-    auto pl = map_to_local<EdgeHandle>(i, m_h_edge_prefix);
-    return {pl.first, pl.second};
+    if (i >= get_num_edges()) {
+        RXMESH_ERROR(
+            "RXMeshStatic::map_to_local_edge input ({}) is out of range!", i);
+        return EdgeHandle();
+    }
+    return get_index_map<EdgeHandle>().handle(i);
 }
 
 const FaceHandle RXMesh::map_to_local_face(uint32_t i) const
 {
-    auto pl = map_to_local<FaceHandle>(i, m_h_face_prefix);
-    return {pl.first, pl.second};
-}
-
-
-template <typename HandleT>
-const std::pair<uint32_t, uint16_t> RXMesh::map_to_local(
-    const uint32_t  i,
-    const uint32_t* element_prefix) const
-{
-    const auto end = element_prefix + get_num_patches() + 1;
-
-    auto p = std::lower_bound(
-        element_prefix, end, i, [](int a, int b) { return a <= b; });
-    if (p == end) {
+    if (i >= get_num_faces()) {
         RXMESH_ERROR(
-            "RXMeshStatic::map_to_local can not its patch. Input is out of "
-            "range!");
-    }
-    p -= 1;
-    uint32_t patch_id = std::distance(element_prefix, p);
-    uint32_t prefix   = i - *p;
-    uint16_t local_id = 0;
-    uint16_t num_elements =
-        *(m_h_patches_info[patch_id].template get_num_elements<HandleT>());
-    for (uint16_t l = 0; l < num_elements; ++l) {
-        if (m_h_patches_info[patch_id].is_owned(typename HandleT::LocalT(l)) &&
-            !m_h_patches_info[patch_id].is_deleted(
-                typename HandleT::LocalT(l))) {
-            if (local_id == prefix) {
-                local_id = l;
-                break;
-            }
-            local_id++;
-        }
+            "RXMeshStatic::map_to_local_face input ({}) is out of range!", i);
+        return FaceHandle();
     }
-    return {patch_id, local_id};
+    return get_index_map<FaceHandle>().handle(i);
 }
 
 
@@ -913,6 +1172,7 @@ uint16_t RXMesh::get_per_patch_max_face_capacity() const
 
 void RXMesh::populate_patch_stash()
 {
+    RXMESH_ZONE("RXMesh::populate_patch_stash");
     auto populate_patch_stash = [&](uint32_t                     p,
                                     const std::vector<uint32_t>& ltog,
                                     const std::vector<uint32_t>& element_patch,
@@ -929,7 +1189,10 @@ void RXMesh::populate_patch_stash()
         }
     };
 
-    // #pragma omp parallel for
+    // every patch fills its own stash so patches are independent. Within a
+    // patch, the insertion order (and thus the stash index of every neighbor)
+    // is the same as a serial build
+#pragma omp parallel for schedule(dynamic)
     for (int p = 0; p < static_cast<int>(get_num_patches()); ++p) {
         m_h_patches_info[p].patch_stash = PatchStash(false);
 
@@ -947,7 +1210,7 @@ void RXMesh::populate_patch_stash()
                              m_h_num_owned_f[p]);
     }
 
-    // #pragma omp parallel for
+#pragma omp parallel for
     for (int p = get_num_patches(); p < static_cast<int>(get_max_num_patches());
          ++p) {
         m_h_patches_info[p].patch_stash = PatchStash(false);
@@ -956,16 +1219,12 @@ void RXMesh::populate_patch_stash()
 
 void RXMesh::build_device()
 {
-    m_timers.start("cudaMalloc");
-    CUDA_ERROR(cudaMalloc((void**)&m_d_patches_info,
-                          get_max_num_patches() * sizeof(PatchInfo)));
-    m_timers.stop("cudaMalloc");
-
-    m_topo_memory_mega_bytes +=
-        BYTES_TO_MEGABYTES(get_max_num_patches() * sizeof(PatchInfo));
-
+    RXMESH_ZONE("RXMesh::build_device");
 
-    // #pragma omp parallel for
+    // 1) build the host patches (masks and hashtables) in parallel. Every
+    // patch only writes its own PatchInfo
+    m_timers.start("build_host_patches");
+#pragma omp parallel for schedule(dynamic)
     for (int p = 0; p < static_cast<int>(get_num_patches()); ++p) {
 
         const uint16_t p_num_vertices =
@@ -975,22 +1234,22 @@ void RXMesh::build_device()
         const uint16_t p_num_faces =
             static_cast<uint16_t>(m_h_patches_ltog_f[p].size());
 
-        build_device_single_patch(p,
-                                  p_num_vertices,
-                                  p_num_edges,
-                                  p_num_faces,
-                                  get_per_patch_max_vertex_capacity(),
-                                  get_per_patch_max_edge_capacity(),
-                                  get_per_patch_max_face_capacity(),
-                                  m_h_num_owned_v[p],
-                                  m_h_num_owned_e[p],
-                                  m_h_num_owned_f[p],
-                                  m_h_patches_ltog_v[p],
-                                  m_h_patches_ltog_e[p],
-                                  m_h_patches_ltog_f[p],
-                                  m_h_patches_info[p],
-                                  m_d_patches_info[p]);
+        build_host_single_patch(p,
+                                p_num_vertices,
+                                p_num_edges,
+                                p_num_faces,
+                                get_per_patch_max_vertex_capacity(),
+                                get_per_patch_max_edge_capacity(),
+                                get_per_patch_max_face_capacity(),
+                                m_h_num_owned_v[p],
+                                m_h_num_owned_e[p],
+                                m_h_num_owned_f[p],
+                                m_h_patches_ltog_v[p],
+                                m_h_patches_ltog_e[p],
+                                m_h_patches_ltog_f[p],
+                                m_h_patches_info[p]);
     }
+    m_timers.stop("build_host_patches");
 
 
     for (uint32_t p = 0; p < get_num_patches(); ++p) {
@@ -1005,7 +1264,8 @@ void RXMesh::build_device()
     }
 
     // make sure that if a patch stash of patch p has patch q, then q's patch
-    // stash should have p in it
+    // stash should have p in it. This only fills empty slots so the stash
+    // indices used by the hashtables do not change
     for (uint32_t p = 0; p < get_num_patches(); ++p) {
         for (uint8_t p_sh = 0; p_sh < PatchStash::stash_size; ++p_sh) {
             uint32_t q = m_h_patches_info[p].patch_stash.get_patch(p_sh);
@@ -1023,29 +1283,45 @@ void RXMesh::build_device()
             }
         }
     }
+
+    // 2) publish the host patches to the device
+    m_timers.start("publish_device");
+    m_timers.start("cudaMalloc");
+    CUDA_ERROR(cudaMalloc((void**)&m_d_patches_info,
+                          get_max_num_patches() * sizeof(PatchInfo)));
+    m_timers.stop("cudaMalloc");
+
+    m_topo_memory_mega_bytes +=
+        BYTES_TO_MEGABYTES(get_max_num_patches() * sizeof(PatchInfo));
+
+    for (uint32_t p = 0; p < get_num_patches(); ++p) {
+        build_device_single_patch(p, m_h_patches_info[p], m_d_patches_info[p]);
+    }
+    m_timers.stop("publish_device");
 }
 
-void RXMesh::build_device_single_patch(const uint32_t patch_id,
-                                       const uint16_t p_num_vertices,
-                                       const uint16_t p_num_edges,
-                                       const uint16_t p_num_faces,
-                                       const uint16_t p_vertices_capacity,
-                                       const uint16_t p_edges_capacity,
-                                       const uint16_t p_faces_capacity,
-                                       const uint16_t p_num_owned_vertices,
-                                       const uint16_t p_num_owned_edges,
-                                       const uint16_t p_num_owned_faces,
-                                       const std::vector<uint32_t>& ltog_v,
-                                       const std::vector<uint32_t>& ltog_e,
-                                       const std::vector<uint32_t>& ltog_f,
-                                       PatchInfo& h_patch_info,
-                                       PatchInfo& d_patch_info)
+void RXMesh::build_host_single_patch(const uint32_t patch_id,
+                                     const uint16_t p_num_vertices,
+                                     const uint16_t p_num_edges,
+                                     const uint16_t p_num_faces,
+                                     const uint16_t p_vertices_capacity,
+                                     const uint16_t p_edges_capacity,
+                                     const uint16_t p_faces_capacity,
+                                     const uint16_t p_num_owned_vertices,
+                                     const uint16_t p_num_owned_edges,
+                                     const uint16_t p_num_owned_faces,
+                                     const std::vector<uint32_t>& ltog_v,
+                                     const std::vector<uint32_t>& ltog_e,
+                                     const std::vector<uint32_t>& ltog_f,
+                                     PatchInfo& h_patch_info)
 {
+    RXMESH_ZONE("RXMesh::build_host_single_patch");
 
+    // this runs in parallel over patches so it only touches h_patch_info and
+    // does not use m_timers
 
-    m_timers.start("malloc");
-    uint16_t* h_counts = (uint16_t*)malloc(6 * sizeof(uint16_t));
-    m_timers.stop("malloc");
+    uint16_t* h_counts = host_malloc<uint16_t>(6, HostMemTag::Topology);
+    int*      h_dirty  = host_malloc<int>(1, HostMemTag::Topology);
 
     h_patch_info.num_faces            = h_counts;
     h_patch_info.num_faces[0]         = p_num_faces;
@@ -1060,11 +1336,173 @@ void RXMesh::build_device_single_patch(const uint32_t patch_id,
     h_patch_info.vertices_capacity    = h_counts + 5;
     h_patch_info.vertices_capacity[0] = p_vertices_capacity;
     h_patch_info.patch_id             = patch_id;
-    h_patch_info.dirty                = (int*)malloc(sizeof(int));
+    h_patch_info.dirty                = h_dirty;
     h_patch_info.dirty[0]             = 0;
     h_patch_info.child_id             = INVALID32;
     h_patch_info.should_slice         = false;
 
+    // we realloc the host h_patch_info EV and FE to ensure that both host and
+    // device has the same capacity
+    h_patch_info.ev = host_realloc(
+        h_patch_info.ev, p_edges_capacity * 2, HostMemTag::Topology);
+    h_patch_info.fe = host_realloc(
+        h_patch_info.fe, p_faces_capacity * 3, HostMemTag::Topology);
+
+    // allocate and set bitmask
+    auto bitmask = [&](uint32_t*& h_mask, uint32_t capacity, auto predicate) {
+        size_t num_bytes = detail::mask_num_bytes(capacity);
+
+        h_mask = host_malloc<uint32_t>(num_bytes / sizeof(uint32_t),
+                                       HostMemTag::Topology);
+
+        for (uint16_t i = 0; i < capacity; ++i) {
+            if (predicate(i)) {
+                detail::bitmask_set_bit(i, h_mask);
+            } else {
+                detail::bitmask_clear_bit(i, h_mask);
+            }
+        }
+    };
+
+    // vertices active mask
+    bitmask(h_patch_info.active_mask_v, p_vertices_capacity, [&](uint16_t v) {
+        return v < p_num_vertices;
+    });
+
+    // edges active mask
+    bitmask(h_patch_info.active_mask_e, p_edges_capacity, [&](uint16_t e) {
+        return e < p_num_edges;
+    });
+
+    // faces active mask
+    bitmask(h_patch_info.active_mask_f, p_faces_capacity, [&](uint16_t f) {
+        return f < p_num_faces;
+    });
+
+    // vertices owned mask
+    bitmask(h_patch_info.owned_mask_v, p_vertices_capacity, [&](uint16_t v) {
+        return v < p_num_owned_vertices;
+    });
+
+    // edges owned mask
+    bitmask(h_patch_info.owned_mask_e, p_edges_capacity, [&](uint16_t e) {
+        return e < p_num_owned_edges;
+    });
+
+    // faces owned mask
+    bitmask(h_patch_info.owned_mask_f, p_faces_capacity, [&](uint16_t f) {
+        return f < p_num_owned_faces;
+    });
+
+
+    // build LPHashtable
+    auto build_ht = [&](const std::vector<std::vector<uint32_t>>& ltog,
+                        const std::vector<uint32_t>&              p_ltog,
+                        const std::vector<uint32_t>&              element_patch,
+                        const std::vector<uint16_t>&              num_owned,
+                        const uint16_t                            num_elements,
+                        const uint16_t num_owned_elements,
+                        const uint16_t cap,
+                        PatchStash&    stash,
+                        LPHashTable&   h_hashtable) {
+        const uint16_t num_not_owned = num_elements - num_owned_elements;
+
+        h_hashtable = LPHashTable(
+            lp_hashtable_capacity(patch_id, num_not_owned, cap), false);
+
+        for (uint16_t i = 0; i < num_not_owned; ++i) {
+            uint16_t local_id    = i + num_owned_elements;
+            uint32_t global_id   = p_ltog[local_id];
+            uint32_t owner_patch = element_patch[global_id];
+
+            auto it = std::lower_bound(
+                ltog[owner_patch].begin(),
+                ltog[owner_patch].begin() + num_owned[owner_patch],
+                global_id);
+
+            if (it == ltog[owner_patch].begin() + num_owned[owner_patch]) {
+                RXMESH_ERROR(
+                    "rxmesh::build_host_single_patch can not find the local "
+                    "id of {} in patch {}. Maybe this patch does not own "
+                    "this mesh element.",
+                    global_id,
+                    owner_patch);
+            } else {
+                uint16_t local_id_in_owner_patch =
+                    static_cast<uint16_t>(it - ltog[owner_patch].begin());
+
+                uint8_t owner_st = stash.find_patch_index(owner_patch);
+
+                LPPair pair(local_id, local_id_in_owner_patch, owner_st);
+                if (!h_hashtable.insert(pair, nullptr, nullptr)) {
+                    RXMESH_ERROR(
+                        "rxmesh::build_host_single_patch failed to insert in "
+                        "the hashtable. Retry with smaller load factor. Load "
+                        "factor used = {}",
+                        m_lp_hashtable_load_factor);
+                }
+            }
+        }
+    };
+
+    const uint16_t lp_cap_v = max_lp_hashtable_capacity<LocalVertexT>();
+    build_ht(m_h_patches_ltog_v,
+             ltog_v,
+             m_patcher->get_vertex_patch(),
+             m_h_num_owned_v,
+             p_num_vertices,
+             p_num_owned_vertices,
+             lp_cap_v,
+             h_patch_info.patch_stash,
+             h_patch_info.lp_v);
+
+    const uint16_t lp_cap_e = max_lp_hashtable_capacity<LocalEdgeT>();
+    build_ht(m_h_patches_ltog_e,
+             ltog_e,
+             m_patcher->get_edge_patch(),
+             m_h_num_owned_e,
+             p_num_edges,
+             p_num_owned_edges,
+             lp_cap_e,
+             h_patch_info.patch_stash,
+             h_patch_info.lp_e);
+
+    const uint16_t lp_cap_f = max_lp_hashtable_capacity<LocalFaceT>();
+    build_ht(m_h_patches_ltog_f,
+             ltog_f,
+             m_patcher->get_face_patch(),
+             m_h_num_owned_f,
+             p_num_faces,
+             p_num_owned_faces,
+             lp_cap_f,
+             h_patch_info.patch_stash,
+             h_patch_info.lp_f);
+}
+
+uint16_t RXMesh::lp_hashtable_capacity(const uint32_t patch_id,
+                                       const uint16_t num_not_owned,
+                                       const uint16_t cap) const
+{
+    if (patch_id == INVALID32) {
+        return cap;
+    }
+    return static_cast<uint16_t>(
+        std::ceil(m_capacity_factor * static_cast<float>(num_not_owned) /
+                  m_lp_hashtable_load_factor));
+}
+
+void RXMesh::build_device_single_patch(const uint32_t   patch_id,
+                                       const PatchInfo& h_patch_info,
+                                       PatchInfo&       d_patch_info)
+{
+    RXMESH_ZONE("RXMesh::build_device_single_patch");
+
+    const uint16_t p_num_vertices      = h_patch_info.num_vertices[0];
+    const uint16_t p_num_edges         = h_patch_info.num_edges[0];
+    const uint16_t p_num_faces         = h_patch_info.num_faces[0];
+    const uint16_t p_vertices_capacity = h_patch_info.vertices_capacity[0];
+    const uint16_t p_edges_capacity    = h_patch_info.edges_capacity[0];
+    const uint16_t p_faces_capacity    = h_patch_info.faces_capacity[0];
 
     uint16_t* d_counts;
 
@@ -1092,35 +1530,13 @@ void RXMesh::build_device_single_patch(const uint32_t patch_id,
     m_topo_memory_mega_bytes +=
         BYTES_TO_MEGABYTES(PatchStash::stash_size * sizeof(uint32_t));
 
-    // copy count and capacities
-    CUDA_ERROR(cudaMemcpy(d_patch.num_faces,
+    // copy count and capacities (stored contiguously on the host)
+    CUDA_ERROR(cudaMemcpy(d_counts,
                           h_patch_info.num_faces,
-                          sizeof(uint16_t),
-                          cudaMemcpyHostToDevice));
-    CUDA_ERROR(cudaMemcpy(d_patch.num_edges,
-                          h_patch_info.num_edges,
-                          sizeof(uint16_t),
-                          cudaMemcpyHostToDevice));
-    CUDA_ERROR(cudaMemcpy(d_patch.num_vertices,
-                          h_patch_info.num_vertices,
-                          sizeof(uint16_t),
-                          cudaMemcpyHostToDevice));
-    CUDA_ERROR(cudaMemcpy(d_patch.faces_capacity,
-                          h_patch_info.faces_capacity,
-                          sizeof(uint16_t),
-                          cudaMemcpyHostToDevice));
-    CUDA_ERROR(cudaMemcpy(d_patch.edges_capacity,
-                          h_patch_info.edges_capacity,
-                          sizeof(uint16_t),
-                          cudaMemcpyHostToDevice));
-    CUDA_ERROR(cudaMemcpy(d_patch.vertices_capacity,
-                          h_patch_info.vertices_capacity,
-                          sizeof(uint16_t),
+                          6 * sizeof(uint16_t),
                           cudaMemcpyHostToDevice));
 
     // allocate and copy patch topology to the device
-    // we realloc the host h_patch_info EV and FE to ensure that both host and
-    // device has the same capacity
     m_timers.start("cudaMalloc");
     CUDA_ERROR(cudaMalloc((void**)&d_patch.ev,
                           p_edges_capacity * 2 * sizeof(LocalVertexT)));
@@ -1129,8 +1545,6 @@ void RXMesh::build_device_single_patch(const uint32_t patch_id,
 
     m_topo_memory_mega_bytes +=
         BYTES_TO_MEGABYTES(p_edges_capacity * 2 * sizeof(LocalVertexT));
-    h_patch_info.ev = (LocalVertexT*)realloc(
-        h_patch_info.ev, p_edges_capacity * 2 * sizeof(LocalVertexT));
 
     if (p_num_edges > 0) {
         CUDA_ERROR(cudaMemcpy(d_patch.ev,
@@ -1147,8 +1561,6 @@ void RXMesh::build_device_single_patch(const uint32_t patch_id,
 
     m_topo_memory_mega_bytes +=
         BYTES_TO_MEGABYTES(p_faces_capacity * 3 * sizeof(LocalEdgeT));
-    h_patch_info.fe = (LocalEdgeT*)realloc(
-        h_patch_info.fe, p_faces_capacity * 3 * sizeof(LocalEdgeT));
 
     if (p_num_faces > 0) {
         CUDA_ERROR(cudaMemcpy(d_patch.fe,
@@ -1166,19 +1578,14 @@ void RXMesh::build_device_single_patch(const uint32_t patch_id,
     CUDA_ERROR(cudaMemset(d_patch.dirty, 0, sizeof(int)));
 
 
-    // allocate and set bitmask
+    // allocate and copy bitmask
     auto bitmask = [&](uint32_t*& d_mask,
-                       uint32_t*& h_mask,
-                       uint32_t   capacity,
-                       auto       predicate) {
+                       const uint32_t* h_mask,
+                       uint32_t        capacity) {
         m_timers.start("bitmask");
 
         size_t num_bytes = detail::mask_num_bytes(capacity);
 
-        m_timers.start("malloc");
-        h_mask = (uint32_t*)malloc(num_bytes);
-        m_timers.stop("malloc");
-
         m_timers.start("cudaMalloc");
         CUDA_ERROR(cudaMalloc((void**)&d_mask, num_bytes));
         m_timers.stop("cudaMalloc");
@@ -1186,56 +1593,23 @@ void RXMesh::build_device_single_patch(const uint32_t patch_id,
 
         m_topo_memory_mega_bytes += BYTES_TO_MEGABYTES(num_bytes);
 
-        for (uint16_t i = 0; i < capacity; ++i) {
-            if (predicate(i)) {
-                detail::bitmask_set_bit(i, h_mask);
-            } else {
-                detail::bitmask_clear_bit(i, h_mask);
-            }
-        }
-
         CUDA_ERROR(
             cudaMemcpy(d_mask, h_mask, num_bytes, cudaMemcpyHostToDevice));
 
         m_timers.stop("bitmask");
     };
 
-
-    // vertices active mask
     bitmask(d_patch.active_mask_v,
             h_patch_info.active_mask_v,
-            p_vertices_capacity,
-            [&](uint16_t v) { return v < p_num_vertices; });
-
-    // edges active mask
-    bitmask(d_patch.active_mask_e,
-            h_patch_info.active_mask_e,
-            p_edges_capacity,
-            [&](uint16_t e) { return e < p_num_edges; });
-
-    // faces active mask
-    bitmask(d_patch.active_mask_f,
-            h_patch_info.active_mask_f,
-            p_faces_capacity,
-            [&](uint16_t f) { return f < p_num_faces; });
-
-    // vertices owned mask
-    bitmask(d_patch.owned_mask_v,
-            h_patch_info.owned_mask_v,
-            p_vertices_capacity,
-            [&](uint16_t v) { return v < p_num_owned_vertices; });
-
-    // edges owned mask
-    bitmask(d_patch.owned_mask_e,
-            h_patch_info.owned_mask_e,
-            p_edges_capacity,
-            [&](uint16_t e) { return e < p_num_owned_edges; });
-
-    // faces owned mask
-    bitmask(d_patch.owned_mask_f,
-            h_patch_info.owned_mask_f,
-            p_faces_capacity,
-            [&](uint16_t f) { return f < p_num_owned_faces; });
+            p_vertices_capacity);
+    bitmask(
+        d_patch.active_mask_e, h_patch_info.active_mask_e, p_edges_capacity);
+    bitmask(
+        d_patch.active_mask_f, h_patch_info.active_mask_f, p_faces_capacity);
+    bitmask(
+        d_patch.owned_mask_v, h_patch_info.owned_mask_v, p_vertices_capacity);
+    bitmask(d_patch.owned_mask_e, h_patch_info.owned_mask_e, p_edges_capacity);
+    bitmask(d_patch.owned_mask_f, h_patch_info.owned_mask_f, p_faces_capacity);
 
 
     // Copy PatchStash
@@ -1247,116 +1621,44 @@ void RXMesh::build_device_single_patch(const uint32_t patch_id,
     }
 
 
-    // build LPHashtable
-    auto build_ht = [&](const std::vector<std::vector<uint32_t>>& ltog,
-                        const std::vector<uint32_t>&              p_ltog,
-                        const std::vector<uint32_t>&              element_patch,
-                        const std::vector<uint16_t>&              num_owned,
-                        const uint16_t                            num_elements,
-                        const uint16_t num_owned_elements,
-                        const uint16_t cap,
-                        PatchStash&    stash,
-                        LPHashTable&   h_hashtable,
-                        LPHashTable&   d_hashtable) {
-        m_timers.start("buildHT");
-
-        const uint16_t num_not_owned = num_elements - num_owned_elements;
-
-        uint16_t capacity = cap;
-
-        if (patch_id != INVALID32) {
-            capacity = static_cast<uint16_t>(std::ceil(
-                m_capacity_factor * static_cast<float>(num_not_owned) /
-                m_lp_hashtable_load_factor));
-        }
-
+    // copy LPHashtable. The device table is constructed with the same
+    // requested capacity as the host one so both end up with the same size and
+    // hash functions
+    auto copy_ht = [&](const LPHashTable& h_hashtable,
+                       LPHashTable&       d_hashtable,
+                       const uint16_t     num_owned,
+                       const uint16_t     num_elements,
+                       const uint16_t     cap) {
         m_timers.start("LPHashTable");
-        h_hashtable = LPHashTable(capacity, false);
-        d_hashtable = LPHashTable(capacity, true);
+        d_hashtable = LPHashTable(
+            lp_hashtable_capacity(patch_id, num_elements - num_owned, cap),
+            true);
         m_timers.stop("LPHashTable");
 
         m_topo_memory_mega_bytes += BYTES_TO_MEGABYTES(d_hashtable.num_bytes());
         m_topo_memory_mega_bytes +=
             BYTES_TO_MEGABYTES(LPHashTable::stash_size * sizeof(LPPair));
 
-        for (uint16_t i = 0; i < num_not_owned; ++i) {
-            uint16_t local_id    = i + num_owned_elements;
-            uint32_t global_id   = p_ltog[local_id];
-            uint32_t owner_patch = element_patch[global_id];
-
-            m_timers.start("lower_bound");
-            auto it = std::lower_bound(
-                ltog[owner_patch].begin(),
-                ltog[owner_patch].begin() + num_owned[owner_patch],
-                global_id);
-            m_timers.stop("lower_bound");
-
-            if (it == ltog[owner_patch].begin() + num_owned[owner_patch]) {
-                RXMESH_ERROR(
-                    "rxmesh::build_device can not find the local id of "
-                    "{} in patch {}. Maybe this patch does not own "
-                    "this mesh element.",
-                    global_id,
-                    owner_patch);
-            } else {
-                uint16_t local_id_in_owner_patch =
-                    static_cast<uint16_t>(it - ltog[owner_patch].begin());
-
-                uint8_t owner_st = stash.find_patch_index(owner_patch);
-
-                m_timers.start("ht.insert");
-                LPPair pair(local_id, local_id_in_owner_patch, owner_st);
-                if (!h_hashtable.insert(pair, nullptr, nullptr)) {
-                    RXMESH_ERROR(
-                        "rxmesh::build_device failed to insert in the "
-                        "hashtable. Retry with smaller load factor. Load "
-                        "factor used = {}",
-                        m_lp_hashtable_load_factor);
-                }
-                m_timers.stop("ht.insert");
-            }
-        }
-
         d_hashtable.move(h_hashtable);
-
-        m_timers.stop("buildHT");
     };
 
-    const uint16_t lp_cap_v = max_lp_hashtable_capacity<LocalVertexT>();
-    build_ht(m_h_patches_ltog_v,
-             ltog_v,
-             m_patcher->get_vertex_patch(),
-             m_h_num_owned_v,
-             p_num_vertices,
-             p_num_owned_vertices,
-             lp_cap_v,
-             h_patch_info.patch_stash,
-             h_patch_info.lp_v,
-             d_patch.lp_v);
-
-    const uint16_t lp_cap_e = max_lp_hashtable_capacity<LocalEdgeT>();
-    build_ht(m_h_patches_ltog_e,
-             ltog_e,
-             m_patcher->get_edge_patch(),
-             m_h_num_owned_e,
-             p_num_edges,
-             p_num_owned_edges,
-             lp_cap_e,
-             h_patch_info.patch_stash,
-             h_patch_info.lp_e,
-             d_patch.lp_e);
-
-    const uint16_t lp_cap_f = max_lp_hashtable_capacity<LocalFaceT>();
-    build_ht(m_h_patches_ltog_f,
-             ltog_f,
-             m_patcher->get_face_patch(),
-             m_h_num_owned_f,
-             p_num_faces,
-             p_num_owned_faces,
-             lp_cap_f,
-             h_patch_info.patch_stash,
-             h_patch_info.lp_f,
-             d_patch.lp_f);
+    const bool valid = patch_id != INVALID32;
+
+    copy_ht(h_patch_info.lp_v,
+            d_patch.lp_v,
+            valid ? m_h_num_owned_v[patch_id] : 0,
+            p_num_vertices,
+            max_lp_hashtable_capacity<LocalVertexT>());
+    copy_ht(h_patch_info.lp_e,
+            d_patch.lp_e,
+            valid ? m_h_num_owned_e[patch_id] : 0,
+            p_num_edges,
+            max_lp_hashtable_capacity<LocalEdgeT>());
+    copy_ht(h_patch_info.lp_f,
+            d_patch.lp_f,
+            valid ? m_h_num_owned_f[patch_id] : 0,
+            p_num_faces,
+            max_lp_hashtable_capacity<LocalFaceT>());
 
 
     CUDA_ERROR(cudaMemcpy(
@@ -1365,6 +1667,7 @@ void RXMesh::build_device_single_patch(const uint32_t patch_id,
 
 void RXMesh::allocate_extra_patches()
 {
+    RXMESH_ZONE("RXMesh::allocate_extra_patches");
 
     const uint16_t p_vertices_capacity = get_per_patch_max_vertex_capacity();
     const uint16_t p_edges_capacity    = get_per_patch_max_edge_capacity();
@@ -1379,27 +1682,29 @@ void RXMesh::allocate_extra_patches()
         const uint16_t p_num_faces    = 0;
 
         m_timers.start("malloc");
-        m_h_patches_info[p].ev =
-            (LocalVertexT*)malloc(2 * p_edges_capacity * sizeof(LocalVertexT));
-        m_h_patches_info[p].fe =
-            (LocalEdgeT*)malloc(3 * p_faces_capacity * sizeof(LocalEdgeT));
+        m_h_patches_info[p].ev = host_malloc<LocalVertexT>(
+            2 * p_edges_capacity, HostMemTag::Topology);
+        m_h_patches_info[p].fe = host_malloc<LocalEdgeT>(3 * p_faces_capacity,
+                                                         HostMemTag::Topology);
         m_timers.stop("malloc");
 
-        build_device_single_patch(INVALID32,
-                                  p_num_vertices,
-                                  p_num_edges,
-                                  p_num_faces,
-                                  p_vertices_capacity,
-                                  p_edges_capacity,
-                                  p_faces_capacity,
-                                  m_h_num_owned_v[p],
-                                  m_h_num_owned_e[p],
-                                  m_h_num_owned_f[p],
-                                  m_h_patches_ltog_v[0],
-                                  m_h_patches_ltog_e[0],
-                                  m_h_patches_ltog_f[0],
-                                  m_h_patches_info[p],
-                                  m_d_patches_info[p]);
+        build_host_single_patch(INVALID32,
+                                p_num_vertices,
+                                p_num_edges,
+                                p_num_faces,
+                                p_vertices_capacity,
+                                p_edges_capacity,
+                                p_faces_capacity,
+                                m_h_num_owned_v[p],
+                                m_h_num_owned_e[p],
+                                m_h_num_owned_f[p],
+                                m_h_patches_ltog_v[0],
+                                m_h_patches_ltog_e[0],
+                                m_h_patches_ltog_f[0],
+                                m_h_patches_info[p]);
+
+        build_device_single_patch(
+            INVALID32, m_h_patches_info[p], m_d_patches_info[p]);
     }
 
 
@@ -1417,6 +1722,7 @@ void RXMesh::allocate_extra_patches()
 
 void RXMesh::patch_graph_coloring()
 {
+    RXMESH_ZONE("RXMesh::patch_graph_coloring");
     std::vector<uint32_t> ids(m_num_patches);
     fill_with_random_numbers(ids.data(), ids.size());
 
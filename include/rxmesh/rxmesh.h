@@ -1,11 +1,17 @@
 #pragma once
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include "rxmesh/context.h"
 #include "rxmesh/handle.h"
+#include "rxmesh/host_schedule.h"
+#include "rxmesh/index_map.h"
+#include "rxmesh/partition_diagnostics.h"
 #include "rxmesh/patch_info.h"
+#include "rxmesh/patch_stats.h"
 #include "rxmesh/patcher/patcher.h"
+#include "rxmesh/super_patch.h"
 #include "rxmesh/types.h"
 #include "rxmesh/util/log.h"
 #include "rxmesh/util/macros.h"
@@ -290,6 +296,25 @@ class RXMesh
         return m_patcher->get_patching_time();
     }
 
+    /**
+     * @brief The time (ms) of every stage of the mesh build in the order they
+     * run, i.e., ltog, topology, patch stash, coloring, host patches
+     * (masks and hashtables), and publishing the patches to the device
+     */
+    const std::vector<std::pair<std::string, float>>& get_build_stage_times()
+        const
+    {
+        return m_build_stage_times;
+    }
+
+    /**
+     * @brief The method used for the initial partition of the input mesh
+     */
+    PartitionMethod get_partition_method() const
+    {
+        return m_patcher->get_partition_method();
+    }
+
     /**
      * @brief The number of Lloyd iterations run to partition the mesh into
      * patches
@@ -307,6 +332,63 @@ class RXMesh
      */
     uint32_t get_edge_id(const uint32_t v0, const uint32_t v1) const;
 
+    /**
+     * @brief enable/disable collecting per-patch work counters and host timing
+     * (see PatchStats). Enabling it resets the counters. Device-side counters
+     * are only collected if compiled with RXMESH_PATCH_STATS
+     */
+    void enable_patch_stats(bool enable)
+    {
+        if (enable) {
+            if (!m_patch_stats) {
+                m_patch_stats =
+                    std::make_unique<PatchStats>(get_max_num_patches());
+            }
+            m_patch_stats->reset();
+            m_rxmesh_context.m_h_patch_stats =
+                m_patch_stats->get_host_counters();
+            m_rxmesh_context.m_d_patch_stats =
+                m_patch_stats->get_device_counters();
+        } else {
+            m_rxmesh_context.m_h_patch_stats = nullptr;
+            m_rxmesh_context.m_d_patch_stats = nullptr;
+            m_patch_stats.reset();
+        }
+    }
+
+    /**
+     * @brief return the per-patch work counters. nullptr if enable_patch_stats
+     * was not called
+     */
+    PatchStats* get_patch_stats() const
+    {
+        return m_patch_stats.get();
+    }
+
+    /**
+     * @brief compute the partition quality (see PartitionDiagnostics) from
+     * the host patches. The patches are processed in parallel
+     */
+    PartitionDiagnostics compute_partition_diagnostics() const;
+
+    /**
+     * @brief set how host loops over patches (e.g., for_each with HOST) are
+     * executed. With a NUMA-aware policy, every thread processes the same
+     * contiguous range of patches in all host loops and, if first_touch is
+     * set, the host patch topology is moved to the NUMA domain of that thread.
+     * Attributes allocated afterwards are placed on the same domain, so this
+     * should be called before allocating attributes
+     */
+    void set_host_execution_policy(const HostExecutionPolicy& policy);
+
+    /**
+     * @brief the patch-to-thread mapping used by host loops
+     */
+    const HostPatchSchedule& get_host_schedule() const
+    {
+        return m_host_schedule;
+    }
+
     /**
      * @brief save/seralize the patcher info to a file
      * @param filename
@@ -337,6 +419,69 @@ class RXMesh
      */
     const FaceHandle map_to_local_face(uint32_t i) const;
 
+    /**
+     * @brief the host tables that map the elements of type HandleT between
+     * their handle, linear id, and global id. The tables are built in
+     * parallel on the first request and are safe to read from host loops
+     */
+    template <typename HandleT>
+    const IndexMap<HandleT>& get_index_map() const
+    {
+        IndexMap<HandleT>*                        map    = nullptr;
+        const uint32_t*                           prefix = nullptr;
+        const std::vector<std::vector<uint32_t>>* ltog   = nullptr;
+
+        if constexpr (std::is_same_v<HandleT, VertexHandle>) {
+            map    = &m_vertex_index_map;
+            prefix = m_h_vertex_prefix;
+            ltog   = &m_h_patches_ltog_v;
+        }
+        if constexpr (std::is_same_v<HandleT, EdgeHandle>) {
+            map    = &m_edge_index_map;
+            prefix = m_h_edge_prefix;
+            ltog   = &m_h_patches_ltog_e;
+        }
+        if constexpr (std::is_same_v<HandleT, FaceHandle>) {
+            map    = &m_face_index_map;
+            prefix = m_h_face_prefix;
+            ltog   = &m_h_patches_ltog_f;
+        }
+
+        if (!map->is_built()) {
+            std::lock_guard<std::mutex> lock(m_index_map_mutex);
+            if (!map->is_built()) {
+                map->build(get_num_patches(),
+                           m_h_patches_info,
+                           prefix,
+                           *ltog,
+                           m_rxmesh_context,
+                           m_host_schedule);
+            }
+        }
+        return *map;
+    }
+
+    /**
+     * @brief the super-patches i.e., groups of neighbor patches with their
+     * adjacency graph. Built on the host on the first request and rebuilt if
+     * requested with a different size or after the topology changes. A
+     * rebuild invalidates references returned earlier
+     * @param patches_per_super the target number of patches per super-patch
+     */
+    const SuperPatches& get_super_patches(
+        const uint32_t patches_per_super = 8) const
+    {
+        std::lock_guard<std::mutex> lock(m_super_patch_mutex);
+        if (!m_super_patches.is_built() ||
+            m_super_patches.get_patches_per_super() != patches_per_super) {
+            m_super_patches.build(get_num_patches(),
+                                  m_h_patches_info,
+                                  m_rxmesh_context,
+                                  patches_per_super);
+        }
+        return m_super_patches;
+    }
+
     /**
      * @brief return the number of owned vertices in a patch
      */
@@ -429,6 +574,32 @@ class RXMesh
 
     RXMesh(uint32_t patch_size);
 
+    /**
+     * @brief update the HostMemory accounting of the host containers (ltog,
+     * edge map, owned counts, and the patcher output). Should be called after
+     * these containers change size
+     */
+    void track_host_containers();
+
+    /**
+     * @brief (re)build the host patch schedule using the number of owned
+     * elements in each patch as its weight
+     */
+    void build_host_schedule(const HostExecutionPolicy& policy);
+
+    /**
+     * @brief drop the index maps and the super-patches. Should be called when
+     * the topology changes
+     */
+    void clear_index_maps()
+    {
+        m_vertex_index_map.clear();
+        m_edge_index_map.clear();
+        m_face_index_map.clear();
+        std::lock_guard<std::mutex> lock(m_super_patch_mutex);
+        m_super_patches.clear();
+    }
+
     /**
      * @brief init all the data structures
      * @param fv the mesh connectivity as an index triangle
@@ -441,12 +612,18 @@ class RXMesh
      * patch_alloc_factor*x patches
      * @param lp_hashtable_load_factor loading factor for the hashtable use for
      * the not-owned vertices/edges/faces
+     * @param partition_policy how the input faces are partitioned into patches
+     * @param vertices vertex coordinates. Only needed by the geometric
+     * partitioners. Without them, a geometric partition_policy falls back to
+     * METIS
      */
     void init(const std::vector<std::vector<uint32_t>>& fv,
               const std::string                         patcher_file    = "",
               const float                               capacity_factor = 1.8,
               const float patch_alloc_factor                            = 5.0,
-              const float lp_hashtable_load_factor                      = 0.5);
+              const float lp_hashtable_load_factor                      = 0.5,
+              const PartitionPolicy& partition_policy = PartitionPolicy(),
+              const std::vector<std::vector<float>>* vertices = nullptr);
 
     /**
      * @brief build different supporting data structure used to build RXMesh
@@ -494,11 +671,6 @@ class RXMesh
      */
     void allocate_extra_patches();
 
-    template <typename HandleT>
-    const std::pair<uint32_t, uint16_t> map_to_local(
-        const uint32_t  i,
-        const uint32_t* element_prefix) const;
-
     template <typename LocalT>
     uint16_t max_lp_hashtable_capacity() const
     {
@@ -526,11 +698,17 @@ class RXMesh
     }
 
     void build(const std::vector<std::vector<uint32_t>>& fv,
-               const std::string                         patcher_file);
+               const std::string                         patcher_file,
+               const PartitionPolicy&                    partition_policy,
+               const std::vector<std::vector<float>>*    vertices);
 
     void build_single_patch_ltog(const std::vector<std::vector<uint32_t>>& fv,
                                  const std::vector<std::vector<uint32_t>>& ev,
-                                 const uint32_t patch_id);
+                                 const std::vector<uint32_t>& owned_offset_v,
+                                 const std::vector<uint32_t>& owned_v,
+                                 const std::vector<uint32_t>& owned_offset_e,
+                                 const std::vector<uint32_t>& owned_e,
+                                 const uint32_t               patch_id);
 
     void build_single_patch_topology(
         const std::vector<std::vector<uint32_t>>& fv,
@@ -543,21 +721,32 @@ class RXMesh
     uint16_t get_per_patch_max_face_capacity() const;
 
     void build_device();
-    void build_device_single_patch(const uint32_t patch_id,
-                                   const uint16_t p_num_vertices,
-                                   const uint16_t p_num_edges,
-                                   const uint16_t p_num_faces,
-                                   const uint16_t p_vertices_capacity,
-                                   const uint16_t p_edges_capacity,
-                                   const uint16_t p_faces_capacity,
-                                   const uint16_t p_num_owned_vertices,
-                                   const uint16_t p_num_owned_edges,
-                                   const uint16_t p_num_owned_faces,
-                                   const std::vector<uint32_t>& ltog_v,
-                                   const std::vector<uint32_t>& ltog_e,
-                                   const std::vector<uint32_t>& ltog_f,
-                                   PatchInfo&                   h_patch_info,
-                                   PatchInfo&                   d_patch_info);
+    // build the host side of a patch (counts, masks, and hashtables). Only
+    // writes to h_patch_info so it can run in parallel over patches
+    void build_host_single_patch(const uint32_t patch_id,
+                                 const uint16_t p_num_vertices,
+                                 const uint16_t p_num_edges,
+                                 const uint16_t p_num_faces,
+                                 const uint16_t p_vertices_capacity,
+                                 const uint16_t p_edges_capacity,
+                                 const uint16_t p_faces_capacity,
+                                 const uint16_t p_num_owned_vertices,
+                                 const uint16_t p_num_owned_edges,
+                                 const uint16_t p_num_owned_faces,
+                                 const std::vector<uint32_t>& ltog_v,
+                                 const std::vector<uint32_t>& ltog_e,
+                                 const std::vector<uint32_t>& ltog_f,
+                                 PatchInfo&                   h_patch_info);
+
+    // allocate a patch on the device and copy h_patch_info into it
+    void build_device_single_patch(const uint32_t   patch_id,
+                                   const PatchInfo& h_patch_info,
+                                   PatchInfo&       d_patch_info);
+
+    // the requested capacity of a patch LP hashtable
+    uint16_t lp_hashtable_capacity(const uint32_t patch_id,
+                                   const uint16_t num_not_owned,
+                                   const uint16_t cap) const;
 
     void patch_graph_coloring();
 
@@ -592,6 +781,12 @@ class RXMesh
     // patching the mesh into small pieces
     std::unique_ptr<patcher::Patcher> m_patcher;
 
+    // optional per-patch work counters
+    std::unique_ptr<PatchStats> m_patch_stats;
+
+    // patch-to-thread mapping of host loops
+    HostPatchSchedule m_host_schedule;
+
     // the number of owned mesh elements per patch
     std::vector<uint16_t> m_h_num_owned_f, m_h_num_owned_e, m_h_num_owned_v;
 
@@ -623,8 +818,24 @@ class RXMesh
 
     double m_topo_memory_mega_bytes;
 
+    // bytes of the host containers reported to HostMemory
+    size_t m_h_tracked_topology_bytes, m_h_tracked_patcher_bytes;
+
     uint32_t m_num_colors;
 
     Timers<CPUTimer> m_timers;
+
+    // (stage, ms) of the last build. See get_build_stage_times()
+    std::vector<std::pair<std::string, float>> m_build_stage_times;
+
+    // handle <-> linear id <-> global id tables built on first request
+    mutable IndexMap<VertexHandle> m_vertex_index_map;
+    mutable IndexMap<EdgeHandle>   m_edge_index_map;
+    mutable IndexMap<FaceHandle>   m_face_index_map;
+    mutable std::mutex             m_index_map_mutex;
+
+    // second partition level built on first request
+    mutable SuperPatches m_super_patches;
+    mutable std::mutex   m_super_patch_mutex;
 };
 }  // namespace rxmesh
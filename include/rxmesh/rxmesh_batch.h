@@ -0,0 +1,647 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <cub/device/device_segmented_reduce.cuh>
+
+#include "rxmesh/kernels/attribute.cuh"
+#include "rxmesh/rxmesh_static.h"
+#include "rxmesh/util/import_obj.h"
+#include "rxmesh/util/log.h"
+#include "rxmesh/util/macros.h"
+
+namespace rxmesh {
+
+namespace detail {
+template <typename T>
+__global__ void gather_by_index(const uint32_t  n,
+                                const uint32_t* index,
+                                const T*        in,
+                                T*              out)
+{
+    const uint32_t i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i < n) {
+        out[i] = in[index[i]];
+    }
+}
+}  // namespace detail
+
+/**
+ * @brief mesh id of the patches of an RXMeshBatch. It is small and can be
+ * captured by value in host and device lambdas
+ */
+struct MeshBatchInfo
+{
+    uint32_t        num_meshes;
+    const uint32_t* h_patch_mesh;
+    const uint32_t* d_patch_mesh;
+
+    /**
+     * @brief the mesh that a mesh element belongs to
+     */
+    template <typename HandleT>
+    __host__ __device__ __forceinline__ uint32_t
+    get_mesh_id(const HandleT handle) const
+    {
+#ifdef __CUDA_ARCH__
+        return d_patch_mesh[handle.patch_id()];
+#else
+        return h_patch_mesh[handle.patch_id()];
+#endif
+    }
+};
+
+/**
+ * @brief read a list of obj files to be used with RXMeshBatch
+ * @return false if any of the files could not be read
+ */
+inline bool import_obj_batch(
+    const std::vector<std::string>&                  file_paths,
+    std::vector<std::vector<std::vector<float>>>&    vertices_batch,
+    std::vector<std::vector<std::vector<uint32_t>>>& fv_batch)
+{
+    vertices_batch.resize(file_paths.size());
+    fv_batch.resize(file_paths.size());
+    for (size_t m = 0; m < file_paths.size(); ++m) {
+        if (!import_obj(file_paths[m], vertices_batch[m], fv_batch[m])) {
+            RXMESH_ERROR("import_obj_batch() could not read the input file {}",
+                         file_paths[m]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief many (small) meshes packed in one RXMeshStatic. The meshes are
+ * disconnected components of a single mesh so they share one patcher, one
+ * context, and one allocation per attribute, and a single for_each/query
+ * launch processes the whole batch. The patcher splits every patch into its
+ * face-connected components so a patch never spans two meshes and every
+ * patch has a mesh id. Vertices and faces of mesh m take the global ids
+ * [vertex_offset(m), vertex_offset(m + 1)) and
+ * [face_offset(m), face_offset(m + 1)) in their input order
+ */
+class RXMeshBatch : public RXMeshStatic
+{
+   public:
+    RXMeshBatch(const RXMeshBatch&) = delete;
+
+    /**
+     * @brief Constructor using the faces and vertices of every mesh
+     * @param fv_batch the face incident vertices of every mesh, indexed
+     * locally to the mesh
+     * @param vertices_batch the vertex coordinates of every mesh. Can be empty
+     */
+    explicit RXMeshBatch(
+        const std::vector<std::vector<std::vector<uint32_t>>>& fv_batch,
+        const std::vector<std::vector<std::vector<float>>>&    vertices_batch,
+        const uint32_t patch_size               = 512,
+        const float    capacity_factor          = 1.0,
+        const float    patch_alloc_factor       = 1.0,
+        const float    lp_hashtable_load_factor = 0.8)
+        : RXMeshBatch(concatenate_faces(fv_batch, vertices_batch),
+                      fv_batch,
+                      vertices_batch,
+                      patch_size,
+                      capacity_factor,
+                      patch_alloc_factor,
+                      lp_hashtable_load_factor)
+    {
+    }
+
+    virtual ~RXMeshBatch()
+    {
+        GPU_FREE(m_d_patch_mesh);
+        GPU_FREE(m_d_mesh_patch_offset);
+        GPU_FREE(m_d_mesh_patches);
+        GPU_FREE(m_d_reduce_scratch);
+    }
+
+    /**
+     * @brief number of meshes in the batch
+     */
+    uint32_t get_num_meshes() const
+    {
+        return static_cast<uint32_t>(m_vertex_offset.size() - 1);
+    }
+
+    /**
+     * @brief the first global vertex id of a mesh. vertex_offset(num_meshes)
+     * is the total number of vertices
+     */
+    uint32_t vertex_offset(const uint32_t mesh_id) const
+    {
+        return m_vertex_offset[mesh_id];
+    }
+
+    /**
+     * @brief the first global face id of a mesh. face_offset(num_meshes) is
+     * the total number of faces
+     */
+    uint32_t face_offset(const uint32_t mesh_id) const
+    {
+        return m_face_offset[mesh_id];
+    }
+
+    uint32_t get_mesh_num_vertices(const uint32_t mesh_id) const
+    {
+        return m_vertex_offset[mesh_id + 1] - m_vertex_offset[mesh_id];
+    }
+
+    uint32_t get_mesh_num_edges(const uint32_t mesh_id) const
+    {
+        return m_mesh_num_edges[mesh_id];
+    }
+
+    uint32_t get_mesh_num_faces(const uint32_t mesh_id) const
+    {
+        return m_face_offset[mesh_id + 1] - m_face_offset[mesh_id];
+    }
+
+    /**
+     * @brief the patches of a mesh
+     */
+    std::vector<uint32_t> get_mesh_patches(const uint32_t mesh_id) const
+    {
+        return std::vector<uint32_t>(
+            m_mesh_patches.begin() + m_mesh_patch_offset[mesh_id],
+            m_mesh_patches.begin() + m_mesh_patch_offset[mesh_id + 1]);
+    }
+
+    /**
+     * @brief the mesh id of every patch to be used inside host/device lambdas
+     */
+    MeshBatchInfo get_batch_info() const
+    {
+        MeshBatchInfo info;
+        info.num_meshes   = get_num_meshes();
+        info.h_patch_mesh = m_h_patch_mesh.data();
+        info.d_patch_mesh = m_d_patch_mesh;
+        return info;
+    }
+
+    /**
+     * @brief the mesh a mesh element belongs to (on the host)
+     */
+    template <typename HandleT>
+    uint32_t get_mesh_id(const HandleT handle) const
+    {
+        return m_h_patch_mesh[handle.patch_id()];
+    }
+
+    /**
+     * @brief the index of a vertex in the input of its mesh
+     */
+    uint32_t map_to_mesh_local(const VertexHandle vh) const
+    {
+        return map_to_global(vh) - m_vertex_offset[get_mesh_id(vh)];
+    }
+
+    /**
+     * @brief the index of a face in the input of its mesh
+     */
+    uint32_t map_to_mesh_local(const FaceHandle fh) const
+    {
+        return map_to_global(fh) - m_face_offset[get_mesh_id(fh)];
+    }
+
+    /**
+     * @brief Adding a new vertex attribute by reading the values of every
+     * mesh where values_batch[m] follows the vertex order of mesh m input
+     */
+    template <class T>
+    std::shared_ptr<VertexAttribute<T>> add_vertex_attribute_batch(
+        const std::vector<std::vector<std::vector<T>>>& values_batch,
+        const std::string&                              name,
+        layoutT                                         layout = SoA)
+    {
+        if (values_batch.size() != get_num_meshes()) {
+            RXMESH_ERROR(
+                "RXMeshBatch::add_vertex_attribute_batch() expected {} meshes "
+                "but got {}",
+                get_num_meshes(),
+                values_batch.size());
+            return nullptr;
+        }
+        std::vector<std::vector<T>> values;
+        values.reserve(get_num_vertices());
+        for (const auto& mesh_values : values_batch) {
+            values.insert(values.end(), mesh_values.begin(), mesh_values.end());
+        }
+        return add_vertex_attribute(values, name, layout);
+    }
+
+    /**
+     * @brief copy the values of a vertex attribute of one mesh in the vertex
+     * order of the mesh input
+     */
+    template <class T>
+    void export_vertex_attribute(const uint32_t               mesh_id,
+                                 const VertexAttribute<T>&    attr,
+                                 std::vector<std::vector<T>>& values) const
+    {
+        values.resize(get_mesh_num_vertices(mesh_id));
+        for_each_mesh_patch(mesh_id, [&](const PatchInfo& pi, uint32_t p) {
+            for (uint16_t v = 0; v < pi.num_vertices[0]; ++v) {
+                if (!pi.is_owned(LocalVertexT(v)) ||
+                    pi.is_deleted(LocalVertexT(v))) {
+                    continue;
+                }
+                const VertexHandle vh(p, v);
+                std::vector<T>&    row = values[map_to_mesh_local(vh)];
+                row.resize(attr.get_num_attributes());
+                for (uint32_t i = 0; i < attr.get_num_attributes(); ++i) {
+                    row[i] = attr(vh, i);
+                }
+            }
+        });
+    }
+
+    /**
+     * @brief Export one mesh of the batch to an obj file
+     * @param mesh_id the mesh to export
+     * @param filename the output file
+     * @param coords vertices coordinates
+     */
+    template <typename T>
+    void export_obj(const uint32_t            mesh_id,
+                    const std::string&        filename,
+                    const VertexAttribute<T>& coords) const
+    {
+        std::vector<std::vector<T>> v_list;
+        export_vertex_attribute(mesh_id, coords, v_list);
+
+        std::vector<glm::uvec3> f_list(get_mesh_num_faces(mesh_id));
+        for_each_mesh_patch(mesh_id, [&](const PatchInfo& pi, uint32_t p) {
+            for (uint16_t f = 0; f < pi.num_faces[0]; ++f) {
+                if (!pi.is_owned(LocalFaceT(f)) ||
+                    pi.is_deleted(LocalFaceT(f))) {
+                    continue;
+                }
+                glm::uvec3 face;
+                for (uint32_t e = 0; e < 3; ++e) {
+                    uint16_t edge = pi.fe[3 * f + e].id;
+                    flag_t   dir(0);
+                    Context::unpack_edge_dir(edge, edge, dir);
+                    const uint16_t v = pi.ev[(2 * edge) + dir].id;
+                    face[e]          = map_to_mesh_local(VertexHandle(p, v));
+                }
+                f_list[map_to_mesh_local(FaceHandle(p, f))] = face;
+            }
+        });
+
+        std::fstream file(filename, std::ios::out);
+        file.precision(30);
+        for (uint32_t v = 0; v < v_list.size(); ++v) {
+            file << "v " << v_list[v][0] << " " << v_list[v][1] << " "
+                 << v_list[v][2] << " \n";
+        }
+        for (uint32_t f = 0; f < f_list.size(); ++f) {
+            file << "f ";
+            for (uint32_t i = 0; i < 3; ++i) {
+                file << f_list[f][i] + 1 << " ";
+            }
+            file << "\n";
+        }
+        file.close();
+    }
+
+    /**
+     * @brief reduce an attribute on the device separately for every mesh of
+     * the batch. Every patch is reduced by one block and the per-patch results
+     * are then reduced by a segmented reduction over the patches of each mesh
+     * @param attr input attribute allocated on the device
+     * @param reduction_op the binary reduction functor e.g., cub::Sum()
+     * @param init the neutral value of the reduction
+     * @param attribute_id specific attribute ID to reduce. Default is
+     * INVALID32 which reduces all attributes
+     * @param stream stream to run the computation on
+     * @return the reduced value of every mesh on the host
+     */
+    template <typename T, typename HandleT, typename ReductionOp>
+    std::vector<T> reduce_per_mesh(const Attribute<T, HandleT>& attr,
+                                   ReductionOp                  reduction_op,
+                                   T                            init,
+                                   uint32_t     attribute_id = INVALID32,
+                                   cudaStream_t stream       = NULL)
+    {
+        const uint32_t num_patches = get_num_patches();
+        const uint32_t num_meshes  = get_num_meshes();
+
+        std::vector<T> h_output(num_meshes, init);
+
+        if ((attr.get_allocated() & DEVICE) != DEVICE) {
+            RXMESH_ERROR(
+                "RXMeshBatch::reduce_per_mesh() input attribute to should be "
+                "allocated on the device");
+            return h_output;
+        }
+
+        size_t temp_bytes = 0;
+        cub::DeviceSegmentedReduce::Reduce(nullptr,
+                                           temp_bytes,
+                                           (T*)nullptr,
+                                           (T*)nullptr,
+                                           num_meshes,
+                                           m_d_mesh_patch_offset,
+                                           m_d_mesh_patch_offset + 1,
+                                           reduction_op,
+                                           init,
+                                           stream);
+
+        // per-patch output, per-patch output ordered by mesh, per-mesh
+        // output, and cub temp storage
+        const size_t patch_bytes = align_bytes(num_patches * sizeof(T));
+        const size_t mesh_bytes  = align_bytes(num_meshes * sizeof(T));
+        reserve_reduce_scratch(2 * patch_bytes + mesh_bytes + temp_bytes);
+
+        char* scratch  = reinterpret_cast<char*>(m_d_reduce_scratch);
+        T*    d_patch  = reinterpret_cast<T*>(scratch);
+        T*    d_sorted = reinterpret_cast<T*>(scratch + patch_bytes);
+        T*    d_mesh   = reinterpret_cast<T*>(scratch + 2 * patch_bytes);
+        void* d_temp   = scratch + 2 * patch_bytes + mesh_bytes;
+
+        constexpr uint32_t blockThreads = 256;
+
+        detail::generic_reduce<T, blockThreads>
+            <<<num_patches, blockThreads, 0, stream>>>(
+                attr,
+                num_patches,
+                attr.get_num_attributes(),
+                d_patch,
+                reduction_op,
+                init,
+                attribute_id);
+
+        detail::gather_by_index<<<DIVIDE_UP(num_patches, blockThreads),
+                                  blockThreads,
+                                  0,
+                                  stream>>>(
+            num_patches, m_d_mesh_patches, d_patch, d_sorted);
+
+        cub::DeviceSegmentedReduce::Reduce(d_temp,
+                                           temp_bytes,
+                                           d_sorted,
+                                           d_mesh,
+                                           num_meshes,
+                                           m_d_mesh_patch_offset,
+                                           m_d_mesh_patch_offset + 1,
+                                           reduction_op,
+                                           init,
+                                           stream);
+
+        CUDA_ERROR(cudaMemcpyAsync(h_output.data(),
+                                   d_mesh,
+                                   num_meshes * sizeof(T),
+                                   cudaMemcpyDeviceToHost,
+                                   stream));
+        CUDA_ERROR(cudaStreamSynchronize(stream));
+
+        return h_output;
+    }
+
+   private:
+    RXMeshBatch(
+        std::vector<std::vector<uint32_t>>&&                   fv,
+        const std::vector<std::vector<std::vector<uint32_t>>>& fv_batch,
+        const std::vector<std::vector<std::vector<float>>>&    vertices_batch,
+        const uint32_t                                         patch_size,
+        const float                                            capacity_factor,
+        const float patch_alloc_factor,
+        const float lp_hashtable_load_factor)
+        : RXMeshStatic(fv,
+                       "",
+                       patch_size,
+                       capacity_factor,
+                       patch_alloc_factor,
+                       lp_hashtable_load_factor),
+          m_d_patch_mesh(nullptr),
+          m_d_mesh_patch_offset(nullptr),
+          m_d_mesh_patches(nullptr),
+          m_d_reduce_scratch(nullptr),
+          m_reduce_scratch_bytes(0)
+    {
+        const uint32_t num_meshes = static_cast<uint32_t>(fv_batch.size());
+
+        m_face_offset.resize(num_meshes + 1, 0);
+        m_vertex_offset.resize(num_meshes + 1, 0);
+        for (uint32_t m = 0; m < num_meshes; ++m) {
+            m_face_offset[m + 1] = m_face_offset[m] + fv_batch[m].size();
+            m_vertex_offset[m + 1] =
+                m_vertex_offset[m] +
+                count_vertices(fv_batch, vertices_batch, m);
+        }
+
+        if (!vertices_batch.empty()) {
+            if (vertices_batch.size() != num_meshes) {
+                RXMESH_ERROR(
+                    "RXMeshBatch::RXMeshBatch() the number of vertex lists "
+                    "({}) does not match the number of meshes ({})",
+                    vertices_batch.size(),
+                    num_meshes);
+            } else {
+                std::vector<std::vector<float>> vertices;
+                vertices.reserve(m_vertex_offset.back());
+                for (const auto& mesh_vertices : vertices_batch) {
+                    vertices.insert(vertices.end(),
+                                    mesh_vertices.begin(),
+                                    mesh_vertices.end());
+                }
+                add_vertex_coordinates(vertices, "RXMeshBatch");
+            }
+        }
+
+        build_patch_mesh();
+    }
+
+    /**
+     * @brief concatenate the faces of all meshes while shifting the vertex
+     * ids of every mesh by the number of vertices of the meshes before it
+     */
+    static std::vector<std::vector<uint32_t>> concatenate_faces(
+        const std::vector<std::vector<std::vector<uint32_t>>>& fv_batch,
+        const std::vector<std::vector<std::vector<float>>>&    vertices_batch)
+    {
+        size_t num_faces = 0;
+        for (const auto& fv : fv_batch) {
+            num_faces += fv.size();
+        }
+
+        std::vector<std::vector<uint32_t>> ret;
+        ret.reserve(num_faces);
+
+        uint32_t offset = 0;
+        for (uint32_t m = 0; m < fv_batch.size(); ++m) {
+            for (const auto& face : fv_batch[m]) {
+                std::vector<uint32_t> f(face);
+                for (uint32_t& v : f) {
+                    v += offset;
+                }
+                ret.push_back(std::move(f));
+            }
+            offset += count_vertices(fv_batch, vertices_batch, m);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief the number of vertices of a mesh which is the size of its vertex
+     * list so the faces and the concatenated vertex lists use the same ids
+     * even if the mesh has unreferenced vertices. If the vertex lists are not
+     * given, it is the largest vertex id referenced by the faces plus one
+     */
+    static uint32_t count_vertices(
+        const std::vector<std::vector<std::vector<uint32_t>>>& fv_batch,
+        const std::vector<std::vector<std::vector<float>>>&    vertices_batch,
+        const uint32_t                                         mesh_id)
+    {
+        uint32_t max_ref = 0;
+        for (const auto& face : fv_batch[mesh_id]) {
+            for (const uint32_t v : face) {
+                max_ref = std::max(max_ref, v + 1);
+            }
+        }
+
+        if (vertices_batch.size() != fv_batch.size()) {
+            return max_ref;
+        }
+
+        const uint32_t num_vertices =
+            static_cast<uint32_t>(vertices_batch[mesh_id].size());
+        if (max_ref > num_vertices) {
+            RXMESH_ERROR(
+                "RXMeshBatch::count_vertices() mesh {} references vertex {} "
+                "but has {} vertices",
+                mesh_id,
+                max_ref - 1,
+                num_vertices);
+            exit(EXIT_FAILURE);
+        }
+        return num_vertices;
+    }
+
+    /**
+     * @brief find the mesh of every patch from its owned faces, sort the
+     * patches by mesh, and count the edges of every mesh
+     */
+    void build_patch_mesh()
+    {
+        const uint32_t num_patches = get_num_patches();
+        const uint32_t num_meshes  = get_num_meshes();
+
+        auto mesh_of_face = [&](uint32_t global_f) {
+            return static_cast<uint32_t>(
+                std::upper_bound(
+                    m_face_offset.begin(), m_face_offset.end(), global_f) -
+                m_face_offset.begin() - 1);
+        };
+
+        m_h_patch_mesh.assign(num_patches, INVALID32);
+        m_mesh_num_edges.assign(num_meshes, 0);
+
+        for (uint32_t p = 0; p < num_patches; ++p) {
+            const PatchInfo& pi = m_h_patches_info[p];
+            for (uint16_t f = 0; f < pi.num_faces[0]; ++f) {
+                if (!pi.is_owned(LocalFaceT(f)) ||
+                    pi.is_deleted(LocalFaceT(f))) {
+                    continue;
+                }
+                const uint32_t m = mesh_of_face(m_h_patches_ltog_f[p][f]);
+                if (m_h_patch_mesh[p] == INVALID32) {
+                    m_h_patch_mesh[p] = m;
+                } else if (m_h_patch_mesh[p] != m) {
+                    RXMESH_ERROR(
+                        "RXMeshBatch::build_patch_mesh() patch {} spans meshes "
+                        "{} and {}",
+                        p,
+                        m_h_patch_mesh[p],
+                        m);
+                    exit(EXIT_FAILURE);
+                }
+            }
+            if (m_h_patch_mesh[p] != INVALID32) {
+                m_mesh_num_edges[m_h_patch_mesh[p]] +=
+                    pi.get_num_owned<EdgeHandle>();
+            }
+        }
+
+        // counting sort of the patches by mesh
+        m_mesh_patch_offset.assign(num_meshes + 1, 0);
+        for (uint32_t p = 0; p < num_patches; ++p) {
+            if (m_h_patch_mesh[p] != INVALID32) {
+                m_mesh_patch_offset[m_h_patch_mesh[p] + 1]++;
+            }
+        }
+        for (uint32_t m = 0; m < num_meshes; ++m) {
+            m_mesh_patch_offset[m + 1] += m_mesh_patch_offset[m];
+        }
+        m_mesh_patches.resize(m_mesh_patch_offset.back());
+        std::vector<uint32_t> pos(m_mesh_patch_offset.begin(),
+                                  m_mesh_patch_offset.end() - 1);
+        for (uint32_t p = 0; p < num_patches; ++p) {
+            if (m_h_patch_mesh[p] != INVALID32) {
+                m_mesh_patches[pos[m_h_patch_mesh[p]]++] = p;
+            }
+        }
+
+        auto to_device = [](uint32_t*& d_ptr, const std::vector<uint32_t>& h) {
+            CUDA_ERROR(cudaMalloc((void**)&d_ptr,
+                                  std::max<size_t>(h.size(), 1) *
+                                      sizeof(uint32_t)));
+            CUDA_ERROR(cudaMemcpy(d_ptr,
+                                  h.data(),
+                                  h.size() * sizeof(uint32_t),
+                                  cudaMemcpyHostToDevice));
+        };
+        to_device(m_d_patch_mesh, m_h_patch_mesh);
+        to_device(m_d_mesh_patch_offset, m_mesh_patch_offset);
+        to_device(m_d_mesh_patches, m_mesh_patches);
+    }
+
+    /**
+     * @brief run func(patch_info, p) on the patches of one mesh in parallel
+     */
+    template <typename FuncT>
+    void for_each_mesh_patch(const uint32_t mesh_id, FuncT func) const
+    {
+        const uint32_t  begin   = m_mesh_patch_offset[mesh_id];
+        const uint32_t  end     = m_mesh_patch_offset[mesh_id + 1];
+        const uint32_t* patches = m_mesh_patches.data() + begin;
+        get_host_schedule().run(end - begin, [&](uint32_t i) {
+            func(m_h_patches_info[patches[i]], patches[i]);
+        });
+    }
+
+    static size_t align_bytes(const size_t bytes)
+    {
+        return DIVIDE_UP(bytes, 256) * 256;
+    }
+
+    void reserve_reduce_scratch(const size_t bytes)
+    {
+        if (bytes > m_reduce_scratch_bytes) {
+            GPU_FREE(m_d_reduce_scratch);
+            CUDA_ERROR(cudaMalloc(&m_d_reduce_scratch, bytes));
+            m_reduce_scratch_bytes = bytes;
+        }
+    }
+
+    std::vector<uint32_t> m_vertex_offset;
+    std::vector<uint32_t> m_face_offset;
+    std::vector<uint32_t> m_mesh_num_edges;
+    std::vector<uint32_t> m_h_patch_mesh;
+    std::vector<uint32_t> m_mesh_patch_offset;
+    std::vector<uint32_t> m_mesh_patches;
+    uint32_t*             m_d_patch_mesh;
+    uint32_t*             m_d_mesh_patch_offset;
+    uint32_t*             m_d_mesh_patches;
+    void*                 m_d_reduce_scratch;
+    size_t                m_reduce_scratch_bytes;
+};
+
+}  // namespace rxmesh
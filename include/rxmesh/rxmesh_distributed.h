@@ -0,0 +1,746 @@
+#pragma once
+
+#ifdef RXMESH_MPI
+
+#include <mpi.h>
+#include <stdint.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "metis.h"
+
+#include "rxmesh/rxmesh_static.h"
+#include "rxmesh/util/import_obj.h"
+#include "rxmesh/util/log.h"
+#include "rxmesh/util/macros.h"
+#include "rxmesh/util/util.h"
+
+namespace rxmesh {
+
+namespace detail {
+template <typename T>
+__global__ void pack_halo(const VertexAttribute<T> attr,
+                          const uint32_t           num_handles,
+                          const VertexHandle*      handles,
+                          T*                       buffer)
+{
+    const uint32_t n = attr.get_num_attributes();
+    const uint32_t i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i < num_handles) {
+        for (uint32_t j = 0; j < n; ++j) {
+            buffer[i * n + j] = attr(handles[i], j);
+        }
+    }
+}
+
+template <typename T>
+__global__ void unpack_halo(VertexAttribute<T>  attr,
+                            const uint32_t      num_handles,
+                            const VertexHandle* handles,
+                            const T*            buffer)
+{
+    const uint32_t n = attr.get_num_attributes();
+    const uint32_t i = blockIdx.x * blockDim.x + threadIdx.x;
+    if (i < num_handles) {
+        for (uint32_t j = 0; j < n; ++j) {
+            attr(handles[i], j) = buffer[i * n + j];
+        }
+    }
+}
+}  // namespace detail
+
+/**
+ * @brief distributed-memory mesh where every MPI rank holds the part of the
+ * mesh it owns plus a one-ring halo of faces around it. The faces are
+ * partitioned between ranks with METIS (on rank 0) and every rank builds its
+ * own RXMeshStatic from its part, so the local patches, ribbons, and queries
+ * are the same as in a single-process run. A vertex is owned by the lowest
+ * rank among its incident faces; all other copies are ghosts. Halo exchange
+ * copies vertex attributes from the owners to the ghosts using packed
+ * per-neighbor buffers and non-blocking MPI so it can overlap with the work
+ * on interior patches (patches without ghosts):
+ *
+ * dist.begin_halo_exchange(attr);
+ * ... work on dist.get_interior_patches() ...
+ * dist.end_halo_exchange(attr);
+ * ... work on dist.get_boundary_patches() ...
+ *
+ * Only available when RXMesh is built with RXMESH_MPI. Run with
+ * mpirun -np N
+ */
+class RXMeshDistributed
+{
+   public:
+    RXMeshDistributed(const RXMeshDistributed&) = delete;
+
+    /**
+     * @brief Constructor using path to obj file. Every rank reads the
+     * connectivity but only keeps the coordinates of its local vertices
+     * @param comm the MPI communicator
+     * @param file_path path to an obj file
+     * @param patch_size the patch size of the local meshes
+     */
+    explicit RXMeshDistributed(MPI_Comm          comm,
+                               const std::string file_path,
+                               const uint32_t    patch_size = 512)
+        : m_comm(comm)
+    {
+        std::vector<std::vector<uint32_t>> fv;
+        std::vector<std::vector<float>>    vertices;
+        if (!import_obj(file_path, vertices, fv)) {
+            RXMESH_ERROR(
+                "RXMeshDistributed::RXMeshDistributed could not read the "
+                "input file {}",
+                file_path);
+            MPI_Abort(comm, EXIT_FAILURE);
+        }
+        init(fv, vertices, patch_size);
+    }
+
+    /**
+     * @brief Constructor using the (global) faces and vertices. All ranks
+     * should pass the same input
+     */
+    explicit RXMeshDistributed(
+        MPI_Comm                                  comm,
+        const std::vector<std::vector<uint32_t>>& fv,
+        const std::vector<std::vector<float>>&    vertices,
+        const uint32_t                            patch_size = 512)
+        : m_comm(comm)
+    {
+        init(fv, vertices, patch_size);
+    }
+
+    virtual ~RXMeshDistributed()
+    {
+        for (auto& n : m_neighbors) {
+            GPU_FREE(n.d_send);
+            GPU_FREE(n.d_recv);
+            GPU_FREE(n.d_send_buffer);
+            GPU_FREE(n.d_recv_buffer);
+        }
+    }
+
+    /**
+     * @brief the mesh of this rank (owned and ghost elements)
+     */
+    RXMeshStatic& get_local_mesh()
+    {
+        return *m_local;
+    }
+
+    int get_rank() const
+    {
+        return m_rank;
+    }
+
+    int get_num_ranks() const
+    {
+        return m_num_ranks;
+    }
+
+    MPI_Comm get_comm() const
+    {
+        return m_comm;
+    }
+
+    uint32_t get_num_global_vertices() const
+    {
+        return m_num_global_vertices;
+    }
+
+    uint32_t get_num_global_faces() const
+    {
+        return m_num_global_faces;
+    }
+
+    /**
+     * @brief number of vertices owned by this rank
+     */
+    uint32_t get_num_owned_vertices() const
+    {
+        return m_num_owned_vertices;
+    }
+
+    /**
+     * @brief number of ghost vertices on this rank
+     */
+    uint32_t get_num_ghost_vertices() const
+    {
+        return m_local->get_num_vertices() - m_num_owned_vertices;
+    }
+
+    /**
+     * @brief the index of a (local) vertex in the global input
+     */
+    uint32_t map_to_global(const VertexHandle vh) const
+    {
+        return m_local_to_global_v[m_local->map_to_global(vh)];
+    }
+
+    /**
+     * @brief the rank that owns a (local) vertex
+     */
+    int get_owner_rank(const VertexHandle vh) const
+    {
+        return m_local_owner_v[m_local->map_to_global(vh)];
+    }
+
+    /**
+     * @brief check if a vertex is owned by this rank (i.e., it is not a ghost)
+     */
+    bool is_owned(const VertexHandle vh) const
+    {
+        return get_owner_rank(vh) == m_rank;
+    }
+
+    /**
+     * @brief the local patches that do not have ghost vertices. They can be
+     * processed while the halo exchange is in flight
+     */
+    const std::vector<uint32_t>& get_interior_patches() const
+    {
+        return m_interior_patches;
+    }
+
+    /**
+     * @brief the local patches that have ghost vertices
+     */
+    const std::vector<uint32_t>& get_boundary_patches() const
+    {
+        return m_boundary_patches;
+    }
+
+    /**
+     * @brief the ranks this rank exchanges halo with
+     */
+    std::vector<int> get_neighbor_ranks() const
+    {
+        std::vector<int> ret;
+        for (const auto& n : m_neighbors) {
+            ret.push_back(n.rank);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief pack the values of the owned vertices needed by other ranks and
+     * post the non-blocking sends and receives. The attribute values of the
+     * owned vertices can be modified after this call returns
+     * @param attr the vertex attribute of the local mesh
+     * @param location where the attribute values are read from and written to
+     * (HOST or DEVICE)
+     */
+    template <typename T>
+    void begin_halo_exchange(VertexAttribute<T>& attr,
+                             locationT           location = HOST)
+    {
+        if (!m_requests.empty()) {
+            RXMESH_ERROR(
+                "RXMeshDistributed::begin_halo_exchange() the previous "
+                "exchange was not ended");
+            return;
+        }
+        if (location != HOST && location != DEVICE) {
+            RXMESH_ERROR(
+                "RXMeshDistributed::begin_halo_exchange() location should be "
+                "HOST or DEVICE");
+            return;
+        }
+
+        m_exchange_location = location;
+
+        const uint32_t n = attr.get_num_attributes();
+
+        m_requests.reserve(2 * m_neighbors.size());
+
+        for (auto& nb : m_neighbors) {
+            nb.send_bytes.resize(nb.send.size() * n * sizeof(T));
+            nb.recv_bytes.resize(nb.recv.size() * n * sizeof(T));
+
+            MPI_Request req;
+            MPI_Irecv(nb.recv_bytes.data(),
+                      int(nb.recv_bytes.size()),
+                      MPI_BYTE,
+                      nb.rank,
+                      s_tag,
+                      m_comm,
+                      &req);
+            m_requests.push_back(req);
+        }
+
+        for (auto& nb : m_neighbors) {
+            T* buffer = reinterpret_cast<T*>(nb.send_bytes.data());
+            if (location == HOST) {
+                for (size_t i = 0; i < nb.send.size(); ++i) {
+                    for (uint32_t j = 0; j < n; ++j) {
+                        buffer[i * n + j] = attr(nb.send[i], j);
+                    }
+                }
+            } else {
+                reserve_device_buffer(nb.d_send_buffer,
+                                      nb.d_send_buffer_bytes,
+                                      nb.send_bytes.size());
+                const uint32_t num   = uint32_t(nb.send.size());
+                const uint32_t block = 256;
+                if (num > 0) {
+                    detail::pack_halo<<<DIVIDE_UP(num, block), block>>>(
+                        attr,
+                        num,
+                        nb.d_send,
+                        reinterpret_cast<T*>(nb.d_send_buffer));
+                }
+                CUDA_ERROR(cudaMemcpy(nb.send_bytes.data(),
+                                      nb.d_send_buffer,
+                                      nb.send_bytes.size(),
+                                      cudaMemcpyDeviceToHost));
+            }
+
+            MPI_Request req;
+            MPI_Isend(nb.send_bytes.data(),
+                      int(nb.send_bytes.size()),
+                      MPI_BYTE,
+                      nb.rank,
+                      s_tag,
+                      m_comm,
+                      &req);
+            m_requests.push_back(req);
+        }
+    }
+
+    /**
+     * @brief wait for the exchange started by begin_halo_exchange() and write
+     * the received values into the ghost vertices
+     */
+    template <typename T>
+    void end_halo_exchange(VertexAttribute<T>& attr)
+    {
+        if (m_requests.empty() && !m_neighbors.empty()) {
+            RXMESH_ERROR(
+                "RXMeshDistributed::end_halo_exchange() no exchange was "
+                "started");
+            return;
+        }
+        MPI_Waitall(
+            int(m_requests.size()), m_requests.data(), MPI_STATUSES_IGNORE);
+        m_requests.clear();
+
+        const uint32_t n = attr.get_num_attributes();
+
+        for (auto& nb : m_neighbors) {
+            const T* buffer = reinterpret_cast<const T*>(nb.recv_bytes.data());
+            if (m_exchange_location == HOST) {
+                for (size_t i = 0; i < nb.recv.size(); ++i) {
+                    for (uint32_t j = 0; j < n; ++j) {
+                        attr(nb.recv[i], j) = buffer[i * n + j];
+                    }
+                }
+            } else {
+                reserve_device_buffer(nb.d_recv_buffer,
+                                      nb.d_recv_buffer_bytes,
+                                      nb.recv_bytes.size());
+                CUDA_ERROR(cudaMemcpy(nb.d_recv_buffer,
+                                      nb.recv_bytes.data(),
+                                      nb.recv_bytes.size(),
+                                      cudaMemcpyHostToDevice));
+                const uint32_t num   = uint32_t(nb.recv.size());
+                const uint32_t block = 256;
+                if (num > 0) {
+                    detail::unpack_halo<<<DIVIDE_UP(num, block), block>>>(
+                        attr,
+                        num,
+                        nb.d_recv,
+                        reinterpret_cast<const T*>(nb.d_recv_buffer));
+                }
+            }
+        }
+        if (m_exchange_location == DEVICE) {
+            CUDA_ERROR(cudaDeviceSynchronize());
+        }
+    }
+
+    /**
+     * @brief blocking halo exchange
+     */
+    template <typename T>
+    void halo_exchange(VertexAttribute<T>& attr, locationT location = HOST)
+    {
+        begin_halo_exchange(attr, location);
+        end_halo_exchange(attr);
+    }
+
+    /**
+     * @brief sum an attribute (on the host) over the vertices owned by all
+     * ranks
+     */
+    double reduce_sum(const VertexAttribute<float>& attr,
+                      const uint32_t                attribute_id = 0) const
+    {
+        double local = 0;
+        m_local->for_each_vertex(
+            HOST,
+            [&](const VertexHandle vh) {
+                if (is_owned(vh)) {
+                    local += attr(vh, attribute_id);
+                }
+            },
+            NULL,
+            false);
+        double global = 0;
+        MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_SUM, m_comm);
+        return global;
+    }
+
+   private:
+    struct Neighbor
+    {
+        int rank = -1;
+        // owned vertices sent to the neighbor
+        std::vector<VertexHandle> send;
+        // ghost vertices received from the neighbor
+        std::vector<VertexHandle> recv;
+        std::vector<char>         send_bytes;
+        std::vector<char>         recv_bytes;
+        // device copies of send/recv and the device staging buffers
+        VertexHandle* d_send              = nullptr;
+        VertexHandle* d_recv              = nullptr;
+        void*         d_send_buffer       = nullptr;
+        void*         d_recv_buffer       = nullptr;
+        size_t        d_send_buffer_bytes = 0;
+        size_t        d_recv_buffer_bytes = 0;
+    };
+
+    static constexpr int s_tag = 7411;
+
+    void init(const std::vector<std::vector<uint32_t>>& fv,
+              const std::vector<std::vector<float>>&    vertices,
+              const uint32_t                            patch_size)
+    {
+        MPI_Comm_rank(m_comm, &m_rank);
+        MPI_Comm_size(m_comm, &m_num_ranks);
+
+        m_num_global_faces    = uint32_t(fv.size());
+        m_num_global_vertices = uint32_t(vertices.size());
+
+        // 1) partition the faces between ranks
+        std::vector<int> face_rank(m_num_global_faces, 0);
+        if (m_num_ranks > 1) {
+            if (m_rank == 0) {
+                partition_faces(fv, face_rank);
+            }
+            MPI_Bcast(face_rank.data(),
+                      int(m_num_global_faces),
+                      MPI_INT,
+                      0,
+                      m_comm);
+        }
+
+        // 2) vertex owner is the lowest rank among its incident faces
+        std::vector<int> owner(m_num_global_vertices, m_num_ranks);
+        for (uint32_t f = 0; f < m_num_global_faces; ++f) {
+            for (const uint32_t v : fv[f]) {
+                owner[v] = std::min(owner[v], face_rank[f]);
+            }
+        }
+
+        // 3) local faces are the owned faces plus the faces sharing a vertex
+        // with them
+        std::vector<bool> touched(m_num_global_vertices, false);
+        for (uint32_t f = 0; f < m_num_global_faces; ++f) {
+            if (face_rank[f] == m_rank) {
+                for (const uint32_t v : fv[f]) {
+                    touched[v] = true;
+                }
+            }
+        }
+
+        std::vector<uint32_t> global_to_local(m_num_global_vertices,
+                                              INVALID32);
+        std::vector<std::vector<uint32_t>> local_fv;
+        for (uint32_t f = 0; f < m_num_global_faces; ++f) {
+            bool keep = face_rank[f] == m_rank;
+            for (uint32_t i = 0; i < fv[f].size() && !keep; ++i) {
+                keep = touched[fv[f][i]];
+            }
+            if (keep) {
+                local_fv.push_back(fv[f]);
+                for (const uint32_t v : fv[f]) {
+                    global_to_local[v] = 0;
+                }
+            }
+        }
+
+        // number the local vertices in global order
+        for (uint32_t v = 0; v < m_num_global_vertices; ++v) {
+            if (global_to_local[v] != INVALID32) {
+                global_to_local[v] = uint32_t(m_local_to_global_v.size());
+                m_local_to_global_v.push_back(v);
+                m_local_owner_v.push_back(owner[v]);
+                if (owner[v] == m_rank) {
+                    m_num_owned_vertices++;
+                }
+            }
+        }
+        for (auto& face : local_fv) {
+            for (uint32_t& v : face) {
+                v = global_to_local[v];
+            }
+        }
+
+        std::vector<std::vector<float>> local_vertices(
+            m_local_to_global_v.size());
+        for (size_t v = 0; v < m_local_to_global_v.size(); ++v) {
+            local_vertices[v] = vertices[m_local_to_global_v[v]];
+        }
+
+        // 4) the local mesh
+        m_local = std::make_unique<RXMeshStatic>(local_fv, "", patch_size);
+        m_local->add_vertex_coordinates(local_vertices);
+
+        // 5) exchange lists
+        build_exchange_lists(global_to_local);
+        classify_patches();
+
+        RXMESH_INFO(
+            "RXMeshDistributed rank {}/{}: #F= {}, #V= {} (owned {}, ghost "
+            "{}), #neighbors= {}, #interior_patches= {}, "
+            "#boundary_patches= {}",
+            m_rank,
+            m_num_ranks,
+            m_local->get_num_faces(),
+            m_local->get_num_vertices(),
+            m_num_owned_vertices,
+            get_num_ghost_vertices(),
+            m_neighbors.size(),
+            m_interior_patches.size(),
+            m_boundary_patches.size());
+    }
+
+    /**
+     * @brief k-way partition of the face dual graph (faces sharing an edge)
+     */
+    void partition_faces(const std::vector<std::vector<uint32_t>>& fv,
+                         std::vector<int>&                         face_rank)
+    {
+        std::unordered_map<std::pair<uint32_t, uint32_t>,
+                           std::vector<uint32_t>,
+                           detail::edge_key_hash>
+            edge_faces;
+        for (uint32_t f = 0; f < fv.size(); ++f) {
+            const size_t deg = fv[f].size();
+            for (size_t i = 0; i < deg; ++i) {
+                edge_faces[detail::edge_key(fv[f][i], fv[f][(i + 1) % deg])]
+                    .push_back(f);
+            }
+        }
+
+        std::vector<std::vector<idx_t>> ff(fv.size());
+        for (const auto& ef : edge_faces) {
+            for (const uint32_t f0 : ef.second) {
+                for (const uint32_t f1 : ef.second) {
+                    if (f0 != f1) {
+                        ff[f0].push_back(f1);
+                    }
+                }
+            }
+        }
+
+        std::vector<idx_t> xadj(fv.size() + 1, 0);
+        std::vector<idx_t> adjncy;
+        for (size_t f = 0; f < fv.size(); ++f) {
+            adjncy.insert(adjncy.end(), ff[f].begin(), ff[f].end());
+            xadj[f + 1] = idx_t(adjncy.size());
+        }
+
+        idx_t options[METIS_NOPTIONS];
+        METIS_SetDefaultOptions(options);
+        options[METIS_OPTION_NUMBERING] = 0;
+
+        idx_t              nvtxs  = idx_t(fv.size());
+        idx_t              ncon   = 1;
+        idx_t              nparts = m_num_ranks;
+        idx_t              objval = 0;
+        std::vector<idx_t> part(nvtxs, 0);
+
+        int status = METIS_PartGraphKway(&nvtxs,
+                                         &ncon,
+                                         xadj.data(),
+                                         adjncy.data(),
+                                         NULL,
+                                         NULL,
+                                         NULL,
+                                         &nparts,
+                                         NULL,
+                                         NULL,
+                                         options,
+                                         &objval,
+                                         part.data());
+        if (status != METIS_OK) {
+            RXMESH_ERROR(
+                "RXMeshDistributed::partition_faces() METIS failed with {}",
+                status);
+            MPI_Abort(m_comm, EXIT_FAILURE);
+        }
+        for (size_t f = 0; f < fv.size(); ++f) {
+            face_rank[f] = int(part[f]);
+        }
+    }
+
+    /**
+     * @brief every rank asks the owners of its ghost vertices for them. The
+     * owners record which of their vertices each neighbor needs
+     */
+    void build_exchange_lists(const std::vector<uint32_t>& global_to_local)
+    {
+        const IndexMap<VertexHandle>& v_map =
+            m_local->get_index_map<VertexHandle>();
+
+        auto local_handle = [&](uint32_t local_v) {
+            return v_map.handle(v_map.linear_from_global(local_v));
+        };
+
+        // ghost vertices grouped by owner, in global order
+        std::vector<std::vector<uint32_t>> request(m_num_ranks);
+        std::vector<std::vector<VertexHandle>> recv(m_num_ranks);
+        for (uint32_t v = 0; v < m_local_to_global_v.size(); ++v) {
+            const int r = m_local_owner_v[v];
+            if (r != m_rank) {
+                request[r].push_back(m_local_to_global_v[v]);
+                recv[r].push_back(local_handle(v));
+            }
+        }
+
+        std::vector<int> send_count(m_num_ranks), recv_count(m_num_ranks);
+        for (int r = 0; r < m_num_ranks; ++r) {
+            send_count[r] = int(request[r].size());
+        }
+        MPI_Alltoall(send_count.data(),
+                     1,
+                     MPI_INT,
+                     recv_count.data(),
+                     1,
+                     MPI_INT,
+                     m_comm);
+
+        std::vector<int> send_displ(m_num_ranks + 1, 0);
+        std::vector<int> recv_displ(m_num_ranks + 1, 0);
+        for (int r = 0; r < m_num_ranks; ++r) {
+            send_displ[r + 1] = send_displ[r] + send_count[r];
+            recv_displ[r + 1] = recv_displ[r] + recv_count[r];
+        }
+        std::vector<uint32_t> send_ids(send_displ.back());
+        std::vector<uint32_t> recv_ids(recv_displ.back());
+        for (int r = 0; r < m_num_ranks; ++r) {
+            std::copy(request[r].begin(),
+                      request[r].end(),
+                      send_ids.begin() + send_displ[r]);
+        }
+        MPI_Alltoallv(send_ids.data(),
+                      send_count.data(),
+                      send_displ.data(),
+                      MPI_UINT32_T,
+                      recv_ids.data(),
+                      recv_count.data(),
+                      recv_displ.data(),
+                      MPI_UINT32_T,
+                      m_comm);
+
+        for (int r = 0; r < m_num_ranks; ++r) {
+            if (recv_count[r] == 0 && recv[r].empty()) {
+                continue;
+            }
+            Neighbor nb;
+            nb.rank = r;
+            nb.recv = std::move(recv[r]);
+            for (int i = recv_displ[r]; i < recv_displ[r + 1]; ++i) {
+                const uint32_t local_v = global_to_local[recv_ids[i]];
+                if (local_v == INVALID32 ||
+                    m_local_owner_v[local_v] != m_rank) {
+                    RXMESH_ERROR(
+                        "RXMeshDistributed::build_exchange_lists() rank {} "
+                        "asked rank {} for vertex {} it does not own",
+                        r,
+                        m_rank,
+                        recv_ids[i]);
+                    continue;
+                }
+                nb.send.push_back(local_handle(local_v));
+            }
+
+            auto to_device = [](VertexHandle*&                   d_ptr,
+                                const std::vector<VertexHandle>& h) {
+                if (h.empty()) {
+                    return;
+                }
+                CUDA_ERROR(cudaMalloc((void**)&d_ptr,
+                                      h.size() * sizeof(VertexHandle)));
+                CUDA_ERROR(cudaMemcpy(d_ptr,
+                                      h.data(),
+                                      h.size() * sizeof(VertexHandle),
+                                      cudaMemcpyHostToDevice));
+            };
+            to_device(nb.d_send, nb.send);
+            to_device(nb.d_recv, nb.recv);
+
+            m_neighbors.push_back(std::move(nb));
+        }
+    }
+
+    /**
+     * @brief a local patch is a boundary patch if any of its vertices (owned
+     * or not by the patch) is a ghost
+     */
+    void classify_patches()
+    {
+        for (uint32_t p = 0; p < m_local->get_num_patches(); ++p) {
+            const PatchInfo& pi       = m_local->get_patch(p);
+            bool             boundary = false;
+            for (uint16_t v = 0; v < pi.num_vertices[0] && !boundary; ++v) {
+                if (pi.is_deleted(LocalVertexT(v))) {
+                    continue;
+                }
+                const VertexHandle owner =
+                    m_local->get_owner_handle(VertexHandle(p, v));
+                boundary = !is_owned(owner);
+            }
+            if (boundary) {
+                m_boundary_patches.push_back(p);
+            } else {
+                m_interior_patches.push_back(p);
+            }
+        }
+    }
+
+    static void reserve_device_buffer(void*&       d_ptr,
+                                      size_t&      capacity,
+                                      const size_t bytes)
+    {
+        if (bytes > capacity) {
+            GPU_FREE(d_ptr);
+            CUDA_ERROR(cudaMalloc(&d_ptr, bytes));
+            capacity = bytes;
+        }
+    }
+
+    MPI_Comm                      m_comm;
+    int                           m_rank                = 0;
+    int                           m_num_ranks           = 1;
+    uint32_t                      m_num_global_vertices = 0;
+    uint32_t                      m_num_global_faces    = 0;
+    uint32_t                      m_num_owned_vertices  = 0;
+    std::unique_ptr<RXMeshStatic> m_local;
+    std::vector<uint32_t>         m_local_to_global_v;
+    std::vector<int>              m_local_owner_v;
+    std::vector<Neighbor>         m_neighbors;
+    std::vector<MPI_Request>      m_requests;
+    locationT                     m_exchange_location = HOST;
+    std::vector<uint32_t>         m_interior_patches;
+    std::vector<uint32_t>         m_boundary_patches;
+};
+
+}  // namespace rxmesh
+
+#endif
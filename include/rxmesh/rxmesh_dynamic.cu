@@ -10,6 +10,7 @@
 #include "rxmesh/query.cuh"
 #include "rxmesh/rxmesh_dynamic.h"
 #include "rxmesh/util/bitmask_util.h"
+#include "rxmesh/util/instrument.h"
 #include "rxmesh/util/macros.h"
 #include "rxmesh/util/util.h"
 
@@ -2241,6 +2242,7 @@ void RXMeshDynamic::save(std::string filename)
 
 bool RXMeshDynamic::validate()
 {
+    RXMESH_ZONE("RXMeshDynamic::validate");
     CUDA_ERROR(cudaDeviceSynchronize());
     RXMESH_TRACE("RXMeshDynamic validation started");
 
@@ -2607,6 +2609,7 @@ bool RXMeshDynamic::validate()
 
 void RXMeshDynamic::cleanup()
 {
+    RXMESH_ZONE("RXMeshDynamic::cleanup");
     CUDA_ERROR(cudaMemcpy(&m_num_patches,
                           m_rxmesh_context.m_num_patches,
                           sizeof(uint32_t),
@@ -2693,18 +2696,24 @@ void RXMeshDynamic::cleanup()
 
 void RXMeshDynamic::update_host()
 {
+    RXMESH_ZONE("RXMeshDynamic::update_host");
     RXMESH_TRACE("RXMeshDynamic updating host started");
 
+    // the index maps are built for the old topology
+    this->clear_index_maps();
+
     auto resize_masks = [&](uint16_t   size,
                             uint16_t&  capacity,
                             uint32_t*& active_mask,
                             uint32_t*& owned_mask) {
         if (size > capacity) {
             capacity = size;
-            free(active_mask);
-            free(owned_mask);
-            active_mask = (uint32_t*)malloc(detail::mask_num_bytes(size));
-            owned_mask  = (uint32_t*)malloc(detail::mask_num_bytes(size));
+            host_free(active_mask);
+            host_free(owned_mask);
+            active_mask = host_malloc<uint32_t>(DIVIDE_UP(size, 32),
+                                                HostMemTag::Topology);
+            owned_mask  = host_malloc<uint32_t>(DIVIDE_UP(size, 32),
+                                               HostMemTag::Topology);
         }
     };
 
@@ -2745,16 +2754,16 @@ void RXMeshDynamic::update_host()
         // resize topology (don't update capacity here)
         if (m_h_patches_info[p].num_edges[0] >
             m_h_patches_info[p].edges_capacity[0]) {
-            free(m_h_patches_info[p].ev);
-            m_h_patches_info[p].ev = (LocalVertexT*)malloc(
-                m_h_patches_info[p].num_edges[0] * 2 * sizeof(LocalVertexT));
+            host_free(m_h_patches_info[p].ev);
+            m_h_patches_info[p].ev = host_malloc<LocalVertexT>(
+                m_h_patches_info[p].num_edges[0] * 2, HostMemTag::Topology);
         }
 
         if (m_h_patches_info[p].num_faces[0] >
             m_h_patches_info[p].faces_capacity[0]) {
-            free(m_h_patches_info[p].fe);
-            m_h_patches_info[p].fe = (LocalEdgeT*)malloc(
-                m_h_patches_info[p].num_faces[0] * 3 * sizeof(LocalEdgeT));
+            host_free(m_h_patches_info[p].fe);
+            m_h_patches_info[p].fe = host_malloc<LocalEdgeT>(
+                m_h_patches_info[p].num_faces[0] * 3, HostMemTag::Topology);
         }
 
         // copy topology
@@ -2928,6 +2937,18 @@ void RXMeshDynamic::update_host()
 
     this->calc_max_elements();
 
+    this->build_host_schedule(m_host_schedule.get_policy());
+
+    this->track_host_containers();
+
+    // the cached sparse patterns and oriented one-ring are built for the old
+    // topology
+    m_sparse_pattern_cache.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_oriented_one_ring_mutex);
+        m_oriented_one_ring.reset();
+    }
+
     RXMESH_TRACE("RXMeshDynamic updating host finished");
 }
 
@@ -931,6 +931,7 @@ class RXMeshDynamic : public RXMeshStatic
     template <typename... AttributesT>
     void slice_patches(AttributesT... attributes)
     {
+        RXMESH_ZONE("RXMeshDynamic::slice_patches");
 
         const uint32_t grid_size = get_num_patches();
 
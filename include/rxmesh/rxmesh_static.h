@@ -3,19 +3,26 @@
 #include <fstream>
 #include <functional>
 #include <memory>
+#include <mutex>
 
 #include <cuda_profiler_api.h>
 
 #include "rxmesh/attribute.h"
 #include "rxmesh/diff/diff_attribute.h"
 #include "rxmesh/handle.h"
+#include "rxmesh/k_ring.h"
 #include "rxmesh/kernels/for_each.cuh"
 #include "rxmesh/kernels/shmem_allocator.cuh"
 #include "rxmesh/launch_box.h"
+#include "rxmesh/matrix/sparse_pattern.h"
+#include "rxmesh/mixed_attribute.h"
+#include "rxmesh/oriented_one_ring.h"
 #include "rxmesh/rxmesh.h"
+#include "rxmesh/sparse_attribute.h"
 #include "rxmesh/types.h"
 #include "rxmesh/util/bitmask_util.h"
 #include "rxmesh/util/import_obj.h"
+#include "rxmesh/util/instrument.h"
 #include "rxmesh/util/log.h"
 #include "rxmesh/util/timer.h"
 
@@ -43,13 +50,16 @@ class RXMeshStatic : public RXMesh
     /**
      * @brief Constructor using path to obj file
      * @param file_path path to an obj file
+     * @param partition_policy how the input is partitioned into patches
      */
-    explicit RXMeshStatic(const std::string file_path,
-                          const std::string patcher_file             = "",
-                          const uint32_t    patch_size               = 512,
-                          const float       capacity_factor          = 1.0,
-                          const float       patch_alloc_factor       = 1.0,
-                          const float       lp_hashtable_load_factor = 0.8)
+    explicit RXMeshStatic(
+        const std::string     file_path,
+        const std::string     patcher_file             = "",
+        const uint32_t        patch_size               = 512,
+        const float           capacity_factor          = 1.0,
+        const float           patch_alloc_factor       = 1.0,
+        const float           lp_hashtable_load_factor = 0.8,
+        const PartitionPolicy partition_policy         = PartitionPolicy())
         : RXMesh(patch_size)
     {
         std::vector<std::vector<uint32_t>> fv;
@@ -65,7 +75,9 @@ class RXMeshStatic : public RXMesh
                    patcher_file,
                    capacity_factor,
                    patch_alloc_factor,
-                   lp_hashtable_load_factor);
+                   lp_hashtable_load_factor,
+                   partition_policy,
+                   &vertices);
 
         m_attr_container = std::make_shared<AttributeContainer>();
 
@@ -96,6 +108,36 @@ class RXMeshStatic : public RXMesh
         m_attr_container = std::make_shared<AttributeContainer>();
     };
 
+    /**
+     * @brief Constructor using triangles and vertices that also adds the
+     * vertex coordinates. The coordinates are available to the geometric
+     * partitioners (see PartitionMethod)
+     * @param fv Face incident vertices as read from an obj file
+     * @param vertices vertex coordinates as read from an obj file
+     * @param partition_policy how the input is partitioned into patches
+     */
+    explicit RXMeshStatic(
+        std::vector<std::vector<uint32_t>>& fv,
+        std::vector<std::vector<float>>&    vertices,
+        const std::string                   patcher_file             = "",
+        const uint32_t                      patch_size               = 512,
+        const float                         capacity_factor          = 1.0,
+        const float                         patch_alloc_factor       = 1.0,
+        const float                         lp_hashtable_load_factor = 0.8,
+        const PartitionPolicy partition_policy = PartitionPolicy())
+        : RXMesh(patch_size), m_input_vertex_coordinates(nullptr)
+    {
+        this->init(fv,
+                   patcher_file,
+                   capacity_factor,
+                   patch_alloc_factor,
+                   lp_hashtable_load_factor,
+                   partition_policy,
+                   &vertices);
+        m_attr_container = std::make_shared<AttributeContainer>();
+        add_vertex_coordinates(vertices);
+    };
+
     /**
      * @brief Add vertex coordinates to the input mesh. When calling
      * RXMeshStatic constructor that takes the face's vertices, this function
@@ -450,6 +492,7 @@ class RXMeshStatic : public RXMesh
             const int num_patches = this->get_num_patches();
 
             auto run = [&](int p) {
+                uint32_t num_visited = 0;
                 for (uint16_t v = 0;
                      v < this->m_h_patches_info[p].num_vertices[0];
                      ++v) {
@@ -461,20 +504,13 @@ class RXMeshStatic : public RXMesh
                         const VertexHandle v_handle(static_cast<uint32_t>(p),
                                                     v);
                         apply(v_handle);
+                        num_visited++;
                     }
                 }
+                return num_visited;
             };
 
-            if (!with_omp) {
-                for (int p = 0; p < num_patches; ++p) {
-                    run(p);
-                }
-            } else {
-#pragma omp parallel for
-                for (int p = 0; p < num_patches; ++p) {
-                    run(p);
-                }
-            }
+            run_host_patches(num_patches, with_omp, run);
         }
 
         if ((location & DEVICE) == DEVICE) {
@@ -514,6 +550,7 @@ class RXMeshStatic : public RXMesh
             const int num_patches = this->get_num_patches();
 
             auto run = [&](int p) {
+                uint32_t num_visited = 0;
                 for (uint16_t e = 0; e < this->m_h_patches_info[p].num_edges[0];
                      ++e) {
 
@@ -523,20 +560,13 @@ class RXMeshStatic : public RXMesh
 
                         const EdgeHandle e_handle(static_cast<uint32_t>(p), e);
                         apply(e_handle);
+                        num_visited++;
                     }
                 }
+                return num_visited;
             };
 
-            if (!with_omp) {
-                for (int p = 0; p < num_patches; ++p) {
-                    run(p);
-                }
-            } else {
-#pragma omp parallel for
-                for (int p = 0; p < num_patches; ++p) {
-                    run(p);
-                }
-            }
+            run_host_patches(num_patches, with_omp, run);
         }
 
         if ((location & DEVICE) == DEVICE) {
@@ -576,6 +606,7 @@ class RXMeshStatic : public RXMesh
             const int num_patches = this->get_num_patches();
 
             auto run = [&](int p) {
+                uint32_t num_visited = 0;
                 for (int f = 0; f < this->m_h_patches_info[p].num_faces[0];
                      ++f) {
 
@@ -584,21 +615,13 @@ class RXMeshStatic : public RXMesh
                             f, m_h_patches_info[p].active_mask_f)) {
                         const FaceHandle f_handle(static_cast<uint32_t>(p), f);
                         apply(f_handle);
+                        num_visited++;
                     }
                 }
+                return num_visited;
             };
 
-
-            if (!with_omp) {
-                for (int p = 0; p < num_patches; ++p) {
-                    run(p);
-                }
-            } else {
-#pragma omp parallel for
-                for (int p = 0; p < num_patches; ++p) {
-                    run(p);
-                }
-            }
+            run_host_patches(num_patches, with_omp, run);
         }
         if ((location & DEVICE) == DEVICE) {
             if constexpr (IS_HD_LAMBDA(LambdaT) || IS_D_LAMBDA(LambdaT)) {
@@ -764,11 +787,16 @@ class RXMeshStatic : public RXMesh
     {
         LaunchBox<blockThreads> lb;
 
-        prepare_launch_box(
-            {op},
-            lb,
-            (void*)detail::query_kernel<blockThreads, op, LambdaT>,
-            oriented);
+        const void* kernel =
+            (void*)detail::query_kernel<blockThreads, op, false, LambdaT>;
+        if constexpr (op_is_orientable(op)) {
+            if (oriented) {
+                kernel = (void*)
+                    detail::query_kernel<blockThreads, op, true, LambdaT>;
+            }
+        }
+
+        prepare_launch_box({op}, lb, kernel, oriented);
 
         run_query_kernel<op>(lb, user_lambda, oriented, stream);
     }
@@ -796,9 +824,22 @@ class RXMeshStatic : public RXMesh
                           const bool              oriented = false,
                           cudaStream_t            stream   = NULL)
     {
-        detail::query_kernel<blockThreads, op>
+        RXMESH_ZONE_NAMED(query_zone, "RXMeshStatic::run_query_kernel");
+        RXMESH_ZONE_COUNTER(query_zone, "blocks", lb.blocks);
+        RXMESH_ZONE_COUNTER(query_zone, "smem_bytes_dyn", lb.smem_bytes_dyn);
+        // oriented is a template parameter of the kernel. It is ignored for
+        // ops that do not have an oriented variant
+        if constexpr (op_is_orientable(op)) {
+            if (oriented) {
+                detail::query_kernel<blockThreads, op, true>
+                    <<<lb.blocks, lb.num_threads, lb.smem_bytes_dyn, stream>>>(
+                        get_context(), user_lambda);
+                return;
+            }
+        }
+        detail::query_kernel<blockThreads, op, false>
             <<<lb.blocks, lb.num_threads, lb.smem_bytes_dyn, stream>>>(
-                get_context(), oriented, user_lambda);
+                get_context(), user_lambda);
     }
 
 
@@ -937,8 +978,7 @@ class RXMeshStatic : public RXMesh
 
         // populate the attribute before returning it
         const int num_patches = this->get_num_patches();
-#pragma omp parallel for
-        for (int p = 0; p < num_patches; ++p) {
+        this->m_host_schedule.run(num_patches, [&](uint32_t p) {
             for (uint16_t f = 0; f < this->m_h_num_owned_f[p]; ++f) {
 
                 const FaceHandle f_handle(static_cast<uint32_t>(p), f);
@@ -949,7 +989,7 @@ class RXMeshStatic : public RXMesh
                     (*ret)(f_handle, a) = f_attributes[global_f][a];
                 }
             }
-        }
+        });
 
         // move to device
         ret->move(rxmesh::HOST, rxmesh::DEVICE);
@@ -1014,8 +1054,7 @@ class RXMeshStatic : public RXMesh
 
         // populate the attribute before returning it
         const int num_patches = this->get_num_patches();
-#pragma omp parallel for
-        for (int p = 0; p < num_patches; ++p) {
+        this->m_host_schedule.run(num_patches, [&](uint32_t p) {
             for (uint16_t f = 0; f < this->m_h_num_owned_f[p]; ++f) {
 
                 const FaceHandle f_handle(static_cast<uint32_t>(p), f);
@@ -1024,7 +1063,7 @@ class RXMeshStatic : public RXMesh
 
                 (*ret)(f_handle, 0) = f_attributes[global_f];
             }
-        }
+        });
 
         // move to device
         ret->move(rxmesh::HOST, rxmesh::DEVICE);
@@ -1179,6 +1218,113 @@ class RXMeshStatic : public RXMesh
                 name.c_str(), num_attributes, location, layout, this);
     }
 
+    /**
+     * @brief Adding a new mixed-precision vertex attribute that stores values
+     * as StorageT (e.g., __half, __nv_bfloat16, or quant16_t) and reads and
+     * writes them as ComputeT
+     * @tparam ComputeT the type used in computation
+     * @tparam StorageT the type stored in memory
+     * @param name of the attribute. Should not collide with other attributes
+     * names
+     * @param num_attributes number of the attributes
+     * @param location where to allocate the attributes
+     * @param layout as SoA or AoS
+     * @return shared pointer to the created attribute
+     */
+    template <class ComputeT, class StorageT>
+    std::shared_ptr<MixedVertexAttribute<ComputeT, StorageT>>
+    add_mixed_vertex_attribute(const std::string& name,
+                               uint32_t           num_attributes,
+                               locationT          location = LOCATION_ALL,
+                               layoutT            layout   = SoA)
+    {
+        return m_attr_container
+            ->template add<MixedVertexAttribute<ComputeT, StorageT>>(
+                name.c_str(), num_attributes, location, layout, this);
+    }
+
+    /**
+     * @brief Adding a new mixed-precision edge attribute. See
+     * add_mixed_vertex_attribute()
+     */
+    template <class ComputeT, class StorageT>
+    std::shared_ptr<MixedEdgeAttribute<ComputeT, StorageT>>
+    add_mixed_edge_attribute(const std::string& name,
+                             uint32_t           num_attributes,
+                             locationT          location = LOCATION_ALL,
+                             layoutT            layout   = SoA)
+    {
+        return m_attr_container
+            ->template add<MixedEdgeAttribute<ComputeT, StorageT>>(
+                name.c_str(), num_attributes, location, layout, this);
+    }
+
+    /**
+     * @brief Adding a new mixed-precision face attribute. See
+     * add_mixed_vertex_attribute()
+     */
+    template <class ComputeT, class StorageT>
+    std::shared_ptr<MixedFaceAttribute<ComputeT, StorageT>>
+    add_mixed_face_attribute(const std::string& name,
+                             uint32_t           num_attributes,
+                             locationT          location = LOCATION_ALL,
+                             layoutT            layout   = SoA)
+    {
+        return m_attr_container
+            ->template add<MixedFaceAttribute<ComputeT, StorageT>>(
+                name.c_str(), num_attributes, location, layout, this);
+    }
+
+    /**
+     * @brief Adding a new sparse vertex attribute i.e., an attribute that is
+     * defined only on the vertices inserted in it. Memory and iteration scale
+     * with the number of inserted vertices, not the number of vertices in the
+     * mesh. See SparseAttribute
+     * @tparam T type of the attribute
+     * @param name of the attribute. Should not collide with other attributes
+     * names
+     * @param num_attributes number of the attributes per inserted vertex
+     * @param location where to allocate the attributes
+     * @return shared pointer to the created attribute
+     */
+    template <class T>
+    std::shared_ptr<SparseVertexAttribute<T>> add_sparse_vertex_attribute(
+        const std::string& name,
+        uint32_t           num_attributes,
+        locationT          location = LOCATION_ALL)
+    {
+        return m_attr_container->template add<SparseVertexAttribute<T>>(
+            name.c_str(), num_attributes, location, AoS, this);
+    }
+
+    /**
+     * @brief Adding a new sparse edge attribute. See
+     * add_sparse_vertex_attribute()
+     */
+    template <class T>
+    std::shared_ptr<SparseEdgeAttribute<T>> add_sparse_edge_attribute(
+        const std::string& name,
+        uint32_t           num_attributes,
+        locationT          location = LOCATION_ALL)
+    {
+        return m_attr_container->template add<SparseEdgeAttribute<T>>(
+            name.c_str(), num_attributes, location, AoS, this);
+    }
+
+    /**
+     * @brief Adding a new sparse face attribute. See
+     * add_sparse_vertex_attribute()
+     */
+    template <class T>
+    std::shared_ptr<SparseFaceAttribute<T>> add_sparse_face_attribute(
+        const std::string& name,
+        uint32_t           num_attributes,
+        locationT          location = LOCATION_ALL)
+    {
+        return m_attr_container->template add<SparseFaceAttribute<T>>(
+            name.c_str(), num_attributes, location, AoS, this);
+    }
+
     /**
      * @brief Adding a new vertex attribute by reading values from a host buffer
      * v_attributes where the order of vertices is the same as the order of
@@ -1220,8 +1366,7 @@ class RXMeshStatic : public RXMesh
 
         // populate the attribute before returning it
         const int num_patches = this->get_num_patches();
-#pragma omp parallel for
-        for (int p = 0; p < num_patches; ++p) {
+        this->m_host_schedule.run(num_patches, [&](uint32_t p) {
             for (uint16_t v = 0; v < this->m_h_num_owned_v[p]; ++v) {
 
                 const VertexHandle v_handle(static_cast<uint32_t>(p), v);
@@ -1232,7 +1377,7 @@ class RXMeshStatic : public RXMesh
                     (*ret)(v_handle, a) = v_attributes[global_v][a];
                 }
             }
-        }
+        });
 
         // move to device
         ret->move(rxmesh::HOST, rxmesh::DEVICE);
@@ -1280,8 +1425,7 @@ class RXMeshStatic : public RXMesh
 
         // populate the attribute before returning it
         const int num_patches = this->get_num_patches();
-#pragma omp parallel for
-        for (int p = 0; p < num_patches; ++p) {
+        this->m_host_schedule.run(num_patches, [&](uint32_t p) {
             for (uint16_t v = 0; v < this->m_h_num_owned_v[p]; ++v) {
 
                 const VertexHandle v_handle(static_cast<uint32_t>(p), v);
@@ -1290,7 +1434,7 @@ class RXMeshStatic : public RXMesh
 
                 (*ret)(v_handle, 0) = v_attributes[global_v];
             }
-        }
+        });
 
         // move to device
         ret->move(rxmesh::HOST, rxmesh::DEVICE);
@@ -1537,8 +1681,6 @@ class RXMeshStatic : public RXMesh
     template <typename HandleT>
     uint32_t linear_id(HandleT input) const
     {
-        using LocalT = typename HandleT::LocalT;
-
         if (!input.is_valid()) {
             RXMESH_ERROR("RXMeshStatic::linear_id() input handle is not valid");
         }
@@ -1550,25 +1692,131 @@ class RXMeshStatic : public RXMesh
                 input.patch_id());
         }
 
-        const HandleT owner_handle = get_owner_handle(input);
+        return this->template get_index_map<HandleT>().linear_id(input);
+    }
 
-        uint32_t p_id = owner_handle.patch_id();
-        uint16_t ret  = owner_handle.local_id();
+    /**
+     * @brief check if the local order of the elements of type HandleT matches
+     * their linear order, i.e., in every patch the owned elements are numbered
+     * first and none of them is deleted. In this case, linear_id() of an
+     * element is its patch prefix plus its local id so an attribute and a
+     * DenseMatrix store the elements of a patch in the same order. This holds
+     * for a mesh that is not modified after construction. The check is done
+     * once when the index map is built (see get_index_map())
+     */
+    template <typename HandleT>
+    bool is_row_ordered() const
+    {
+        return this->template get_index_map<HandleT>().is_row_ordered();
+    }
 
-        ret = this->m_h_patches_info[p_id].count_num_owned(
-            m_h_patches_info[p_id].get_owned_mask<HandleT>(),
-            m_h_patches_info[p_id].get_active_mask<HandleT>(),
-            ret);
+    /**
+     * @brief get the CSR pattern described by desc. The pattern is built on
+     * the host in parallel over patches the first time it is requested and
+     * cached for later requests with the same description
+     */
+    std::shared_ptr<const SparsePattern> get_sparse_pattern(
+        const SparsePatternDesc& desc) const
+    {
+        return m_sparse_pattern_cache.get(*this, desc);
+    }
 
-        if constexpr (std::is_same_v<HandleT, VertexHandle>) {
-            return ret + m_h_vertex_prefix[p_id];
-        }
-        if constexpr (std::is_same_v<HandleT, EdgeHandle>) {
-            return ret + m_h_edge_prefix[p_id];
+    /**
+     * @brief the cache of the sparse patterns built for this mesh
+     */
+    SparsePatternCache& get_sparse_pattern_cache() const
+    {
+        return m_sparse_pattern_cache;
+    }
+
+    /**
+     * @brief the super-patch of every element of type HandleT indexed by its
+     * linear_id(), i.e., the aggregates a coarse solver or preconditioner
+     * can use as its coarse unknowns (see aggregation_prolongation())
+     * @param patches_per_super the target number of patches per super-patch
+     */
+    template <typename HandleT>
+    std::vector<uint32_t> get_super_patch_aggregates(
+        const uint32_t patches_per_super = 8)
+    {
+        const SuperPatches& sp = this->get_super_patches(patches_per_super);
+
+        std::vector<uint32_t> ret(this->template get_num_elements<HandleT>(),
+                                  INVALID32);
+        for_each<HandleT>(HOST, [&](const HandleT h) {
+            ret[linear_id(h)] = sp.get_super_patch(h);
+        });
+        return ret;
+    }
+
+    /**
+     * @brief compute the k-ring of every element of type HandleT on the host
+     * (and upload it to the device if requested). The caller owns the result
+     * and should call release() on it. See KRing
+     * @param rings the number of rings (k)
+     * @param location where the result should be available
+     */
+    template <typename HandleT>
+    KRing<HandleT> compute_k_ring(const uint32_t rings,
+                                  locationT      location = LOCATION_ALL) const
+    {
+        return KRing<HandleT>(*this, rings, location);
+    }
+
+    /**
+     * @brief the cached oriented one-ring (Op::VV, Op::VE, and Op::VF) of every
+     * vertex. It is built on the host on the first request and uploaded to the
+     * device on the first DEVICE request. The cache is dropped when the
+     * topology changes (see RXMeshDynamic::update_host()) and rebuilt lazily.
+     * The returned object can be captured by value in host and device
+     * lambdas and is valid as long as the returned pointer is alive. See
+     * OrientedOneRing
+     * @param location where the one-ring should be available
+     */
+    std::shared_ptr<const OrientedOneRing> get_oriented_one_ring(
+        locationT location = HOST) const
+    {
+        std::lock_guard<std::mutex> lock(m_oriented_one_ring_mutex);
+        if (!m_oriented_one_ring) {
+            m_oriented_one_ring = std::shared_ptr<OrientedOneRing>(
+                new OrientedOneRing(*this, HOST), [](OrientedOneRing* ring) {
+                    ring->release();
+                    delete ring;
+                });
         }
-        if constexpr (std::is_same_v<HandleT, FaceHandle>) {
-            return ret + m_h_face_prefix[p_id];
+        if ((location & DEVICE) == DEVICE &&
+            !m_oriented_one_ring->is_device_allocated()) {
+            m_oriented_one_ring->move(HOST, DEVICE);
         }
+        return m_oriented_one_ring;
+    }
+
+    /**
+     * @brief run an oriented query on the host using the cached oriented
+     * one-ring (see get_oriented_one_ring()). Iterating over the oriented
+     * output costs the same as an unoriented query
+     * @tparam op the query operation. Should be Op::VV, Op::VE, or Op::VF
+     * @param apply lambda function that takes a VertexHandle and an iterator
+     * over the oriented output i.e., OneRingIterator of Vertex/Edge/FaceHandle
+     * @param with_omp use OpenMP where each patch is assigned to a thread
+     */
+    template <Op op, typename LambdaT>
+    void for_each_oriented(LambdaT apply, bool with_omp = true) const
+    {
+        static_assert(op == Op::VV || op == Op::VE || op == Op::VF,
+                      "RXMeshStatic::for_each_oriented() only supports "
+                      "Op::VV, Op::VE, and Op::VF");
+
+        std::shared_ptr<const OrientedOneRing> ring =
+            get_oriented_one_ring(HOST);
+
+        for_each_vertex(
+            HOST,
+            [&](const VertexHandle vh) {
+                apply(vh, ring->template get<op>(vh));
+            },
+            NULL,
+            with_omp);
     }
 
     /**
@@ -1592,6 +1840,7 @@ class RXMeshStatic : public RXMesh
     void export_obj(const std::string&        filename,
                     const VertexAttribute<T>& coords) const
     {
+        RXMESH_ZONE("RXMeshStatic::export_obj");
         std::string  fn = filename;
         std::fstream file(fn, std::ios::out);
         file.precision(30);
@@ -1634,6 +1883,7 @@ class RXMeshStatic : public RXMesh
                     const VertexAttribute<T>& coords,
                     AttributesT... attributes) const
     {
+        RXMESH_ZONE("RXMeshStatic::export_vtk");
         std::string  fn = filename;
         std::fstream file(fn, std::ios::out);
         file.precision(30);
@@ -1687,10 +1937,11 @@ class RXMeshStatic : public RXMesh
                             const VertexAttribute<T>& coords) const
     {
         v_list.resize(get_num_vertices());
+        const IndexMap<VertexHandle>& v_map = get_index_map<VertexHandle>();
         for_each_vertex(
             HOST,
             [&](const VertexHandle vh) {
-                uint32_t vid   = linear_id(vh);
+                uint32_t vid   = v_map.linear_id(vh);
                 v_list[vid][0] = coords(vh, 0);
                 v_list[vid][1] = coords(vh, 1);
                 v_list[vid][2] = coords(vh, 2);
@@ -1704,36 +1955,67 @@ class RXMeshStatic : public RXMesh
      */
     void create_face_list(std::vector<glm::uvec3>& f_list) const
     {
-        f_list.reserve(get_num_faces());
+        f_list.resize(get_num_faces());
 
-        for (uint32_t p = 0; p < this->m_num_patches; ++p) {
-            const uint32_t p_num_faces = this->m_h_patches_info[p].num_faces[0];
-            for (uint32_t f = 0; f < p_num_faces; ++f) {
-                if (!detail::is_deleted(
-                        f, this->m_h_patches_info[p].active_mask_f) &&
-                    detail::is_owned(f,
-                                     this->m_h_patches_info[p].owned_mask_f)) {
-
-                    glm::uvec3 face;
-
-                    for (uint32_t e = 0; e < 3; ++e) {
-                        uint16_t edge =
-                            this->m_h_patches_info[p].fe[3 * f + e].id;
-                        flag_t dir(0);
-                        Context::unpack_edge_dir(edge, edge, dir);
-                        uint16_t     e_id = (2 * edge) + dir;
-                        uint16_t     v = this->m_h_patches_info[p].ev[e_id].id;
-                        VertexHandle vh(p, v);
-                        uint32_t     vid = linear_id(vh);
-                        face[e]          = vid;
-                    }
-                    f_list.push_back(face);
-                }
+        const IndexMap<VertexHandle>& v_map = get_index_map<VertexHandle>();
+        const IndexMap<FaceHandle>&   f_map = get_index_map<FaceHandle>();
+
+        for_each_face(HOST, [&](const FaceHandle fh) {
+            const uint32_t   p  = fh.patch_id();
+            const uint16_t   f  = fh.local_id();
+            const PatchInfo& pi = this->m_h_patches_info[p];
+
+            glm::uvec3 face;
+
+            for (uint32_t e = 0; e < 3; ++e) {
+                uint16_t edge = pi.fe[3 * f + e].id;
+                flag_t   dir(0);
+                Context::unpack_edge_dir(edge, edge, dir);
+                uint16_t e_id = (2 * edge) + dir;
+                uint16_t v    = pi.ev[e_id].id;
+                face[e]       = v_map.linear_id(VertexHandle(p, v));
             }
-        }
+            f_list[f_map.linear_id(fh)] = face;
+        });
     }
 
    protected:
+    /**
+     * @brief run a host per-patch function on all patches. The function takes
+     * the patch id and returns the number of mesh elements it visited. If
+     * patch stats is enabled, the number of visited elements and the time
+     * spent on each patch are recorded
+     */
+    template <typename RunT>
+    void run_host_patches(const int  num_patches,
+                          const bool with_omp,
+                          RunT       run) const
+    {
+        PatchStats* stats = this->m_patch_stats.get();
+
+        auto run_patch = [&](int p) {
+            if (stats == nullptr) {
+                run(p);
+            } else {
+                CPUTimer timer;
+                timer.start();
+                const uint32_t num_visited = run(p);
+                timer.stop();
+                stats->add(PatchCounter::Visited, p, num_visited);
+                stats->add_host_time(p, timer.elapsed_millis());
+            }
+        };
+
+        if (!with_omp) {
+            for (int p = 0; p < num_patches; ++p) {
+                run_patch(p);
+            }
+        } else {
+            this->m_host_schedule.run(num_patches,
+                                      [&](uint32_t p) { run_patch(p); });
+        }
+    }
+
     template <typename AttributeT>
     void export_vtk(std::fstream&     file,
                     bool&             first_v_attr,
@@ -2335,5 +2617,10 @@ class RXMeshStatic : public RXMesh
 
     std::shared_ptr<AttributeContainer>     m_attr_container;
     std::shared_ptr<VertexAttribute<float>> m_input_vertex_coordinates;
+
+    mutable SparsePatternCache m_sparse_pattern_cache;
+
+    mutable std::shared_ptr<OrientedOneRing> m_oriented_one_ring;
+    mutable std::mutex                       m_oriented_one_ring_mutex;
 };
 }  // namespace rxmesh
\ No newline at end of file
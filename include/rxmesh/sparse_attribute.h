@@ -0,0 +1,651 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+
+#include "rxmesh/attribute.h"
+#include "rxmesh/handle.h"
+#include "rxmesh/kernels/util.cuh"
+#include "rxmesh/types.h"
+#include "rxmesh/util/bitmask_util.h"
+#include "rxmesh/util/log.h"
+#include "rxmesh/util/macros.h"
+#include "rxmesh/util/meta.h"
+
+namespace rxmesh {
+
+namespace detail {
+
+/**
+ * @brief host storage of one patch of a SparseAttribute. The value of the k-th
+ * present element (in local order) starts at values[k * num_attributes]
+ */
+template <typename T>
+struct SparsePatch
+{
+    // one bit per local id
+    std::vector<uint32_t> mask;
+    // number of set bits in the words before each word
+    std::vector<uint16_t> prefix;
+    // packed values of the present elements
+    std::vector<T> values;
+
+    uint32_t rank(const uint16_t local_id) const
+    {
+        const uint32_t w   = local_id / 32;
+        const uint32_t low = (uint32_t(1) << (local_id % 32)) - 1;
+        return prefix[w] + popc(mask[w] & low);
+    }
+
+    uint32_t num_present() const
+    {
+        return mask.empty() ? 0 : prefix.back() + popc(mask.back());
+    }
+};
+
+template <typename HandleT, typename LambdaT>
+__global__ void for_each_sparse(const uint32_t  num_patches,
+                                const uint32_t* word_offset,
+                                const uint32_t* mask,
+                                LambdaT         apply)
+{
+    using LocalT = typename HandleT::LocalT;
+
+    const uint32_t p = blockIdx.x;
+    if (p < num_patches) {
+        const uint32_t start = word_offset[p];
+        const uint32_t end   = word_offset[p + 1];
+        for (uint32_t w = start + threadIdx.x; w < end; w += blockDim.x) {
+            uint32_t m = mask[w];
+            while (m != 0) {
+                const uint32_t bit = __ffs(m) - 1;
+                m &= m - 1;
+                apply(HandleT(p, LocalT((w - start) * 32 + bit)));
+            }
+        }
+    }
+}
+}  // namespace detail
+
+/**
+ * @brief attribute defined only on a subset of the mesh elements e.g.,
+ * boundary tags, constraint handles, or geodesic seeds. Every patch stores a
+ * presence bitmask (one bit per element) and the values of the present
+ * elements packed in local order, so memory and iteration scale with the size
+ * of the subset. Accessing a present element costs one popc on the mask word.
+ * Elements are inserted and erased on the host. move(HOST, DEVICE) uploads the
+ * presence and the values; on the device, values can be read and written but
+ * the set of present elements is fixed. move(DEVICE, HOST) only copies the
+ * values back. Values are stored as AoS
+ * @tparam T type of the attribute
+ * @tparam HandleT handle of the mesh element the attribute is defined on
+ */
+template <class T, typename HandleT>
+class SparseAttribute : public AttributeBase
+{
+    static_assert(!std::is_same_v<T, bool>,
+                  "SparseAttribute<bool> is not supported since the presence "
+                  "bitmask already tags the elements. Use uint8_t instead");
+
+   public:
+    using HandleType = HandleT;
+    using Type       = T;
+    using LocalT     = typename HandleT::LocalT;
+
+    /**
+     * @brief Default constructor which initializes all pointers to nullptr
+     */
+    SparseAttribute()
+        : AttributeBase(),
+          m_rxmesh(nullptr),
+          m_name(nullptr),
+          m_num_attributes(0),
+          m_num_patches(0),
+          m_allocated(LOCATION_NONE),
+          m_h_patch(nullptr),
+          m_d_word_offset(nullptr),
+          m_d_mask(nullptr),
+          m_d_prefix(nullptr),
+          m_d_values(nullptr),
+          m_d_num_words(0),
+          m_d_num_present(0),
+          m_h_epoch(0),
+          m_d_epoch(0)
+    {
+        this->m_name    = (char*)malloc(sizeof(char) * 1);
+        this->m_name[0] = '\0';
+    }
+
+    /**
+     * @brief Main constructor to be used by RXMeshStatic not directly by the
+     * user. The attribute starts with no present element
+     * @param name of the attribute
+     * @param num_attributes number of attributes per present element
+     * @param location where the attribute to be allocated
+     * @param layout ignored. Values are always AoS
+     * @param rxmesh the mesh the attribute is defined on
+     */
+    explicit SparseAttribute(const char*    name,
+                             const uint32_t num_attributes,
+                             locationT      location,
+                             const layoutT  layout,
+                             RXMeshStatic*  rxmesh)
+        : AttributeBase(),
+          m_rxmesh(rxmesh),
+          m_name(nullptr),
+          m_num_attributes(num_attributes),
+          m_num_patches(rxmesh->get_num_patches()),
+          m_allocated(LOCATION_NONE),
+          m_h_patch(nullptr),
+          m_d_word_offset(nullptr),
+          m_d_mask(nullptr),
+          m_d_prefix(nullptr),
+          m_d_values(nullptr),
+          m_d_num_words(0),
+          m_d_num_present(0),
+          m_h_epoch(0),
+          m_d_epoch(0)
+    {
+        if (layout != AoS) {
+            RXMESH_WARN(
+                "SparseAttribute::SparseAttribute() {} values are always "
+                "stored as AoS",
+                std::string(name));
+        }
+
+        if (name != nullptr) {
+            this->m_name = (char*)malloc(sizeof(char) * (strlen(name) + 1));
+            strcpy(this->m_name, name);
+        }
+
+        allocate(location);
+    }
+
+    SparseAttribute(const SparseAttribute& rhs) = default;
+
+    virtual ~SparseAttribute() = default;
+
+    /**
+     * @brief get the attribute name
+     */
+    const char* get_name() const
+    {
+        return m_name;
+    }
+
+    /**
+     * @brief get the number of attributes per present element
+     */
+    __host__ __device__ __forceinline__ uint32_t get_num_attributes() const
+    {
+        return m_num_attributes;
+    }
+
+    /**
+     * @brief check if attribute is allocated on host
+     */
+    bool is_host_allocated() const
+    {
+        return (m_allocated & HOST) == HOST;
+    }
+
+    /**
+     * @brief check if attribute is allocated on device
+     */
+    bool is_device_allocated() const
+    {
+        return (m_allocated & DEVICE) == DEVICE;
+    }
+
+    /**
+     * @brief check if an element has a value
+     */
+    __host__ __device__ __forceinline__ bool has(const HandleT handle) const
+    {
+        const uint32_t p = handle.patch_id();
+        const uint16_t l = handle.local_id();
+        assert(p < m_num_patches);
+#ifdef __CUDA_ARCH__
+        return detail::is_set_bit(l, m_d_mask + m_d_word_offset[p]);
+#else
+        return detail::is_set_bit(l, m_h_patch[p].mask.data());
+#endif
+    }
+
+    /**
+     * @brief Accessing the value of a present element
+     * @param handle input handle. has(handle) should be true
+     * @param attr the attribute id
+     * @return reference to the attribute
+     */
+    __host__ __device__ __forceinline__ T& operator()(
+        const HandleT  handle,
+        const uint32_t attr = 0) const
+    {
+        assert(has(handle));
+        assert(attr < m_num_attributes);
+
+        const uint32_t p = handle.patch_id();
+        const uint16_t l = handle.local_id();
+#ifdef __CUDA_ARCH__
+        const uint32_t  w    = l / 32;
+        const uint32_t  low  = (uint32_t(1) << (l % 32)) - 1;
+        const uint32_t* mask = m_d_mask + m_d_word_offset[p];
+        const uint32_t  k =
+            m_d_prefix[m_d_word_offset[p] + w] + detail::popc(mask[w] & low);
+        return m_d_values[k * m_num_attributes + attr];
+#else
+        return m_h_patch[p].values[m_h_patch[p].rank(l) * m_num_attributes +
+                                   attr];
+#endif
+    }
+
+    /**
+     * @brief read the value of an element or default_val if it is not present
+     */
+    __host__ __device__ __forceinline__ T get(const HandleT  handle,
+                                              const uint32_t attr,
+                                              const T        default_val) const
+    {
+        return has(handle) ? this->operator()(handle, attr) : default_val;
+    }
+
+    /**
+     * @brief add an element to the subset (on the host) with all its
+     * attributes set to value. If the element is already present, its values
+     * are not changed
+     * @return true if the element was not present before
+     */
+    bool insert(const HandleT handle, const T value = T(0))
+    {
+        if (!is_host_allocated()) {
+            RXMESH_ERROR(
+                "SparseAttribute::insert() {} is not allocated on host",
+                std::string(m_name));
+            return false;
+        }
+        const uint32_t p = handle.patch_id();
+        const uint16_t l = handle.local_id();
+        assert(p < m_num_patches);
+
+        detail::SparsePatch<T>& patch = m_h_patch[p];
+
+        if (detail::is_set_bit(l, patch.mask.data())) {
+            return false;
+        }
+        const uint32_t k = patch.rank(l);
+
+        detail::bitmask_set_bit(l, patch.mask.data());
+        for (size_t w = l / 32 + 1; w < patch.prefix.size(); ++w) {
+            patch.prefix[w]++;
+        }
+        patch.values.insert(patch.values.begin() + k * m_num_attributes,
+                            m_num_attributes,
+                            value);
+        m_h_epoch++;
+        return true;
+    }
+
+    /**
+     * @brief remove an element from the subset (on the host)
+     * @return true if the element was present
+     */
+    bool erase(const HandleT handle)
+    {
+        if (!is_host_allocated()) {
+            RXMESH_ERROR(
+                "SparseAttribute::erase() {} is not allocated on host",
+                std::string(m_name));
+            return false;
+        }
+        const uint32_t p = handle.patch_id();
+        const uint16_t l = handle.local_id();
+        assert(p < m_num_patches);
+
+        detail::SparsePatch<T>& patch = m_h_patch[p];
+
+        if (!detail::is_set_bit(l, patch.mask.data())) {
+            return false;
+        }
+        const uint32_t k = patch.rank(l);
+
+        detail::bitmask_clear_bit(l, patch.mask.data());
+        for (size_t w = l / 32 + 1; w < patch.prefix.size(); ++w) {
+            patch.prefix[w]--;
+        }
+        auto first = patch.values.begin() + k * m_num_attributes;
+        patch.values.erase(first, first + m_num_attributes);
+        m_h_epoch++;
+        return true;
+    }
+
+    /**
+     * @brief remove all elements from the subset (on the host)
+     */
+    void clear()
+    {
+        if (!is_host_allocated()) {
+            return;
+        }
+        for (uint32_t p = 0; p < m_num_patches; ++p) {
+            std::fill(m_h_patch[p].mask.begin(), m_h_patch[p].mask.end(), 0);
+            std::fill(
+                m_h_patch[p].prefix.begin(), m_h_patch[p].prefix.end(), 0);
+            m_h_patch[p].values.clear();
+        }
+        m_h_epoch++;
+    }
+
+    /**
+     * @brief set all attributes of all present elements to value
+     */
+    void reset(const T value, locationT location, cudaStream_t stream = NULL)
+    {
+        if ((location & HOST) == HOST && is_host_allocated()) {
+            for (uint32_t p = 0; p < m_num_patches; ++p) {
+                std::fill(m_h_patch[p].values.begin(),
+                          m_h_patch[p].values.end(),
+                          value);
+            }
+        }
+
+        if ((location & DEVICE) == DEVICE && is_device_allocated() &&
+            m_d_num_present > 0) {
+            const uint32_t n       = m_d_num_present * m_num_attributes;
+            const uint32_t threads = 256;
+            const uint32_t blocks  = DIVIDE_UP(n, threads);
+            rxmesh::memset<<<blocks, threads, 0, stream>>>(
+                m_d_values, value, n);
+        }
+    }
+
+    /**
+     * @brief number of present elements in a patch (on the host)
+     */
+    uint32_t size(const uint32_t p) const
+    {
+        assert(p < m_num_patches);
+        return m_h_patch[p].num_present();
+    }
+
+    /**
+     * @brief total number of present elements (on the host)
+     */
+    uint32_t size() const
+    {
+        uint32_t ret = 0;
+        for (uint32_t p = 0; p < m_num_patches; ++p) {
+            ret += size(p);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief the memory used on the host to store the subset and its values
+     */
+    size_t host_bytes() const
+    {
+        size_t ret = 0;
+        for (uint32_t p = 0; p < m_num_patches; ++p) {
+            ret += m_h_patch[p].mask.size() * sizeof(uint32_t) +
+                   m_h_patch[p].prefix.size() * sizeof(uint16_t) +
+                   m_h_patch[p].values.size() * sizeof(T);
+        }
+        return ret;
+    }
+
+    /**
+     * @brief apply a lambda function on the present elements only
+     * @param location the execution location. Device iteration uses the
+     * subset uploaded by the last move(HOST, DEVICE)
+     * @param apply lambda function that takes a HandleT
+     * @param stream the stream used to run the kernel in case of DEVICE
+     */
+    template <typename LambdaT>
+    void for_each(locationT location, LambdaT apply, cudaStream_t stream = NULL)
+    {
+        if ((location & HOST) == HOST) {
+            m_rxmesh->get_host_schedule().run(m_num_patches, [&](uint32_t p) {
+                const std::vector<uint32_t>& mask = m_h_patch[p].mask;
+                for (uint32_t w = 0; w < mask.size(); ++w) {
+                    uint32_t m = mask[w];
+                    while (m != 0) {
+                        const uint32_t bit = detail::popc((m & (~m + 1)) - 1);
+                        m &= m - 1;
+                        apply(HandleT(p, LocalT(w * 32 + bit)));
+                    }
+                }
+            });
+        }
+
+        if ((location & DEVICE) == DEVICE) {
+            if constexpr (IS_HD_LAMBDA(LambdaT) || IS_D_LAMBDA(LambdaT)) {
+                if (!is_device_allocated()) {
+                    RXMESH_ERROR(
+                        "SparseAttribute::for_each() {} is not allocated on "
+                        "device",
+                        std::string(m_name));
+                    return;
+                }
+                const uint32_t threads = 256;
+                detail::for_each_sparse<HandleT>
+                    <<<m_num_patches, threads, 0, stream>>>(
+                        m_num_patches, m_d_word_offset, m_d_mask, apply);
+            } else {
+                RXMESH_ERROR(
+                    "SparseAttribute::for_each() Input lambda function "
+                    "should be annotated with  __device__ for execution on "
+                    "device");
+            }
+        }
+    }
+
+    /**
+     * @brief copy from one location to another. HOST to DEVICE uploads the
+     * presence and values (re-allocating the device buffers to the current
+     * subset size). DEVICE to HOST copies the values back and is rejected if
+     * the subset changed on the host (insert(), erase(), or clear()) since
+     * the last HOST to DEVICE
+     * @param source the source location
+     * @param target the destination location
+     * @param stream to be used for the copies
+     */
+    void move(locationT source, locationT target, cudaStream_t stream = NULL)
+    {
+        if (source == target) {
+            RXMESH_WARN(
+                "SparseAttribute::move() source ({}) and target ({}) "
+                "are the same.",
+                location_to_string(source),
+                location_to_string(target));
+            return;
+        }
+
+        if (!is_host_allocated()) {
+            RXMESH_ERROR(
+                "SparseAttribute::move() {} is not allocated on host",
+                std::string(m_name));
+            return;
+        }
+
+        // flatten the patches
+        std::vector<uint32_t> word_offset(m_num_patches + 1, 0);
+        std::vector<uint32_t> value_offset(m_num_patches + 1, 0);
+        for (uint32_t p = 0; p < m_num_patches; ++p) {
+            word_offset[p + 1] =
+                word_offset[p] + uint32_t(m_h_patch[p].mask.size());
+            value_offset[p + 1] =
+                value_offset[p] + uint32_t(m_h_patch[p].values.size());
+        }
+
+        if (source == HOST && target == DEVICE) {
+            std::vector<uint32_t> mask(word_offset.back());
+            std::vector<uint32_t> prefix(word_offset.back());
+            std::vector<T>        values(value_offset.back());
+            for (uint32_t p = 0; p < m_num_patches; ++p) {
+                const detail::SparsePatch<T>& patch = m_h_patch[p];
+                for (size_t w = 0; w < patch.mask.size(); ++w) {
+                    mask[word_offset[p] + w] = patch.mask[w];
+                    prefix[word_offset[p] + w] =
+                        value_offset[p] / m_num_attributes + patch.prefix[w];
+                }
+                std::copy(patch.values.begin(),
+                          patch.values.end(),
+                          values.begin() + value_offset[p]);
+            }
+
+            allocate_device(word_offset.back(),
+                            value_offset.back() / m_num_attributes);
+
+            CUDA_ERROR(cudaMemcpy(m_d_word_offset,
+                                  word_offset.data(),
+                                  word_offset.size() * sizeof(uint32_t),
+                                  cudaMemcpyHostToDevice));
+            CUDA_ERROR(cudaMemcpy(m_d_mask,
+                                  mask.data(),
+                                  mask.size() * sizeof(uint32_t),
+                                  cudaMemcpyHostToDevice));
+            CUDA_ERROR(cudaMemcpy(m_d_prefix,
+                                  prefix.data(),
+                                  prefix.size() * sizeof(uint32_t),
+                                  cudaMemcpyHostToDevice));
+            if (!values.empty()) {
+                CUDA_ERROR(cudaMemcpyAsync(m_d_values,
+                                           values.data(),
+                                           values.size() * sizeof(T),
+                                           cudaMemcpyHostToDevice,
+                                           stream));
+                CUDA_ERROR(cudaStreamSynchronize(stream));
+            }
+            m_d_epoch = m_h_epoch;
+        } else if (source == DEVICE && target == HOST) {
+            if (!is_device_allocated()) {
+                RXMESH_ERROR(
+                    "SparseAttribute::move() {} is not allocated on device",
+                    std::string(m_name));
+                return;
+            }
+            if (m_d_epoch != m_h_epoch) {
+                RXMESH_ERROR(
+                    "SparseAttribute::move() the subset of {} changed on the "
+                    "host since the last move(HOST, DEVICE)",
+                    std::string(m_name));
+                return;
+            }
+            std::vector<T> values(value_offset.back());
+            if (!values.empty()) {
+                CUDA_ERROR(cudaMemcpyAsync(values.data(),
+                                           m_d_values,
+                                           values.size() * sizeof(T),
+                                           cudaMemcpyDeviceToHost,
+                                           stream));
+                CUDA_ERROR(cudaStreamSynchronize(stream));
+            }
+            for (uint32_t p = 0; p < m_num_patches; ++p) {
+                std::copy(values.begin() + value_offset[p],
+                          values.begin() + value_offset[p + 1],
+                          m_h_patch[p].values.begin());
+            }
+        }
+    }
+
+    /**
+     * @brief Release allocated memory in certain location
+     * @param location where memory will be released
+     */
+    void release(locationT location = LOCATION_ALL)
+    {
+        if (((location & HOST) == HOST) && is_host_allocated()) {
+            delete[] m_h_patch;
+            m_h_patch   = nullptr;
+            m_allocated = m_allocated & (~HOST);
+        }
+
+        if (((location & DEVICE) == DEVICE) && is_device_allocated()) {
+            GPU_FREE(m_d_word_offset);
+            GPU_FREE(m_d_mask);
+            GPU_FREE(m_d_prefix);
+            GPU_FREE(m_d_values);
+            m_d_num_words   = 0;
+            m_d_num_present = 0;
+            m_allocated     = m_allocated & (~DEVICE);
+        }
+    }
+
+   private:
+    void allocate(locationT location)
+    {
+        if ((location & HOST) == HOST) {
+            release(HOST);
+            m_h_patch = new detail::SparsePatch<T>[m_num_patches];
+            for (uint32_t p = 0; p < m_num_patches; ++p) {
+                const uint16_t cap =
+                    m_rxmesh->get_patch(p).template get_capacity<HandleT>()[0];
+                m_h_patch[p].mask.assign(DIVIDE_UP(cap, 32), 0);
+                m_h_patch[p].prefix.assign(DIVIDE_UP(cap, 32), 0);
+            }
+            m_allocated = m_allocated | HOST;
+        }
+
+        if ((location & DEVICE) == DEVICE) {
+            // the device buffers are sized by the subset on move(HOST, DEVICE)
+            allocate_device(0, 0);
+        }
+    }
+
+    void allocate_device(const uint32_t num_words, const uint32_t num_present)
+    {
+        if (is_device_allocated() && num_words == m_d_num_words &&
+            num_present == m_d_num_present) {
+            return;
+        }
+        release(DEVICE);
+        CUDA_ERROR(cudaMalloc((void**)&m_d_word_offset,
+                              (m_num_patches + 1) * sizeof(uint32_t)));
+        CUDA_ERROR(cudaMemset(
+            m_d_word_offset, 0, (m_num_patches + 1) * sizeof(uint32_t)));
+        if (num_words > 0) {
+            CUDA_ERROR(
+                cudaMalloc((void**)&m_d_mask, num_words * sizeof(uint32_t)));
+            CUDA_ERROR(
+                cudaMalloc((void**)&m_d_prefix, num_words * sizeof(uint32_t)));
+        }
+        if (num_present > 0) {
+            CUDA_ERROR(cudaMalloc((void**)&m_d_values,
+                                  num_present * m_num_attributes * sizeof(T)));
+        }
+        m_d_num_words   = num_words;
+        m_d_num_present = num_present;
+        m_allocated     = m_allocated | DEVICE;
+    }
+
+    RXMeshStatic*           m_rxmesh;
+    char*                   m_name;
+    uint32_t                m_num_attributes;
+    uint32_t                m_num_patches;
+    locationT               m_allocated;
+    detail::SparsePatch<T>* m_h_patch;
+    uint32_t*               m_d_word_offset;
+    uint32_t*               m_d_mask;
+    uint32_t*               m_d_prefix;
+    T*                      m_d_values;
+    uint32_t                m_d_num_words;
+    uint32_t                m_d_num_present;
+    // bumped by every change of the subset on the host. m_d_epoch is the host
+    // epoch uploaded by the last move(HOST, DEVICE)
+    uint64_t m_h_epoch;
+    uint64_t m_d_epoch;
+};
+
+template <class T>
+using SparseVertexAttribute = SparseAttribute<T, VertexHandle>;
+
+template <class T>
+using SparseEdgeAttribute = SparseAttribute<T, EdgeHandle>;
+
+template <class T>
+using SparseFaceAttribute = SparseAttribute<T, FaceHandle>;
+
+}  // namespace rxmesh
@@ -0,0 +1,506 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+#include <vector>
+
+#include <omp.h>
+
+#include "rxmesh/context.h"
+#include "rxmesh/handle.h"
+#include "rxmesh/patch_info.h"
+#include "rxmesh/util/log.h"
+#include "rxmesh/util/macros.h"
+
+namespace rxmesh {
+
+/**
+ * @brief a second partition level that groups neighbor patches into
+ * super-patches. Stores the super-patch of every patch, the patches of every
+ * super-patch (as CSR, listed in the order they were grown), and the weighted
+ * super-patch adjacency graph. Two patches are adjacent if one has ribbon
+ * faces owned by the other and the weight is the number of such faces.
+ *
+ * Super-patches are grown greedily from seeds taken in breadth-first order of
+ * the patch graph. A super-patch absorbs the neighbor patch with the heaviest
+ * connection to it until it reaches the target size. Single leftover patches
+ * are merged into their heaviest neighbor super-patch. Super-patch ids follow
+ * the growth order so consecutive super-patches are spatially close, which is
+ * what the host schedule (see HostExecutionPolicy::super_patch_size) and
+ * partition() rely on
+ */
+class SuperPatches
+{
+   public:
+    SuperPatches() : m_patches_per_super(0), m_built(false)
+    {
+    }
+
+    /**
+     * @brief build the super-patches
+     * @param num_patches number of patches
+     * @param patches_info the host patches
+     * @param context the mesh context used to find the owner of ribbon faces
+     * @param patches_per_super the target number of patches per super-patch
+     */
+    void build(const uint32_t   num_patches,
+               const PatchInfo* patches_info,
+               const Context&   context,
+               const uint32_t   patches_per_super)
+    {
+        m_patches_per_super = std::max<uint32_t>(1, patches_per_super);
+
+        build_patch_graph(num_patches, patches_info, context);
+
+        // breadth-first order of the patch graph (all components)
+        std::vector<uint32_t> order;
+        order.reserve(num_patches);
+        std::vector<uint8_t> visited(num_patches, 0);
+        for (uint32_t root = 0; root < num_patches; ++root) {
+            if (visited[root]) {
+                continue;
+            }
+            visited[root] = 1;
+            order.push_back(root);
+            for (size_t i = order.size() - 1; i < order.size(); ++i) {
+                const uint32_t p = order[i];
+                for (uint32_t j = m_patch_adj_offset[p];
+                     j < m_patch_adj_offset[p + 1];
+                     ++j) {
+                    const uint32_t q = m_patch_adj[j];
+                    if (!visited[q]) {
+                        visited[q] = 1;
+                        order.push_back(q);
+                    }
+                }
+            }
+        }
+
+        // grow the super-patches
+        std::vector<std::vector<uint32_t>> groups;
+        std::vector<uint32_t>              group(num_patches, INVALID32);
+        std::vector<uint32_t>              gain(num_patches, 0);
+        std::vector<uint32_t>              candidates;
+
+        for (const uint32_t seed : order) {
+            if (group[seed] != INVALID32) {
+                continue;
+            }
+            const uint32_t        s = uint32_t(groups.size());
+            std::vector<uint32_t> members;
+            candidates.clear();
+
+            auto add = [&](const uint32_t p) {
+                group[p] = s;
+                members.push_back(p);
+                for (uint32_t j = m_patch_adj_offset[p];
+                     j < m_patch_adj_offset[p + 1];
+                     ++j) {
+                    const uint32_t q = m_patch_adj[j];
+                    if (group[q] != INVALID32) {
+                        continue;
+                    }
+                    if (gain[q] == 0) {
+                        candidates.push_back(q);
+                    }
+                    gain[q] += m_patch_adj_weight[j];
+                }
+            };
+
+            add(seed);
+            while (members.size() < m_patches_per_super) {
+                uint32_t best = INVALID32;
+                for (const uint32_t c : candidates) {
+                    if (group[c] == INVALID32 &&
+                        (best == INVALID32 || gain[c] > gain[best] ||
+                         (gain[c] == gain[best] && c < best))) {
+                        best = c;
+                    }
+                }
+                if (best == INVALID32) {
+                    break;
+                }
+                add(best);
+            }
+            for (const uint32_t c : candidates) {
+                gain[c] = 0;
+            }
+            groups.push_back(std::move(members));
+        }
+
+        // merge single leftover patches into the heaviest neighbor group
+        if (m_patches_per_super > 1) {
+            for (uint32_t s = 0; s < groups.size(); ++s) {
+                if (groups[s].size() != 1) {
+                    continue;
+                }
+                const uint32_t p    = groups[s][0];
+                uint32_t       best = INVALID32, best_w = 0;
+                for (uint32_t j = m_patch_adj_offset[p];
+                     j < m_patch_adj_offset[p + 1];
+                     ++j) {
+                    const uint32_t g = group[m_patch_adj[j]];
+                    if (groups[g].size() > 1 &&
+                        m_patch_adj_weight[j] > best_w) {
+                        best   = g;
+                        best_w = m_patch_adj_weight[j];
+                    }
+                }
+                if (best != INVALID32) {
+                    groups[best].push_back(p);
+                    groups[s].clear();
+                    group[p] = best;
+                }
+            }
+        }
+
+        // compact
+        m_super_offset.assign(1, 0);
+        m_super_patches.clear();
+        m_super_patches.reserve(num_patches);
+        m_patch_super.assign(num_patches, INVALID32);
+        for (const auto& g : groups) {
+            if (g.empty()) {
+                continue;
+            }
+            const uint32_t s = uint32_t(m_super_offset.size() - 1);
+            for (const uint32_t p : g) {
+                m_patch_super[p] = s;
+                m_super_patches.push_back(p);
+            }
+            m_super_offset.push_back(uint32_t(m_super_patches.size()));
+        }
+
+        build_super_graph();
+
+        m_built.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief release the tables. They are rebuilt on the next request
+     */
+    void clear()
+    {
+        m_patch_adj_offset.clear();
+        m_patch_adj.clear();
+        m_patch_adj_weight.clear();
+        m_patch_super.clear();
+        m_super_offset.clear();
+        m_super_patches.clear();
+        m_adj_offset.clear();
+        m_adj.clear();
+        m_adj_weight.clear();
+        m_built.store(false, std::memory_order_release);
+    }
+
+    bool is_built() const
+    {
+        return m_built.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief the target number of patches per super-patch used in build()
+     */
+    uint32_t get_patches_per_super() const
+    {
+        return m_patches_per_super;
+    }
+
+    /**
+     * @brief number of super-patches
+     */
+    uint32_t get_num_super_patches() const
+    {
+        return m_super_offset.empty() ? 0 :
+                                        uint32_t(m_super_offset.size() - 1);
+    }
+
+    /**
+     * @brief number of patches covered by the super-patches
+     */
+    uint32_t get_num_patches() const
+    {
+        return uint32_t(m_patch_super.size());
+    }
+
+    /**
+     * @brief the super-patch that owns a patch
+     */
+    uint32_t get_super_patch(const uint32_t p) const
+    {
+        return m_patch_super[p];
+    }
+
+    /**
+     * @brief the super-patch that owns a mesh element. The handle should be
+     * owned by its patch (e.g., as given by for_each)
+     */
+    template <typename HandleT>
+    uint32_t get_super_patch(const HandleT handle) const
+    {
+        return m_patch_super[handle.patch_id()];
+    }
+
+    /**
+     * @brief number of patches in a super-patch
+     */
+    uint32_t get_num_patches(const uint32_t s) const
+    {
+        return m_super_offset[s + 1] - m_super_offset[s];
+    }
+
+    /**
+     * @brief the i-th patch of a super-patch
+     */
+    uint32_t get_patch(const uint32_t s, const uint32_t i) const
+    {
+        return m_super_patches[m_super_offset[s] + i];
+    }
+
+    /**
+     * @brief number of neighbor super-patches of a super-patch
+     */
+    uint32_t get_num_neighbors(const uint32_t s) const
+    {
+        return m_adj_offset[s + 1] - m_adj_offset[s];
+    }
+
+    /**
+     * @brief the i-th neighbor super-patch of a super-patch
+     */
+    uint32_t get_neighbor(const uint32_t s, const uint32_t i) const
+    {
+        return m_adj[m_adj_offset[s] + i];
+    }
+
+    /**
+     * @brief the weight (number of ribbon faces) between a super-patch and
+     * its i-th neighbor
+     */
+    uint32_t get_neighbor_weight(const uint32_t s, const uint32_t i) const
+    {
+        return m_adj_weight[m_adj_offset[s] + i];
+    }
+
+    /**
+     * @brief the patch-to-super-patch owner map
+     */
+    const std::vector<uint32_t>& get_patch_to_super() const
+    {
+        return m_patch_super;
+    }
+
+    /**
+     * @brief all patches ordered by super-patch, i.e., the patches of
+     * super-patch s are at [get_super_offset()[s], get_super_offset()[s + 1])
+     */
+    const std::vector<uint32_t>& get_patch_order() const
+    {
+        return m_super_patches;
+    }
+
+    const std::vector<uint32_t>& get_super_offset() const
+    {
+        return m_super_offset;
+    }
+
+    /**
+     * @brief the super-patch adjacency as CSR (offset, neighbors, weights)
+     */
+    std::tuple<const std::vector<uint32_t>&,
+               const std::vector<uint32_t>&,
+               const std::vector<uint32_t>&>
+    get_super_graph() const
+    {
+        return {m_adj_offset, m_adj, m_adj_weight};
+    }
+
+    /**
+     * @brief the patch adjacency as CSR (offset, neighbors, weights) the
+     * super-patches were grown on
+     */
+    std::tuple<const std::vector<uint32_t>&,
+               const std::vector<uint32_t>&,
+               const std::vector<uint32_t>&>
+    get_patch_graph() const
+    {
+        return {m_patch_adj_offset, m_patch_adj, m_patch_adj_weight};
+    }
+
+    /**
+     * @brief assign whole super-patches to num_parts parts (e.g., NUMA
+     * domains, thread groups, or ranks) as contiguous runs of super-patch ids
+     * balanced by the patch weights
+     * @param num_parts number of parts
+     * @param weights per-patch work (e.g., number of owned faces). Empty
+     * means every patch has the same weight
+     * @return the part of every patch
+     */
+    std::vector<uint32_t> partition(const uint32_t               num_parts,
+                                    const std::vector<uint32_t>& weights =
+                                        std::vector<uint32_t>()) const
+    {
+        const uint32_t num_super = get_num_super_patches();
+
+        std::vector<uint64_t> prefix(num_super + 1, 0);
+        for (uint32_t s = 0; s < num_super; ++s) {
+            uint64_t w = 0;
+            for (uint32_t i = 0; i < get_num_patches(s); ++i) {
+                const uint32_t p = get_patch(s, i);
+                w += weights.empty() ? 1 : std::max<uint32_t>(1, weights[p]);
+            }
+            prefix[s + 1] = prefix[s] + w;
+        }
+
+        std::vector<uint32_t> ret(get_num_patches(), 0);
+        if (num_parts <= 1) {
+            return ret;
+        }
+        for (uint32_t s = 0; s < num_super; ++s) {
+            // the part of the super-patch midpoint
+            const uint64_t mid  = prefix[s] + (prefix[s + 1] - prefix[s]) / 2;
+            const uint32_t part = std::min<uint32_t>(
+                num_parts - 1, uint32_t((mid * num_parts) / prefix.back()));
+            for (uint32_t i = 0; i < get_num_patches(s); ++i) {
+                ret[get_patch(s, i)] = part;
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * @brief the memory used by the tables
+     */
+    size_t bytes() const
+    {
+        return sizeof(uint32_t) *
+               (m_patch_adj_offset.size() + m_patch_adj.size() +
+                m_patch_adj_weight.size() + m_patch_super.size() +
+                m_super_offset.size() + m_super_patches.size() +
+                m_adj_offset.size() + m_adj.size() + m_adj_weight.size());
+    }
+
+   private:
+    // weighted directed edges (source, destination, weight)
+    using EdgeList = std::vector<std::tuple<uint32_t, uint32_t, uint32_t>>;
+
+    /**
+     * @brief symmetric patch graph weighted by the number of ribbon faces.
+     * Every patch finds the owners of its ribbon faces in parallel
+     */
+    void build_patch_graph(const uint32_t   num_patches,
+                           const PatchInfo* patches_info,
+                           const Context&   context)
+    {
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> counts(
+            num_patches);
+
+#pragma omp parallel for schedule(dynamic)
+        for (int64_t i = 0; i < int64_t(num_patches); ++i) {
+            const uint32_t   p  = static_cast<uint32_t>(i);
+            const PatchInfo& pi = patches_info[p];
+
+            std::vector<uint32_t> owners;
+            for (uint16_t f = 0; f < pi.num_faces[0]; ++f) {
+                if (pi.is_deleted(LocalFaceT(f)) ||
+                    pi.is_owned(LocalFaceT(f))) {
+                    continue;
+                }
+                const FaceHandle owner = context.get_owner_handle(
+                    FaceHandle(p, LocalFaceT(f)), patches_info);
+                owners.push_back(owner.patch_id());
+            }
+            std::sort(owners.begin(), owners.end());
+            for (size_t j = 0; j < owners.size();) {
+                size_t k = j;
+                while (k < owners.size() && owners[k] == owners[j]) {
+                    ++k;
+                }
+                counts[p].push_back({owners[j], uint32_t(k - j)});
+                j = k;
+            }
+        }
+
+        // symmetrize: w(p, q) = ribbon faces of p owned by q and vice versa
+        EdgeList edges;
+        for (uint32_t p = 0; p < num_patches; ++p) {
+            for (const auto& c : counts[p]) {
+                if (c.first == p) {
+                    continue;
+                }
+                edges.push_back({p, c.first, c.second});
+                edges.push_back({c.first, p, c.second});
+            }
+        }
+        to_csr(num_patches,
+               edges,
+               m_patch_adj_offset,
+               m_patch_adj,
+               m_patch_adj_weight);
+    }
+
+    /**
+     * @brief the super-patch graph induced by the patch graph
+     */
+    void build_super_graph()
+    {
+        const uint32_t num_patches = get_num_patches();
+
+        EdgeList edges;
+        for (uint32_t p = 0; p < num_patches; ++p) {
+            for (uint32_t j = m_patch_adj_offset[p];
+                 j < m_patch_adj_offset[p + 1];
+                 ++j) {
+                const uint32_t a = m_patch_super[p];
+                const uint32_t b = m_patch_super[m_patch_adj[j]];
+                if (a != b) {
+                    edges.push_back({a, b, m_patch_adj_weight[j]});
+                }
+            }
+        }
+        to_csr(
+            get_num_super_patches(), edges, m_adj_offset, m_adj, m_adj_weight);
+    }
+
+    /**
+     * @brief CSR of a list of weighted directed edges. Duplicated edges are
+     * merged and their weights are summed
+     */
+    static void to_csr(const uint32_t         n,
+                       EdgeList&              edges,
+                       std::vector<uint32_t>& offset,
+                       std::vector<uint32_t>& adj,
+                       std::vector<uint32_t>& weight)
+    {
+        std::sort(edges.begin(), edges.end());
+
+        offset.assign(n + 1, 0);
+        adj.clear();
+        weight.clear();
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const auto [a, b, w] = edges[i];
+            if (i > 0 && std::get<0>(edges[i - 1]) == a &&
+                std::get<1>(edges[i - 1]) == b) {
+                weight.back() += w;
+                continue;
+            }
+            offset[a + 1]++;
+            adj.push_back(b);
+            weight.push_back(w);
+        }
+        for (uint32_t i = 0; i < n; ++i) {
+            offset[i + 1] += offset[i];
+        }
+    }
+
+    uint32_t              m_patches_per_super;
+    std::atomic<bool>     m_built;
+    std::vector<uint32_t> m_patch_adj_offset, m_patch_adj, m_patch_adj_weight;
+    std::vector<uint32_t> m_patch_super;
+    std::vector<uint32_t> m_super_offset, m_super_patches;
+    std::vector<uint32_t> m_adj_offset, m_adj, m_adj_weight;
+};
+
+}  // namespace rxmesh
@@ -71,14 +71,30 @@ static std::string location_to_string(const locationT location)
 }
 
 /**
- * @brief Memory layout
+ * @brief Memory layout. AoSoA stores the elements of a patch in tiles of
+ * AOSOA_TILE_WIDTH elements where each tile stores the first attribute of all
+ * its elements, then the second attribute, and so on
  */
 using layoutT = uint32_t;
 enum : layoutT
 {
-    AoS = 0x00,
-    SoA = 0x01,
+    AoS   = 0x00,
+    SoA   = 0x01,
+    AoSoA = 0x02,
 };
+
+/**
+ * @brief number of elements in an AoSoA tile. 8 floats fill an AVX2 register
+ * and 8 doubles fill an AVX-512 register
+ */
+constexpr uint32_t AOSOA_TILE_WIDTH = 8;
+
+/**
+ * @brief alignment in bytes of the per-patch host buffers of attributes. A
+ * cache line, which also fits an AVX-512 register, so aligned vector loads can
+ * be used on AoSoA tiles
+ */
+constexpr size_t ATTRIBUTE_HOST_ALIGNMENT = 64;
 /**
  * @brief convert locationT to string
  */
@@ -89,6 +105,8 @@ static std::string layout_to_string(const layoutT layout)
             return "AoS";
         case SoA:
             return "SoA";
+        case AoSoA:
+            return "AoSoA";
         default: {
             RXMESH_ERROR("to_string() unknown layout");
             return "";
@@ -139,6 +157,28 @@ enum class CavityOp
     EF = E,  // same as removing an edge
 };
 
+/**
+ * @brief the number of output elements of a query operation with fixed arity
+ * (EV = 2, FV = FE = 3, EVDiamond = 4), zero otherwise. Fixed-arity outputs
+ * are stored without an offset array
+ */
+__host__ __device__ constexpr uint16_t op_fixed_size(const Op op)
+{
+    return (op == Op::EV)                   ? 2 :
+           (op == Op::FV || op == Op::FE) ? 3 :
+           (op == Op::EVDiamond)            ? 4 :
+                                              0;
+}
+
+/**
+ * @brief if a query operation has an oriented variant i.e., if the oriented
+ * flag changes its output
+ */
+__host__ __device__ constexpr bool op_is_orientable(const Op op)
+{
+    return op == Op::VV || op == Op::VE || op == Op::EV;
+}
+
 /**
  * @brief Convert an operation to string
  * @param op a query operation
@@ -20,6 +20,20 @@ constexpr __host__ __device__ __inline__ bool is_set_bit(
     return mask & (one << bit);
 }
 
+/**
+ * @brief number of set bits in a 32-bit word
+ */
+__host__ __device__ __inline__ uint32_t popc(const uint32_t mask)
+{
+#ifdef __CUDA_ARCH__
+    return __popc(mask);
+#else
+    uint32_t x = mask - ((mask >> 1) & 0x55555555u);
+    x          = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    return (((x + (x >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+#endif
+}
+
 __host__ __inline__ uint16_t count_set_bits(const uint16_t  size,
                                             const uint32_t* bitmask)
 {
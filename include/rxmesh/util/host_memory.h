@@ -0,0 +1,349 @@
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "rxmesh/util/log.h"
+
+namespace rxmesh {
+
+/**
+ * @brief the subsystem a host allocation belongs to
+ */
+enum class HostMemTag : uint32_t
+{
+    // patches topology, masks, hashtables, prefix, ltog, and edge map
+    Topology     = 0,
+    Patcher      = 1,
+    Attribute    = 2,
+    SparseMatrix = 3,
+    DenseMatrix  = 4,
+    // host caches of query results, e.g., KRing and OrientedOneRing
+    Query        = 5,
+    Other        = 6,
+    NumTags      = 7,
+};
+
+/**
+ * @brief convert HostMemTag to string
+ */
+static std::string host_mem_tag_to_string(const HostMemTag tag)
+{
+    switch (tag) {
+        case HostMemTag::Topology:
+            return "Topology";
+        case HostMemTag::Patcher:
+            return "Patcher";
+        case HostMemTag::Attribute:
+            return "Attribute";
+        case HostMemTag::SparseMatrix:
+            return "SparseMatrix";
+        case HostMemTag::DenseMatrix:
+            return "DenseMatrix";
+        case HostMemTag::Query:
+            return "Query";
+        case HostMemTag::Other:
+            return "Other";
+        default: {
+            RXMESH_ERROR("host_mem_tag_to_string() unknown input tag");
+            return "";
+        }
+    }
+}
+
+/**
+ * @brief process-wide accounting of the host memory allocated by RXMesh. Keeps
+ * the current and peak number of bytes per tag. Buffers allocated with
+ * host_malloc() are tracked automatically. Containers (e.g., std::vector)
+ * are tracked by their owner using track()/untrack()
+ */
+class HostMemory
+{
+   public:
+    static constexpr uint32_t num_tags =
+        static_cast<uint32_t>(HostMemTag::NumTags);
+
+    static HostMemory& instance()
+    {
+        static HostMemory s_instance;
+        return s_instance;
+    }
+
+    void track(const HostMemTag tag, const size_t bytes)
+    {
+        const int64_t cur =
+            m_current[id(tag)].fetch_add(bytes, std::memory_order_relaxed) +
+            int64_t(bytes);
+        atomic_max(m_peak[id(tag)], cur);
+
+        const int64_t total =
+            m_total.fetch_add(bytes, std::memory_order_relaxed) +
+            int64_t(bytes);
+        atomic_max(m_total_peak, total);
+    }
+
+    void untrack(const HostMemTag tag, const size_t bytes)
+    {
+        m_current[id(tag)].fetch_sub(bytes, std::memory_order_relaxed);
+        m_total.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief current number of bytes allocated under a tag
+     */
+    size_t current(const HostMemTag tag) const
+    {
+        return size_t(std::max<int64_t>(
+            0, m_current[id(tag)].load(std::memory_order_relaxed)));
+    }
+
+    /**
+     * @brief high-water mark of a tag since the start or the last reset_peak()
+     */
+    size_t peak(const HostMemTag tag) const
+    {
+        return size_t(m_peak[id(tag)].load(std::memory_order_relaxed));
+    }
+
+    size_t total_current() const
+    {
+        return size_t(
+            std::max<int64_t>(0, m_total.load(std::memory_order_relaxed)));
+    }
+
+    size_t total_peak() const
+    {
+        return size_t(m_total_peak.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief set the peaks to the current usage, e.g., to measure the peak of
+     * one phase
+     */
+    void reset_peak()
+    {
+        for (uint32_t t = 0; t < num_tags; ++t) {
+            m_peak[t].store(m_current[t].load());
+        }
+        m_total_peak.store(m_total.load());
+    }
+
+    /**
+     * @brief process resident set size in bytes. Zero if not supported
+     */
+    static size_t process_rss()
+    {
+        return read_proc_status("VmRSS:");
+    }
+
+    /**
+     * @brief process peak resident set size in bytes. Zero if not supported
+     */
+    static size_t process_peak_rss()
+    {
+        return read_proc_status("VmHWM:");
+    }
+
+   private:
+    HostMemory() : m_total(0), m_total_peak(0)
+    {
+        for (uint32_t t = 0; t < num_tags; ++t) {
+            m_current[t].store(0);
+            m_peak[t].store(0);
+        }
+    }
+
+    static uint32_t id(const HostMemTag tag)
+    {
+        return static_cast<uint32_t>(tag);
+    }
+
+    static void atomic_max(std::atomic<int64_t>& target, const int64_t val)
+    {
+        int64_t prev = target.load(std::memory_order_relaxed);
+        while (prev < val && !target.compare_exchange_weak(
+                                 prev, val, std::memory_order_relaxed)) {
+        }
+    }
+
+    static size_t read_proc_status(const std::string& key)
+    {
+#ifdef __linux__
+        std::ifstream file("/proc/self/status");
+        std::string   token;
+        while (file >> token) {
+            if (token == key) {
+                size_t kb = 0;
+                file >> kb;
+                return kb * 1024;
+            }
+        }
+#endif
+        return 0;
+    }
+
+    std::array<std::atomic<int64_t>, num_tags> m_current;
+    std::array<std::atomic<int64_t>, num_tags> m_peak;
+    std::atomic<int64_t>                       m_total;
+    std::atomic<int64_t>                       m_total_peak;
+};
+
+namespace detail {
+// the size and tag are stored right in front of the returned pointer. Keep the
+// header size a multiple of the max alignment so the returned pointer has the
+// same alignment as malloc. With a larger alignment, the returned pointer is
+// moved forward and offset is its distance from the malloc pointer
+struct HostAllocHeader
+{
+    size_t     bytes;
+    size_t     alignment;
+    size_t     offset;
+    HostMemTag tag;
+};
+constexpr size_t host_alloc_header_bytes =
+    ((sizeof(HostAllocHeader) + alignof(std::max_align_t) - 1) /
+     alignof(std::max_align_t)) *
+    alignof(std::max_align_t);
+
+inline HostAllocHeader* host_alloc_header(void* ptr)
+{
+    return reinterpret_cast<HostAllocHeader*>(static_cast<char*>(ptr) -
+                                              host_alloc_header_bytes);
+}
+}  // namespace detail
+
+/**
+ * @brief malloc count elements of type T on the host and track it under tag.
+ * The returned pointer must be freed with host_free()
+ * @param alignment alignment in bytes of the returned pointer. Must be a power
+ * of two. Values below alignof(std::max_align_t) give malloc's alignment
+ */
+template <typename T>
+T* host_malloc(const size_t     count,
+               const HostMemTag tag,
+               const size_t     alignment = alignof(std::max_align_t))
+{
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        RXMESH_ERROR("host_malloc() alignment {} is not a power of two",
+                     alignment);
+        return nullptr;
+    }
+    const size_t align = std::max(alignment, alignof(std::max_align_t));
+    const size_t bytes = count * sizeof(T);
+
+    // raw + host_alloc_header_bytes is max_align_t aligned so moving it to the
+    // next multiple of align takes at most align - alignof(max_align_t)
+    char* raw = static_cast<char*>(malloc(detail::host_alloc_header_bytes +
+                                          align - alignof(std::max_align_t) +
+                                          bytes));
+    if (raw == nullptr) {
+        RXMESH_ERROR("host_malloc() failed to allocate {} bytes for {}",
+                     bytes,
+                     host_mem_tag_to_string(tag));
+        return nullptr;
+    }
+    const uintptr_t first =
+        reinterpret_cast<uintptr_t>(raw) + detail::host_alloc_header_bytes;
+    const uintptr_t aligned = (first + align - 1) & ~uintptr_t(align - 1);
+    char* ret = raw + (aligned - reinterpret_cast<uintptr_t>(raw));
+
+    detail::HostAllocHeader* header = detail::host_alloc_header(ret);
+    header->bytes                   = bytes;
+    header->alignment               = align;
+    header->offset                  = size_t(ret - raw);
+    header->tag                     = tag;
+    HostMemory::instance().track(tag, bytes);
+    return reinterpret_cast<T*>(ret);
+}
+
+/**
+ * @brief free a pointer allocated with host_malloc(). nullptr is ignored
+ */
+inline void host_free(void* ptr)
+{
+    if (ptr == nullptr) {
+        return;
+    }
+    const detail::HostAllocHeader* header = detail::host_alloc_header(ptr);
+    HostMemory::instance().untrack(header->tag, header->bytes);
+    free(static_cast<char*>(ptr) - header->offset);
+}
+
+/**
+ * @brief resize a buffer allocated with host_malloc() to count elements of
+ * type T. If ptr is nullptr, this is the same as host_malloc(). The buffer
+ * keeps the alignment it was allocated with
+ */
+template <typename T>
+T* host_realloc(T* ptr, const size_t count, const HostMemTag tag)
+{
+    if (ptr == nullptr) {
+        return host_malloc<T>(count, tag);
+    }
+    const size_t             bytes     = count * sizeof(T);
+    detail::HostAllocHeader* header    = detail::host_alloc_header(ptr);
+    const size_t             old_bytes = header->bytes;
+    const HostMemTag         old_tag   = header->tag;
+
+    // realloc may move the buffer to an address with a different alignment
+    if (header->alignment > alignof(std::max_align_t)) {
+        T* ret = host_malloc<T>(count, tag, header->alignment);
+        if (ret == nullptr) {
+            return nullptr;
+        }
+        std::memcpy(ret, ptr, std::min(bytes, old_bytes));
+        host_free(ptr);
+        return ret;
+    }
+
+    char* raw = reinterpret_cast<char*>(ptr) - detail::host_alloc_header_bytes;
+
+    char* new_raw = static_cast<char*>(
+        realloc(raw, detail::host_alloc_header_bytes + bytes));
+    if (new_raw == nullptr) {
+        RXMESH_ERROR("host_realloc() failed to allocate {} bytes for {}",
+                     bytes,
+                     host_mem_tag_to_string(tag));
+        return nullptr;
+    }
+    char* ret     = new_raw + detail::host_alloc_header_bytes;
+    header        = detail::host_alloc_header(ret);
+    header->bytes = bytes;
+    header->tag   = tag;
+    HostMemory::instance().untrack(old_tag, old_bytes);
+    HostMemory::instance().track(tag, bytes);
+    return reinterpret_cast<T*>(ret);
+}
+
+/**
+ * @brief move a buffer allocated with host_malloc() to a new buffer with the
+ * same size, tag, and alignment, and free the old one. The new pages are
+ * placed by the OS first-touch policy, i.e., on the NUMA node of the calling
+ * thread
+ */
+template <typename T>
+T* host_first_touch_copy(T* ptr)
+{
+    if (ptr == nullptr) {
+        return nullptr;
+    }
+    const detail::HostAllocHeader* header = detail::host_alloc_header(ptr);
+    const size_t                   bytes  = header->bytes;
+
+    char* ret = host_malloc<char>(bytes, header->tag, header->alignment);
+    if (ret == nullptr) {
+        return ptr;
+    }
+    std::memcpy(ret, ptr, bytes);
+    host_free(ptr);
+    return reinterpret_cast<T*>(ret);
+}
+
+}  // namespace rxmesh
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <rapidjson/document.h>
+#include <rapidjson/ostreamwrapper.h>
+#include <rapidjson/writer.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rxmesh/util/log.h"
+
+namespace rxmesh {
+
+/**
+ * @brief a single completed zone, i.e., a named time range recorded by one
+ * host thread with optional counters attached to it
+ */
+struct TraceEvent
+{
+    const char*                                  name;
+    const char*                                  category;
+    int64_t                                      start_us;
+    int64_t                                      duration_us;
+    std::vector<std::pair<const char*, double>> counters;
+};
+
+/**
+ * @brief per-thread buffer of trace events. Every host thread that records a
+ * zone gets its own buffer so recording does not need a lock
+ */
+struct TraceThreadBuffer
+{
+    uint32_t                tid;
+    std::vector<TraceEvent> events;
+};
+
+/**
+ * @brief process-wide collector of instrumentation zones. Zones are only
+ * recorded if the library is compiled with RXMESH_INSTRUMENT and the collector
+ * is enabled at runtime. The collected zones can be written as Chrome
+ * trace/Perfetto JSON (load it in chrome://tracing or ui.perfetto.dev).
+ * Zones measure host time only, so a zone around an asynchronous kernel launch
+ * measures the launch and not the kernel
+ */
+class Instrument
+{
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    static Instrument& instance()
+    {
+        static Instrument s_instance;
+        return s_instance;
+    }
+
+    /**
+     * @brief enable/disable recording at runtime. Recording is enabled by
+     * default when compiled with RXMESH_INSTRUMENT
+     */
+    void enable(bool enabled)
+    {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    bool is_enabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief time in microseconds since the collector was created
+     */
+    int64_t now_us() const
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   Clock::now() - m_origin)
+            .count();
+    }
+
+    /**
+     * @brief append a completed zone to the calling thread's buffer
+     */
+    void record(TraceEvent&& event)
+    {
+        thread_buffer().events.push_back(std::move(event));
+    }
+
+    /**
+     * @brief total number of zones recorded so far across all threads
+     */
+    size_t num_events()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t                      num = 0;
+        for (const auto& b : m_buffers) {
+            num += b->events.size();
+        }
+        return num;
+    }
+
+    /**
+     * @brief drop all recorded zones. Should not be called while other
+     * threads are recording
+     */
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& b : m_buffers) {
+            b->events.clear();
+        }
+    }
+
+    /**
+     * @brief write all recorded zones to a Chrome trace JSON file. Should not
+     * be called while other threads are recording
+     * @param filename full path of the output file
+     */
+    void write_chrome_trace(const std::string& filename)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        std::ofstream ofs(filename);
+        if (!ofs.is_open()) {
+            RXMESH_ERROR(
+                "Instrument::write_chrome_trace() can not open {}", filename);
+            return;
+        }
+        rapidjson::OStreamWrapper                     osw(ofs);
+        rapidjson::Writer<rapidjson::OStreamWrapper> w(osw);
+
+        w.StartObject();
+        w.Key("displayTimeUnit");
+        w.String("ms");
+        w.Key("traceEvents");
+        w.StartArray();
+        for (const auto& b : m_buffers) {
+            // thread name metadata so the viewer labels each track
+            w.StartObject();
+            w.Key("name");
+            w.String("thread_name");
+            w.Key("ph");
+            w.String("M");
+            w.Key("pid");
+            w.Int(0);
+            w.Key("tid");
+            w.Uint(b->tid);
+            w.Key("args");
+            w.StartObject();
+            w.Key("name");
+            w.String(("host_" + std::to_string(b->tid)).c_str());
+            w.EndObject();
+            w.EndObject();
+
+            for (const auto& e : b->events) {
+                w.StartObject();
+                w.Key("name");
+                w.String(e.name);
+                w.Key("cat");
+                w.String(e.category);
+                w.Key("ph");
+                w.String("X");
+                w.Key("ts");
+                w.Int64(e.start_us);
+                w.Key("dur");
+                w.Int64(e.duration_us);
+                w.Key("pid");
+                w.Int(0);
+                w.Key("tid");
+                w.Uint(b->tid);
+                if (!e.counters.empty()) {
+                    w.Key("args");
+                    w.StartObject();
+                    for (const auto& c : e.counters) {
+                        w.Key(c.first);
+                        w.Double(c.second);
+                    }
+                    w.EndObject();
+                }
+                w.EndObject();
+            }
+        }
+        w.EndArray();
+        w.EndObject();
+
+        RXMESH_INFO("Instrument: wrote trace to {}", filename);
+    }
+
+   private:
+    Instrument() : m_origin(Clock::now()), m_enabled(true)
+    {
+    }
+
+    TraceThreadBuffer& thread_buffer()
+    {
+        // the collector owns the buffers so that zones recorded by threads
+        // that already exited (e.g., OpenMP workers) are still written
+        thread_local TraceThreadBuffer* t_buffer = nullptr;
+        if (t_buffer == nullptr) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buffers.emplace_back(std::make_unique<TraceThreadBuffer>());
+            t_buffer      = m_buffers.back().get();
+            t_buffer->tid = static_cast<uint32_t>(m_buffers.size() - 1);
+        }
+        return *t_buffer;
+    }
+
+    Clock::time_point                               m_origin;
+    std::atomic<bool>                               m_enabled;
+    std::mutex                                      m_mutex;
+    std::vector<std::unique_ptr<TraceThreadBuffer>> m_buffers;
+};
+
+/**
+ * @brief RAII zone that records the time between its construction and
+ * destruction. Use it through RXMESH_ZONE/RXMESH_ZONE_NAMED so it compiles to
+ * nothing when RXMESH_INSTRUMENT is not defined
+ */
+class ScopedZone
+{
+   public:
+    explicit ScopedZone(const char* name, const char* category = "rxmesh")
+        : m_active(Instrument::instance().is_enabled())
+    {
+        if (m_active) {
+            m_event.name     = name;
+            m_event.category = category;
+            m_event.start_us = Instrument::instance().now_us();
+        }
+    }
+
+    ScopedZone(const ScopedZone&)            = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+
+    /**
+     * @brief attach a named counter to this zone. Shows up under "args" in
+     * the trace viewer. The name should be a string literal
+     */
+    void counter(const char* name, double value)
+    {
+        if (m_active) {
+            m_event.counters.emplace_back(name, value);
+        }
+    }
+
+    ~ScopedZone()
+    {
+        if (m_active) {
+            m_event.duration_us =
+                Instrument::instance().now_us() - m_event.start_us;
+            Instrument::instance().record(std::move(m_event));
+        }
+    }
+
+   private:
+    bool       m_active;
+    TraceEvent m_event;
+};
+
+}  // namespace rxmesh
+
+#define RXMESH_ZONE_CONCAT_IMPL(a, b) a##b
+#define RXMESH_ZONE_CONCAT(a, b) RXMESH_ZONE_CONCAT_IMPL(a, b)
+
+#ifdef RXMESH_INSTRUMENT
+// anonymous zone that lasts until the end of the enclosing scope
+#define RXMESH_ZONE(name) \
+    ::rxmesh::ScopedZone RXMESH_ZONE_CONCAT(rx_zone_, __LINE__)(name)
+
+// zone with a variable name so counters can be attached to it
+#define RXMESH_ZONE_NAMED(var, name) ::rxmesh::ScopedZone var(name)
+
+// attach a counter to a named zone. value is not evaluated when disabled
+#define RXMESH_ZONE_COUNTER(var, name, value) \
+    var.counter(name, static_cast<double>(value))
+
+#define RXMESH_TRACE_WRITE(filename) \
+    ::rxmesh::Instrument::instance().write_chrome_trace(filename)
+#else
+#define RXMESH_ZONE(name)
+#define RXMESH_ZONE_NAMED(var, name)
+#define RXMESH_ZONE_COUNTER(var, name, value)
+#define RXMESH_TRACE_WRITE(filename)
+#endif
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <stdint.h>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "rxmesh/util/log.h"
+
+namespace rxmesh {
+
+/**
+ * @brief hardware counter deltas of a measured region. Counters that could not
+ * be opened are left at zero and marked as not available
+ */
+struct PerfCounterValues
+{
+    enum Counter : uint32_t
+    {
+        CYCLES           = 0,
+        INSTRUCTIONS     = 1,
+        CACHE_REFERENCES = 2,
+        CACHE_MISSES     = 3,
+        BRANCHES         = 4,
+        BRANCH_MISSES    = 5,
+        NUM_COUNTERS     = 6,
+    };
+
+    std::array<uint64_t, NUM_COUNTERS> value       = {};
+    std::array<bool, NUM_COUNTERS>     available   = {};
+    double                             time_ms     = 0;
+    int                                num_threads = 0;
+
+    static std::string counter_name(const uint32_t c)
+    {
+        switch (c) {
+            case CYCLES:
+                return "cycles";
+            case INSTRUCTIONS:
+                return "instructions";
+            case CACHE_REFERENCES:
+                return "cache_references";
+            case CACHE_MISSES:
+                return "cache_misses";
+            case BRANCHES:
+                return "branches";
+            case BRANCH_MISSES:
+                return "branch_misses";
+            default:
+                return "unknown";
+        }
+    }
+
+    /**
+     * @brief true if at least one counter was collected
+     */
+    bool any_available() const
+    {
+        for (bool a : available) {
+            if (a) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief instructions per cycle. Zero if not available
+     */
+    double ipc() const
+    {
+        return ratio(INSTRUCTIONS, CYCLES);
+    }
+
+    double cache_miss_rate() const
+    {
+        return ratio(CACHE_MISSES, CACHE_REFERENCES);
+    }
+
+    double branch_miss_rate() const
+    {
+        return ratio(BRANCH_MISSES, BRANCHES);
+    }
+
+    /**
+     * @brief estimate of the DRAM bandwidth (GB/s) as last-level cache misses
+     * times the cache line size over the region time. This is a lower bound
+     * since it does not account for prefetching and write-backs
+     */
+    double estimated_bandwidth_gbs(const uint32_t cache_line_bytes = 64) const
+    {
+        if (!available[CACHE_MISSES] || time_ms <= 0) {
+            return 0;
+        }
+        return double(value[CACHE_MISSES]) * double(cache_line_bytes) /
+               (time_ms * 1.0e6);
+    }
+
+   private:
+    double ratio(const uint32_t num, const uint32_t den) const
+    {
+        if (!available[num] || !available[den] || value[den] == 0) {
+            return 0;
+        }
+        return double(value[num]) / double(value[den]);
+    }
+};
+
+/**
+ * @brief a group of hardware counters (cycles, instructions, cache
+ * references/misses, branches/misses) read through Linux perf_event_open.
+ * The counters are opened for every OpenMP thread so host loops that use
+ * OpenMP (e.g., for_each with HOST) are measured on all threads. If the
+ * counters are not available (not Linux, no permission, virtualized
+ * environment), start()/stop() still work and only the time is measured.
+ * Per-thread counters rely on OpenMP reusing the same thread pool across
+ * parallel regions (the default behavior of the common runtimes)
+ */
+class PerfCounters
+{
+   public:
+    PerfCounters(bool all_omp_threads = true)
+        : m_num_threads(all_omp_threads ? omp_get_max_threads() : 1)
+    {
+        m_fds.resize(m_num_threads);
+        for (auto& fds : m_fds) {
+            fds.fill(-1);
+        }
+        m_grouped.resize(m_num_threads);
+        for (auto& grouped : m_grouped) {
+            grouped.fill(false);
+        }
+        m_start.resize(m_num_threads);
+        m_stop.resize(m_num_threads);
+
+#ifdef __linux__
+        if (m_num_threads > 1) {
+#pragma omp parallel num_threads(m_num_threads)
+            {
+                open(omp_get_thread_num());
+            }
+        } else {
+            open(0);
+        }
+#endif
+        if (!is_available()) {
+            RXMESH_WARN(
+                "PerfCounters::PerfCounters() hardware counters are not "
+                "available. Only time will be reported");
+        } else {
+            for (uint32_t c = 0; c < PerfCounterValues::NUM_COUNTERS; ++c) {
+                if (!is_available(c)) {
+                    RXMESH_WARN(
+                        "PerfCounters::PerfCounters() the {} counter could "
+                        "not be opened on every thread and will not be "
+                        "reported",
+                        PerfCounterValues::counter_name(c));
+                }
+            }
+        }
+    }
+
+    PerfCounters(const PerfCounters&)            = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters()
+    {
+#ifdef __linux__
+        for (auto& fds : m_fds) {
+            for (int& fd : fds) {
+                if (fd >= 0) {
+                    ::close(fd);
+                    fd = -1;
+                }
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief true if at least one hardware counter could be opened
+     */
+    bool is_available() const
+    {
+        for (const auto& fds : m_fds) {
+            for (int fd : fds) {
+                if (fd >= 0) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief true if the counter could be opened on every thread. Counters
+     * missing on some threads are not reported since their sum would be
+     * partial
+     */
+    bool is_available(const uint32_t c) const
+    {
+        for (const auto& fds : m_fds) {
+            if (fds[c] < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void start()
+    {
+        for (int t = 0; t < m_num_threads; ++t) {
+            read(t, m_start[t]);
+        }
+        m_start_time = std::chrono::high_resolution_clock::now();
+    }
+
+    void stop()
+    {
+        m_stop_time = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < m_num_threads; ++t) {
+            read(t, m_stop[t]);
+        }
+    }
+
+    /**
+     * @brief the counter deltas (summed over all threads) between the last
+     * start() and stop()
+     */
+    PerfCounterValues values() const
+    {
+        PerfCounterValues ret;
+        ret.num_threads = m_num_threads;
+        ret.time_ms     = std::chrono::duration<double, std::milli>(
+                          m_stop_time - m_start_time)
+                          .count();
+        for (uint32_t c = 0; c < PerfCounterValues::NUM_COUNTERS; ++c) {
+            if (!is_available(c)) {
+                continue;
+            }
+            ret.available[c] = true;
+            for (int t = 0; t < m_num_threads; ++t) {
+                ret.value[c] += scaled_delta(m_start[t][c], m_stop[t][c]);
+            }
+        }
+        return ret;
+    }
+
+    /**
+     * @brief measure a callable
+     */
+    template <typename FuncT>
+    PerfCounterValues measure(FuncT func)
+    {
+        start();
+        func();
+        stop();
+        return values();
+    }
+
+   private:
+    // raw counter value along with the time the counter was enabled and
+    // running to scale the value in case the counters are multiplexed
+    struct Reading
+    {
+        uint64_t value   = 0;
+        uint64_t enabled = 0;
+        uint64_t running = 0;
+    };
+
+    using Readings = std::array<Reading, PerfCounterValues::NUM_COUNTERS>;
+
+    static uint64_t scaled_delta(const Reading& a, const Reading& b)
+    {
+        const uint64_t value   = b.value - a.value;
+        const uint64_t enabled = b.enabled - a.enabled;
+        const uint64_t running = b.running - a.running;
+        if (running == 0) {
+            return 0;
+        }
+        if (running >= enabled) {
+            return value;
+        }
+        return static_cast<uint64_t>(double(value) * double(enabled) /
+                                     double(running));
+    }
+
+#ifdef __linux__
+    static int open_event(const uint64_t config,
+                          const int      group_fd,
+                          const uint64_t read_format)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(perf_event_attr));
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof(perf_event_attr);
+        attr.config         = config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = read_format | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // pid = 0, cpu = -1: the calling thread on any cpu
+        return static_cast<int>(
+            syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+    }
+
+    /**
+     * @brief open the counters of a thread. Every ratio (instructions/cycles,
+     * cache misses/references, branch misses/branches) is one group with the
+     * first counter as the leader, so both counters are scheduled together
+     * on the PMU and their ratio comes from the same time window. Small
+     * groups still fit when the PMU has few counters and are multiplexed
+     * otherwise. A counter that can not join its group is opened on its own
+     */
+    void open(const int thread)
+    {
+        const uint64_t config[PerfCounterValues::NUM_COUNTERS] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_REFERENCES,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+            PERF_COUNT_HW_BRANCH_MISSES};
+
+        for (uint32_t c = 0; c < PerfCounterValues::NUM_COUNTERS; c += 2) {
+            const int leader = open_event(config[c], -1, PERF_FORMAT_GROUP);
+
+            int member = -1;
+            if (leader >= 0) {
+                member = open_event(config[c + 1], leader, PERF_FORMAT_GROUP);
+            }
+            m_grouped[thread][c + 1] = member >= 0;
+            if (member < 0) {
+                member = open_event(config[c + 1], -1, 0);
+            }
+
+            m_fds[thread][c]     = leader;
+            m_fds[thread][c + 1] = member;
+        }
+    }
+#endif
+
+    void read(const int thread, Readings& readings) const
+    {
+#ifdef __linux__
+        for (uint32_t c = 0; c < PerfCounterValues::NUM_COUNTERS; c += 2) {
+            // the leader reads its group at once as
+            // {nr, time_enabled, time_running, value[nr]}
+            const int leader = m_fds[thread][c];
+            if (leader >= 0) {
+                uint64_t buf[5] = {0, 0, 0, 0, 0};
+                const ssize_t bytes = ::read(leader, buf, sizeof(buf));
+                if (bytes >= ssize_t(4 * sizeof(uint64_t)) &&
+                    bytes == ssize_t((3 + buf[0]) * sizeof(uint64_t))) {
+                    for (uint32_t i = 0; i < buf[0]; ++i) {
+                        readings[c + i].value   = buf[3 + i];
+                        readings[c + i].enabled = buf[1];
+                        readings[c + i].running = buf[2];
+                    }
+                }
+            }
+
+            // a member that could not join the group
+            const int member = m_fds[thread][c + 1];
+            if (member >= 0 && !m_grouped[thread][c + 1]) {
+                uint64_t buf[3] = {0, 0, 0};
+                if (::read(member, buf, sizeof(buf)) == sizeof(buf)) {
+                    readings[c + 1].value   = buf[0];
+                    readings[c + 1].enabled = buf[1];
+                    readings[c + 1].running = buf[2];
+                }
+            }
+        }
+#endif
+    }
+
+    using FDs = std::array<int, PerfCounterValues::NUM_COUNTERS>;
+
+    // true if the counter is read through the leader of its group
+    using Grouped = std::array<bool, PerfCounterValues::NUM_COUNTERS>;
+
+    int                                            m_num_threads;
+    std::vector<FDs>                               m_fds;
+    std::vector<Grouped>                           m_grouped;
+    std::vector<Readings>                          m_start, m_stop;
+    std::chrono::high_resolution_clock::time_point m_start_time, m_stop_time;
+};
+
+}  // namespace rxmesh
@@ -10,7 +10,10 @@
 #include <fstream>
 #include <map>
 #include <sstream>
+#include "rxmesh/matrix/permute_cache.h"
 #include "rxmesh/rxmesh.h"
+#include "rxmesh/util/host_memory.h"
+#include "rxmesh/util/perf_counters.h"
 #include "rxmesh/util/util.h"
 #ifdef __NVCC__
 #include "cuda.h"
@@ -361,6 +364,177 @@ struct Report
         m_doc.AddMember(key, subdoc, m_doc.GetAllocator());
     }
 
+    // add the per-patch work counters and host time (see PatchStats) collected
+    // since the last reset as distribution summaries under pass_name
+    void patch_stats(const std::string& pass_name, const rxmesh::RXMesh& rx)
+    {
+        PatchStats* stats = rx.get_patch_stats();
+        if (stats == nullptr) {
+            RXMESH_WARN(
+                "Report::patch_stats() patch stats is not enabled. Call "
+                "RXMesh::enable_patch_stats(true) before the pass");
+            return;
+        }
+        stats->sync_from_device();
+
+        rapidjson::Document subdoc(&m_doc.GetAllocator());
+        subdoc.SetObject();
+
+        const uint32_t num_patches = rx.get_num_patches();
+        add_member("num_patches", num_patches, subdoc);
+
+        for (uint32_t c = 0; c < PatchStats::num_counters(); ++c) {
+            const PatchCounter counter = static_cast<PatchCounter>(c);
+            add_summary(patch_counter_to_string(counter),
+                        stats->summarize(counter, num_patches),
+                        subdoc);
+        }
+        add_summary("host_time (ms)",
+                    stats->summarize_host_time(num_patches),
+                    subdoc);
+
+        rapidjson::Value key(pass_name.c_str(), subdoc.GetAllocator());
+        m_doc.AddMember(key, subdoc, m_doc.GetAllocator());
+    }
+
+    // add the partition quality (see PartitionDiagnostics) as per-patch
+    // distribution summaries along with the build parameters. Used to tune
+    // patch_size, capacity_factor, and lp_hashtable_load_factor for a mesh
+    void partition_diagnostics(
+        const rxmesh::RXMesh& rx,
+        const std::string     json_member_name = "PartitionDiagnostics")
+    {
+        const PartitionDiagnostics diag = rx.compute_partition_diagnostics();
+
+        rapidjson::Document subdoc(&m_doc.GetAllocator());
+        subdoc.SetObject();
+
+        add_member("num_patches", rx.get_num_patches(), subdoc);
+        add_member("patch_size", diag.patch_size, subdoc);
+        add_member("capacity_factor", double(diag.capacity_factor), subdoc);
+        add_member("lp_hashtable_load_factor",
+                   double(diag.lp_hashtable_load_factor),
+                   subdoc);
+        add_member("ribbon_overhead (%)", rx.get_ribbon_overhead(), subdoc);
+        add_member("total_edge_cut", diag.total_edge_cut, subdoc);
+        add_member("num_colors", diag.num_colors, subdoc);
+        add_member("patch_stash_size", diag.patch_stash_size, subdoc);
+        add_member("num_patches_at_stash_limit",
+                   diag.num_patches_at_stash_limit,
+                   subdoc);
+
+        auto add = [&](const std::string& name, const auto& values) {
+            add_summary(name, DistributionSummary::summarize(values), subdoc);
+        };
+        add("num_owned_vertices", diag.num_owned_vertices);
+        add("num_owned_edges", diag.num_owned_edges);
+        add("num_owned_faces", diag.num_owned_faces);
+        add("num_ribbon_vertices", diag.num_ribbon_vertices);
+        add("num_ribbon_edges", diag.num_ribbon_edges);
+        add("num_ribbon_faces", diag.num_ribbon_faces);
+        add("ribbon_ratio", diag.ribbon_ratio);
+        add("edge_cut", diag.edge_cut);
+        add("num_neighbor_patches", diag.num_neighbor_patches);
+        add("lp_load_factor_v", diag.lp_load_factor_v);
+        add("lp_load_factor_e", diag.lp_load_factor_e);
+        add("lp_load_factor_f", diag.lp_load_factor_f);
+        add("lp_stash_load_factor_v", diag.lp_stash_load_factor_v);
+        add("lp_stash_load_factor_e", diag.lp_stash_load_factor_e);
+        add("lp_stash_load_factor_f", diag.lp_stash_load_factor_f);
+
+        rapidjson::Value key(json_member_name.c_str(), subdoc.GetAllocator());
+        m_doc.AddMember(key, subdoc, m_doc.GetAllocator());
+    }
+
+    // add hardware counter deltas of a measured region (see PerfCounters),
+    // e.g., report.perf_counters("for_each_vertex", pc.measure([&]() {
+    // rx.for_each_vertex(HOST, ...); }));
+    void perf_counters(const std::string&       region_name,
+                       const PerfCounterValues& values)
+    {
+        rapidjson::Document subdoc(&m_doc.GetAllocator());
+        subdoc.SetObject();
+
+        add_member("time (ms)", values.time_ms, subdoc);
+        add_member("num_threads", values.num_threads, subdoc);
+        add_member("counters_available", values.any_available(), subdoc);
+
+        for (uint32_t c = 0; c < PerfCounterValues::NUM_COUNTERS; ++c) {
+            if (values.available[c]) {
+                add_member(PerfCounterValues::counter_name(c),
+                           size_t(values.value[c]),
+                           subdoc);
+            }
+        }
+        if (values.any_available()) {
+            add_member("ipc", values.ipc(), subdoc);
+            add_member("cache_miss_rate", values.cache_miss_rate(), subdoc);
+            add_member("branch_miss_rate", values.branch_miss_rate(), subdoc);
+            add_member("estimated_bandwidth (GB/s)",
+                       values.estimated_bandwidth_gbs(),
+                       subdoc);
+        }
+
+        rapidjson::Value key(region_name.c_str(), subdoc.GetAllocator());
+        m_doc.AddMember(key, subdoc, m_doc.GetAllocator());
+    }
+
+    // add the current and peak host memory per subsystem (see HostMemory)
+    // along with the process resident set size. The peaks are since the start
+    // or the last HostMemory::reset_peak()
+    void host_memory(const std::string& phase_name = "HostMemory")
+    {
+        const HostMemory& hm = HostMemory::instance();
+
+        rapidjson::Document subdoc(&m_doc.GetAllocator());
+        subdoc.SetObject();
+
+        for (uint32_t t = 0; t < HostMemory::num_tags; ++t) {
+            const HostMemTag  tag  = static_cast<HostMemTag>(t);
+            const std::string name = host_mem_tag_to_string(tag);
+            add_member(name + " current (MB)",
+                       BYTES_TO_MEGABYTES(hm.current(tag)),
+                       subdoc);
+            add_member(
+                name + " peak (MB)", BYTES_TO_MEGABYTES(hm.peak(tag)), subdoc);
+        }
+        add_member("total current (MB)",
+                   BYTES_TO_MEGABYTES(hm.total_current()),
+                   subdoc);
+        add_member(
+            "total peak (MB)", BYTES_TO_MEGABYTES(hm.total_peak()), subdoc);
+        add_member("process RSS (MB)",
+                   BYTES_TO_MEGABYTES(HostMemory::process_rss()),
+                   subdoc);
+        add_member("process peak RSS (MB)",
+                   BYTES_TO_MEGABYTES(HostMemory::process_peak_rss()),
+                   subdoc);
+
+        rapidjson::Value key(phase_name.c_str(), subdoc.GetAllocator());
+        m_doc.AddMember(key, subdoc, m_doc.GetAllocator());
+    }
+
+    // add the hit/miss counts of the fill-reducing permutation cache (see
+    // PermuteCache)
+    void permute_cache(const std::string& phase_name = "PermuteCache")
+    {
+        const PermuteCache& pc = PermuteCache::instance();
+
+        rapidjson::Document subdoc(&m_doc.GetAllocator());
+        subdoc.SetObject();
+
+        add_member("enabled", pc.is_enabled(), subdoc);
+        add_member("folder", pc.get_folder(), subdoc);
+        add_member("num_entries", pc.size(), subdoc);
+        add_member("num_hits", pc.get_num_hits(), subdoc);
+        add_member("num_disk_hits", pc.get_num_disk_hits(), subdoc);
+        add_member("num_misses", pc.get_num_misses(), subdoc);
+        add_member("hit_rate", pc.hit_rate(), subdoc);
+
+        rapidjson::Value key(phase_name.c_str(), subdoc.GetAllocator());
+        m_doc.AddMember(key, subdoc, m_doc.GetAllocator());
+    }
+
     // add members to the main object
     template <typename T>
     void add_member(std::string member_key, const T member_val)
@@ -376,6 +550,26 @@ struct Report
    protected:
     std::string m_output_name_suffix;
 
+    template <typename docT>
+    void add_summary(std::string                member_key,
+                     const DistributionSummary& summary,
+                     docT&                      doc)
+    {
+        rapidjson::Document subdoc(&m_doc.GetAllocator());
+        subdoc.SetObject();
+        add_member("min", summary.min, subdoc);
+        add_member("max", summary.max, subdoc);
+        add_member("mean", summary.mean, subdoc);
+        add_member("stddev", summary.stddev, subdoc);
+        add_member("median", summary.median, subdoc);
+        add_member("p90", summary.p90, subdoc);
+        add_member("total", summary.total, subdoc);
+        add_member("imbalance (max/mean)", summary.imbalance, subdoc);
+
+        rapidjson::Value key(member_key.c_str(), doc.GetAllocator());
+        doc.AddMember(key, subdoc, doc.GetAllocator());
+    }
+
     template <typename docT>
     void add_member(std::string member_key, const int32_t member_val, docT& doc)
     {
@@ -412,6 +412,27 @@ inline std::pair<uint32_t, uint32_t> edge_key(const uint32_t v0,
     uint32_t j = std::min(v0, v1);
     return std::make_pair(i, j);
 }
+
+/**
+ * @brief initial value of fnv1a()
+ */
+constexpr uint64_t fnv1a_seed = 14695981039346656037ull;
+
+/**
+ * @brief FNV-1a hash of bytes bytes starting at data. Pass the hash of the
+ * previous buffers as h to hash several buffers as one stream
+ */
+inline uint64_t fnv1a(const void* data,
+                      const size_t bytes,
+                      uint64_t     h = fnv1a_seed)
+{
+    const unsigned char* d = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < bytes; ++i) {
+        h ^= d[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
 }  // namespace detail
 
 /**
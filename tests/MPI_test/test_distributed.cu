@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+
+#include "rxmesh/rxmesh_distributed.h"
+
+TEST(RXMeshDistributed, HaloExchange)
+{
+    using namespace rxmesh;
+
+    RXMeshDistributed dist(MPI_COMM_WORLD,
+                           STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    RXMeshStatic& rx = dist.get_local_mesh();
+
+    // every vertex is owned by exactly one rank
+    uint32_t num_owned = dist.get_num_owned_vertices();
+    uint32_t num_total = 0;
+    MPI_Allreduce(
+        &num_owned, &num_total, 1, MPI_UINT32_T, MPI_SUM, MPI_COMM_WORLD);
+    EXPECT_EQ(num_total, dist.get_num_global_vertices());
+
+    for (const locationT location : {HOST, DEVICE}) {
+        auto attr = rx.add_vertex_attribute<float>("halo", 2);
+        attr->reset(-1.f, LOCATION_ALL);
+
+        // owners write the global id, ghosts keep -1
+        rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+            if (dist.is_owned(vh)) {
+                (*attr)(vh, 0) = float(dist.map_to_global(vh));
+                (*attr)(vh, 1) = float(dist.get_rank());
+            }
+        });
+        if (location == DEVICE) {
+            attr->move(HOST, DEVICE);
+        }
+
+        dist.begin_halo_exchange(*attr, location);
+        dist.end_halo_exchange(*attr);
+
+        if (location == DEVICE) {
+            attr->move(DEVICE, HOST);
+        }
+
+        rx.for_each_vertex(
+            HOST,
+            [&](const VertexHandle vh) {
+                EXPECT_EQ((*attr)(vh, 0), float(dist.map_to_global(vh)));
+                EXPECT_EQ((*attr)(vh, 1), float(dist.get_owner_rank(vh)));
+            },
+            NULL,
+            false);
+
+        rx.remove_attribute("halo");
+    }
+
+    EXPECT_EQ(dist.get_interior_patches().size() +
+                  dist.get_boundary_patches().size(),
+              rx.get_num_patches());
+    if (dist.get_num_ranks() > 1) {
+        EXPECT_FALSE(dist.get_neighbor_ranks().empty());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    using namespace rxmesh;
+
+    MPI_Init(&argc, &argv);
+    Log::init();
+
+    ::testing::InitGoogleTest(&argc, argv);
+
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank != 0) {
+        // only rank 0 prints the test results
+        ::testing::TestEventListeners& listeners =
+            ::testing::UnitTest::GetInstance()->listeners();
+        delete listeners.Release(listeners.default_result_printer());
+    }
+
+    const int ret = RUN_ALL_TESTS();
+
+    MPI_Finalize();
+    return ret;
+}
@@ -20,6 +20,8 @@ struct RXMeshTestArg
 #include "test_patch_lock.cuh"
 #include "test_wasted_work.cuh"
 #include "test_grad.h"
+#include "test_host_schedule.cuh"
+#include "test_attribute_layout.cuh"
 // clang-format on
 
 int main(int argc, char** argv)
@@ -223,4 +223,177 @@ TEST(Attribute, AddingAndRemoving)
     // this is not neccessary in general but we are just testing the
     // functionality here
     rx.remove_attribute(attr_name);
-}
\ No newline at end of file
+}
+
+template <typename StorageT>
+void mixed_precision_round_trip(rxmesh::RXMeshStatic& rx, float tol)
+{
+    using namespace rxmesh;
+
+    auto coords = rx.get_input_vertex_coordinates();
+
+    auto mixed = rx.add_mixed_vertex_attribute<float, StorageT>("mixed", 3);
+
+    if constexpr (std::is_same_v<StorageT, quant16_t>) {
+        // leave room for doubling the values
+        mixed->set_range(-3.f, 3.f);
+        mixed->from_attribute(*coords, false);
+    } else {
+        mixed->from_attribute(*coords);
+    }
+
+    // double the values on the device through the converting proxy
+    auto m = *mixed;
+    rx.for_each_vertex(DEVICE, [m] __device__(const VertexHandle vh) {
+        for (uint32_t i = 0; i < 3; ++i) {
+            m(vh, i) *= 2.f;
+        }
+    });
+    ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
+    mixed->move(DEVICE, HOST);
+
+    auto back = rx.add_vertex_attribute<float>("back", 3, HOST);
+    mixed->to_attribute(*back);
+
+    rx.for_each_vertex(
+        HOST,
+        [&](const VertexHandle vh) {
+            const glm::fvec3 x = mixed->template to_glm<3>(vh);
+            for (uint32_t i = 0; i < 3; ++i) {
+                const float expected = 2.f * (*coords)(vh, i);
+                EXPECT_NEAR(x[i], expected, tol);
+                EXPECT_EQ(x[i], (*back)(vh, i));
+            }
+        },
+        NULL,
+        false);
+
+    rx.remove_attribute("mixed");
+    rx.remove_attribute("back");
+}
+
+TEST(Attribute, MixedPrecision)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    // the sphere coordinates are in [-1.4, 1.4] so the doubled values are
+    // within a few ulps of the storage type
+    mixed_precision_round_trip<__half>(rx, 4e-3);
+    mixed_precision_round_trip<__nv_bfloat16>(rx, 2e-2);
+    mixed_precision_round_trip<quant16_t>(rx, 2e-4);
+
+    // moving through the base class also moves the quantization parameters
+    auto q = rx.add_mixed_vertex_attribute<float, quant16_t>("q", 1, HOST);
+    q->set_range(-3.f, 3.f);
+    rx.for_each_vertex(HOST,
+                       [&](const VertexHandle vh) { (*q)(vh, 0) = 1.5f; });
+
+    Attribute<quant16_t, VertexHandle>& base = *q;
+    base.move(HOST, DEVICE);
+
+    auto out = rx.add_vertex_attribute<float>("out", 1);
+    auto qd  = *q;
+    auto od  = *out;
+    rx.for_each_vertex(DEVICE, [qd, od] __device__(const VertexHandle vh) {
+        od(vh, 0) = qd(vh, 0);
+    });
+    ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
+    out->move(DEVICE, HOST);
+    rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        EXPECT_NEAR((*out)(vh, 0), 1.5f, 2e-4);
+    });
+
+    rx.remove_attribute("q");
+    rx.remove_attribute("out");
+}
+
+TEST(Attribute, Sparse)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    auto coords = rx.get_input_vertex_coordinates();
+
+    auto seeds = rx.add_sparse_vertex_attribute<float>("seeds", 2);
+
+    // every 7th vertex (in linear order) is a seed
+    std::vector<VertexHandle> expected;
+    rx.for_each_vertex(
+        HOST,
+        [&](const VertexHandle vh) {
+            if (rx.linear_id(vh) % 7 == 0) {
+                EXPECT_TRUE(seeds->insert(vh, -1.f));
+                EXPECT_FALSE(seeds->insert(vh));
+                (*seeds)(vh, 0) = (*coords)(vh, 0);
+                expected.push_back(vh);
+            }
+        },
+        NULL,
+        false);
+
+    EXPECT_EQ(seeds->size(), expected.size());
+    EXPECT_LT(seeds->host_bytes(),
+              rx.get_num_vertices() * 2 * sizeof(float));
+
+    // erasing and re-inserting keeps the other values in place
+    EXPECT_TRUE(seeds->erase(expected[0]));
+    EXPECT_FALSE(seeds->has(expected[0]));
+    EXPECT_FALSE(seeds->erase(expected[0]));
+    EXPECT_TRUE(seeds->insert(expected[0], -1.f));
+    (*seeds)(expected[0], 0) = (*coords)(expected[0], 0);
+
+    rx.for_each_vertex(
+        HOST,
+        [&](const VertexHandle vh) {
+            EXPECT_EQ(seeds->has(vh), rx.linear_id(vh) % 7 == 0);
+            EXPECT_EQ(seeds->get(vh, 0, 0.f),
+                      seeds->has(vh) ? (*coords)(vh, 0) : 0.f);
+        },
+        NULL,
+        false);
+
+    // the device visits only the seeds
+    seeds->move(HOST, DEVICE);
+
+    auto s = *seeds;
+    seeds->for_each(DEVICE, [s] __device__(const VertexHandle vh) {
+        s(vh, 1) = 2.f * s(vh, 0);
+    });
+    ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
+    seeds->move(DEVICE, HOST);
+
+    std::atomic<uint32_t> num_visited(0);
+    seeds->for_each(HOST, [&](const VertexHandle vh) {
+        EXPECT_TRUE(seeds->has(vh));
+        EXPECT_EQ((*seeds)(vh, 1), 2.f * (*coords)(vh, 0));
+        num_visited++;
+    });
+    EXPECT_EQ(num_visited, expected.size());
+
+    // swapping a seed for another vertex keeps the size but the device values
+    // no longer match the subset
+    VertexHandle other;
+    rx.for_each_vertex(
+        HOST,
+        [&](const VertexHandle vh) {
+            if (rx.linear_id(vh) == 1) {
+                other = vh;
+            }
+        },
+        NULL,
+        false);
+    EXPECT_TRUE(seeds->erase(expected[0]));
+    EXPECT_TRUE(seeds->insert(other, -1.f));
+    EXPECT_EQ(seeds->size(), expected.size());
+    seeds->move(DEVICE, HOST);
+    EXPECT_EQ((*seeds)(other, 1), -1.f);
+
+    seeds->move(HOST, DEVICE);
+    seeds->move(DEVICE, HOST);
+    EXPECT_EQ((*seeds)(other, 1), -1.f);
+
+    rx.remove_attribute("seeds");
+}
@@ -0,0 +1,165 @@
+#include "gtest/gtest.h"
+
+#include "rxmesh/rxmesh_static.h"
+#include "rxmesh/util/report.h"
+#include "rxmesh/util/timer.h"
+
+TEST(RXMeshStatic, AttributeLayout)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(rxmesh_args.obj_file_name);
+
+    auto coords = rx.get_input_vertex_coordinates();
+
+    const float dt = 0.01f;
+
+    // XPBD-like predict-and-project step on the host: x = x + dt * v followed
+    // by projecting x on the unit sphere. Every vertex reads and writes all 3
+    // components of two attributes
+    auto step = [dt](float* x, const float* v) {
+        float len = 0;
+        for (int i = 0; i < 3; ++i) {
+            x[i] += dt * v[i];
+            len += x[i] * x[i];
+        }
+        const float inv = 1.f / std::sqrt(len + 1e-12f);
+        for (int i = 0; i < 3; ++i) {
+            x[i] *= inv;
+        }
+    };
+
+    auto init = [&](const layoutT layout) {
+        auto x = rx.add_vertex_attribute<float>("x", 3, HOST, layout);
+        auto v = rx.add_vertex_attribute<float>("v", 3, HOST, layout);
+        // AoSoA tile loops also touch the padding lanes
+        x->reset(0.f, HOST);
+        v->reset(0.f, HOST);
+        rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+            for (uint32_t i = 0; i < 3; ++i) {
+                (*x)(vh, i) = (*coords)(vh, i);
+                (*v)(vh, i) = (*coords)(vh, (i + 1) % 3);
+            }
+        });
+        return std::make_pair(x, v);
+    };
+
+    auto collect = [&](VertexAttribute<float>& x) {
+        std::vector<float> ret;
+        rx.for_each_vertex(
+            HOST,
+            [&](const VertexHandle vh) {
+                for (uint32_t i = 0; i < 3; ++i) {
+                    ret.push_back(x(vh, i));
+                }
+            },
+            NULL,
+            false);
+        rx.remove_attribute("x");
+        rx.remove_attribute("v");
+        return ret;
+    };
+
+    // handle-based access works the same for all layouts
+    auto benchmark = [&](const layoutT layout) {
+        auto xv = init(layout);
+        auto x  = xv.first;
+        auto v  = xv.second;
+
+        CPUTimer timer;
+        timer.start();
+        for (uint32_t r = 0; r < rxmesh_args.num_run; ++r) {
+            rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+                float xx[3], vv[3];
+                for (uint32_t i = 0; i < 3; ++i) {
+                    xx[i] = (*x)(vh, i);
+                    vv[i] = (*v)(vh, i);
+                }
+                step(xx, vv);
+                for (uint32_t i = 0; i < 3; ++i) {
+                    (*x)(vh, i) = xx[i];
+                }
+            });
+        }
+        timer.stop();
+
+        const float time_ms = timer.elapsed_millis() / rxmesh_args.num_run;
+        RXMESH_INFO("AttributeLayout {}: {} (ms) per step",
+                    layout_to_string(layout),
+                    time_ms);
+        return std::make_pair(time_ms, collect(*x));
+    };
+
+    // AoSoA tile loop where every lane of a tile is one vertex
+    auto benchmark_tiles = [&]() {
+        auto xv = init(AoSoA);
+        auto x  = xv.first;
+        auto v  = xv.second;
+
+        // tiles are aligned to a full tile of floats
+        for (uint32_t p = 0; p < rx.get_num_patches(); ++p) {
+            for (uint32_t i = 0; i < 3 && x->num_tiles(p) > 0; ++i) {
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(x->tile(p, 0, i)) %
+                              (AOSOA_TILE_WIDTH * sizeof(float)),
+                          0);
+            }
+        }
+
+        CPUTimer timer;
+        timer.start();
+        for (uint32_t r = 0; r < rxmesh_args.num_run; ++r) {
+            rx.get_host_schedule().run(rx.get_num_patches(), [&](uint32_t p) {
+                for (uint32_t t = 0; t < x->num_tiles(p); ++t) {
+                    float* px = x->tile(p, t, 0);
+                    float* py = x->tile(p, t, 1);
+                    float* pz = x->tile(p, t, 2);
+
+                    const float* vx = v->tile(p, t, 0);
+                    const float* vy = v->tile(p, t, 1);
+                    const float* vz = v->tile(p, t, 2);
+#pragma omp simd
+                    for (uint32_t l = 0; l < AOSOA_TILE_WIDTH; ++l) {
+                        float xx[3] = {px[l], py[l], pz[l]};
+                        float vv[3] = {vx[l], vy[l], vz[l]};
+                        step(xx, vv);
+                        px[l] = xx[0];
+                        py[l] = xx[1];
+                        pz[l] = xx[2];
+                    }
+                }
+            });
+        }
+        timer.stop();
+
+        const float time_ms = timer.elapsed_millis() / rxmesh_args.num_run;
+        RXMESH_INFO("AttributeLayout AoSoA tiles: {} (ms) per step", time_ms);
+        return std::make_pair(time_ms, collect(*x));
+    };
+
+    Report report("AttributeLayout");
+    report.command_line(rxmesh_args.argc, rxmesh_args.argv);
+    report.system();
+    report.model_data(rxmesh_args.obj_file_name, rx);
+    report.add_member("tile_width", AOSOA_TILE_WIDTH);
+
+    auto aos   = benchmark(AoS);
+    auto soa   = benchmark(SoA);
+    auto aosoa = benchmark(AoSoA);
+    auto tiles = benchmark_tiles();
+
+    report.add_member("AoS_time_ms", double(aos.first));
+    report.add_member("SoA_time_ms", double(soa.first));
+    report.add_member("AoSoA_time_ms", double(aosoa.first));
+    report.add_member("AoSoA_tiles_time_ms", double(tiles.first));
+
+    // the layout does not change the results
+    EXPECT_EQ(aos.second, soa.second);
+    EXPECT_EQ(aos.second, aosoa.second);
+    ASSERT_EQ(aos.second.size(), tiles.second.size());
+    for (size_t i = 0; i < aos.second.size(); ++i) {
+        EXPECT_NEAR(aos.second[i], tiles.second[i], 1e-5);
+    }
+
+    report.write(rxmesh_args.output_folder + "/AttributeLayout",
+                 extract_file_name(rxmesh_args.obj_file_name));
+}
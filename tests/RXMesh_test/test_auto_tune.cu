@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+
+#include "rxmesh/auto_tune.h"
+
+static uint32_t s_num_tune_calls = 0;
+
+void tune_workload(rxmesh::RXMeshStatic& rx)
+{
+    using namespace rxmesh;
+    s_num_tune_calls++;
+    auto attr = *rx.add_vertex_attribute<float>("tune", 1);
+    rx.for_each_vertex(
+        DEVICE, [=] __device__(const VertexHandle vh) { attr(vh) = 1.f; });
+    rx.remove_attribute("tune");
+}
+
+TEST(RXMeshStatic, AutoTune)
+{
+    using namespace rxmesh;
+
+    std::vector<std::vector<uint32_t>> fv;
+    std::vector<std::vector<float>>    vertices;
+    ASSERT_TRUE(import_obj(STRINGIFY(INPUT_DIR) "dragon.obj", vertices, fv));
+
+    const std::string folder = STRINGIFY(OUTPUT_DIR) "tune_cache";
+    std::filesystem::remove_all(folder);
+
+    TuneCache& cache = TuneCache::instance();
+    cache.set_folder(folder);
+    cache.clear();
+    cache.reset_stats();
+
+    TuneOptions options;
+    options.candidates.clear();
+    for (const uint32_t patch_size : {256u, 512u}) {
+        BuildConfig c;
+        c.patch_size = patch_size;
+        options.candidates.push_back(c);
+    }
+    options.num_runs         = 2;
+    options.max_sample_faces = 10000;
+
+    s_num_tune_calls = 0;
+
+    // tuning runs the workload (1 + num_runs) times for every candidate
+    const BuildConfig tuned =
+        auto_tune("tune", fv, vertices, tune_workload, options);
+    EXPECT_EQ(s_num_tune_calls, 6u);
+    EXPECT_TRUE(tuned == options.candidates[0] ||
+                tuned == options.candidates[1]);
+    EXPECT_EQ(cache.get_num_misses(), 1u);
+
+    // a second call returns the cached configuration
+    EXPECT_TRUE(auto_tune("tune", fv, vertices, tune_workload, options) ==
+                tuned);
+    EXPECT_EQ(s_num_tune_calls, 6u);
+    EXPECT_EQ(cache.get_num_hits(), 1u);
+
+    // a later run reads it from the folder
+    cache.clear();
+    EXPECT_TRUE(auto_tune("tune", fv, vertices, tune_workload, options) ==
+                tuned);
+    EXPECT_EQ(s_num_tune_calls, 6u);
+    EXPECT_EQ(cache.get_num_disk_hits(), 1u);
+
+    // other candidates are tuned again and cached under their own key
+    TuneOptions other_options = options;
+    other_options.candidates.pop_back();
+    EXPECT_TRUE(auto_tune("tune", fv, vertices, tune_workload, other_options) ==
+                other_options.candidates[0]);
+    EXPECT_EQ(s_num_tune_calls, 9u);
+    EXPECT_EQ(cache.get_num_misses(), 2u);
+    EXPECT_EQ(cache.size(), 2u);
+
+    // the sample is a re-indexed part of the input
+    std::vector<std::vector<uint32_t>> sample_fv;
+    std::vector<std::vector<float>>    sample_vertices;
+    detail::subsample_mesh(fv, vertices, 1000, sample_fv, sample_vertices);
+    EXPECT_EQ(sample_fv.size(), 1000u);
+    for (const auto& f : sample_fv) {
+        for (const uint32_t v : f) {
+            EXPECT_LT(v, sample_vertices.size());
+        }
+    }
+
+    cache.set_folder("");
+    cache.clear();
+    std::filesystem::remove_all(folder);
+}
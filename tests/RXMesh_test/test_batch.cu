@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+
+#include "rxmesh/rxmesh_batch.h"
+
+TEST(RXMeshBatch, Batch)
+{
+    using namespace rxmesh;
+
+    std::vector<std::string> files = {STRINGIFY(INPUT_DIR) "sphere3.obj",
+                                      STRINGIFY(INPUT_DIR) "cube.obj",
+                                      STRINGIFY(INPUT_DIR) "torus.obj",
+                                      STRINGIFY(INPUT_DIR) "sphere3.obj"};
+
+    std::vector<std::vector<std::vector<float>>>    vertices_batch;
+    std::vector<std::vector<std::vector<uint32_t>>> fv_batch;
+    ASSERT_TRUE(import_obj_batch(files, vertices_batch, fv_batch));
+
+    RXMeshBatch batch(fv_batch, vertices_batch);
+
+    ASSERT_EQ(batch.get_num_meshes(), files.size());
+
+    uint32_t num_edges = 0;
+    for (uint32_t m = 0; m < batch.get_num_meshes(); ++m) {
+        RXMeshStatic rx(files[m]);
+        EXPECT_EQ(batch.get_mesh_num_vertices(m), rx.get_num_vertices());
+        EXPECT_EQ(batch.get_mesh_num_edges(m), rx.get_num_edges());
+        EXPECT_EQ(batch.get_mesh_num_faces(m), rx.get_num_faces());
+        num_edges += batch.get_mesh_num_edges(m);
+    }
+    EXPECT_EQ(num_edges, batch.get_num_edges());
+
+    // every vertex and face is in the mesh of its patch
+    const MeshBatchInfo info = batch.get_batch_info();
+    batch.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        const uint32_t m = info.get_mesh_id(vh);
+        EXPECT_GE(batch.map_to_global(vh), batch.vertex_offset(m));
+        EXPECT_LT(batch.map_to_global(vh), batch.vertex_offset(m + 1));
+    });
+    batch.for_each_face(HOST, [&](const FaceHandle fh) {
+        const uint32_t m = info.get_mesh_id(fh);
+        EXPECT_GE(batch.map_to_global(fh), batch.face_offset(m));
+        EXPECT_LT(batch.map_to_global(fh), batch.face_offset(m + 1));
+    });
+
+    // one launch over the whole batch followed by a per-mesh reduction
+    auto v_attr = *batch.add_vertex_attribute<float>("v", 1);
+    batch.for_each_vertex(DEVICE, [=] __device__(const VertexHandle vh) {
+        v_attr(vh) = float(info.get_mesh_id(vh) + 1);
+    });
+    ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
+
+    std::vector<float> sum = batch.reduce_per_mesh(v_attr, cub::Sum(), 0.f);
+    for (uint32_t m = 0; m < batch.get_num_meshes(); ++m) {
+        EXPECT_EQ(sum[m], float(m + 1) * batch.get_mesh_num_vertices(m));
+    }
+
+    // export gives back every mesh input
+    auto coords = batch.get_input_vertex_coordinates();
+    for (uint32_t m = 0; m < batch.get_num_meshes(); ++m) {
+        std::vector<std::vector<float>> exported;
+        batch.export_vertex_attribute(m, *coords, exported);
+        EXPECT_EQ(exported, vertices_batch[m]);
+    }
+}
+
+TEST(RXMeshBatch, SmallBatch)
+{
+    using namespace rxmesh;
+
+    // all meshes fit in a single patch so the patcher has to split the patch
+    // by mesh
+    std::vector<std::string> files = {STRINGIFY(INPUT_DIR) "cube.obj",
+                                      STRINGIFY(INPUT_DIR) "cube.obj",
+                                      STRINGIFY(INPUT_DIR) "cube.obj"};
+
+    std::vector<std::vector<std::vector<float>>>    vertices_batch;
+    std::vector<std::vector<std::vector<uint32_t>>> fv_batch;
+    ASSERT_TRUE(import_obj_batch(files, vertices_batch, fv_batch));
+
+    uint32_t num_faces = 0;
+    for (const auto& fv : fv_batch) {
+        num_faces += fv.size();
+    }
+    const uint32_t patch_size = 512;
+    ASSERT_LT(num_faces, patch_size);
+
+    RXMeshBatch batch(fv_batch, vertices_batch, patch_size);
+
+    ASSERT_EQ(batch.get_num_meshes(), files.size());
+    EXPECT_GE(batch.get_num_patches(), batch.get_num_meshes());
+
+    for (uint32_t m = 0; m < batch.get_num_meshes(); ++m) {
+        EXPECT_FALSE(batch.get_mesh_patches(m).empty());
+        EXPECT_EQ(batch.get_mesh_num_vertices(m), vertices_batch[m].size());
+        EXPECT_EQ(batch.get_mesh_num_faces(m), fv_batch[m].size());
+    }
+
+    const MeshBatchInfo info = batch.get_batch_info();
+    batch.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        const uint32_t m = info.get_mesh_id(vh);
+        EXPECT_GE(batch.map_to_global(vh), batch.vertex_offset(m));
+        EXPECT_LT(batch.map_to_global(vh), batch.vertex_offset(m + 1));
+    });
+    batch.for_each_face(HOST, [&](const FaceHandle fh) {
+        const uint32_t m = info.get_mesh_id(fh);
+        EXPECT_GE(batch.map_to_global(fh), batch.face_offset(m));
+        EXPECT_LT(batch.map_to_global(fh), batch.face_offset(m + 1));
+    });
+
+    auto v_attr = *batch.add_vertex_attribute<float>("v", 1);
+    batch.for_each_vertex(DEVICE, [=] __device__(const VertexHandle vh) {
+        v_attr(vh) = float(info.get_mesh_id(vh) + 1);
+    });
+    ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
+
+    std::vector<float> sum = batch.reduce_per_mesh(v_attr, cub::Sum(), 0.f);
+    for (uint32_t m = 0; m < batch.get_num_meshes(); ++m) {
+        EXPECT_EQ(sum[m], float(m + 1) * batch.get_mesh_num_vertices(m));
+    }
+
+    auto coords = batch.get_input_vertex_coordinates();
+    for (uint32_t m = 0; m < batch.get_num_meshes(); ++m) {
+        std::vector<std::vector<float>> exported;
+        batch.export_vertex_attribute(m, *coords, exported);
+        EXPECT_EQ(exported, vertices_batch[m]);
+    }
+}
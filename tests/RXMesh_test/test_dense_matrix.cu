@@ -247,3 +247,89 @@ TEST(RXMeshStatic, DenseMatrixSwap)
 
     EXPECT_EQ(cudaDeviceSynchronize(), cudaSuccess);
 }
+
+TEST(RXMeshStatic, DenseMatrixAttributeView)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    // a static mesh numbers the owned elements first
+    EXPECT_TRUE(rx.is_row_ordered<VertexHandle>());
+    EXPECT_TRUE(rx.is_row_ordered<EdgeHandle>());
+    EXPECT_TRUE(rx.is_row_ordered<FaceHandle>());
+
+    // the block copy matches the handle-based row mapping for all layouts
+    for (layoutT layout : {AoS, SoA, AoSoA}) {
+        auto attr = rx.add_face_attribute<float>("f", 3, LOCATION_ALL, layout);
+
+        rx.for_each_face(HOST, [&](const FaceHandle fh) {
+            for (uint32_t j = 0; j < 3; ++j) {
+                (*attr)(fh, j) = float(rx.linear_id(fh) * 3 + j);
+            }
+        });
+
+        auto mat = attr->to_matrix();
+        rx.for_each_face(HOST, [&](const FaceHandle fh) {
+            for (uint32_t j = 0; j < 3; ++j) {
+                EXPECT_EQ((*mat)(rx.linear_id(fh), j), (*attr)(fh, j));
+            }
+        });
+
+        mat->multiply(2.f);
+        mat->move(DEVICE, HOST);
+        attr->from_matrix(mat.get());
+        rx.for_each_face(HOST, [&](const FaceHandle fh) {
+            for (uint32_t j = 0; j < 3; ++j) {
+                EXPECT_EQ((*attr)(fh, j),
+                          float(2 * (rx.linear_id(fh) * 3 + j)));
+            }
+        });
+
+        mat->release();
+        rx.remove_attribute("f");
+    }
+
+    // sphere3 has more than one patch so the view is a copy
+    auto s_attr = rx.add_vertex_attribute<float>("v", 1);
+    auto s_view = s_attr->to_matrix_view();
+    EXPECT_GT(rx.get_num_patches(), 1);
+    EXPECT_FALSE(s_attr->is_matrix_aliasable());
+    EXPECT_FALSE(s_view->is_view());
+    s_view->release();
+    rx.remove_attribute("v");
+
+    // a view writes directly to the attribute if the mesh has a single patch
+    RXMeshStatic cube(STRINGIFY(INPUT_DIR) "cube.obj");
+    ASSERT_EQ(cube.get_num_patches(), 1);
+
+    auto v_attr = cube.add_vertex_attribute<float>("v", 1);
+    v_attr->reset(1.f, LOCATION_ALL);
+
+    auto view = v_attr->to_matrix_view();
+    EXPECT_TRUE(v_attr->is_matrix_aliasable());
+    ASSERT_TRUE(view->is_view());
+
+    // a host write through the view is seen by the attribute without
+    // from_matrix()
+    cube.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        (*view)(vh, 0) = float(cube.linear_id(vh));
+    });
+    cube.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        EXPECT_EQ((*v_attr)(vh), float(cube.linear_id(vh)));
+    });
+
+    // and so is a device write
+    view->reset(3.f, DEVICE);
+    v_attr->move(DEVICE, HOST);
+    cube.for_each_vertex(
+        HOST, [&](const VertexHandle vh) { EXPECT_EQ((*v_attr)(vh), 3.f); });
+
+    // from_matrix() of a view is a no-op
+    v_attr->from_matrix(view.get());
+    cube.for_each_vertex(
+        HOST, [&](const VertexHandle vh) { EXPECT_EQ((*v_attr)(vh), 3.f); });
+
+    view->release();
+    cube.remove_attribute("v");
+}
@@ -58,4 +58,52 @@ TEST(RXMeshStatic, Export)
 
 
     ASSERT_EQ(cudaDeviceSynchronize(), cudaSuccess);
-}
\ No newline at end of file
+}
+
+TEST(RXMeshStatic, IndexMap)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    const IndexMap<VertexHandle>& v_map = rx.get_index_map<VertexHandle>();
+    const IndexMap<FaceHandle>&   f_map = rx.get_index_map<FaceHandle>();
+
+    EXPECT_EQ(v_map.size(), rx.get_num_vertices());
+    EXPECT_EQ(f_map.size(), rx.get_num_faces());
+
+    std::vector<uint32_t> v_count(rx.get_num_vertices(), 0);
+
+    rx.for_each_vertex(
+        HOST,
+        [&](const VertexHandle vh) {
+            const uint32_t id = v_map.linear_id(vh);
+            ASSERT_LT(id, rx.get_num_vertices());
+            v_count[id]++;
+            EXPECT_EQ(v_map.handle(id), vh);
+            EXPECT_EQ(rx.map_to_local_vertex(id), vh);
+            EXPECT_EQ(v_map.global_id(id), rx.map_to_global(vh));
+            EXPECT_EQ(v_map.linear_from_global(rx.map_to_global(vh)), id);
+        },
+        NULL,
+        false);
+
+    // the linear ids are a permutation
+    for (uint32_t c : v_count) {
+        EXPECT_EQ(c, 1);
+    }
+
+    // not-owned vertices map to the linear id of their owner
+    for (uint32_t p = 0; p < rx.get_num_patches(); ++p) {
+        const PatchInfo& pi = rx.get_patch(p);
+        for (uint16_t l = 0; l < pi.num_vertices[0]; ++l) {
+            const VertexHandle vh(p, l);
+            EXPECT_EQ(v_map.linear_id(vh),
+                      v_map.linear_id(rx.get_owner_handle(vh)));
+        }
+    }
+
+    rx.for_each_face(HOST, [&](const FaceHandle fh) {
+        EXPECT_EQ(f_map.handle(f_map.linear_id(fh)), fh);
+    });
+}
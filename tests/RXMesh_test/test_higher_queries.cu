@@ -50,4 +50,102 @@ TEST(RXMeshStatic, DISABLED_HigherQueries)
 
     // verify
     EXPECT_TRUE(tester.run_test(rx, Faces, *input, *output, true));
-}
\ No newline at end of file
+}
+
+template <typename HandleT>
+void check_k_ring(rxmesh::RXMeshStatic& rx, const uint32_t rings)
+{
+    using namespace rxmesh;
+
+    KRing<HandleT> k_ring = rx.compute_k_ring<HandleT>(rings, HOST);
+
+    // the reference is the k-ring pattern and its 1-ring prefix
+    SparsePatternDesc desc;
+    desc.op       = KRing<HandleT>::ring_op();
+    desc.diagonal = false;
+    desc.rings    = rings;
+    auto ref      = rx.get_sparse_pattern(desc);
+    desc.rings    = 1;
+    auto one_ring = rx.get_sparse_pattern(desc);
+
+    ASSERT_EQ(k_ring.get_num_rows(), uint32_t(ref->num_rows));
+    EXPECT_EQ(k_ring.get_nnz(), uint32_t(ref->nnz()));
+
+    rx.for_each<HandleT>(
+        HOST,
+        [&](const HandleT h) {
+            const uint32_t r = rx.linear_id(h);
+            EXPECT_EQ(k_ring.row(h), r);
+            ASSERT_EQ(k_ring.size(h),
+                      uint32_t(ref->row_ptr[r + 1] - ref->row_ptr[r]));
+            EXPECT_LE(k_ring.size(h), k_ring.get_max_size());
+
+            std::vector<uint32_t> got;
+            for (uint32_t i = 0; i < k_ring.size(h); ++i) {
+                got.push_back(rx.linear_id(k_ring(h, i)));
+            }
+
+            // breadth-first order: the 1-ring comes first
+            const uint32_t n1 = one_ring->row_ptr[r + 1] - one_ring->row_ptr[r];
+            std::vector<uint32_t> first(got.begin(), got.begin() + n1);
+            std::sort(first.begin(), first.end());
+            EXPECT_TRUE(std::equal(first.begin(),
+                                   first.end(),
+                                   one_ring->col_idx.begin() +
+                                       one_ring->row_ptr[r]));
+
+            std::sort(got.begin(), got.end());
+            EXPECT_TRUE(std::equal(got.begin(),
+                                   got.end(),
+                                   ref->col_idx.begin() + ref->row_ptr[r]));
+        },
+        NULL,
+        false);
+
+    k_ring.release();
+}
+
+TEST(RXMeshStatic, KRing)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    check_k_ring<VertexHandle>(rx, 1);
+    check_k_ring<VertexHandle>(rx, 2);
+    check_k_ring<VertexHandle>(rx, 3);
+    check_k_ring<EdgeHandle>(rx, 2);
+    check_k_ring<FaceHandle>(rx, 2);
+
+    // the same rings are seen on the device
+    VertexKRing k_ring = rx.compute_k_ring<VertexHandle>(2);
+
+    auto size = *rx.add_vertex_attribute<uint32_t>("size", 2);
+    size.reset(0, LOCATION_ALL);
+
+    rx.for_each_vertex(DEVICE, [=] __device__(const VertexHandle vh) {
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < k_ring.size(vh); ++i) {
+            sum += k_ring.row(k_ring(vh, i));
+        }
+        size(vh, 0) = k_ring.size(vh);
+        size(vh, 1) = sum;
+    });
+    CUDA_ERROR(cudaDeviceSynchronize());
+    size.move(DEVICE, HOST);
+
+    rx.for_each_vertex(
+        HOST,
+        [&](const VertexHandle vh) {
+            uint32_t sum = 0;
+            for (uint32_t i = 0; i < k_ring.size(vh); ++i) {
+                sum += rx.linear_id(k_ring(vh, i));
+            }
+            EXPECT_EQ(size(vh, 0), k_ring.size(vh));
+            EXPECT_EQ(size(vh, 1), sum);
+        },
+        NULL,
+        false);
+
+    k_ring.release();
+}
@@ -0,0 +1,140 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+
+#include "rxmesh/host_schedule.h"
+#include "rxmesh/rxmesh_static.h"
+#include "rxmesh/util/report.h"
+#include "rxmesh/util/timer.h"
+
+TEST(RXMeshStatic, HostSchedule)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(rxmesh_args.obj_file_name);
+
+    // benchmark a streaming host loop with the default OpenMP loop and the
+    // NUMA-aware schedule. On a multi-socket machine, the NUMA-aware schedule
+    // should avoid the cross-socket traffic
+    auto benchmark = [&](const std::string& name) {
+        auto v_attr = rx.add_vertex_attribute<float>("v", 3, HOST);
+        v_attr->reset(1.f, HOST);
+
+        CPUTimer timer;
+        timer.start();
+        for (uint32_t i = 0; i < rxmesh_args.num_run; ++i) {
+            rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+                for (uint32_t a = 0; a < 3; ++a) {
+                    (*v_attr)(vh, a) = 0.5f * (*v_attr)(vh, a) + 1.f;
+                }
+            });
+        }
+        timer.stop();
+
+        const float time_ms = timer.elapsed_millis() / rxmesh_args.num_run;
+        RXMESH_INFO("HostSchedule {}: {} (ms) per for_each_vertex",
+                    name,
+                    time_ms);
+
+        std::vector<float> ret;
+        rx.for_each_vertex(
+            HOST,
+            [&](const VertexHandle vh) {
+                for (uint32_t a = 0; a < 3; ++a) {
+                    ret.push_back((*v_attr)(vh, a));
+                }
+            },
+            NULL,
+            false);
+
+        rx.remove_attribute("v");
+        return std::make_pair(time_ms, ret);
+    };
+
+    Report report("HostSchedule");
+    report.command_line(rxmesh_args.argc, rxmesh_args.argv);
+    report.system();
+    report.model_data(rxmesh_args.obj_file_name, rx);
+    report.add_member("num_numa_nodes", NumaTopology::instance().num_nodes());
+
+    auto default_res = benchmark("default");
+    report.add_member("default_time_ms", double(default_res.first));
+
+    HostExecutionPolicy policy;
+    policy.numa_aware = true;
+    rx.set_host_execution_policy(policy);
+
+    const HostPatchSchedule& schedule = rx.get_host_schedule();
+    EXPECT_TRUE(schedule.is_numa_aware());
+    EXPECT_EQ(schedule.get_num_patches(), rx.get_max_num_patches());
+
+    // the thread ranges are contiguous and cover all patches
+    EXPECT_EQ(schedule.thread_begin(0), 0);
+    EXPECT_EQ(schedule.thread_end(schedule.get_num_threads() - 1),
+              rx.get_max_num_patches());
+    for (int t = 0; t < schedule.get_num_threads(); ++t) {
+        EXPECT_LE(schedule.thread_begin(t), schedule.thread_end(t));
+        EXPECT_LT(schedule.thread_node(t),
+                  NumaTopology::instance().num_nodes());
+        for (uint32_t p = schedule.thread_begin(t); p < schedule.thread_end(t);
+             ++p) {
+            EXPECT_EQ(schedule.patch_thread(p), t);
+        }
+    }
+
+    // every element is visited once
+    std::atomic<uint32_t> num_faces(0);
+    rx.for_each_face(HOST, [&](const FaceHandle fh) { num_faces++; });
+    EXPECT_EQ(num_faces.load(), rx.get_num_faces());
+
+    // every patch is visited once even if the team is smaller than the
+    // schedule (nested region) or the loop has more patches than the schedule
+    {
+        HostExecutionPolicy small_policy;
+        small_policy.numa_aware  = true;
+        small_policy.num_threads = 4;
+        small_policy.pin_threads = true;
+
+        HostPatchSchedule small;
+        small.build(small_policy, std::vector<uint32_t>(16, 1));
+
+#ifdef __linux__
+        cpu_set_t before;
+        CPU_ZERO(&before);
+        sched_getaffinity(0, sizeof(cpu_set_t), &before);
+#endif
+
+        std::vector<std::atomic<uint32_t>> visits(20);
+        for (auto& v : visits) {
+            v = 0;
+        }
+        auto count = [&](uint32_t p) { visits[p]++; };
+#pragma omp parallel num_threads(2)
+        {
+#pragma omp single
+            small.run(16, count);
+        }
+        small.run(20, count);
+        for (uint32_t p = 0; p < 20; ++p) {
+            EXPECT_EQ(visits[p].load(), (p < 16) ? 2u : 1u);
+        }
+
+#ifdef __linux__
+        // the calling thread is not pinned
+        cpu_set_t after;
+        CPU_ZERO(&after);
+        sched_getaffinity(0, sizeof(cpu_set_t), &after);
+        EXPECT_TRUE(CPU_EQUAL(&before, &after));
+#endif
+    }
+
+    auto numa_res = benchmark("numa_aware");
+    report.add_member("numa_aware_time_ms", double(numa_res.first));
+    report.add_member("num_threads", schedule.get_num_threads());
+
+    // the schedule does not change the results
+    EXPECT_EQ(default_res.second, numa_res.second);
+
+    report.write(rxmesh_args.output_folder + "/HostSchedule",
+                 extract_file_name(rxmesh_args.obj_file_name));
+}
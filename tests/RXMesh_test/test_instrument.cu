@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+
+#include <omp.h>
+#include <filesystem>
+#include <fstream>
+
+#include <rapidjson/document.h>
+#include <rapidjson/istreamwrapper.h>
+
+#include "rxmesh/util/instrument.h"
+#include "rxmesh/util/macros.h"
+
+TEST(Util, Instrument)
+{
+    using namespace rxmesh;
+
+    Instrument& inst = Instrument::instance();
+    inst.clear();
+    inst.enable(true);
+
+    const size_t num_before = inst.num_events();
+
+    {
+        ScopedZone outer("outer");
+        outer.counter("answer", 42);
+        {
+            ScopedZone inner("inner");
+        }
+    }
+
+    int num_threads = 0;
+#pragma omp parallel
+    {
+#pragma omp single
+        num_threads = omp_get_num_threads();
+        ScopedZone zone("parallel");
+    }
+
+    EXPECT_EQ(inst.num_events(), num_before + 2 + num_threads);
+
+    // disabled collector should not record anything
+    inst.enable(false);
+    {
+        ScopedZone zone("ignored");
+    }
+    EXPECT_EQ(inst.num_events(), num_before + 2 + num_threads);
+    inst.enable(true);
+
+    std::filesystem::path filename =
+        std::filesystem::path(STRINGIFY(OUTPUT_DIR)) / "instrument_trace.json";
+    std::filesystem::create_directories(filename.parent_path());
+    inst.write_chrome_trace(filename.string());
+
+    std::ifstream             ifs(filename);
+    rapidjson::IStreamWrapper isw(ifs);
+    rapidjson::Document       doc;
+    doc.ParseStream(isw);
+    ASSERT_FALSE(doc.HasParseError());
+    ASSERT_TRUE(doc.HasMember("traceEvents"));
+
+    uint32_t num_complete = 0;
+    bool     found_counter = false;
+    for (const auto& e : doc["traceEvents"].GetArray()) {
+        if (std::string(e["ph"].GetString()) != "X") {
+            continue;
+        }
+        num_complete++;
+        EXPECT_GE(e["dur"].GetInt64(), 0);
+        if (std::string(e["name"].GetString()) == "outer") {
+            ASSERT_TRUE(e.HasMember("args"));
+            EXPECT_EQ(e["args"]["answer"].GetDouble(), 42.0);
+            found_counter = true;
+        }
+    }
+    EXPECT_EQ(num_complete, inst.num_events());
+    EXPECT_TRUE(found_counter);
+
+    inst.clear();
+    EXPECT_EQ(inst.num_events(), 0);
+}
@@ -0,0 +1,308 @@
+#include "gtest/gtest.h"
+
+#include <omp.h>
+#include <map>
+#include <queue>
+
+#include "rxmesh/matrix/sparse_algebra.h"
+#include "rxmesh/rxmesh_static.h"
+#include "rxmesh/util/report.h"
+
+TEST(RXMeshStatic, GeometricPartition)
+{
+    using namespace rxmesh;
+
+    std::vector<std::vector<uint32_t>> fv;
+    std::vector<std::vector<float>>    vertices;
+    ASSERT_TRUE(import_obj(STRINGIFY(INPUT_DIR) "dragon.obj", vertices, fv));
+
+    const uint32_t patch_size = 256;
+
+    // faces that share an edge
+    std::vector<std::vector<uint32_t>> ff(fv.size());
+    {
+        std::map<std::pair<uint32_t, uint32_t>, std::vector<uint32_t>> ef;
+        for (uint32_t f = 0; f < fv.size(); ++f) {
+            for (uint32_t i = 0; i < fv[f].size(); ++i) {
+                uint32_t v0 = fv[f][i];
+                uint32_t v1 = fv[f][(i + 1) % fv[f].size()];
+                ef[{std::min(v0, v1), std::max(v0, v1)}].push_back(f);
+            }
+        }
+        for (const auto& e : ef) {
+            for (const uint32_t f0 : e.second) {
+                for (const uint32_t f1 : e.second) {
+                    if (f0 != f1) {
+                        ff[f0].push_back(f1);
+                    }
+                }
+            }
+        }
+    }
+
+    for (const PartitionMethod method : {PartitionMethod::METIS,
+                                         PartitionMethod::Morton,
+                                         PartitionMethod::Inertial}) {
+        PartitionPolicy policy;
+        policy.method = method;
+
+        RXMeshStatic rx(fv, vertices, "", patch_size, 1.0, 1.0, 0.8, policy);
+
+        EXPECT_EQ(rx.get_partition_method(), method);
+        EXPECT_EQ(rx.get_num_vertices(), vertices.size());
+        EXPECT_EQ(rx.get_num_faces(), fv.size());
+
+        // disconnected chunks are split into more patches
+        if (method != PartitionMethod::METIS) {
+            EXPECT_GE(rx.get_num_patches(), DIVIDE_UP(fv.size(), patch_size));
+        }
+
+        // the owned faces of every patch are face-connected
+        std::vector<uint32_t> face_patch(fv.size(), INVALID32);
+        rx.for_each_face(HOST, [&](const FaceHandle fh) {
+            face_patch[rx.map_to_global(fh)] = fh.patch_id();
+        });
+        std::vector<uint32_t> num_components(rx.get_num_patches(), 0);
+        std::vector<bool>     visited(fv.size(), false);
+        for (uint32_t seed = 0; seed < fv.size(); ++seed) {
+            if (visited[seed]) {
+                continue;
+            }
+            const uint32_t p = face_patch[seed];
+            ASSERT_LT(p, rx.get_num_patches());
+            num_components[p]++;
+            std::queue<uint32_t> queue;
+            queue.push(seed);
+            visited[seed] = true;
+            while (!queue.empty()) {
+                const uint32_t f = queue.front();
+                queue.pop();
+                for (const uint32_t n : ff[f]) {
+                    if (!visited[n] && face_patch[n] == p) {
+                        visited[n] = true;
+                        queue.push(n);
+                    }
+                }
+            }
+        }
+        for (uint32_t p = 0; p < rx.get_num_patches(); ++p) {
+            EXPECT_EQ(num_components[p], 1u);
+        }
+
+        // the coordinates land on the right vertices
+        auto coords = rx.get_input_vertex_coordinates();
+        rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+            const uint32_t v = rx.map_to_global(vh);
+            for (uint32_t i = 0; i < 3; ++i) {
+                EXPECT_EQ((*coords)(vh, i), vertices[v][i]);
+            }
+        });
+
+        RXMESH_INFO(
+            "{} partition: #patches = {}, ribbon overhead = {:.2f}%, "
+            "patching time = {} (ms)",
+            partition_method_to_string(method),
+            rx.get_num_patches(),
+            rx.get_ribbon_overhead(),
+            rx.get_patching_time());
+    }
+}
+
+TEST(RXMeshStatic, PartitionDiagnostics)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "dragon.obj", "", 256);
+
+    const PartitionDiagnostics diag = rx.compute_partition_diagnostics();
+
+    const uint32_t num_patches = rx.get_num_patches();
+    ASSERT_EQ(diag.num_owned_faces.size(), num_patches);
+
+    uint32_t num_v(0), num_e(0), num_f(0);
+    for (uint32_t p = 0; p < num_patches; ++p) {
+        num_v += diag.num_owned_vertices[p];
+        num_e += diag.num_owned_edges[p];
+        num_f += diag.num_owned_faces[p];
+
+        EXPECT_EQ(diag.num_ribbon_faces[p],
+                  rx.get_num_faces(p) - diag.num_owned_faces[p]);
+        EXPECT_LE(diag.num_neighbor_patches[p], diag.patch_stash_size);
+        if (num_patches > 1) {
+            EXPECT_GT(diag.edge_cut[p], 0u);
+            EXPECT_GT(diag.num_neighbor_patches[p], 0u);
+        }
+        EXPECT_GE(diag.lp_load_factor_v[p], 0.f);
+        EXPECT_LE(diag.lp_load_factor_v[p], 1.f);
+        EXPECT_LE(diag.lp_load_factor_e[p], 1.f);
+        EXPECT_LE(diag.lp_load_factor_f[p], 1.f);
+    }
+    EXPECT_EQ(num_v, rx.get_num_vertices());
+    EXPECT_EQ(num_e, rx.get_num_edges());
+    EXPECT_EQ(num_f, rx.get_num_faces());
+    EXPECT_EQ(diag.num_colors, rx.get_num_colors());
+
+    Report report("PartitionDiagnostics");
+    report.partition_diagnostics(rx);
+    EXPECT_TRUE(report.m_doc.HasMember("PartitionDiagnostics"));
+}
+
+TEST(RXMeshStatic, SuperPatches)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "dragon.obj", "", 256);
+
+    const uint32_t      patches_per_super = 4;
+    const SuperPatches& sp = rx.get_super_patches(patches_per_super);
+
+    ASSERT_TRUE(sp.is_built());
+    EXPECT_EQ(sp.get_num_patches(), rx.get_num_patches());
+    EXPECT_GT(sp.get_num_super_patches(), 0);
+    EXPECT_LE(sp.get_num_super_patches(), rx.get_num_patches());
+
+    // every patch is in exactly one super-patch
+    std::vector<uint32_t> count(rx.get_num_patches(), 0);
+    for (uint32_t s = 0; s < sp.get_num_super_patches(); ++s) {
+        EXPECT_GT(sp.get_num_patches(s), 0);
+        for (uint32_t i = 0; i < sp.get_num_patches(s); ++i) {
+            const uint32_t p = sp.get_patch(s, i);
+            EXPECT_EQ(sp.get_super_patch(p), s);
+            count[p]++;
+        }
+    }
+    for (uint32_t p = 0; p < rx.get_num_patches(); ++p) {
+        EXPECT_EQ(count[p], 1);
+    }
+
+    // the super-patch graph is symmetric and has no self loops
+    for (uint32_t s = 0; s < sp.get_num_super_patches(); ++s) {
+        for (uint32_t i = 0; i < sp.get_num_neighbors(s); ++i) {
+            const uint32_t n = sp.get_neighbor(s, i);
+            EXPECT_NE(n, s);
+            bool found = false;
+            for (uint32_t j = 0; j < sp.get_num_neighbors(n); ++j) {
+                if (sp.get_neighbor(n, j) == s) {
+                    EXPECT_EQ(sp.get_neighbor_weight(n, j),
+                              sp.get_neighbor_weight(s, i));
+                    found = true;
+                }
+            }
+            EXPECT_TRUE(found);
+        }
+    }
+
+    // super-patches are not split between parts
+    const uint32_t        num_parts = 3;
+    std::vector<uint32_t> part      = sp.partition(num_parts);
+    for (uint32_t p = 0; p < rx.get_num_patches(); ++p) {
+        EXPECT_LT(part[p], num_parts);
+        const uint32_t s = sp.get_super_patch(p);
+        EXPECT_EQ(part[p], part[sp.get_patch(s, 0)]);
+    }
+
+    // the super-patch aggregation of the vertices: transpose(P) * P is the
+    // diagonal of the number of vertices per super-patch
+    const std::vector<uint32_t> agg =
+        rx.get_super_patch_aggregates<VertexHandle>(patches_per_super);
+    ASSERT_EQ(agg.size(), rx.get_num_vertices());
+    HostSparseMatrix<double> P =
+        aggregation_prolongation<double>(agg, sp.get_num_super_patches());
+    HostSparseMatrix<double> PtP = spgemm(transpose(P), P);
+    EXPECT_EQ(PtP.rows(), int(sp.get_num_super_patches()));
+    EXPECT_EQ(PtP.non_zeros(), PtP.rows());
+    double num_agg_vertices = 0;
+    for (int s = 0; s < PtP.rows(); ++s) {
+        EXPECT_EQ(PtP.col_idx()[PtP.row_ptr()[s]], s);
+        EXPECT_GT(PtP.val[s], 0);
+        num_agg_vertices += PtP.val[s];
+    }
+    EXPECT_EQ(num_agg_vertices, double(rx.get_num_vertices()));
+
+    // host loops over the super-patch order visit every element once
+    HostExecutionPolicy policy;
+    policy.numa_aware       = true;
+    policy.super_patch_size = patches_per_super;
+    rx.set_host_execution_policy(policy);
+
+    const HostPatchSchedule& schedule = rx.get_host_schedule();
+    for (uint32_t i = 0; i < rx.get_num_patches(); ++i) {
+        EXPECT_EQ(schedule.patch_at(i), sp.get_patch_order()[i]);
+    }
+
+    std::atomic<uint32_t> num_faces(0);
+    rx.for_each_face(HOST, [&](const FaceHandle fh) { num_faces++; });
+    EXPECT_EQ(num_faces.load(), rx.get_num_faces());
+
+    // the plain (not NUMA-aware) loop follows the super-patch order too. A
+    // single thread shows the visit order
+    policy.numa_aware = false;
+    rx.set_host_execution_policy(policy);
+
+    std::vector<uint32_t> visits;
+    const int             max_threads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    rx.get_host_schedule().run(rx.get_num_patches(),
+                               [&](uint32_t p) { visits.push_back(p); });
+    omp_set_num_threads(max_threads);
+    ASSERT_EQ(visits.size(), rx.get_num_patches());
+    for (uint32_t i = 0; i < rx.get_num_patches(); ++i) {
+        EXPECT_EQ(visits[i], sp.get_patch_order()[i]);
+    }
+
+    RXMESH_INFO("#patches = {}, #super-patches = {}",
+                rx.get_num_patches(),
+                sp.get_num_super_patches());
+}
+
+TEST(RXMeshStatic, BuildStages)
+{
+    using namespace rxmesh;
+
+    // the stage times with one thread and with all threads
+    const int max_threads = omp_get_max_threads();
+
+    std::vector<std::vector<std::pair<std::string, float>>> stages;
+    for (const int num_threads : {1, max_threads}) {
+        omp_set_num_threads(num_threads);
+        RXMeshStatic dragon(STRINGIFY(INPUT_DIR) "dragon.obj");
+        stages.push_back(dragon.get_build_stage_times());
+    }
+    omp_set_num_threads(max_threads);
+
+    ASSERT_EQ(stages[0].size(), 6);
+    ASSERT_EQ(stages[1].size(), stages[0].size());
+    for (size_t i = 0; i < stages[0].size(); ++i) {
+        EXPECT_EQ(stages[0][i].first, stages[1][i].first);
+        EXPECT_GE(stages[0][i].second, 0.f);
+        EXPECT_GE(stages[1][i].second, 0.f);
+        RXMESH_INFO("{}: 1 thread = {} (ms), {} threads = {} (ms)",
+                    stages[0][i].first,
+                    stages[0][i].second,
+                    max_threads,
+                    stages[1][i].second);
+    }
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    // every mesh element is owned by exactly one patch
+    auto check = [&](auto handle_type, uint32_t num_elements) {
+        using HandleT = decltype(handle_type);
+
+        std::vector<std::atomic<uint32_t>> count(num_elements);
+        for (auto& c : count) {
+            c = 0;
+        }
+        rx.for_each<HandleT>(HOST, [&](const HandleT h) {
+            const uint32_t g = rx.map_to_global(h);
+            ASSERT_LT(g, num_elements);
+            count[g]++;
+        });
+        for (uint32_t i = 0; i < num_elements; ++i) {
+            EXPECT_EQ(count[i].load(), 1);
+        }
+    };
+    check(VertexHandle(), rx.get_num_vertices());
+    check(EdgeHandle(), rx.get_num_edges());
+    check(FaceHandle(), rx.get_num_faces());
+}
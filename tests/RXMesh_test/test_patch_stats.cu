@@ -0,0 +1,48 @@
+#include "gtest/gtest.h"
+
+#include "rxmesh/rxmesh_static.h"
+#include "rxmesh/util/report.h"
+
+TEST(RXMeshStatic, PatchStats)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    EXPECT_EQ(rx.get_patch_stats(), nullptr);
+
+    rx.enable_patch_stats(true);
+
+    PatchStats* stats = rx.get_patch_stats();
+    ASSERT_NE(stats, nullptr);
+
+    rx.for_each_vertex(HOST, [&](const VertexHandle vh) {});
+
+    uint64_t num_visited = 0;
+    for (uint32_t p = 0; p < rx.get_num_patches(); ++p) {
+        num_visited += stats->get(PatchCounter::Visited, p);
+        EXPECT_GE(stats->get_host_time(p), 0.f);
+    }
+    EXPECT_EQ(num_visited, rx.get_num_vertices());
+
+    DistributionSummary summary =
+        stats->summarize(PatchCounter::Visited, rx.get_num_patches());
+    EXPECT_DOUBLE_EQ(summary.total, double(rx.get_num_vertices()));
+    EXPECT_LE(summary.min, summary.median);
+    EXPECT_LE(summary.median, summary.p90);
+    EXPECT_LE(summary.p90, summary.max);
+    EXPECT_GE(summary.imbalance, 1.0);
+
+    Report report("PatchStats");
+    report.patch_stats("for_each_vertex", rx);
+    EXPECT_TRUE(report.m_doc.HasMember("for_each_vertex"));
+
+    stats->reset();
+    rx.for_each_face(HOST, [&](const FaceHandle fh) {});
+    EXPECT_DOUBLE_EQ(
+        stats->summarize(PatchCounter::Visited, rx.get_num_patches()).total,
+        double(rx.get_num_faces()));
+
+    rx.enable_patch_stats(false);
+    EXPECT_EQ(rx.get_patch_stats(), nullptr);
+}
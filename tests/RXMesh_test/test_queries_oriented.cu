@@ -1,3 +1,4 @@
+#include <atomic>
 #include <functional>
 #include <numeric>
 #include <vector>
@@ -223,4 +224,160 @@ TEST(RXMeshStatic, Oriented_VV_Closed)
             }
         }
     });
-}
\ No newline at end of file
+}
+
+TEST(RXMeshStatic, Oriented_Host)
+{
+    using namespace rxmesh;
+
+    for (const std::string file : {"plane.obj", "sphere3.obj"}) {
+        std::vector<std::vector<float>>    Verts;
+        std::vector<std::vector<uint32_t>> Faces;
+
+        ASSERT_TRUE(import_obj(STRINGIFY(INPUT_DIR) + file, Verts, Faces));
+
+        RXMeshStatic rx(Faces);
+
+        std::shared_ptr<const OrientedOneRing> ring =
+            rx.get_oriented_one_ring();
+
+        // the cache is reused
+        EXPECT_EQ(ring.get(), rx.get_oriented_one_ring().get());
+
+        std::atomic<uint32_t> num_open(0);
+
+        rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+            const auto vv = ring->get<Op::VV>(vh);
+            const auto ve = ring->get<Op::VE>(vh);
+            const auto vf = ring->get<Op::VF>(vh);
+
+            const uint32_t v = rx.map_to_global(vh);
+
+            ASSERT_EQ(vv.size(), ve.size());
+            ASSERT_TRUE(vv.size() == vf.size() || vv.size() == vf.size() + 1);
+            if (ring->is_open(vh)) {
+                num_open++;
+            }
+
+            for (uint32_t i = 0; i < vv.size(); ++i) {
+                const uint32_t a = rx.map_to_global(vv[i]);
+
+                // the i-th edge connects the vertex to its i-th neighbor
+                const EdgeHandle eh = ve[i];
+                const PatchInfo& pi = rx.get_patch(eh.patch_id());
+
+                const uint32_t e0 = rx.map_to_global(VertexHandle(
+                    eh.patch_id(), pi.ev[2 * eh.local_id()].id));
+                const uint32_t e1 = rx.map_to_global(VertexHandle(
+                    eh.patch_id(), pi.ev[2 * eh.local_id() + 1].id));
+                EXPECT_TRUE((e0 == v && e1 == a) || (e0 == a && e1 == v));
+            }
+
+            // the i-th face is (v, vv[i], vv[i+1]) in this order
+            for (uint32_t i = 0; i < vf.size(); ++i) {
+                const std::vector<uint32_t>& f = Faces[rx.map_to_global(vf[i])];
+
+                const uint32_t a = rx.map_to_global(vv[i]);
+                const uint32_t b = rx.map_to_global(vv[(i + 1) % vv.size()]);
+
+                uint32_t k = 0;
+                while (k < 3 && f[k] != v) {
+                    ++k;
+                }
+                ASSERT_LT(k, 3);
+                EXPECT_EQ(f[(k + 1) % 3], a);
+                EXPECT_EQ(f[(k + 2) % 3], b);
+            }
+        });
+
+        EXPECT_EQ(num_open.load() == 0, rx.is_closed());
+
+        // the host query path gives the same order
+        rx.for_each_oriented<Op::VV>(
+            [&](const VertexHandle                   vh,
+                const OneRingIterator<VertexHandle>& iter) {
+                const auto vv = ring->get<Op::VV>(vh);
+                ASSERT_EQ(iter.size(), vv.size());
+                for (uint32_t i = 0; i < iter.size(); ++i) {
+                    EXPECT_EQ(iter[i], vv[i]);
+                }
+            });
+    }
+}
+
+TEST(RXMeshStatic, Oriented_Device)
+{
+    using namespace rxmesh;
+
+    std::vector<std::vector<float>>    Verts;
+    std::vector<std::vector<uint32_t>> Faces;
+
+    ASSERT_TRUE(import_obj(STRINGIFY(INPUT_DIR) "sphere3.obj", Verts, Faces));
+
+    RXMeshStatic rx(Faces);
+
+    const uint32_t max_valence = rx.get_input_max_valence();
+
+    auto input  = rx.add_vertex_attribute<VertexHandle>("input", 1);
+    auto output = rx.add_vertex_attribute<VertexHandle>("output", max_valence);
+    auto cached = rx.add_vertex_attribute<VertexHandle>("cached", max_valence);
+
+    input->reset(VertexHandle(), DEVICE);
+    output->reset(VertexHandle(), DEVICE);
+    cached->reset(VertexHandle(), DEVICE);
+
+    // the oriented VV query kernel
+    constexpr uint32_t      blockThreads = 320;
+    LaunchBox<blockThreads> launch_box;
+    rx.prepare_launch_box({Op::VV},
+                          launch_box,
+                          (void*)query_kernel<blockThreads,
+                                              Op::VV,
+                                              VertexHandle,
+                                              VertexHandle,
+                                              VertexAttribute<VertexHandle>,
+                                              VertexAttribute<VertexHandle>>,
+                          true);
+
+    query_kernel<blockThreads, Op::VV, VertexHandle, VertexHandle>
+        <<<launch_box.blocks, blockThreads, launch_box.smem_bytes_dyn>>>(
+            rx.get_context(), *input, *output, true);
+
+    // the cached one-ring read on the device
+    const OrientedOneRing         ring = *rx.get_oriented_one_ring(DEVICE);
+    VertexAttribute<VertexHandle> c    = *cached;
+    rx.for_each_vertex(DEVICE, [=] __device__(const VertexHandle vh) {
+        const OneRingIterator<VertexHandle> vv = ring.get<Op::VV>(vh);
+        for (uint32_t i = 0; i < vv.size(); ++i) {
+            c(vh, i) = vv[i];
+        }
+    });
+
+    CUDA_ERROR(cudaDeviceSynchronize());
+
+    output->move(DEVICE, HOST);
+    cached->move(DEVICE, HOST);
+
+    // same neighbors in the same cyclic order. The rings may start at a
+    // different neighbor
+    rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        uint32_t n = 0;
+        while (n < max_valence && (*cached)(vh, n).is_valid()) {
+            ++n;
+        }
+        ASSERT_GT(n, 0);
+
+        uint32_t k = 0;
+        while (k < n && (*cached)(vh, k) != (*output)(vh, 0)) {
+            ++k;
+        }
+        ASSERT_LT(k, n);
+
+        for (uint32_t i = 0; i < n; ++i) {
+            EXPECT_EQ((*output)(vh, i), (*cached)(vh, (k + i) % n));
+        }
+        if (n < max_valence) {
+            EXPECT_FALSE((*output)(vh, n).is_valid());
+        }
+    });
+}
@@ -439,4 +439,408 @@ TEST(RXMeshStatic, SparseMatrixToEigen)
     X_mat.release();
     B_mat.release();
     X_copy.release();
-}
\ No newline at end of file
+}
+
+TEST(RXMeshStatic, SparsePattern)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    // the host VV pattern matches the device-built VV matrix
+    SparseMatrix<float> vv_mat(rx);
+    SparsePatternDesc   vv_desc;
+
+    auto vv = rx.get_sparse_pattern(vv_desc);
+    EXPECT_EQ(vv->num_rows, vv_mat.rows());
+    EXPECT_EQ(vv->num_cols, vv_mat.cols());
+    EXPECT_EQ(vv->nnz(), vv_mat.non_zeros());
+
+    for (int r = 0; r < vv_mat.rows(); ++r) {
+        EXPECT_EQ(vv->row_ptr[r], vv_mat.row_ptr()[r]);
+        // diagonal first
+        EXPECT_EQ(vv->col_idx[vv->row_ptr[r]], r);
+        std::set<int> host_cols(vv->col_idx.begin() + vv->row_ptr[r],
+                                vv->col_idx.begin() + vv->row_ptr[r + 1]);
+        std::set<int> dev_cols(vv_mat.col_idx() + vv_mat.row_ptr()[r],
+                               vv_mat.col_idx() + vv_mat.row_ptr()[r + 1]);
+        EXPECT_EQ(host_cols, dev_cols);
+    }
+
+    // the same description returns the cached pattern
+    EXPECT_EQ(vv.get(), rx.get_sparse_pattern(vv_desc).get());
+
+    // concurrent misses on the same description share one pattern
+    SparsePatternDesc ee_desc;
+    ee_desc.op = Op::EE;
+
+    const size_t  cache_size = rx.get_sparse_pattern_cache().size();
+    constexpr int num_req    = 4;
+
+    const SparsePattern* ee[num_req];
+#pragma omp parallel for num_threads(num_req)
+    for (int i = 0; i < num_req; ++i) {
+        ee[i] = rx.get_sparse_pattern(ee_desc).get();
+    }
+    for (int i = 1; i < num_req; ++i) {
+        EXPECT_EQ(ee[i], ee[0]);
+    }
+    EXPECT_EQ(rx.get_sparse_pattern_cache().size(), cache_size + 1);
+
+    // rectangular patterns
+    SparsePatternDesc vf_desc;
+    vf_desc.op = Op::VF;
+    auto vf    = rx.get_sparse_pattern(vf_desc);
+    EXPECT_EQ(vf->num_rows, rx.get_num_vertices());
+    EXPECT_EQ(vf->num_cols, rx.get_num_faces());
+    EXPECT_EQ(vf->nnz(), 3 * rx.get_num_faces());
+
+    SparsePatternDesc ev_desc;
+    ev_desc.op = Op::EV;
+    EXPECT_EQ(rx.get_sparse_pattern(ev_desc)->nnz(), 2 * rx.get_num_edges());
+
+    // sphere3 is closed so every face has 3 neighbor faces
+    SparsePatternDesc ff_desc;
+    ff_desc.op       = Op::FF;
+    ff_desc.diagonal = false;
+    EXPECT_EQ(rx.get_sparse_pattern(ff_desc)->nnz(), 3 * rx.get_num_faces());
+
+    // the 2-ring contains the 1-ring
+    SparsePatternDesc vv2_desc;
+    vv2_desc.rings = 2;
+    auto vv2       = rx.get_sparse_pattern(vv2_desc);
+    for (int r = 0; r < vv->num_rows; ++r) {
+        EXPECT_EQ(vv2->col_idx[vv2->row_ptr[r]], r);
+        EXPECT_GT(vv2->row_ptr[r + 1] - vv2->row_ptr[r],
+                  vv->row_ptr[r + 1] - vv->row_ptr[r]);
+        for (int i = vv->row_ptr[r]; i < vv->row_ptr[r + 1]; ++i) {
+            EXPECT_TRUE(std::find(vv2->col_idx.begin() + vv2->row_ptr[r],
+                                  vv2->col_idx.begin() + vv2->row_ptr[r + 1],
+                                  vv->col_idx[i]) !=
+                        vv2->col_idx.begin() + vv2->row_ptr[r + 1]);
+        }
+    }
+
+    // a VF matrix accessed with vertex and face handles
+    SparseMatrix<float> vf_mat(rx, vf_desc);
+    EXPECT_EQ(vf_mat.rows(), rx.get_num_vertices());
+    EXPECT_EQ(vf_mat.cols(), rx.get_num_faces());
+
+    rx.run_query_kernel<Op::FV, 256>(
+        [=] __device__(const FaceHandle&     fh,
+                       const VertexIterator& iter) mutable {
+            for (uint16_t i = 0; i < iter.size(); ++i) {
+                vf_mat(iter[i], fh) = 1.f;
+            }
+        });
+    vf_mat.move(DEVICE, HOST);
+
+    vf_mat.for_each([&](int r, int c, float& val) { EXPECT_EQ(val, 1.f); });
+
+    vv_mat.release();
+    vf_mat.release();
+}
+
+TEST(RXMeshStatic, SparseAlgebra)
+{
+    using namespace rxmesh;
+    using EigenSpMat = Eigen::SparseMatrix<double, Eigen::RowMajor, int>;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    // uniform Laplacian L and a diagonal mass matrix M
+    HostSparseMatrix<double> L(rx.get_sparse_pattern(SparsePatternDesc()));
+    for (int r = 0; r < L.rows(); ++r) {
+        const int start = L.row_ptr()[r];
+        const int end   = L.row_ptr()[r + 1];
+        L.val[start]    = double(end - start - 1);
+        for (int i = start + 1; i < end; ++i) {
+            L.val[i] = -1.0;
+        }
+    }
+
+    SparsePatternDesc m_desc;
+    m_desc.op = Op::V;
+    HostSparseMatrix<double> M(rx.get_sparse_pattern(m_desc));
+    std::vector<double>      m_inv(M.rows());
+    for (int r = 0; r < M.rows(); ++r) {
+        M.val[r] = 1.0 + double(r % 7);
+        m_inv[r] = 1.0 / M.val[r];
+    }
+
+    auto to_eigen = [](const HostSparseMatrix<double>& mat) {
+        std::vector<Eigen::Triplet<double>> triplets;
+        for (int r = 0; r < mat.rows(); ++r) {
+            for (int i = mat.row_ptr()[r]; i < mat.row_ptr()[r + 1]; ++i) {
+                triplets.emplace_back(r, mat.col_idx()[i], mat.val[i]);
+            }
+        }
+        EigenSpMat ret(mat.rows(), mat.cols());
+        ret.setFromTriplets(triplets.begin(), triplets.end());
+        return ret;
+    };
+
+    auto expect_near = [](const EigenSpMat& a, const EigenSpMat& b) {
+        EXPECT_EQ(a.rows(), b.rows());
+        EXPECT_EQ(a.cols(), b.cols());
+        EXPECT_NEAR((a - b).norm(), 0.0, 1e-9);
+    };
+
+    EigenSpMat L_eigen = to_eigen(L);
+    EigenSpMat M_eigen = to_eigen(M);
+
+    // bilaplacian L^T M^-1 L
+    HostSparseMatrix<double> Lt    = transpose(L);
+    HostSparseMatrix<double> MinvL = L;
+    scale_rows(m_inv, MinvL);
+    HostSparseMatrix<double> B = spgemm(Lt, MinvL);
+
+    EigenSpMat M_inv_eigen = M_eigen;
+    for (int k = 0; k < M_inv_eigen.outerSize(); ++k) {
+        for (EigenSpMat::InnerIterator it(M_inv_eigen, k); it; ++it) {
+            it.valueRef() = 1.0 / it.value();
+        }
+    }
+    EigenSpMat Lt_eigen = L_eigen.transpose();
+    EigenSpMat B_eigen  = Lt_eigen * M_inv_eigen * L_eigen;
+    expect_near(to_eigen(B), B_eigen);
+
+    // numeric phase with the same pattern
+    HostSparseMatrix<double> L2 = L;
+    for (auto& v : L2.val) {
+        v *= 2.0;
+    }
+    spgemm_numeric(Lt, L2, B);
+    expect_near(to_eigen(B), EigenSpMat(2.0 * Lt_eigen * L_eigen));
+
+    // L + 0.5 M
+    expect_near(to_eigen(add(1.0, L, 0.5, M)),
+                EigenSpMat(L_eigen + 0.5 * M_eigen));
+
+    // a pattern that misses the off-diagonal entries of L is reported and
+    // only the entries in the pattern are written
+    HostSparseMatrix<double> D(M.pattern);
+    add_numeric(1.0, L, 0.5, M, D);
+    for (int r = 0; r < D.rows(); ++r) {
+        EXPECT_EQ(D(r, r), L.val[L.row_ptr()[r]] + 0.5 * M.val[r]);
+    }
+
+    // scale the columns
+    HostSparseMatrix<double> LM = L;
+    scale_cols(LM, M.val);
+    expect_near(to_eigen(LM), EigenSpMat(L_eigen * M_eigen));
+
+    // replicate to xyz
+    HostSparseMatrix<double> L3 = kron_identity(L, 3);
+    EXPECT_EQ(L3.rows(), 3 * L.rows());
+    EXPECT_EQ(L3.non_zeros(), 3 * L.non_zeros());
+    for (int r = 0; r < L.rows(); ++r) {
+        for (int i = L.row_ptr()[r]; i < L.row_ptr()[r + 1]; ++i) {
+            const int c = L.col_idx()[i];
+            for (int k = 0; k < 3; ++k) {
+                EXPECT_EQ(L3(3 * r + k, 3 * c + k), L.val[i]);
+            }
+        }
+    }
+
+    // move the result to a SparseMatrix and back
+    SparseMatrix<double>     B_mat(rx, B);
+    HostSparseMatrix<double> B_back = B_mat.to_host_sparse();
+    expect_near(to_eigen(B_back), to_eigen(B));
+    EXPECT_EQ(B_mat.replicate(), 1);
+
+    // the zero-copy Eigen map of the host matrix matches the copy of the
+    // SparseMatrix
+    expect_near(EigenSpMat(B.to_eigen()), B_mat.to_eigen_copy());
+
+    // the block size is read from the structure, not the (default)
+    // description of the sparse algebra result
+    SparsePatternDesc r_desc;
+    r_desc.replicate = 3;
+    HostSparseMatrix<double> R(rx.get_sparse_pattern(r_desc));
+    std::fill(R.val.begin(), R.val.end(), 1.0);
+    HostSparseMatrix<double> RR = spgemm(R, R);
+    EXPECT_EQ(RR.pattern->desc.replicate, 1u);
+
+    SparseMatrix<double> RR_mat(rx, RR);
+    EXPECT_EQ(RR_mat.replicate(), 3);
+
+    // kron_identity() gives diagonal, not dense, 3 x 3 blocks
+    SparseMatrix<double> L3_mat(rx, L3);
+    EXPECT_EQ(L3_mat.replicate(), 1);
+
+    B_mat.release();
+    RR_mat.release();
+    L3_mat.release();
+}
+
+TEST(RXMeshStatic, PermuteCache)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    const std::string folder =
+        (std::filesystem::temp_directory_path() / "rxmesh_permute_cache")
+            .string();
+    std::filesystem::remove_all(folder);
+
+    PermuteCache& cache = PermuteCache::instance();
+    cache.clear();
+    cache.reset_stats();
+    cache.set_folder(folder);
+
+    SparseMatrix<float> A_mat(rx);
+    SparseMatrix<float> B_mat(rx);
+
+    // first permutation is computed and cached
+    A_mat.permute(rx, PermuteMethod::NSTDIS);
+    EXPECT_EQ(cache.size(), 1);
+
+    // same pattern and method
+    B_mat.permute(rx, PermuteMethod::NSTDIS);
+    EXPECT_GE(cache.get_num_hits(), 1);
+
+    const int        num_rows = A_mat.rows();
+    std::vector<int> a_perm(A_mat.get_h_permute(),
+                            A_mat.get_h_permute() + num_rows);
+    std::vector<int> b_perm(B_mat.get_h_permute(),
+                            B_mat.get_h_permute() + num_rows);
+    EXPECT_EQ(a_perm, b_perm);
+
+    // a new process would start with an empty memory cache and read the
+    // permutation from disk
+    cache.clear();
+    const uint32_t disk_hits = cache.get_num_disk_hits();
+    B_mat.permute(rx, PermuteMethod::NSTDIS);
+    EXPECT_EQ(cache.get_num_disk_hits(), disk_hits + 1);
+    std::vector<int> c_perm(B_mat.get_h_permute(),
+                            B_mat.get_h_permute() + num_rows);
+    EXPECT_EQ(a_perm, c_perm);
+
+    cache.set_folder("");
+    cache.clear();
+    std::filesystem::remove_all(folder);
+
+    A_mat.release();
+    B_mat.release();
+}
+
+TEST(RXMeshStatic, SparseMatrixReorder)
+{
+    using namespace rxmesh;
+
+    RXMeshStatic rx(STRINGIFY(INPUT_DIR) "sphere3.obj");
+
+    SparseMatrix<double> A_mat(rx);
+    A_mat.for_each([](int r, int c, double& val) {
+        val = (r == c) ? 100.0 : -1.0 - 0.001 * double(r + 2 * c);
+    });
+    A_mat.move(HOST, DEVICE);
+
+    const int num_rows = A_mat.rows();
+
+    const Eigen::SparseMatrix<double, Eigen::RowMajor, int> A_ref =
+        A_mat.to_eigen_copy();
+
+    DenseMatrix<double> X_mat(rx, num_rows, 2);
+    X_mat.fill_random();
+    X_mat.move(HOST, DEVICE);
+    const Eigen::MatrixXd X_ref = X_mat.to_eigen();
+    const Eigen::MatrixXd Y_ref = A_ref * X_ref;
+
+    const CSRBandwidth before = A_mat.bandwidth();
+
+    A_mat.reorder(rx, PermuteMethod::SYMRCM);
+    EXPECT_TRUE(A_mat.is_reordered());
+
+    const CSRBandwidth after = A_mat.bandwidth();
+    EXPECT_LE(after.max_bandwidth, before.max_bandwidth);
+
+    std::vector<int> order(A_mat.get_h_row_order(),
+                           A_mat.get_h_row_order() + num_rows);
+    EXPECT_TRUE(is_unique_permutation(num_rows, order.data()));
+
+    // same entries in the new order, and the handle accessor follows them
+    for (int r = 0; r < num_rows; ++r) {
+        for (Eigen::SparseMatrix<double, Eigen::RowMajor, int>::InnerIterator
+                 it(A_ref, r);
+             it;
+             ++it) {
+            EXPECT_EQ(A_mat(order[r], order[int(it.col())]), it.value());
+        }
+    }
+    rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        const int r = rx.linear_id(vh);
+        EXPECT_EQ(A_mat(vh, vh), A_ref.coeff(r, r));
+    });
+
+    // host and device SpMV on the reordered pair
+    A_mat.reorder(X_mat);
+    EXPECT_TRUE(X_mat.is_reordered());
+
+    // the output in the linear id order is rejected
+    DenseMatrix<double> Y_mat(rx, num_rows, 2);
+    Y_mat.reset(-1.0, LOCATION_ALL);
+    A_mat.multiply(X_mat, Y_mat);
+    Y_mat.move(DEVICE, HOST);
+    EXPECT_EQ(Y_mat(0, 0), -1.0);
+
+    A_mat.reorder(Y_mat);
+    A_mat.multiply(X_mat, Y_mat);
+    Y_mat.move(DEVICE, HOST);
+
+    const Eigen::MatrixXd Y_host = A_mat.to_eigen() * X_mat.to_eigen();
+    for (int r = 0; r < num_rows; ++r) {
+        for (int j = 0; j < 2; ++j) {
+            EXPECT_NEAR(Y_host(order[r], j), Y_ref(r, j), 1e-9);
+            EXPECT_NEAR(Y_mat(order[r], j), Y_ref(r, j), 1e-9);
+        }
+    }
+
+    RXMESH_INFO(
+        "SparseMatrixReorder: bandwidth (max/avg) {}/{:.2f} -> {}/{:.2f}",
+        before.max_bandwidth,
+        before.avg_bandwidth,
+        after.max_bandwidth,
+        after.avg_bandwidth);
+
+    // attributes map to and from the reordered rows
+    auto attr = rx.add_vertex_attribute<double>("v", 1);
+    rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        (*attr)(vh) = double(rx.linear_id(vh));
+    });
+    auto mat = A_mat.to_matrix(*attr);
+    rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        EXPECT_EQ((*mat)(vh, 0), (*attr)(vh));
+        EXPECT_EQ((*mat)(order[rx.linear_id(vh)], 0), (*attr)(vh));
+    });
+    attr->reset(0.0, HOST);
+    A_mat.from_matrix(*mat, *attr);
+    rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        EXPECT_EQ((*attr)(vh), double(rx.linear_id(vh)));
+    });
+
+    // reordering again does not remap the dense matrices in the older order
+    A_mat.reorder(rx, PermuteMethod::GPUND);
+    rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        EXPECT_EQ((*mat)(vh, 0), double(rx.linear_id(vh)));
+    });
+
+    // ... which are not in the row order of the matrix anymore
+    attr->reset(-1.0, HOST);
+    A_mat.from_matrix(*mat, *attr);
+    rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        EXPECT_EQ((*attr)(vh), -1.0);
+    });
+
+    // and the dense matrix outlives the sparse matrix
+    A_mat.release();
+    rx.for_each_vertex(HOST, [&](const VertexHandle vh) {
+        EXPECT_EQ((*mat)(vh, 0), double(rx.linear_id(vh)));
+    });
+
+    mat->release();
+    X_mat.release();
+    Y_mat.release();
+}
@@ -5,7 +5,10 @@
 #include "rxmesh/kernels/collective.cuh"
 #include "rxmesh/kernels/rxmesh_queries.cuh"
 #include "rxmesh/kernels/util.cuh"
+#include "rxmesh/util/host_memory.h"
 #include "rxmesh/util/macros.h"
+#include "rxmesh/util/perf_counters.h"
+#include "rxmesh/util/report.h"
 #include "rxmesh/util/util.h"
 
 template <uint32_t rowOffset, uint32_t blockThreads, uint32_t itemPerThread>
@@ -322,4 +325,120 @@ TEST(Util, BlockMatrixTranspose)
 
     EXPECT_TRUE(is_offset_okay);
     EXPECT_TRUE(is_value_okay);
-}
\ No newline at end of file
+}
+
+TEST(Util, PerfCounters)
+{
+    using namespace rxmesh;
+
+    // hardware counters may not be available (e.g., no permission or
+    // virtualized machine) in which case only the time is measured
+    PerfCounters pc;
+
+    auto run = [&](const int n) {
+        std::vector<double> vals(n, 1.0);
+        double              sum = 0;
+
+        PerfCounterValues res = pc.measure([&]() {
+#pragma omp parallel for reduction(+ : sum)
+            for (int i = 0; i < int(vals.size()); ++i) {
+                sum += vals[i];
+            }
+        });
+        EXPECT_DOUBLE_EQ(sum, double(vals.size()));
+        return res;
+    };
+
+    const PerfCounterValues small = run(1 << 18);
+    const PerfCounterValues large = run(1 << 22);
+
+    EXPECT_GT(large.time_ms, 0.0);
+    EXPECT_EQ(large.num_threads, omp_get_max_threads());
+
+    // a counter is only reported if it is opened on every thread
+    for (uint32_t c = 0; c < PerfCounterValues::NUM_COUNTERS; ++c) {
+        EXPECT_EQ(small.available[c], large.available[c]);
+        if (!large.available[c]) {
+            EXPECT_EQ(large.value[c], 0u);
+        }
+    }
+
+    // 16x more work
+    if (large.available[PerfCounterValues::INSTRUCTIONS]) {
+        EXPECT_GT(large.value[PerfCounterValues::INSTRUCTIONS],
+                  small.value[PerfCounterValues::INSTRUCTIONS]);
+    }
+    if (!large.any_available()) {
+        EXPECT_EQ(large.ipc(), 0.0);
+        EXPECT_EQ(large.estimated_bandwidth_gbs(), 0.0);
+    }
+
+    Report report("PerfCounters");
+    report.perf_counters("PerfCounters", large);
+    ASSERT_TRUE(report.m_doc.HasMember("PerfCounters"));
+    const auto& member = report.m_doc["PerfCounters"];
+    EXPECT_TRUE(member.HasMember("time (ms)"));
+    for (uint32_t c = 0; c < PerfCounterValues::NUM_COUNTERS; ++c) {
+        EXPECT_EQ(
+            member.HasMember(PerfCounterValues::counter_name(c).c_str()),
+            large.available[c]);
+    }
+}
+
+TEST(Util, HostMemory)
+{
+    using namespace rxmesh;
+
+    HostMemory& hm = HostMemory::instance();
+
+    const size_t cur   = hm.current(HostMemTag::Other);
+    const size_t total = hm.total_current();
+
+    uint32_t* ptr = host_malloc<uint32_t>(1024, HostMemTag::Other);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignof(std::max_align_t), 0);
+    EXPECT_EQ(hm.current(HostMemTag::Other), cur + 1024 * sizeof(uint32_t));
+    EXPECT_EQ(hm.total_current(), total + 1024 * sizeof(uint32_t));
+    EXPECT_GE(hm.peak(HostMemTag::Other), cur + 1024 * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < 1024; ++i) {
+        ptr[i] = i;
+    }
+
+    ptr = host_realloc(ptr, 2048, HostMemTag::Other);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(hm.current(HostMemTag::Other), cur + 2048 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < 1024; ++i) {
+        EXPECT_EQ(ptr[i], i);
+    }
+
+    host_free(ptr);
+    EXPECT_EQ(hm.current(HostMemTag::Other), cur);
+    EXPECT_EQ(hm.total_current(), total);
+    EXPECT_GE(hm.peak(HostMemTag::Other), cur + 2048 * sizeof(uint32_t));
+
+    // over-aligned buffers keep their alignment when resized
+    float* aligned = host_malloc<float>(100, HostMemTag::Other, 64);
+    ASSERT_NE(aligned, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0);
+    for (uint32_t i = 0; i < 100; ++i) {
+        aligned[i] = float(i);
+    }
+    aligned = host_realloc(aligned, 1000, HostMemTag::Other);
+    ASSERT_NE(aligned, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0);
+    EXPECT_EQ(hm.current(HostMemTag::Other), cur + 1000 * sizeof(float));
+    for (uint32_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(aligned[i], float(i));
+    }
+    host_free(aligned);
+    EXPECT_EQ(hm.current(HostMemTag::Other), cur);
+
+    hm.reset_peak();
+    EXPECT_EQ(hm.peak(HostMemTag::Other), cur);
+
+#ifdef __linux__
+    EXPECT_GT(HostMemory::process_rss(), 0);
+    EXPECT_GE(HostMemory::process_peak_rss(), HostMemory::process_rss());
+#endif
+}